@@ -0,0 +1,27 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/Imath.dir/ImathColorAlgo.cpp.o"
+  "CMakeFiles/Imath.dir/ImathColorAlgo.cpp.o.d"
+  "CMakeFiles/Imath.dir/ImathFun.cpp.o"
+  "CMakeFiles/Imath.dir/ImathFun.cpp.o.d"
+  "CMakeFiles/Imath.dir/ImathMatrixAlgo.cpp.o"
+  "CMakeFiles/Imath.dir/ImathMatrixAlgo.cpp.o.d"
+  "CMakeFiles/Imath.dir/ImathParallel.cpp.o"
+  "CMakeFiles/Imath.dir/ImathParallel.cpp.o.d"
+  "CMakeFiles/Imath.dir/ImathRandom.cpp.o"
+  "CMakeFiles/Imath.dir/ImathRandom.cpp.o.d"
+  "CMakeFiles/Imath.dir/ImathVecArray.cpp.o"
+  "CMakeFiles/Imath.dir/ImathVecArray.cpp.o.d"
+  "CMakeFiles/Imath.dir/half.cpp.o"
+  "CMakeFiles/Imath.dir/half.cpp.o.d"
+  "CMakeFiles/Imath.dir/halfFunction.cpp.o"
+  "CMakeFiles/Imath.dir/halfFunction.cpp.o.d"
+  "libImath-3_2.pdb"
+  "libImath-3_2.so"
+  "libImath-3_2.so.30"
+  "libImath-3_2.so.30.3.2.0"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/Imath.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
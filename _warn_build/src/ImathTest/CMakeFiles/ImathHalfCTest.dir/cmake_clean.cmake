@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../../bin/ImathHalfCTest"
+  "../../bin/ImathHalfCTest.pdb"
+  "CMakeFiles/ImathHalfCTest.dir/half_c_main.c.o"
+  "CMakeFiles/ImathHalfCTest.dir/half_c_main.c.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/ImathHalfCTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../../bin/ImathHalfPerfTest"
+  "../../bin/ImathHalfPerfTest.pdb"
+  "CMakeFiles/ImathHalfPerfTest.dir/half_perf_test.cpp.o"
+  "CMakeFiles/ImathHalfPerfTest.dir/half_perf_test.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/ImathHalfPerfTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../../bin/ImathPerfTest"
+  "../../bin/ImathPerfTest.pdb"
+  "CMakeFiles/ImathPerfTest.dir/perf_test.cpp.o"
+  "CMakeFiles/ImathPerfTest.dir/perf_test.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/ImathPerfTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
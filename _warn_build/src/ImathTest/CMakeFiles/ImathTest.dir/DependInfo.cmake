@@ -0,0 +1,60 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/ImathTest/main.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/main.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/main.cpp.o.d"
+  "/root/repo/src/ImathTest/testArithmetic.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testArithmetic.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testArithmetic.cpp.o.d"
+  "/root/repo/src/ImathTest/testBatchMath.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testBatchMath.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testBatchMath.cpp.o.d"
+  "/root/repo/src/ImathTest/testBitPatterns.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testBitPatterns.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testBitPatterns.cpp.o.d"
+  "/root/repo/src/ImathTest/testBox.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testBox.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testBox.cpp.o.d"
+  "/root/repo/src/ImathTest/testBoxAlgo.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testBoxAlgo.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testBoxAlgo.cpp.o.d"
+  "/root/repo/src/ImathTest/testBvh.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testBvh.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testBvh.cpp.o.d"
+  "/root/repo/src/ImathTest/testClassification.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testClassification.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testClassification.cpp.o.d"
+  "/root/repo/src/ImathTest/testColor.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testColor.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testColor.cpp.o.d"
+  "/root/repo/src/ImathTest/testDualQuat.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testDualQuat.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testDualQuat.cpp.o.d"
+  "/root/repo/src/ImathTest/testError.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testError.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testError.cpp.o.d"
+  "/root/repo/src/ImathTest/testExtractEuler.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testExtractEuler.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testExtractEuler.cpp.o.d"
+  "/root/repo/src/ImathTest/testExtractSHRT.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testExtractSHRT.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testExtractSHRT.cpp.o.d"
+  "/root/repo/src/ImathTest/testFrustum.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testFrustum.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testFrustum.cpp.o.d"
+  "/root/repo/src/ImathTest/testFrustumTest.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testFrustumTest.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testFrustumTest.cpp.o.d"
+  "/root/repo/src/ImathTest/testFun.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testFun.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testFun.cpp.o.d"
+  "/root/repo/src/ImathTest/testFunction.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testFunction.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testFunction.cpp.o.d"
+  "/root/repo/src/ImathTest/testInterop.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testInterop.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testInterop.cpp.o.d"
+  "/root/repo/src/ImathTest/testInterval.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testInterval.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testInterval.cpp.o.d"
+  "/root/repo/src/ImathTest/testInvert.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testInvert.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testInvert.cpp.o.d"
+  "/root/repo/src/ImathTest/testJacobiEigenSolver.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testJacobiEigenSolver.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testJacobiEigenSolver.cpp.o.d"
+  "/root/repo/src/ImathTest/testLimits.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testLimits.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testLimits.cpp.o.d"
+  "/root/repo/src/ImathTest/testLineAlgo.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testLineAlgo.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testLineAlgo.cpp.o.d"
+  "/root/repo/src/ImathTest/testMatrix.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testMatrix.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testMatrix.cpp.o.d"
+  "/root/repo/src/ImathTest/testMatrixBatch.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testMatrixBatch.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testMatrixBatch.cpp.o.d"
+  "/root/repo/src/ImathTest/testMiscMatrixAlgo.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testMiscMatrixAlgo.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testMiscMatrixAlgo.cpp.o.d"
+  "/root/repo/src/ImathTest/testNoInterop.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testNoInterop.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testNoInterop.cpp.o.d"
+  "/root/repo/src/ImathTest/testPolarDecomposition.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testPolarDecomposition.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testPolarDecomposition.cpp.o.d"
+  "/root/repo/src/ImathTest/testProcrustes.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testProcrustes.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testProcrustes.cpp.o.d"
+  "/root/repo/src/ImathTest/testQuat.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testQuat.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testQuat.cpp.o.d"
+  "/root/repo/src/ImathTest/testQuatArray.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testQuatArray.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testQuatArray.cpp.o.d"
+  "/root/repo/src/ImathTest/testQuatSetRotation.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testQuatSetRotation.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testQuatSetRotation.cpp.o.d"
+  "/root/repo/src/ImathTest/testQuatSlerp.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testQuatSlerp.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testQuatSlerp.cpp.o.d"
+  "/root/repo/src/ImathTest/testRandom.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testRandom.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testRandom.cpp.o.d"
+  "/root/repo/src/ImathTest/testRoots.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testRoots.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testRoots.cpp.o.d"
+  "/root/repo/src/ImathTest/testShear.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testShear.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testShear.cpp.o.d"
+  "/root/repo/src/ImathTest/testSize.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testSize.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testSize.cpp.o.d"
+  "/root/repo/src/ImathTest/testTinySVD.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testTinySVD.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testTinySVD.cpp.o.d"
+  "/root/repo/src/ImathTest/testToFloat.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testToFloat.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testToFloat.cpp.o.d"
+  "/root/repo/src/ImathTest/testVec.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testVec.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testVec.cpp.o.d"
+  "/root/repo/src/ImathTest/testVecArray.cpp" "src/ImathTest/CMakeFiles/ImathTest.dir/testVecArray.cpp.o" "gcc" "src/ImathTest/CMakeFiles/ImathTest.dir/testVecArray.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_warn_build/src/Imath/CMakeFiles/Imath.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
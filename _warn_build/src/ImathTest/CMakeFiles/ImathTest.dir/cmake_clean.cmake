@@ -0,0 +1,91 @@
+file(REMOVE_RECURSE
+  "../../bin/ImathTest"
+  "../../bin/ImathTest.pdb"
+  "CMakeFiles/ImathTest.dir/main.cpp.o"
+  "CMakeFiles/ImathTest.dir/main.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testArithmetic.cpp.o"
+  "CMakeFiles/ImathTest.dir/testArithmetic.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testBatchMath.cpp.o"
+  "CMakeFiles/ImathTest.dir/testBatchMath.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testBitPatterns.cpp.o"
+  "CMakeFiles/ImathTest.dir/testBitPatterns.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testBox.cpp.o"
+  "CMakeFiles/ImathTest.dir/testBox.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testBoxAlgo.cpp.o"
+  "CMakeFiles/ImathTest.dir/testBoxAlgo.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testBvh.cpp.o"
+  "CMakeFiles/ImathTest.dir/testBvh.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testClassification.cpp.o"
+  "CMakeFiles/ImathTest.dir/testClassification.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testColor.cpp.o"
+  "CMakeFiles/ImathTest.dir/testColor.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testDualQuat.cpp.o"
+  "CMakeFiles/ImathTest.dir/testDualQuat.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testError.cpp.o"
+  "CMakeFiles/ImathTest.dir/testError.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testExtractEuler.cpp.o"
+  "CMakeFiles/ImathTest.dir/testExtractEuler.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testExtractSHRT.cpp.o"
+  "CMakeFiles/ImathTest.dir/testExtractSHRT.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testFrustum.cpp.o"
+  "CMakeFiles/ImathTest.dir/testFrustum.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testFrustumTest.cpp.o"
+  "CMakeFiles/ImathTest.dir/testFrustumTest.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testFun.cpp.o"
+  "CMakeFiles/ImathTest.dir/testFun.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testFunction.cpp.o"
+  "CMakeFiles/ImathTest.dir/testFunction.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testInterop.cpp.o"
+  "CMakeFiles/ImathTest.dir/testInterop.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testInterval.cpp.o"
+  "CMakeFiles/ImathTest.dir/testInterval.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testInvert.cpp.o"
+  "CMakeFiles/ImathTest.dir/testInvert.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testJacobiEigenSolver.cpp.o"
+  "CMakeFiles/ImathTest.dir/testJacobiEigenSolver.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testLimits.cpp.o"
+  "CMakeFiles/ImathTest.dir/testLimits.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testLineAlgo.cpp.o"
+  "CMakeFiles/ImathTest.dir/testLineAlgo.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testMatrix.cpp.o"
+  "CMakeFiles/ImathTest.dir/testMatrix.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testMatrixBatch.cpp.o"
+  "CMakeFiles/ImathTest.dir/testMatrixBatch.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testMiscMatrixAlgo.cpp.o"
+  "CMakeFiles/ImathTest.dir/testMiscMatrixAlgo.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testNoInterop.cpp.o"
+  "CMakeFiles/ImathTest.dir/testNoInterop.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testPolarDecomposition.cpp.o"
+  "CMakeFiles/ImathTest.dir/testPolarDecomposition.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testProcrustes.cpp.o"
+  "CMakeFiles/ImathTest.dir/testProcrustes.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testQuat.cpp.o"
+  "CMakeFiles/ImathTest.dir/testQuat.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testQuatArray.cpp.o"
+  "CMakeFiles/ImathTest.dir/testQuatArray.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testQuatSetRotation.cpp.o"
+  "CMakeFiles/ImathTest.dir/testQuatSetRotation.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testQuatSlerp.cpp.o"
+  "CMakeFiles/ImathTest.dir/testQuatSlerp.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testRandom.cpp.o"
+  "CMakeFiles/ImathTest.dir/testRandom.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testRoots.cpp.o"
+  "CMakeFiles/ImathTest.dir/testRoots.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testShear.cpp.o"
+  "CMakeFiles/ImathTest.dir/testShear.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testSize.cpp.o"
+  "CMakeFiles/ImathTest.dir/testSize.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testTinySVD.cpp.o"
+  "CMakeFiles/ImathTest.dir/testTinySVD.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testToFloat.cpp.o"
+  "CMakeFiles/ImathTest.dir/testToFloat.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testVec.cpp.o"
+  "CMakeFiles/ImathTest.dir/testVec.cpp.o.d"
+  "CMakeFiles/ImathTest.dir/testVecArray.cpp.o"
+  "CMakeFiles/ImathTest.dir/testVecArray.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/ImathTest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
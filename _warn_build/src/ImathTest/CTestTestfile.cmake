@@ -0,0 +1,102 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/src/ImathTest
+# Build directory: /root/repo/_warn_build/src/ImathTest
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(Imath.half_c_only "/root/repo/_warn_build/bin/ImathHalfCTest")
+set_tests_properties(Imath.half_c_only PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;77;add_test;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.half_perf_test "/root/repo/_warn_build/bin/ImathHalfPerfTest" "--quick")
+set_tests_properties(Imath.half_perf_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;86;add_test;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.perf_test "/root/repo/_warn_build/bin/ImathPerfTest" "--quick")
+set_tests_properties(Imath.perf_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;93;add_test;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testToFloat "/root/repo/_warn_build/bin/ImathTest" "testToFloat")
+set_tests_properties(Imath.testToFloat PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testBulkConversion "/root/repo/_warn_build/bin/ImathTest" "testBulkConversion")
+set_tests_properties(Imath.testBulkConversion PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testBulkRounding "/root/repo/_warn_build/bin/ImathTest" "testBulkRounding")
+set_tests_properties(Imath.testBulkRounding PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testSize "/root/repo/_warn_build/bin/ImathTest" "testSize")
+set_tests_properties(Imath.testSize PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testArithmetic "/root/repo/_warn_build/bin/ImathTest" "testArithmetic")
+set_tests_properties(Imath.testArithmetic PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testNormalizedConversionError "/root/repo/_warn_build/bin/ImathTest" "testNormalizedConversionError")
+set_tests_properties(Imath.testNormalizedConversionError PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testDenormalizedConversionError "/root/repo/_warn_build/bin/ImathTest" "testDenormalizedConversionError")
+set_tests_properties(Imath.testDenormalizedConversionError PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testRoundingError "/root/repo/_warn_build/bin/ImathTest" "testRoundingError")
+set_tests_properties(Imath.testRoundingError PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testBitPatterns "/root/repo/_warn_build/bin/ImathTest" "testBitPatterns")
+set_tests_properties(Imath.testBitPatterns PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testClassification "/root/repo/_warn_build/bin/ImathTest" "testClassification")
+set_tests_properties(Imath.testClassification PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testLimits "/root/repo/_warn_build/bin/ImathTest" "testLimits")
+set_tests_properties(Imath.testLimits PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testHalfLimits "/root/repo/_warn_build/bin/ImathTest" "testHalfLimits")
+set_tests_properties(Imath.testHalfLimits PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testFunction "/root/repo/_warn_build/bin/ImathTest" "testFunction")
+set_tests_properties(Imath.testFunction PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testVec "/root/repo/_warn_build/bin/ImathTest" "testVec")
+set_tests_properties(Imath.testVec PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testVecArray "/root/repo/_warn_build/bin/ImathTest" "testVecArray")
+set_tests_properties(Imath.testVecArray PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testColor "/root/repo/_warn_build/bin/ImathTest" "testColor")
+set_tests_properties(Imath.testColor PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testShear "/root/repo/_warn_build/bin/ImathTest" "testShear")
+set_tests_properties(Imath.testShear PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testMatrix "/root/repo/_warn_build/bin/ImathTest" "testMatrix")
+set_tests_properties(Imath.testMatrix PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testMatrixBatch "/root/repo/_warn_build/bin/ImathTest" "testMatrixBatch")
+set_tests_properties(Imath.testMatrixBatch PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testMiscMatrixAlgo "/root/repo/_warn_build/bin/ImathTest" "testMiscMatrixAlgo")
+set_tests_properties(Imath.testMiscMatrixAlgo PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testRoots "/root/repo/_warn_build/bin/ImathTest" "testRoots")
+set_tests_properties(Imath.testRoots PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testFun "/root/repo/_warn_build/bin/ImathTest" "testFun")
+set_tests_properties(Imath.testFun PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testBatchMath "/root/repo/_warn_build/bin/ImathTest" "testBatchMath")
+set_tests_properties(Imath.testBatchMath PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testInvert "/root/repo/_warn_build/bin/ImathTest" "testInvert")
+set_tests_properties(Imath.testInvert PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testInterval "/root/repo/_warn_build/bin/ImathTest" "testInterval")
+set_tests_properties(Imath.testInterval PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testFrustum "/root/repo/_warn_build/bin/ImathTest" "testFrustum")
+set_tests_properties(Imath.testFrustum PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testRandom "/root/repo/_warn_build/bin/ImathTest" "testRandom")
+set_tests_properties(Imath.testRandom PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testExtractEuler "/root/repo/_warn_build/bin/ImathTest" "testExtractEuler")
+set_tests_properties(Imath.testExtractEuler PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testExtractSHRT "/root/repo/_warn_build/bin/ImathTest" "testExtractSHRT")
+set_tests_properties(Imath.testExtractSHRT PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testQuat "/root/repo/_warn_build/bin/ImathTest" "testQuat")
+set_tests_properties(Imath.testQuat PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testQuatArray "/root/repo/_warn_build/bin/ImathTest" "testQuatArray")
+set_tests_properties(Imath.testQuatArray PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testDualQuat "/root/repo/_warn_build/bin/ImathTest" "testDualQuat")
+set_tests_properties(Imath.testDualQuat PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testQuatSetRotation "/root/repo/_warn_build/bin/ImathTest" "testQuatSetRotation")
+set_tests_properties(Imath.testQuatSetRotation PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testQuatSlerp "/root/repo/_warn_build/bin/ImathTest" "testQuatSlerp")
+set_tests_properties(Imath.testQuatSlerp PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testLineAlgo "/root/repo/_warn_build/bin/ImathTest" "testLineAlgo")
+set_tests_properties(Imath.testLineAlgo PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testBoxAlgo "/root/repo/_warn_build/bin/ImathTest" "testBoxAlgo")
+set_tests_properties(Imath.testBoxAlgo PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testBvh "/root/repo/_warn_build/bin/ImathTest" "testBvh")
+set_tests_properties(Imath.testBvh PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testBox "/root/repo/_warn_build/bin/ImathTest" "testBox")
+set_tests_properties(Imath.testBox PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testProcrustes "/root/repo/_warn_build/bin/ImathTest" "testProcrustes")
+set_tests_properties(Imath.testProcrustes PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testTinySVD "/root/repo/_warn_build/bin/ImathTest" "testTinySVD")
+set_tests_properties(Imath.testTinySVD PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testJacobiEigenSolver "/root/repo/_warn_build/bin/ImathTest" "testJacobiEigenSolver")
+set_tests_properties(Imath.testJacobiEigenSolver PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testPolarDecomposition "/root/repo/_warn_build/bin/ImathTest" "testPolarDecomposition")
+set_tests_properties(Imath.testPolarDecomposition PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testFrustumTest "/root/repo/_warn_build/bin/ImathTest" "testFrustumTest")
+set_tests_properties(Imath.testFrustumTest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testInterop "/root/repo/_warn_build/bin/ImathTest" "testInterop")
+set_tests_properties(Imath.testInterop PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
+add_test(Imath.testNoInterop "/root/repo/_warn_build/bin/ImathTest" "testNoInterop")
+set_tests_properties(Imath.testNoInterop PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/src/ImathTest/CMakeLists.txt;97;add_test;/root/repo/src/ImathTest/CMakeLists.txt;101;define_imath_tests;/root/repo/src/ImathTest/CMakeLists.txt;0;")
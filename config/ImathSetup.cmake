@@ -11,6 +11,8 @@ endif()
 
 option(IMATH_HALF_USE_LOOKUP_TABLE "Convert half-to-float using a lookup table (on by default)" ON)
 
+option(IMATH_HALF_USE_COMPACT_LOOKUP_TABLE "Convert half-to-float using compact lookup tables of about 8 KiB instead of the 256 KiB table" OFF)
+
 option(IMATH_USE_DEFAULT_VISIBILITY "Makes the compile use default visibility (by default compiles tidy, hidden-by-default)"     OFF)
 
 # This is primarily for the halfFunction code that enables a stack
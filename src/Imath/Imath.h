@@ -1,11 +1,15 @@
 #ifndef __IMATH_H__
 #define __IMATH_H__
 
+#include <ImathBatchMath.h>
 #include <ImathBox.h>
 #include <ImathBoxAlgo.h>
+#include <ImathBoxBatch.h>
+#include <ImathBvh.h>
 #include <ImathColor.h>
 #include <ImathColorAlgo.h>
 #include <ImathConfig.h>
+#include <ImathDualQuat.h>
 #include <ImathEuler.h>
 #include <ImathExport.h>
 #include <ImathForward.h>
@@ -22,10 +26,13 @@
 #include <ImathMath.h>
 #include <ImathMatrix.h>
 #include <ImathMatrixAlgo.h>
+#include <ImathMatrixBatch.h>
 #include <ImathNamespace.h>
+#include <ImathParallel.h>
 #include <ImathPlane.h>
 #include <ImathPlatform.h>
 #include <ImathQuat.h>
+#include <ImathQuatArray.h>
 #include <ImathRandom.h>
 #include <ImathRoots.h>
 #include <ImathShear.h>
@@ -33,6 +40,7 @@
 #include <ImathTypeTraits.h>
 #include <ImathVec.h>
 #include <ImathVecAlgo.h>
+#include <ImathVecArray.h>
 #include <half.h>
 #include <halfFunction.h>
 #include <halfLimits.h>
@@ -0,0 +1,1117 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+//
+// Sine and cosine, arc cosine, arc tangent, exponential and logarithm
+// of many float or double values at once.
+//
+// Compilers do not vectorize calls to the std:: math functions, so
+// loops that need many of them, such as conversions of Euler angles,
+// pay for one library call per value. The functions here evaluate
+// polynomial approximations, after a range reduction that needs no
+// branches, in loops that the compiler vectorizes. Arguments outside
+// the range the reduction handles exactly, such as infinities, NaNs,
+// very large angles or values whose result would be denormalized, are
+// passed to the std:: functions afterwards.
+//
+// On x86, the float loops vectorize with SSE2. The double loops select
+// with 64-bit masks, which compilers vectorize only for SSE4.2 or AVX
+// (for instance with -mavx2); otherwise they run branch-free, one value
+// at a time.
+//
+// Two accuracies are available:
+//
+// - BatchMathPrecise: the error is at most about 1 ulp. The float
+//   functions are evaluated in double precision and rounded.
+//
+// - BatchMathFast: the error is at most about 3 ulp. The float
+//   functions are evaluated in single precision, with twice as many
+//   values per vector instruction, and the double functions use
+//   shorter polynomials and skip the extra-precise final additions.
+//
+
+#ifndef INCLUDED_IMATHBATCHMATH_H
+#define INCLUDED_IMATHBATCHMATH_H
+
+#include "ImathExport.h"
+#include "ImathNamespace.h"
+
+#include "ImathPlatform.h"
+#include "ImathVecArray.h"
+
+#include <cmath>
+#include <limits>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
+
+///
+/// The accuracy of the batched math functions
+///
+
+enum IMATH_EXPORT_ENUM BatchMathAccuracy
+{
+    /// Error of at most about 1 ulp
+    BatchMathPrecise,
+
+    /// Error of at most about 3 ulp, in less time
+    BatchMathFast
+};
+
+/// @cond Doxygen_Suppress
+
+namespace BatchMathDetail
+{
+
+//
+// Number of values the public functions process per block. The
+// arguments of a block are copied to the stack, so that the results
+// may overwrite them.
+//
+
+const size_t blockSize = 256;
+
+//
+// The bits of a float or a double, as an unsigned integer of the same
+// size. Integer operations on these vectorize like the floating-point
+// operations on the values.
+//
+
+template <class T> struct Bits;
+
+template <> struct Bits<float>
+{
+    typedef uint32_t Type;
+
+    static const int mantissa = 23;
+    static const int bias     = 127;
+};
+
+template <> struct Bits<double>
+{
+    typedef uint64_t Type;
+
+    static const int mantissa = 52;
+    static const int bias     = 1023;
+};
+
+template <class T>
+inline typename Bits<T>::Type
+toBits (T x) IMATH_NOEXCEPT
+{
+    typename Bits<T>::Type u;
+    memcpy (&u, &x, sizeof (x));
+    return u;
+}
+
+template <class T>
+inline T
+fromBits (typename Bits<T>::Type u) IMATH_NOEXCEPT
+{
+    T x;
+    memcpy (&x, &u, sizeof (x));
+    return x;
+}
+
+//
+// Return m ? a : b, selecting with bit masks so that the loops stay
+// branch-free.
+//
+
+template <class T>
+inline T
+select (bool m, T a, T b) IMATH_NOEXCEPT
+{
+    typedef typename Bits<T>::Type U;
+
+    const U mask = U (0) - U (m);
+    return fromBits<T> ((toBits (a) & mask) | (toBits (b) & ~mask));
+}
+
+//
+// The high half of the significand of x, whose products with other
+// high or low halves are exact.
+//
+
+template <class T>
+inline T
+highHalf (T x) IMATH_NOEXCEPT
+{
+    typedef typename Bits<T>::Type U;
+
+    const U lowHalf = (U (1) << (Bits<T>::mantissa / 2 + 1)) - 1;
+    return fromBits<T> (toBits (x) & ~lowHalf);
+}
+
+//
+// The rounding errors of s = a + b and p = a * b, so that a + b is
+// exactly s + sumError (a, b, s), and a * b is almost exactly
+// p + productError (a, b, p).
+//
+
+template <class T>
+inline T
+sumError (T a, T b, T s) IMATH_NOEXCEPT
+{
+    const T bb = s - a;
+    return (a - (s - bb)) + (b - bb);
+}
+
+template <class T>
+inline T
+productError (T a, T b, T p) IMATH_NOEXCEPT
+{
+    const T ah = highHalf (a);
+    const T bh = highHalf (b);
+    const T al = a - ah;
+    const T bl = b - bh;
+
+    return (((ah * bh - p) + ah * bl) + al * bh) + al * bl;
+}
+
+//
+// Constants of the range reductions. pio2a + pio2b + pio2c + pio2d is
+// pi/2, split as in fdlibm so that multiplying the first three parts by
+// the quadrant numbers below reductionLimit is exact, and the reduced
+// argument stays accurate close to multiples of pi/2. ln2hi + ln2lo is
+// log(2), split in the same way for the exponents of finite results.
+// Adding and subtracting rounding rounds a value to an integer, which
+// is left in the low bits of the sum. The hi and lo parts of pi, pi/2,
+// pi/4 and 3pi/4 are the nearest values and the remainders.
+//
+
+template <class T> struct Constants;
+
+template <> struct Constants<float>
+{
+    static constexpr float rounding = 12582912.0f;
+
+    static constexpr float pio2a          = 1.5703125f;
+    static constexpr float pio2b          = 4.8375129700e-04f;
+    static constexpr float pio2c          = 7.5495336205e-08f;
+    static constexpr float pio2d          = 2.5633440683e-12f;
+    static constexpr float reductionLimit = 8192.0f;
+
+    static constexpr float log2e = 1.44269504088896341f;
+    static constexpr float ln2hi = 6.9313812256e-01f;
+    static constexpr float ln2lo = 9.0580006145e-06f;
+
+    // exp() of arguments in this range is a normalized float
+    static constexpr float expLow  = -87.0f;
+    static constexpr float expHigh = 88.0f;
+
+    static constexpr float pihi   = 3.1415927410e+00f;
+    static constexpr float pilo   = -8.7422776573e-08f;
+    static constexpr float pio2hi = 1.5707963705e+00f;
+    static constexpr float pio2lo = -4.3711388287e-08f;
+    static constexpr float pio4hi = 7.8539818525e-01f;
+    static constexpr float pio4lo = -2.1855694143e-08f;
+
+    static constexpr float threePio4hi = 2.3561944962e+00f;
+    static constexpr float threePio4lo = -5.9624402274e-09f;
+
+    static constexpr float tanPio8 = 0.41421356237309504880f;
+
+    static const uint32_t sqrtHalfBits = 0x3f3504f3;
+};
+
+template <> struct Constants<double>
+{
+    static constexpr double rounding = 6755399441055744.0;
+
+    static constexpr double pio2a          = 1.57079632673412561417e+00;
+    static constexpr double pio2b          = 6.07710050630396597660e-11;
+    static constexpr double pio2c          = 2.02226624871116645580e-21;
+    static constexpr double pio2d          = 8.47842766036889956997e-32;
+    static constexpr double reductionLimit = 1048576.0;
+
+    static constexpr double log2e = 1.44269504088896338700e+00;
+    static constexpr double ln2hi = 6.93147180369123816490e-01;
+    static constexpr double ln2lo = 1.90821492927058770002e-10;
+
+    static constexpr double expLow  = -708.0;
+    static constexpr double expHigh = 709.0;
+
+    static constexpr double pihi   = 3.14159265358979311600e+00;
+    static constexpr double pilo   = 1.22464679914735317720e-16;
+    static constexpr double pio2hi = 1.57079632679489655800e+00;
+    static constexpr double pio2lo = 6.12323399573676603587e-17;
+    static constexpr double pio4hi = 7.85398163397448278999e-01;
+    static constexpr double pio4lo = 3.06161699786838301793e-17;
+
+    static constexpr double threePio4hi = 2.35619449019234483700e+00;
+    static constexpr double threePio4lo = 9.18485099360514843751e-17;
+
+    static constexpr double tanPio8 = 0.41421356237309504880;
+
+    static const uint64_t sqrtHalfBits = 0x3fe6a09e667f3bcdull;
+};
+
+//
+// The polynomial parts of the approximations, with z = x * x where
+// the function is odd or even:
+//
+//   sin (x)   = x + x * z * sin (z)           |x| <= pi/4
+//   cos (x)   = 1 - z / 2 + z * z * cos (z)   |x| <= pi/4
+//   atan (x)  = x + x * z * atan (z)          |x| <= tan (pi/8)
+//   asin (x)  = x + x * z * asin (z)          |x| <= 1/2
+//   exp (x)   = 1 + x + x * x * exp (x)       |x| <= log (2) / 2
+//   log (m)   = f - f*f/2 + s * (f*f/2 + z * log (z)),
+//               f = m - 1, s = f / (2 + f), z = s * s,
+//                                             sqrt (1/2) <= m < sqrt (2)
+//
+// The single precision coefficients are those of the Cephes library
+// and, for log(), of musl; the double precision sine, cosine and
+// logarithm those of Cephes and fdlibm. The others are Chebyshev
+// approximations, of lower degree for BatchMathFast.
+//
+
+template <class T, BatchMathAccuracy A> struct Poly;
+
+template <> struct Poly<float, BatchMathFast>
+{
+    static float sin (float z) IMATH_NOEXCEPT
+    {
+        return (-1.9515295891e-4f * z + 8.3321608736e-3f) * z -
+               1.6666654611e-1f;
+    }
+
+    static float cos (float z) IMATH_NOEXCEPT
+    {
+        return (2.443315711809948e-5f * z - 1.388731625493765e-3f) * z +
+               4.166664568298827e-2f;
+    }
+
+    static float atan (float z) IMATH_NOEXCEPT
+    {
+        return ((8.05374449538e-2f * z - 1.38776856032e-1f) * z +
+                1.99777106478e-1f) *
+                   z -
+               3.33329491539e-1f;
+    }
+
+    static float asin (float z) IMATH_NOEXCEPT
+    {
+        return (((4.2163199048e-2f * z + 2.4181311049e-2f) * z +
+                 4.5470025998e-2f) *
+                    z +
+                7.4953002686e-2f) *
+                   z +
+               1.6666752422e-1f;
+    }
+
+    static float exp (float x) IMATH_NOEXCEPT
+    {
+        return ((((1.9875691500e-4f * x + 1.3981999507e-3f) * x +
+                  8.3334519073e-3f) *
+                     x +
+                 4.1665795894e-2f) *
+                    x +
+                1.6666665459e-1f) *
+                   x +
+               5.0000001201e-1f;
+    }
+
+    static float log (float z) IMATH_NOEXCEPT
+    {
+        return ((2.4279078841e-1f * z + 2.8498786688e-1f) * z +
+                4.0000972152e-1f) *
+                   z +
+               6.6666662693e-1f;
+    }
+};
+
+template <> struct Poly<double, BatchMathFast>
+{
+    static double sin (double z) IMATH_NOEXCEPT
+    {
+        return ((((1.58962301576546568060e-10 * z -
+                   2.50507477628578072866e-8) *
+                      z +
+                  2.75573136213857245213e-6) *
+                     z -
+                 1.98412698295895385996e-4) *
+                    z +
+                8.33333333332211858878e-3) *
+                   z -
+               1.66666666666666307295e-1;
+    }
+
+    static double cos (double z) IMATH_NOEXCEPT
+    {
+        return ((((-1.13585365213876817300e-11 * z +
+                   2.08757008419747316778e-9) *
+                      z -
+                  2.75573141792967388112e-7) *
+                     z +
+                 2.48015872888517045348e-5) *
+                    z -
+                1.38888888888730564116e-3) *
+                   z +
+               4.16666666666665929218e-2;
+    }
+
+    static double atan (double z) IMATH_NOEXCEPT
+    {
+        return ((((((((2.27506825228358314228e-02 * z -
+                       4.48334706151788942030e-02) *
+                          z +
+                      5.73633632350842026515e-02) *
+                         z -
+                     6.64961444686350544586e-02) *
+                        z +
+                    7.69105523778293581616e-02) *
+                       z -
+                   9.09085256211009384852e-02) *
+                      z +
+                  1.11111096367065037560e-01) *
+                     z -
+                 1.42857142660996139227e-01) *
+                    z +
+                1.99999999998984268057e-01) *
+                   z -
+               3.33333333333332482162e-01;
+    }
+
+    static double asin (double z) IMATH_NOEXCEPT
+    {
+        return ((((((((((2.81691327691078186035e-02 * z -
+                         1.07489371051390971562e-02) *
+                            z +
+                        1.60354528634343296289e-02) *
+                           z +
+                       7.80296666804739923878e-03) *
+                          z +
+                      1.18754919346126062291e-02) *
+                         z +
+                     1.39296530062296142205e-02) *
+                        z +
+                    1.73552599736802974639e-02) *
+                       z +
+                   2.23720476289100030087e-02) *
+                      z +
+                  3.03819473672541223719e-02) *
+                     z +
+                 4.46428571034204191292e-02) *
+                    z +
+                7.50000000002076505634e-02) *
+                   z +
+               1.66666666666666490881e-01;
+    }
+
+    static double exp (double x) IMATH_NOEXCEPT
+    {
+        return ((((((((2.50996340436633925860e-08 * x +
+                        2.76200866180165459405e-07) *
+                           x +
+                       2.75572705075700500452e-06) *
+                          x +
+                      2.48015212964462142123e-05) *
+                         x +
+                     1.98412698611851714883e-04) *
+                        x +
+                    1.38888889172164163750e-03) *
+                       x +
+                   8.33333333333069643800e-03) *
+                      x +
+                  4.16666666666241150563e-02) *
+                     x +
+                 1.66666666666666657415e-01) *
+                    x +
+               5.00000000000000111022e-01;
+    }
+
+    static double log (double z) IMATH_NOEXCEPT
+    {
+        return (((((1.479819860511658591e-01 * z + 1.531383769920937332e-01) *
+                       z +
+                   1.818357216161805012e-01) *
+                      z +
+                  2.222219843214978396e-01) *
+                     z +
+                 2.857142874366239149e-01) *
+                    z +
+                3.999999999940941908e-01) *
+                   z +
+               6.666666666666735130e-01;
+    }
+};
+
+template <> struct Poly<double, BatchMathPrecise> : Poly<double, BatchMathFast>
+{
+    static double atan (double z) IMATH_NOEXCEPT
+    {
+        return (((((((((-1.91774911921643483048e-02 * z +
+                        3.92321484562494632309e-02) *
+                           z -
+                       5.08546660499063010730e-02) *
+                          z +
+                      5.85815212491877929102e-02) *
+                         z -
+                     6.66451181809334380901e-02) *
+                        z +
+                    7.69218321751712896805e-02) *
+                       z -
+                   9.09090457931011758363e-02) *
+                      z +
+                  1.11111110152870756762e-01) *
+                     z -
+                 1.42857142846669449288e-01) *
+                    z +
+                1.99999999999955213603e-01) *
+                   z -
+               3.33333333333333314830e-01;
+    }
+
+    static double asin (double z) IMATH_NOEXCEPT
+    {
+        return (((((((((((2.87422033456655665051e-02 * z -
+                          1.48280400496262777105e-02) *
+                             z +
+                         1.73849469194045438969e-02) *
+                            z +
+                        5.46363691011300493805e-03) *
+                           z +
+                       1.03213139361916818315e-02) *
+                          z +
+                      1.14794209615725912449e-02) *
+                         z +
+                     1.39711864543677136141e-02) *
+                        z +
+                    1.73523946373410793698e-02) *
+                       z +
+                   2.23721728532134088441e-02) *
+                      z +
+                  3.03819441410201548925e-02) *
+                     z +
+                 4.46428571463180073886e-02) *
+                    z +
+                7.49999999999845651244e-02) *
+                   z +
+               1.66666666666666685170e-01;
+    }
+
+    static double exp (double x) IMATH_NOEXCEPT
+    {
+        return (((((((((2.09171580274092354582e-09 * x +
+                         2.51052707923815101612e-08) *
+                            x +
+                        2.75572683589732094979e-07) *
+                           x +
+                       2.75572551991483080566e-06) *
+                          x +
+                      2.48015873275770404912e-05) *
+                         x +
+                     1.98412698750840931069e-04) *
+                        x +
+                    1.38888888888856042864e-03) *
+                       x +
+                   8.33333333332599707211e-03) *
+                      x +
+                  4.16666666666666574148e-02) *
+                     x +
+                 1.66666666666666712926e-01) *
+                    x +
+               5.0e-01;
+    }
+};
+
+//
+// The kernels, for n values. The precise variants add the low parts of
+// the constants separately, as fdlibm does.
+//
+
+template <class T, BatchMathAccuracy A>
+inline void
+sincos (
+    const T* IMATH_RESTRICT x,
+    T* IMATH_RESTRICT       s,
+    T* IMATH_RESTRICT       c,
+    size_t                  n) IMATH_NOEXCEPT
+{
+    typedef Constants<T>                K;
+    typedef Poly<T, A>                  P;
+    typedef typename Bits<T>::Type      U;
+    const int                           signShift = int (sizeof (T) * 8 - 1);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        // x = q * pi/2 + r, with |r| <= pi/4
+        const T v = x[i] * T (2 / M_PI) + K::rounding;
+        const T q = v - K::rounding;
+        T r, e;
+
+        if (A == BatchMathPrecise)
+        {
+            // Keep the rounding error of the reduction in e, so that
+            // the reduced argument is r + e.
+            const T t  = x[i] - q * K::pio2a;
+            const T b  = -q * K::pio2b;
+            const T r1 = t + b;
+            const T lo =
+                sumError (t, b, r1) - q * K::pio2c - q * K::pio2d;
+            r = r1 + lo;
+            e = (r1 - r) + lo;
+        }
+        else
+        {
+            r = (((x[i] - q * K::pio2a) - q * K::pio2b) - q * K::pio2c) -
+                q * K::pio2d;
+            e = 0;
+        }
+
+        const T z = r * r;
+        const T h = T (0.5) * z;
+        const T w = T (1) - h;
+
+        // sin (-0) is -0, and r is x whenever z is 0
+        const T sr = select (
+            z == 0,
+            x[i],
+            A == BatchMathPrecise ? r + ((e - h * e) + r * z * P::sin (z))
+                                  : r + r * z * P::sin (z));
+        const T cr = A == BatchMathPrecise
+                         ? w + (((T (1) - w) - h) +
+                                (z * z * P::cos (z) - r * e))
+                         : w + z * z * P::cos (z);
+
+        // Swap sine and cosine in odd quadrants, and negate the sine in
+        // quadrants 2 and 3 and the cosine in quadrants 1 and 2.
+        const U quadrant = toBits (v);
+        const U swap     = U (0) - (quadrant & 1);
+        const U us       = toBits (sr);
+        const U uc       = toBits (cr);
+
+        s[i] = fromBits<T> (
+            ((us & ~swap) | (uc & swap)) ^
+            ((quadrant & 2) << (signShift - 1)));
+        c[i] = fromBits<T> (
+            ((uc & ~swap) | (us & swap)) ^
+            (((quadrant + 1) & 2) << (signShift - 1)));
+    }
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (!(std::abs (x[i]) <= K::reductionLimit))
+        {
+            s[i] = std::sin (x[i]);
+            c[i] = std::cos (x[i]);
+        }
+    }
+}
+
+template <class T, BatchMathAccuracy A>
+inline void
+acos (const T* IMATH_RESTRICT x, T* IMATH_RESTRICT a, size_t n)
+    IMATH_NOEXCEPT
+{
+    typedef Constants<T> K;
+    typedef Poly<T, A>   P;
+
+    //
+    // acos (x) = pi/2 - asin (x)                    |x| <= 1/2
+    //          = 2 asin (sqrt ((1 - x) / 2))        x > 1/2
+    //          = pi - 2 asin (sqrt ((1 + x) / 2))   x < -1/2
+    //
+
+    T u[blockSize];
+
+    for (size_t i = 0; i < n; ++i)
+        u[i] = (T (1) - std::abs (x[i])) * T (0.5);
+
+    VecArrayDetail::sqrt (u, n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const T    ax  = std::abs (x[i]);
+        const bool big = ax > T (0.5);
+        const T    z   = select (big, (T (1) - ax) * T (0.5), ax * ax);
+        const T    v   = select (big, u[i], ax);
+        T          as  = v + v * z * P::asin (z);
+
+        if (A == BatchMathPrecise)
+        {
+            // As in fdlibm, split the square root into a high part d
+            // whose square is exact and a correction c, to keep the
+            // rounding error of sqrt() out of the result for x > 1/2.
+            const T d = highHalf (v);
+            const T c = select (v == 0, T (0), (z - d * d) / (v + d));
+            as        = select (big, d + (v * z * P::asin (z) + c), as);
+        }
+
+        const T small = A == BatchMathPrecise
+                            ? K::pio2hi - (std::copysign (as, x[i]) - K::pio2lo)
+                            : K::pio2hi - std::copysign (as, x[i]);
+        const T negative = A == BatchMathPrecise
+                               ? K::pihi - (T (2) * as - K::pilo)
+                               : K::pihi - T (2) * as;
+
+        a[i] = select (big, select (x[i] < 0, negative, T (2) * as), small);
+    }
+}
+
+template <class T, BatchMathAccuracy A>
+inline void
+atan2 (
+    const T* IMATH_RESTRICT y,
+    const T* IMATH_RESTRICT x,
+    T* IMATH_RESTRICT       a,
+    size_t                  n) IMATH_NOEXCEPT
+{
+    typedef Constants<T> K;
+    typedef Poly<T, A>   P;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const T ax = std::abs (x[i]);
+        const T ay = std::abs (y[i]);
+
+        //
+        // atan (t), t = min / max in [0, 1], reduced to |u| <= tan(pi/8)
+        // with atan (t) = pi/4 + atan (u), u = (t - 1) / (t + 1)
+        //
+
+        const bool swap = ay > ax;
+        const T    num  = select (swap, ax, ay);
+        const T    den  = select (swap, ay, ax);
+        const bool big  = num > K::tanPio8 * den;
+        const T    p    = select (big, num - den, num);
+        const T    d    = select (den != 0, den, T (1));
+        const T    q    = select (big, num + den, d);
+        const T    u    = p / q;
+        const T    z    = u * u;
+
+        //
+        // atan (u) = u + c. The result is k * pi/4 +- (u + c), with k
+        // = 0 to 4 from the reduction, the swap and the sign of x.
+        //
+
+        T c;
+
+        if (A == BatchMathPrecise)
+        {
+            // The quotient is u + du, with the rounding errors of p, q
+            // and u in du, which is NaN if an argument is infinite.
+            const T ep = select (big, sumError (num, -den, p), T (0));
+            const T eq = select (big, sumError (num, den, q), T (0));
+            const T uq = u * q;
+            const T du =
+                (((p - uq) - productError (u, q, uq)) + ep - u * eq) / q;
+
+            c = select (du - du == 0, du, T (0)) * (T (1) - z) +
+                u * z * P::atan (z);
+        }
+        else
+            c = u * z * P::atan (z);
+
+        const bool negative = std::copysign (T (1), x[i]) < 0;
+
+        T k = select (big, T (1), T (0));
+        k   = select (swap, T (2) - k, k);
+        k   = select (negative, T (4) - k, k);
+
+        const T hi = select (
+            k == 1,
+            K::pio4hi,
+            select (
+                k == 2,
+                K::pio2hi,
+                select (
+                    k == 3,
+                    K::threePio4hi,
+                    select (k == 4, K::pihi, T (0)))));
+        const T lo = select (
+            k == 1,
+            K::pio4lo,
+            select (
+                k == 2,
+                K::pio2lo,
+                select (
+                    k == 3,
+                    K::threePio4lo,
+                    select (k == 4, K::pilo, T (0)))));
+
+        const bool flip = swap != negative;
+        const T    su   = select (flip, -u, u);
+        const T    sc   = select (flip, -c, c);
+        const T    t    = hi + su;
+        const T    r    = A == BatchMathPrecise
+                              ? t + ((sumError (hi, su, t) + sc) + lo)
+                              : t + sc;
+
+        a[i] = std::copysign (r, y[i]);
+    }
+
+    for (size_t i = 0; i < n; ++i)
+        if (std::isinf (x[i]) && std::isinf (y[i]))
+            a[i] = std::atan2 (y[i], x[i]);
+}
+
+template <class T, BatchMathAccuracy A>
+inline void
+exp (const T* IMATH_RESTRICT x, T* IMATH_RESTRICT e, size_t n)
+    IMATH_NOEXCEPT
+{
+    typedef Constants<T>           K;
+    typedef Poly<T, A>             P;
+    typedef typename Bits<T>::Type U;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        // x = k * log(2) + r, with |r| <= log(2) / 2
+        const T v = x[i] * K::log2e + K::rounding;
+        const T k = v - K::rounding;
+        const T r = (x[i] - k * K::ln2hi) - k * K::ln2lo;
+
+        // 2^k, from the integer k in the low bits of v
+        const U scale = (toBits (v) - toBits (K::rounding) + U (Bits<T>::bias))
+                        << Bits<T>::mantissa;
+
+        e[i] = (T (1) + (r + r * r * P::exp (r))) * fromBits<T> (scale);
+    }
+
+    for (size_t i = 0; i < n; ++i)
+        if (!(x[i] >= K::expLow && x[i] <= K::expHigh)) e[i] = std::exp (x[i]);
+}
+
+template <class T, BatchMathAccuracy A>
+inline void
+log (const T* IMATH_RESTRICT x, T* IMATH_RESTRICT l, size_t n)
+    IMATH_NOEXCEPT
+{
+    typedef Constants<T>           K;
+    typedef Poly<T, A>             P;
+    typedef typename Bits<T>::Type U;
+
+    const int M       = Bits<T>::mantissa;
+    const U   mask    = (U (1) << M) - 1;
+    const U   offset  = toBits (T (1)) - K::sqrtHalfBits;
+    const U   twoPowM = U (Bits<T>::bias + M) << M;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        //
+        // x = 2^k * m, with sqrt(1/2) <= m < sqrt(2). Adding offset to
+        // the bits of x carries into the exponent exactly when the
+        // mantissa is at least sqrt(2).
+        //
+
+        const U u = toBits (x[i]) + offset;
+        const T k = fromBits<T> ((u >> M) | twoPowM) -
+                    (T (U (1) << M) + T (Bits<T>::bias));
+        const T m = fromBits<T> ((u & mask) + K::sqrtHalfBits);
+
+        const T f    = m - T (1);
+        const T s    = f / (T (2) + f);
+        const T z    = s * s;
+        const T h    = T (0.5) * f * f;
+        const T poly = s * (h + z * P::log (z));
+
+        l[i] = A == BatchMathPrecise
+                   ? k * K::ln2hi - ((h - (poly + k * K::ln2lo)) - f)
+                   : k * K::ln2hi + (k * K::ln2lo + (f - (h - poly)));
+    }
+
+    for (size_t i = 0; i < n; ++i)
+        if (!(x[i] >= std::numeric_limits<T>::min () &&
+              x[i] <= std::numeric_limits<T>::max ()))
+            l[i] = std::log (x[i]);
+}
+
+//
+// The kernels for each type and accuracy. In single precision, the
+// precise functions are evaluated with the fast double precision
+// kernels and rounded.
+//
+
+template <class T, BatchMathAccuracy A> struct Kernels
+{
+    static void sincos (const T* x, T* s, T* c, size_t n) IMATH_NOEXCEPT
+    {
+        BatchMathDetail::sincos<T, A> (x, s, c, n);
+    }
+
+    static void acos (const T* x, T* a, size_t n) IMATH_NOEXCEPT
+    {
+        BatchMathDetail::acos<T, A> (x, a, n);
+    }
+
+    static void atan2 (const T* y, const T* x, T* a, size_t n) IMATH_NOEXCEPT
+    {
+        BatchMathDetail::atan2<T, A> (y, x, a, n);
+    }
+
+    static void exp (const T* x, T* e, size_t n) IMATH_NOEXCEPT
+    {
+        BatchMathDetail::exp<T, A> (x, e, n);
+    }
+
+    static void log (const T* x, T* l, size_t n) IMATH_NOEXCEPT
+    {
+        BatchMathDetail::log<T, A> (x, l, n);
+    }
+};
+
+inline void
+widen (const float* IMATH_RESTRICT x, double* IMATH_RESTRICT d, size_t n)
+    IMATH_NOEXCEPT
+{
+    for (size_t i = 0; i < n; ++i)
+        d[i] = x[i];
+}
+
+inline void
+narrow (const double* IMATH_RESTRICT d, float* IMATH_RESTRICT x, size_t n)
+    IMATH_NOEXCEPT
+{
+    for (size_t i = 0; i < n; ++i)
+        x[i] = float (d[i]);
+}
+
+template <> struct Kernels<float, BatchMathPrecise>
+{
+    typedef Kernels<double, BatchMathFast> D;
+
+    static void
+    sincos (const float* x, float* s, float* c, size_t n) IMATH_NOEXCEPT
+    {
+        double xd[blockSize], sd[blockSize], cd[blockSize];
+        widen (x, xd, n);
+        D::sincos (xd, sd, cd, n);
+        narrow (sd, s, n);
+        narrow (cd, c, n);
+    }
+
+    static void acos (const float* x, float* a, size_t n) IMATH_NOEXCEPT
+    {
+        double xd[blockSize], ad[blockSize];
+        widen (x, xd, n);
+        D::acos (xd, ad, n);
+        narrow (ad, a, n);
+    }
+
+    static void
+    atan2 (const float* y, const float* x, float* a, size_t n) IMATH_NOEXCEPT
+    {
+        double yd[blockSize], xd[blockSize], ad[blockSize];
+        widen (y, yd, n);
+        widen (x, xd, n);
+        D::atan2 (yd, xd, ad, n);
+        narrow (ad, a, n);
+    }
+
+    static void exp (const float* x, float* e, size_t n) IMATH_NOEXCEPT
+    {
+        double xd[blockSize], ed[blockSize];
+        widen (x, xd, n);
+        D::exp (xd, ed, n);
+        narrow (ed, e, n);
+    }
+
+    static void log (const float* x, float* l, size_t n) IMATH_NOEXCEPT
+    {
+        double xd[blockSize], ld[blockSize];
+        widen (x, xd, n);
+        D::log (xd, ld, n);
+        narrow (ld, l, n);
+    }
+};
+
+//
+// Apply a kernel to the values [0, n) block by block.
+//
+
+template <class T, void (*F) (const T*, T*, size_t)>
+inline void
+apply (const T* x, T* r, size_t n) IMATH_NOEXCEPT
+{
+    T xb[blockSize], rb[blockSize];
+
+    for (size_t begin = 0; begin < n; begin += blockSize)
+    {
+        const size_t k = n - begin < blockSize ? n - begin : blockSize;
+
+        memcpy (xb, x + begin, k * sizeof (T));
+        F (xb, rb, k);
+        memcpy (r + begin, rb, k * sizeof (T));
+    }
+}
+
+template <class T, BatchMathAccuracy A>
+inline void
+sincosBlocks (const T* x, T* s, T* c, size_t n) IMATH_NOEXCEPT
+{
+    T xb[blockSize], sb[blockSize], cb[blockSize];
+
+    for (size_t begin = 0; begin < n; begin += blockSize)
+    {
+        const size_t k = n - begin < blockSize ? n - begin : blockSize;
+
+        memcpy (xb, x + begin, k * sizeof (T));
+        Kernels<T, A>::sincos (xb, sb, cb, k);
+        memcpy (s + begin, sb, k * sizeof (T));
+        memcpy (c + begin, cb, k * sizeof (T));
+    }
+}
+
+template <class T, BatchMathAccuracy A>
+inline void
+atan2Blocks (const T* y, const T* x, T* a, size_t n) IMATH_NOEXCEPT
+{
+    T yb[blockSize], xb[blockSize], ab[blockSize];
+
+    for (size_t begin = 0; begin < n; begin += blockSize)
+    {
+        const size_t k = n - begin < blockSize ? n - begin : blockSize;
+
+        memcpy (yb, y + begin, k * sizeof (T));
+        memcpy (xb, x + begin, k * sizeof (T));
+        Kernels<T, A>::atan2 (yb, xb, ab, k);
+        memcpy (a + begin, ab, k * sizeof (T));
+    }
+}
+
+template <class T> struct IsBatchMathType
+{
+    static const bool value = false;
+};
+
+template <> struct IsBatchMathType<float>
+{
+    static const bool value = true;
+};
+
+template <> struct IsBatchMathType<double>
+{
+    static const bool value = true;
+};
+
+} // namespace BatchMathDetail
+
+/// @endcond
+
+/// @{
+/// @name Batched math functions
+///
+/// Each function computes the std:: function of the same name for `n`
+/// float or double values. The results may be stored over the
+/// arguments.
+
+/// Compute `s[i] = sin (x[i])` and `c[i] = cos (x[i])`.
+template <class T>
+inline void
+batchSincos (
+    const T*          x,
+    T*                s,
+    T*                c,
+    size_t            n,
+    BatchMathAccuracy accuracy = BatchMathPrecise) IMATH_NOEXCEPT
+{
+    static_assert (
+        BatchMathDetail::IsBatchMathType<T>::value,
+        "batchSincos requires float or double");
+
+    if (accuracy == BatchMathFast)
+        BatchMathDetail::sincosBlocks<T, BatchMathFast> (x, s, c, n);
+    else
+        BatchMathDetail::sincosBlocks<T, BatchMathPrecise> (x, s, c, n);
+}
+
+/// Compute `a[i] = acos (x[i])`.
+template <class T>
+inline void
+batchAcos (
+    const T*          x,
+    T*                a,
+    size_t            n,
+    BatchMathAccuracy accuracy = BatchMathPrecise) IMATH_NOEXCEPT
+{
+    static_assert (
+        BatchMathDetail::IsBatchMathType<T>::value,
+        "batchAcos requires float or double");
+
+    if (accuracy == BatchMathFast)
+        BatchMathDetail::apply<
+            T,
+            BatchMathDetail::Kernels<T, BatchMathFast>::acos> (x, a, n);
+    else
+        BatchMathDetail::apply<
+            T,
+            BatchMathDetail::Kernels<T, BatchMathPrecise>::acos> (x, a, n);
+}
+
+/// Compute `a[i] = atan2 (y[i], x[i])`.
+template <class T>
+inline void
+batchAtan2 (
+    const T*          y,
+    const T*          x,
+    T*                a,
+    size_t            n,
+    BatchMathAccuracy accuracy = BatchMathPrecise) IMATH_NOEXCEPT
+{
+    static_assert (
+        BatchMathDetail::IsBatchMathType<T>::value,
+        "batchAtan2 requires float or double");
+
+    if (accuracy == BatchMathFast)
+        BatchMathDetail::atan2Blocks<T, BatchMathFast> (y, x, a, n);
+    else
+        BatchMathDetail::atan2Blocks<T, BatchMathPrecise> (y, x, a, n);
+}
+
+/// Compute `e[i] = exp (x[i])`.
+template <class T>
+inline void
+batchExp (
+    const T*          x,
+    T*                e,
+    size_t            n,
+    BatchMathAccuracy accuracy = BatchMathPrecise) IMATH_NOEXCEPT
+{
+    static_assert (
+        BatchMathDetail::IsBatchMathType<T>::value,
+        "batchExp requires float or double");
+
+    if (accuracy == BatchMathFast)
+        BatchMathDetail::apply<
+            T,
+            BatchMathDetail::Kernels<T, BatchMathFast>::exp> (x, e, n);
+    else
+        BatchMathDetail::apply<
+            T,
+            BatchMathDetail::Kernels<T, BatchMathPrecise>::exp> (x, e, n);
+}
+
+/// Compute `l[i] = log (x[i])`.
+template <class T>
+inline void
+batchLog (
+    const T*          x,
+    T*                l,
+    size_t            n,
+    BatchMathAccuracy accuracy = BatchMathPrecise) IMATH_NOEXCEPT
+{
+    static_assert (
+        BatchMathDetail::IsBatchMathType<T>::value,
+        "batchLog requires float or double");
+
+    if (accuracy == BatchMathFast)
+        BatchMathDetail::apply<
+            T,
+            BatchMathDetail::Kernels<T, BatchMathFast>::log> (x, l, n);
+    else
+        BatchMathDetail::apply<
+            T,
+            BatchMathDetail::Kernels<T, BatchMathPrecise>::log> (x, l, n);
+}
+
+/// @}
+
+IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif // INCLUDED_IMATHBATCHMATH_H
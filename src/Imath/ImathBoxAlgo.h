@@ -17,6 +17,8 @@
 #include "ImathMatrix.h"
 #include "ImathPlane.h"
 
+#include <limits>
+
 IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
 
 ///
@@ -896,6 +898,126 @@ intersects (const Box<Vec3<T>>& box, const Line3<T>& ray) IMATH_NOEXCEPT
     return intersects (box, ray, ignored);
 }
 
+///
+/// A ray, given by its origin and the inverse of its direction, for the
+/// slab tests of intersects() below. A direction component of zero has
+/// an infinite inverse: the ray is parallel to the sides of the box
+/// that are perpendicular to that axis.
+///
+
+template <class T> struct InverseRay
+{
+    /// The origin of the ray
+    Vec3<T> pos;
+
+    /// The inverse of each component of the direction of the ray
+    Vec3<T> invDir;
+
+    /// Uninitialized by default
+    IMATH_HOSTDEVICE constexpr InverseRay () IMATH_NOEXCEPT {}
+
+    /// Initialize with the origin and the direction of a ray
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 explicit InverseRay (
+        const Line3<T>& ray) IMATH_NOEXCEPT
+        : pos (ray.pos),
+          invDir (T (1) / ray.dir.x, T (1) / ray.dir.y, T (1) / ray.dir.z)
+    {}
+};
+
+/// InverseRay of float
+typedef InverseRay<float> InverseRayf;
+
+/// InverseRay of double
+typedef InverseRay<double> InverseRayd;
+
+/// @cond Doxygen_Suppress
+
+namespace BoxAlgoDetail
+{
+
+//
+// Along one axis, the ray is between the planes of the two sides of the
+// box for t in [t0, t1], where t0 belongs to the minimum side unless the
+// direction is negative. Narrow [tNear, tFar] to that interval.
+//
+// A ray that lies in the plane of a side gives 0 * inf = NaN for that
+// side. Every comparison with NaN is false, so the NaN is ignored: the
+// ray is between the planes for every t, as in intersects() above.
+//
+// A ray parallel to the sides, and outside them, gives t0 = t1 = -inf
+// or t0 = t1 = inf. tFar starts at the largest finite value, so that
+// the ray misses in the second case too.
+//
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline void
+narrow (T t0, T t1, T& tNear, T& tFar) IMATH_NOEXCEPT
+{
+    tNear = t0 > tNear ? t0 : tNear;
+    tFar  = t1 < tFar ? t1 : tFar;
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline void
+slab (T min, T max, T pos, T inv, T& tNear, T& tFar) IMATH_NOEXCEPT
+{
+    const T t0 = ((inv < 0 ? max : min) - pos) * inv;
+    const T t1 = ((inv < 0 ? min : max) - pos) * inv;
+
+    narrow (t0, t1, tNear, tFar);
+}
+
+} // namespace BoxAlgoDetail
+
+/// @endcond
+
+///
+/// Intersect a ray, `r`, with a 3D box, `b`, with a branch-free slab
+/// test, and compute the distance along the ray to the intersection,
+/// returned in `t`. The intersection point is `pos + t * dir`, where
+/// `pos` and `dir` are those of the ray from which `r` was made, and
+/// `t` is 0 if the ray starts inside the box.
+///
+/// The results are those of intersects() above, including for rays
+/// that lie in the plane of a side of the box, up to the rounding of
+/// multiplying by the inverse of the direction rather than dividing by
+/// the direction. Direction components whose inverse overflows are
+/// treated as zero.
+///
+/// @return
+/// - true if the ray starts inside the box or if the ray starts
+///   outside and intersects it; `t` is undefined otherwise
+///
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline bool
+intersects (const Box<Vec3<T>>& b, const InverseRay<T>& r, T& t)
+    IMATH_NOEXCEPT
+{
+    T tNear = 0;
+    T tFar  = (std::numeric_limits<T>::max) ();
+
+    BoxAlgoDetail::slab (b.min.x, b.max.x, r.pos.x, r.invDir.x, tNear, tFar);
+    BoxAlgoDetail::slab (b.min.y, b.max.y, r.pos.y, r.invDir.y, tNear, tFar);
+    BoxAlgoDetail::slab (b.min.z, b.max.z, r.pos.z, r.invDir.z, tNear, tFar);
+
+    t = tNear;
+    return tNear <= tFar;
+}
+
+///
+/// Return whether the ray `r` intersects the 3D box `b`, with a
+/// branch-free slab test.
+///
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline bool
+intersects (const Box<Vec3<T>>& b, const InverseRay<T>& r) IMATH_NOEXCEPT
+{
+    T ignored = 0;
+    return intersects (b, r, ignored);
+}
+
 IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
 
 #endif // INCLUDED_IMATHBOXALGO_H
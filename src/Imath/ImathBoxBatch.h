@@ -0,0 +1,341 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+//
+// Ray-box intersection for many rays or boxes at once: a packet of
+// rays against one box, or one ray against a packet of boxes, stored
+// as Vec3Arrays, a register of rays or boxes at a time. The results
+// are those of the slab tests of ImathBoxAlgo.h.
+//
+
+#ifndef INCLUDED_IMATHBOXBATCH_H
+#define INCLUDED_IMATHBOXBATCH_H
+
+#include "ImathNamespace.h"
+
+#include "ImathBox.h"
+#include "ImathBoxAlgo.h"
+#include "ImathMatrix.h"
+#include "ImathVecArray.h"
+
+#include <limits>
+#include <stddef.h>
+#include <stdint.h>
+
+IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
+
+///
+/// Intersect `pos.size()` rays, given by their origins, `pos`, and the
+/// inverses of their directions, `invDir`, with a 3D box, `b`, with the
+/// same results as intersects() for each ray, a register of rays at a
+/// time. Set bit `i % 64` of `hits[i / 64]` if ray `i` intersects the
+/// box, and clear it otherwise. `hits` must hold `(pos.size() + 63) /
+/// 64` words; the unused bits of the last word are cleared. If `t` is
+/// not null, it must hold `pos.size()` values, and `t[i]` is set to the
+/// distance along ray `i` to the intersection, undefined for a miss.
+///
+
+template <class T>
+void intersects (
+    const Box<Vec3<T>>& b,
+    const Vec3Array<T>& pos,
+    const Vec3Array<T>& invDir,
+    uint64_t*           hits,
+    T*                  t = nullptr) IMATH_NOEXCEPT;
+
+///
+/// Intersect a ray, `r`, with `min.size()` 3D boxes, given by their
+/// minimum and maximum corners, `min` and `max`, with the same results
+/// as intersects() for each box, a register of boxes at a time. Set bit
+/// `i % 64` of `hits[i / 64]` if the ray intersects box `i`, and clear
+/// it otherwise. `hits` must hold `(min.size() + 63) / 64` words; the
+/// unused bits of the last word are cleared. If `t` is not null, it
+/// must hold `min.size()` values, and `t[i]` is set to the distance
+/// along the ray to box `i`, undefined for a miss.
+///
+
+template <class T>
+void intersects (
+    const Vec3Array<T>&  min,
+    const Vec3Array<T>&  max,
+    const InverseRay<T>& r,
+    uint64_t*            hits,
+    T*                   t = nullptr) IMATH_NOEXCEPT;
+
+/// @cond Doxygen_Suppress
+
+namespace BoxAlgoDetail
+{
+
+//
+// A packet of rays and one box, or one ray and a packet of boxes. For
+// the boxes, the ray's direction selects which sides face the ray, the
+// front sides, and which face away from it, the back sides, so that the
+// vector kernels need no selection.
+//
+
+template <class T> struct RayPacket
+{
+    T        min[3];
+    T        max[3];
+    const T* pos[3];
+    const T* inv[3];
+};
+
+template <class T> struct BoxPacket
+{
+    const T* front[3];
+    const T* back[3];
+    T        pos[3];
+    T        inv[3];
+};
+
+//
+// Return true if ray or box i is hit, and set t[i] if t is not null.
+// These perform the same arithmetic operations, in the same order, as
+// intersects() for one ray and one box.
+//
+
+template <class T>
+inline bool
+hitScalar (const RayPacket<T>& p, size_t i, T* t) IMATH_NOEXCEPT
+{
+    T tNear = 0;
+    T tFar  = (std::numeric_limits<T>::max) ();
+
+    for (int k = 0; k < 3; ++k)
+        slab (p.min[k], p.max[k], p.pos[k][i], p.inv[k][i], tNear, tFar);
+
+    if (t) t[i] = tNear;
+    return tNear <= tFar;
+}
+
+template <class T>
+inline bool
+hitScalar (const BoxPacket<T>& p, size_t i, T* t) IMATH_NOEXCEPT
+{
+    T tNear = 0;
+    T tFar  = (std::numeric_limits<T>::max) ();
+
+    for (int k = 0; k < 3; ++k)
+        narrow (
+            (p.front[k][i] - p.pos[k]) * p.inv[k],
+            (p.back[k][i] - p.pos[k]) * p.inv[k],
+            tNear,
+            tFar);
+
+    if (t) t[i] = tNear;
+    return tNear <= tFar;
+}
+
+#if defined(IMATH_MATRIX_SIMD)
+
+using MatrixDetail::bits;
+using MatrixDetail::less;
+using MatrixDetail::lessEqual;
+using MatrixDetail::load;
+using MatrixDetail::Mask;
+using MatrixDetail::maximum;
+using MatrixDetail::minimum;
+using MatrixDetail::mul;
+using MatrixDetail::select;
+using MatrixDetail::splat;
+using MatrixDetail::store;
+using MatrixDetail::sub;
+
+//
+// The register versions of hitScalar(), for the rays or boxes
+// [i, i + width), where width is the number of lanes of V. Bit j of the
+// result is set if ray or box i + j is hit.
+//
+
+template <class V, class T>
+inline unsigned
+hitVector (const RayPacket<T>& p, size_t i, T* t) IMATH_NOEXCEPT
+{
+    V tNear, tFar, zero;
+    splat (T (0), tNear);
+    splat ((std::numeric_limits<T>::max) (), tFar);
+    splat (T (0), zero);
+
+    for (int k = 0; k < 3; ++k)
+    {
+        V min, max, pos, inv;
+        splat (p.min[k], min);
+        splat (p.max[k], max);
+        load (p.pos[k] + i, pos);
+        load (p.inv[k] + i, inv);
+
+        const V a = mul (sub (min, pos), inv);
+        const V b = mul (sub (max, pos), inv);
+
+        const typename Mask<V>::Type negative = less (inv, zero);
+
+        tNear = maximum (select (negative, b, a), tNear);
+        tFar  = minimum (select (negative, a, b), tFar);
+    }
+
+    if (t) store (t + i, tNear);
+    return bits (lessEqual (tNear, tFar));
+}
+
+template <class V, class T>
+inline unsigned
+hitVector (const BoxPacket<T>& p, size_t i, T* t) IMATH_NOEXCEPT
+{
+    V tNear, tFar;
+    splat (T (0), tNear);
+    splat ((std::numeric_limits<T>::max) (), tFar);
+
+    for (int k = 0; k < 3; ++k)
+    {
+        V front, back, pos, inv;
+        load (p.front[k] + i, front);
+        load (p.back[k] + i, back);
+        splat (p.pos[k], pos);
+        splat (p.inv[k], inv);
+
+        tNear = maximum (mul (sub (front, pos), inv), tNear);
+        tFar  = minimum (mul (sub (back, pos), inv), tFar);
+    }
+
+    if (t) store (t + i, tNear);
+    return bits (lessEqual (tNear, tFar));
+}
+
+#endif
+
+//
+// Return bit j set if ray or box begin + j is hit, for j in
+// [0, end - begin), where end - begin is at most 64.
+//
+
+template <class T, class Packet>
+inline uint64_t
+hit (const Packet& p, size_t begin, size_t end, T* t) IMATH_NOEXCEPT
+{
+    uint64_t m = 0;
+
+    for (size_t i = begin; i < end; ++i)
+        m |= uint64_t (hitScalar (p, i, t)) << (i - begin);
+
+    return m;
+}
+
+#if defined(IMATH_MATRIX_SIMD)
+
+template <class V, class T, class Packet>
+inline uint64_t
+hitSimd (const Packet& p, size_t begin, size_t end, T* t) IMATH_NOEXCEPT
+{
+    const size_t width = sizeof (V) / sizeof (T);
+
+    uint64_t m = 0;
+    size_t   i = begin;
+
+    for (; i + width <= end; i += width)
+        m |= uint64_t (hitVector<V> (p, i, t)) << (i - begin);
+
+    for (; i < end; ++i)
+        m |= uint64_t (hitScalar (p, i, t)) << (i - begin);
+
+    return m;
+}
+
+template <class Packet>
+inline uint64_t
+hit (const Packet& p, size_t begin, size_t end, float* t) IMATH_NOEXCEPT
+{
+#    if defined(__AVX__)
+    return hitSimd<__m256> (p, begin, end, t);
+#    elif defined(IMATH_MATRIX_SSE2)
+    return hitSimd<__m128> (p, begin, end, t);
+#    else
+    return hitSimd<float32x4_t> (p, begin, end, t);
+#    endif
+}
+
+template <class Packet>
+inline uint64_t
+hit (const Packet& p, size_t begin, size_t end, double* t) IMATH_NOEXCEPT
+{
+#    if defined(__AVX__)
+    return hitSimd<__m256d> (p, begin, end, t);
+#    elif defined(IMATH_MATRIX_SSE2)
+    return hitSimd<__m128d> (p, begin, end, t);
+#    else
+    return hitSimd<float64x2_t> (p, begin, end, t);
+#    endif
+}
+
+#endif
+
+//
+// The hit bits of 64 rays or boxes at a time.
+//
+
+template <class T, class Packet>
+inline void
+hitBits (const Packet& p, size_t n, uint64_t* hits, T* t) IMATH_NOEXCEPT
+{
+    for (size_t begin = 0; begin < n; begin += 64)
+    {
+        const size_t end = n - begin < 64 ? n : begin + 64;
+
+        hits[begin / 64] = hit (p, begin, end, t);
+    }
+}
+
+} // namespace BoxAlgoDetail
+
+/// @endcond
+
+template <class T>
+inline void
+intersects (
+    const Box<Vec3<T>>& b,
+    const Vec3Array<T>& pos,
+    const Vec3Array<T>& invDir,
+    uint64_t*           hits,
+    T*                  t) IMATH_NOEXCEPT
+{
+    const BoxAlgoDetail::RayPacket<T> p = {
+        {b.min.x, b.min.y, b.min.z},
+        {b.max.x, b.max.y, b.max.z},
+        {pos.x (), pos.y (), pos.z ()},
+        {invDir.x (), invDir.y (), invDir.z ()}};
+
+    BoxAlgoDetail::hitBits (p, pos.size (), hits, t);
+}
+
+template <class T>
+inline void
+intersects (
+    const Vec3Array<T>&  min,
+    const Vec3Array<T>&  max,
+    const InverseRay<T>& r,
+    uint64_t*            hits,
+    T*                   t) IMATH_NOEXCEPT
+{
+    const bool negX = r.invDir.x < 0;
+    const bool negY = r.invDir.y < 0;
+    const bool negZ = r.invDir.z < 0;
+
+    const BoxAlgoDetail::BoxPacket<T> p = {
+        {negX ? max.x () : min.x (),
+         negY ? max.y () : min.y (),
+         negZ ? max.z () : min.z ()},
+        {negX ? min.x () : max.x (),
+         negY ? min.y () : max.y (),
+         negZ ? min.z () : max.z ()},
+        {r.pos.x, r.pos.y, r.pos.z},
+        {r.invDir.x, r.invDir.y, r.invDir.z}};
+
+    BoxAlgoDetail::hitBits (p, min.size (), hits, t);
+}
+
+IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif // INCLUDED_IMATHBOXBATCH_H
@@ -0,0 +1,889 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+//
+// A bounding volume hierarchy over axis-aligned boxes, with ray, box
+// overlap and closest point queries.
+//
+
+#ifndef INCLUDED_IMATHBVH_H
+#define INCLUDED_IMATHBVH_H
+
+#include "ImathExport.h"
+#include "ImathNamespace.h"
+
+#include "ImathBox.h"
+#include "ImathBoxAlgo.h"
+#include "ImathLine.h"
+#include "ImathParallel.h"
+#include "ImathVec.h"
+
+#include <algorithm>
+#include <limits>
+#include <stddef.h>
+#include <stdexcept>
+#include <stdint.h>
+#include <vector>
+
+IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
+
+/// @cond Doxygen_Suppress
+
+namespace BvhDetail
+{
+
+//
+// The number of bins of the surface area heuristic, the depth at which
+// the build stops splitting, and the size of the traversal stacks,
+// which never hold more than one node per level plus the root.
+//
+
+const int numBins   = 16;
+const int maxDepth  = 62;
+const int stackSize = maxDepth + 2;
+
+template <class T>
+inline T
+halfArea (const Box<Vec3<T>>& b) IMATH_NOEXCEPT
+{
+    if (b.isEmpty ()) return 0;
+
+    const Vec3<T> d = b.size ();
+    return d.x * d.y + d.y * d.z + d.z * d.x;
+}
+
+//
+// Box::extendBy() without branches, which the compiler turns into
+// min and max instructions.
+//
+
+template <class T>
+inline void
+extend (Box<Vec3<T>>& b, const Vec3<T>& min, const Vec3<T>& max)
+    IMATH_NOEXCEPT
+{
+    b.min.x = min.x < b.min.x ? min.x : b.min.x;
+    b.min.y = min.y < b.min.y ? min.y : b.min.y;
+    b.min.z = min.z < b.min.z ? min.z : b.min.z;
+    b.max.x = max.x > b.max.x ? max.x : b.max.x;
+    b.max.y = max.y > b.max.y ? max.y : b.max.y;
+    b.max.z = max.z > b.max.z ? max.z : b.max.z;
+}
+
+template <class T> struct Bin
+{
+    Box<Vec3<T>> bounds;
+    size_t       count;
+
+    Bin () : count (0) {}
+};
+
+//
+// A range of primitives, and the node that holds them.
+//
+
+struct Range
+{
+    uint32_t node;
+    uint32_t begin;
+    uint32_t end;
+    int      depth;
+};
+
+} // namespace BvhDetail
+
+/// @endcond
+
+///
+/// A bounding volume hierarchy (BVH) over a set of boxes, the bounds
+/// of the primitives of a scene, which finds the boxes a ray hits, the
+/// boxes that overlap a box, or the box closest to a point, without
+/// testing every box.
+///
+/// The hierarchy is built top-down, splitting the boxes of each node
+/// in two along the longest axis of their centers, at the position
+/// that minimizes the surface area heuristic, evaluated at the borders
+/// of 16 bins. Given a `ParallelBuild`, the top levels bin the boxes on
+/// several threads, and the subtrees below them are built on several
+/// threads; the result is the same as that of a single-threaded build.
+///
+/// The nodes are stored in one array, with the two children of a node
+/// next to each other, and the boxes are copied in the order of the
+/// leaves, so that a query reads contiguous memory. The queries return
+/// the indices of the boxes given to the constructor. Empty boxes are
+/// left out, and are never returned.
+///
+/// The nodes and the indices of the boxes are 32-bit, so a hierarchy
+/// holds at most 2^31 boxes; building one of more boxes throws
+/// `std::length_error`.
+///
+/// The ray queries test the nodes and the boxes with `intersects()`
+/// from ImathBoxAlgo.h, so a ray that starts inside a box hits it, and
+/// a box behind the origin of the ray is not hit.
+///
+
+template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Bvh
+{
+public:
+    ///
+    /// A node of the hierarchy. The children of an inner node are
+    /// nodes `offset` and `offset + 1`; the boxes of a leaf are boxes
+    /// `offset` to `offset + count - 1`, in the order of `indices()`.
+    ///
+
+    struct Node
+    {
+        Box<Vec3<T>> bounds;
+        uint32_t     offset;
+        uint32_t     count;
+
+        /// Return true if the node is a leaf
+        bool isLeaf () const IMATH_NOEXCEPT { return count != 0; }
+    };
+
+    /// @{
+    /// @name Constructors
+
+    /// An empty hierarchy
+    Bvh () IMATH_NOEXCEPT {}
+
+    /// Build the hierarchy of the `n` boxes `boxes`, with at most
+    /// `maxLeafSize` boxes in a leaf, unless more boxes have the same
+    /// center.
+    Bvh (const Box<Vec3<T>>* boxes, size_t n, int maxLeafSize = 4);
+
+    /// Build the hierarchy of the `n` boxes `boxes` on up to
+    /// `parallel.numThreads` threads
+    Bvh (
+        const Box<Vec3<T>>*  boxes,
+        size_t               n,
+        const ParallelBuild& parallel,
+        int                  maxLeafSize = 4);
+
+    /// @}
+
+    /// @{
+    /// @name Build
+
+    /// Replace the hierarchy by that of the `n` boxes `boxes`
+    void build (const Box<Vec3<T>>* boxes, size_t n, int maxLeafSize = 4);
+
+    /// Replace the hierarchy by that of the `n` boxes `boxes`, built on
+    /// up to `parallel.numThreads` threads
+    void build (
+        const Box<Vec3<T>>*  boxes,
+        size_t               n,
+        const ParallelBuild& parallel,
+        int                  maxLeafSize = 4);
+
+    /// @}
+
+    /// @{
+    /// @name Query
+
+    /// Call `f (i)` for each box `i` that overlaps `box`
+    template <class F>
+    void findOverlapping (const Box<Vec3<T>>& box, F f) const;
+
+    /// Append to `result` the indices of the boxes that overlap `box`,
+    /// and return their number
+    size_t findOverlapping (
+        const Box<Vec3<T>>& box, std::vector<size_t>& result) const;
+
+    /// Call `f (i)` for each box `i` that `ray` hits
+    template <class F> void findIntersecting (const Line3<T>& ray, F f) const;
+
+    /// Find the box that `ray` hits first. Return false if it hits no
+    /// box; otherwise return true, with the index of the box in
+    /// `index` and the point where the ray enters it, or the origin of
+    /// the ray if it starts inside the box, in `point`.
+    bool closestIntersection (
+        const Line3<T>& ray, size_t& index, Vec3<T>& point) const
+        IMATH_NOEXCEPT;
+
+    /// Find the box closest to `p`. Return false if there are no boxes;
+    /// otherwise return true, with the index of the box in `index` and
+    /// the point of the box closest to `p` in `point`.
+    bool closestPoint (const Vec3<T>& p, size_t& index, Vec3<T>& point) const
+        IMATH_NOEXCEPT;
+
+    /// @}
+
+    /// @{
+    /// @name Direct access to the hierarchy
+
+    /// The nodes, root first. There are no nodes if there are no boxes.
+    const std::vector<Node>& nodes () const IMATH_NOEXCEPT { return _nodes; }
+
+    /// The boxes, in the order of the leaves
+    const std::vector<Box<Vec3<T>>>& boxes () const IMATH_NOEXCEPT
+    {
+        return _boxes;
+    }
+
+    /// The index given to the constructor of each box of `boxes()`
+    const std::vector<uint32_t>& indices () const IMATH_NOEXCEPT
+    {
+        return _indices;
+    }
+
+    /// The bounds of all the boxes
+    Box<Vec3<T>> bounds () const IMATH_NOEXCEPT
+    {
+        return _nodes.empty () ? Box<Vec3<T>> () : _nodes[0].bounds;
+    }
+
+    /// @}
+
+private:
+    // Split the boxes of `r`, whose bounds are `bounds`, at `mid`,
+    // and return the bounds of both halves, or return false to make a
+    // leaf. Bin on up to `numThreads` threads.
+    bool split (
+        const BvhDetail::Range& r,
+        const Box<Vec3<T>>&     bounds,
+        int                     maxLeafSize,
+        unsigned int            numThreads,
+        uint32_t&               mid,
+        Box<Vec3<T>>&           left,
+        Box<Vec3<T>>&           right);
+
+    // Build the subtree of `r` depth-first into `nodes`, where
+    // `nodes[r.node]` holds its bounds.
+    void buildSubtree (
+        const BvhDetail::Range& r,
+        int                     maxLeafSize,
+        std::vector<Node>&      nodes);
+
+    void buildNodes (
+        const Box<Vec3<T>>* boxes,
+        size_t              n,
+        unsigned int        numThreads,
+        int                 maxLeafSize);
+
+    std::vector<Node>         _nodes;
+    std::vector<Box<Vec3<T>>> _boxes;
+    std::vector<uint32_t>     _indices;
+    std::vector<Vec3<T>>      _centers; // Only during the build
+};
+
+//----------------------------------------------------------------------------
+// Implementation
+//----------------------------------------------------------------------------
+
+template <class T>
+inline Bvh<T>::Bvh (const Box<Vec3<T>>* boxes, size_t n, int maxLeafSize)
+{
+    build (boxes, n, maxLeafSize);
+}
+
+template <class T>
+inline Bvh<T>::Bvh (
+    const Box<Vec3<T>>*  boxes,
+    size_t               n,
+    const ParallelBuild& parallel,
+    int                  maxLeafSize)
+{
+    build (boxes, n, parallel, maxLeafSize);
+}
+
+template <class T>
+inline void
+Bvh<T>::build (const Box<Vec3<T>>* boxes, size_t n, int maxLeafSize)
+{
+    buildNodes (boxes, n, 1, maxLeafSize);
+}
+
+template <class T>
+inline void
+Bvh<T>::build (
+    const Box<Vec3<T>>*  boxes,
+    size_t               n,
+    const ParallelBuild& parallel,
+    int                  maxLeafSize)
+{
+    buildNodes (boxes, n, parallel.numThreads, maxLeafSize);
+}
+
+template <class T>
+bool
+Bvh<T>::split (
+    const BvhDetail::Range& r,
+    const Box<Vec3<T>>&     bounds,
+    int                     maxLeafSize,
+    unsigned int            numThreads,
+    uint32_t&               mid,
+    Box<Vec3<T>>&           left,
+    Box<Vec3<T>>&           right)
+{
+    using BvhDetail::Bin;
+    using BvhDetail::numBins;
+
+    const size_t n = r.end - r.begin;
+
+    if (n <= 1 || r.depth >= BvhDetail::maxDepth) return false;
+
+    //
+    // The bounds of the centers, and the bins along their longest axis,
+    // with no more bins than boxes. At the top levels, these are
+    // computed in chunks on several threads, and merged.
+    //
+
+    const unsigned int chunks = parallelThreadCount (numThreads, n, 1 << 15);
+    const int          nb     = n < size_t (numBins) ? int (n) : numBins;
+
+    Box<Vec3<T>> cb;
+
+    if (chunks == 1)
+    {
+        for (uint32_t i = r.begin; i < r.end; ++i)
+            BvhDetail::extend (cb, _centers[i], _centers[i]);
+    }
+    else
+    {
+        std::vector<Box<Vec3<T>>> chunkBounds (chunks);
+
+        parallelFor (0, chunks, chunks, 1, [&] (size_t b, size_t e) {
+            for (size_t c = b; c < e; ++c)
+                for (uint32_t i = r.begin + uint32_t (n * c / chunks);
+                     i < r.begin + uint32_t (n * (c + 1) / chunks);
+                     ++i)
+                    BvhDetail::extend (
+                        chunkBounds[c], _centers[i], _centers[i]);
+        });
+
+        for (unsigned int c = 0; c < chunks; ++c)
+            cb.extendBy (chunkBounds[c]);
+    }
+
+    const int axis   = cb.majorAxis ();
+    const T   extent = cb.max[axis] - cb.min[axis];
+
+    if (!(extent > 0))
+    {
+        //
+        // All the centers are the same: split in the middle only if
+        // there are too many boxes for a leaf
+        //
+
+        if (n <= size_t (maxLeafSize)) return false;
+
+        mid = r.begin + uint32_t (n / 2);
+        left.makeEmpty ();
+        right.makeEmpty ();
+
+        for (uint32_t i = r.begin; i < mid; ++i)
+            left.extendBy (_boxes[i]);
+        for (uint32_t i = mid; i < r.end; ++i)
+            right.extendBy (_boxes[i]);
+
+        return true;
+    }
+
+    const T origin = cb.min[axis];
+    const T scale  = T (nb) * (1 - std::numeric_limits<T>::epsilon ()) / extent;
+
+    auto binOf = [&] (uint32_t i) {
+        int k = int ((_centers[i][axis] - origin) * scale);
+        return k < 0 ? 0 : (k >= nb ? nb - 1 : k);
+    };
+
+    Bin<T> bins[numBins];
+
+    if (chunks == 1)
+    {
+        for (uint32_t i = r.begin; i < r.end; ++i)
+        {
+            Bin<T>& bin = bins[binOf (i)];
+            BvhDetail::extend (bin.bounds, _boxes[i].min, _boxes[i].max);
+            ++bin.count;
+        }
+    }
+    else
+    {
+        std::vector<Bin<T>> chunkBins (chunks * nb);
+
+        parallelFor (0, chunks, chunks, 1, [&] (size_t b, size_t e) {
+            for (size_t c = b; c < e; ++c)
+                for (uint32_t i = r.begin + uint32_t (n * c / chunks);
+                     i < r.begin + uint32_t (n * (c + 1) / chunks);
+                     ++i)
+                {
+                    Bin<T>& bin = chunkBins[c * nb + binOf (i)];
+                    BvhDetail::extend (
+                        bin.bounds, _boxes[i].min, _boxes[i].max);
+                    ++bin.count;
+                }
+        });
+
+        for (unsigned int c = 0; c < chunks; ++c)
+        {
+            for (int k = 0; k < nb; ++k)
+            {
+                bins[k].bounds.extendBy (chunkBins[c * nb + k].bounds);
+                bins[k].count += chunkBins[c * nb + k].count;
+            }
+        }
+    }
+
+    //
+    // The cost of splitting after bin k, relative to the cost of testing
+    // one box: one node test, plus the boxes of each half weighted by
+    // the probability that a ray that hits the node hits the half
+    //
+
+    T            rightCost[numBins];
+    Box<Vec3<T>> b;
+    size_t       count = 0;
+
+    for (int k = nb - 1; k > 0; --k)
+    {
+        b.extendBy (bins[k].bounds);
+        count += bins[k].count;
+        rightCost[k] = BvhDetail::halfArea (b) * T (count);
+    }
+
+    const T area = BvhDetail::halfArea (bounds);
+
+    T   bestCost = std::numeric_limits<T>::max ();
+    int best     = -1;
+
+    b.makeEmpty ();
+    count = 0;
+
+    for (int k = 0; k < nb - 1; ++k)
+    {
+        b.extendBy (bins[k].bounds);
+        count += bins[k].count;
+
+        if (count == 0 || count == n) continue;
+
+        const T cost =
+            1 + (BvhDetail::halfArea (b) * T (count) + rightCost[k + 1]) /
+                    (area > 0 ? area : T (1));
+
+        if (cost < bestCost)
+        {
+            bestCost = cost;
+            best     = k;
+            left     = b;
+        }
+    }
+
+    if (best < 0 || (n <= size_t (maxLeafSize) && T (n) <= bestCost))
+        return false;
+
+    right.makeEmpty ();
+    for (int k = best + 1; k < nb; ++k)
+        right.extendBy (bins[k].bounds);
+
+    //
+    // Move the boxes of the left half to the front of the range. The
+    // swaps are unconditional, which is faster than mispredicting
+    // which half each box goes to.
+    //
+
+    uint32_t j = r.begin;
+
+    for (uint32_t i = r.begin; i < r.end; ++i)
+    {
+        const bool isLeft = binOf (i) <= best;
+
+        std::swap (_boxes[i], _boxes[j]);
+        std::swap (_centers[i], _centers[j]);
+        std::swap (_indices[i], _indices[j]);
+
+        j += isLeft;
+    }
+
+    mid = j;
+    return true;
+}
+
+template <class T>
+void
+Bvh<T>::buildSubtree (
+    const BvhDetail::Range& r, int maxLeafSize, std::vector<Node>& nodes)
+{
+    uint32_t     mid;
+    Box<Vec3<T>> left, right;
+
+    if (!split (r, nodes[r.node].bounds, maxLeafSize, 1, mid, left, right))
+    {
+        nodes[r.node].offset = r.begin;
+        nodes[r.node].count  = r.end - r.begin;
+        return;
+    }
+
+    const uint32_t c = uint32_t (nodes.size ());
+    nodes.resize (c + 2);
+
+    nodes[r.node].offset = c;
+    nodes[r.node].count  = 0;
+    nodes[c].bounds      = left;
+    nodes[c + 1].bounds  = right;
+
+    const BvhDetail::Range a = {c, r.begin, mid, r.depth + 1};
+    const BvhDetail::Range b = {c + 1, mid, r.end, r.depth + 1};
+
+    buildSubtree (a, maxLeafSize, nodes);
+    buildSubtree (b, maxLeafSize, nodes);
+}
+
+template <class T>
+void
+Bvh<T>::buildNodes (
+    const Box<Vec3<T>>* boxes,
+    size_t              n,
+    unsigned int        numThreads,
+    int                 maxLeafSize)
+{
+    // At most 2^31 boxes, so that the 2^32 - 1 nodes and the indices
+    // fit in a uint32_t
+    if (n > size_t (1) << 31)
+        throw std::length_error ("Bvh: more than 2^31 boxes");
+
+    _nodes.clear ();
+    _boxes.clear ();
+    _indices.clear ();
+    _centers.clear ();
+
+    Box<Vec3<T>> bounds;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (boxes[i].isEmpty ()) continue;
+
+        _boxes.push_back (boxes[i]);
+        _centers.push_back (boxes[i].center ());
+        _indices.push_back (uint32_t (i));
+        bounds.extendBy (boxes[i]);
+    }
+
+    if (_boxes.empty ()) return;
+
+    if (maxLeafSize < 1) maxLeafSize = 1;
+
+    //
+    // Split the top levels breadth-first, binning on several threads,
+    // down to ranges small enough to be built as separate subtrees, on
+    // several threads. The size of these ranges does not depend on the
+    // number of threads, so neither does the hierarchy.
+    //
+
+    const size_t subtreeSize = std::max (_boxes.size () / 256, size_t (4096));
+
+    _nodes.resize (1);
+    _nodes[0].bounds = bounds;
+
+    std::vector<BvhDetail::Range> ranges (1);
+    std::vector<BvhDetail::Range> subtrees;
+
+    ranges[0].node  = 0;
+    ranges[0].begin = 0;
+    ranges[0].end   = uint32_t (_boxes.size ());
+    ranges[0].depth = 0;
+
+    for (size_t k = 0; k < ranges.size (); ++k)
+    {
+        const BvhDetail::Range r = ranges[k];
+
+        if (r.end - r.begin <= subtreeSize)
+        {
+            subtrees.push_back (r);
+            continue;
+        }
+
+        uint32_t     mid;
+        Box<Vec3<T>> left, right;
+
+        if (!split (
+                r,
+                _nodes[r.node].bounds,
+                maxLeafSize,
+                numThreads,
+                mid,
+                left,
+                right))
+        {
+            _nodes[r.node].offset = r.begin;
+            _nodes[r.node].count  = r.end - r.begin;
+            continue;
+        }
+
+        const uint32_t c = uint32_t (_nodes.size ());
+        _nodes.resize (c + 2);
+
+        _nodes[r.node].offset = c;
+        _nodes[r.node].count  = 0;
+        _nodes[c].bounds      = left;
+        _nodes[c + 1].bounds  = right;
+
+        const BvhDetail::Range a = {c, r.begin, mid, r.depth + 1};
+        const BvhDetail::Range b = {c + 1, mid, r.end, r.depth + 1};
+
+        ranges.push_back (a);
+        ranges.push_back (b);
+    }
+
+    std::vector<std::vector<Node>> local (subtrees.size ());
+
+    parallelFor (0, subtrees.size (), numThreads, 1, [&] (size_t b, size_t e) {
+        for (size_t k = b; k < e; ++k)
+        {
+            BvhDetail::Range r = subtrees[k];
+
+            local[k].resize (1);
+            local[k][0].bounds = _nodes[r.node].bounds;
+            r.node             = 0;
+
+            buildSubtree (r, maxLeafSize, local[k]);
+        }
+    });
+
+    //
+    // Append the nodes of each subtree, but its root, which replaces
+    // the node of its range
+    //
+
+    for (size_t k = 0; k < subtrees.size (); ++k)
+    {
+        const uint32_t base = uint32_t (_nodes.size ()) - 1;
+
+        for (size_t i = 0; i < local[k].size (); ++i)
+            if (!local[k][i].isLeaf ()) local[k][i].offset += base;
+
+        _nodes[subtrees[k].node] = local[k][0];
+        _nodes.insert (_nodes.end (), local[k].begin () + 1, local[k].end ());
+    }
+
+    std::vector<Vec3<T>> ().swap (_centers);
+}
+
+template <class T>
+template <class F>
+void
+Bvh<T>::findOverlapping (const Box<Vec3<T>>& box, F f) const
+{
+    if (_nodes.empty () || box.isEmpty ()) return;
+
+    uint32_t stack[BvhDetail::stackSize];
+    int      top = 0;
+
+    stack[top++] = 0;
+
+    while (top > 0)
+    {
+        const Node& node = _nodes[stack[--top]];
+
+        if (!node.bounds.intersects (box)) continue;
+
+        if (node.isLeaf ())
+        {
+            for (uint32_t i = node.offset; i < node.offset + node.count; ++i)
+                if (_boxes[i].intersects (box)) f (size_t (_indices[i]));
+        }
+        else
+        {
+            stack[top++] = node.offset + 1;
+            stack[top++] = node.offset;
+        }
+    }
+}
+
+template <class T>
+size_t
+Bvh<T>::findOverlapping (
+    const Box<Vec3<T>>& box, std::vector<size_t>& result) const
+{
+    const size_t n = result.size ();
+    findOverlapping (box, [&result] (size_t i) { result.push_back (i); });
+    return result.size () - n;
+}
+
+template <class T>
+template <class F>
+void
+Bvh<T>::findIntersecting (const Line3<T>& ray, F f) const
+{
+    if (_nodes.empty ()) return;
+
+    uint32_t stack[BvhDetail::stackSize];
+    int      top = 0;
+
+    stack[top++] = 0;
+
+    while (top > 0)
+    {
+        const Node& node = _nodes[stack[--top]];
+
+        if (!intersects (node.bounds, ray)) continue;
+
+        if (node.isLeaf ())
+        {
+            for (uint32_t i = node.offset; i < node.offset + node.count; ++i)
+                if (intersects (_boxes[i], ray)) f (size_t (_indices[i]));
+        }
+        else
+        {
+            stack[top++] = node.offset + 1;
+            stack[top++] = node.offset;
+        }
+    }
+}
+
+template <class T>
+bool
+Bvh<T>::closestIntersection (
+    const Line3<T>& ray, size_t& index, Vec3<T>& point) const IMATH_NOEXCEPT
+{
+    if (_nodes.empty ()) return false;
+
+    //
+    // The distance along the ray is measured in units of the length of
+    // ray.dir squared, which does not change the order of the hits.
+    // The nodes on the stack are those the ray hits, with the distance
+    // at which it enters them; the nearer child is visited first.
+    //
+
+    Vec3<T> ip;
+
+    if (!intersects (_nodes[0].bounds, ray, ip)) return false;
+
+    uint32_t stack[BvhDetail::stackSize];
+    T        enter[BvhDetail::stackSize];
+    int      top = 0;
+    T        best = std::numeric_limits<T>::max ();
+    bool     hit  = false;
+
+    stack[top]   = 0;
+    enter[top++] = (ip - ray.pos) ^ ray.dir;
+
+    while (top > 0)
+    {
+        --top;
+        if (!(enter[top] < best)) continue;
+
+        const Node& node = _nodes[stack[top]];
+
+        if (node.isLeaf ())
+        {
+            for (uint32_t i = node.offset; i < node.offset + node.count; ++i)
+            {
+                if (!intersects (_boxes[i], ray, ip)) continue;
+
+                const T t = (ip - ray.pos) ^ ray.dir;
+
+                if (t < best)
+                {
+                    best  = t;
+                    index = _indices[i];
+                    point = ip;
+                    hit   = true;
+                }
+            }
+
+            continue;
+        }
+
+        T    t[2];
+        bool h[2];
+
+        for (int c = 0; c < 2; ++c)
+        {
+            h[c] = intersects (_nodes[node.offset + c].bounds, ray, ip);
+            t[c] = (ip - ray.pos) ^ ray.dir;
+            h[c] = h[c] && t[c] < best;
+        }
+
+        const int nearer = (h[1] && (!h[0] || t[1] < t[0])) ? 1 : 0;
+
+        for (int c = 1; c >= 0; --c)
+        {
+            const int k = c ? 1 - nearer : nearer;
+
+            if (h[k])
+            {
+                stack[top]   = node.offset + k;
+                enter[top++] = t[k];
+            }
+        }
+    }
+
+    return hit;
+}
+
+template <class T>
+bool
+Bvh<T>::closestPoint (const Vec3<T>& p, size_t& index, Vec3<T>& point) const
+    IMATH_NOEXCEPT
+{
+    if (_nodes.empty ()) return false;
+
+    //
+    // Branch and bound on the squared distance from p to the nodes,
+    // visiting the nearer child first
+    //
+
+    uint32_t stack[BvhDetail::stackSize];
+    T        dist[BvhDetail::stackSize];
+    int      top = 0;
+    T        best = std::numeric_limits<T>::max ();
+    bool     found = false;
+
+    stack[top]  = 0;
+    dist[top++] = (closestPointInBox (p, _nodes[0].bounds) - p).length2 ();
+
+    while (top > 0)
+    {
+        --top;
+        if (!(dist[top] < best) && found) continue;
+
+        const Node& node = _nodes[stack[top]];
+
+        if (node.isLeaf ())
+        {
+            for (uint32_t i = node.offset; i < node.offset + node.count; ++i)
+            {
+                const Vec3<T> q = closestPointInBox (p, _boxes[i]);
+                const T       d = (q - p).length2 ();
+
+                if (d < best || !found)
+                {
+                    best  = d;
+                    index = _indices[i];
+                    point = q;
+                    found = true;
+                }
+            }
+
+            continue;
+        }
+
+        T d[2];
+        for (int c = 0; c < 2; ++c)
+            d[c] = (closestPointInBox (p, _nodes[node.offset + c].bounds) - p)
+                       .length2 ();
+
+        const int nearer = d[1] < d[0] ? 1 : 0;
+
+        stack[top]  = node.offset + 1 - nearer;
+        dist[top++] = d[1 - nearer];
+        stack[top]  = node.offset + nearer;
+        dist[top++] = d[nearer];
+    }
+
+    return found;
+}
+
+/// Bvh of type float
+typedef Bvh<float> Bvhf;
+
+/// Bvh of type double
+typedef Bvh<double> Bvhd;
+
+IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif // INCLUDED_IMATHBVH_H
@@ -0,0 +1,665 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+//
+// A dual quaternion, for representing, composing and blending rigid
+// transforms, and bulk dual quaternion skinning of many points at once.
+//
+
+#ifndef INCLUDED_IMATHDUALQUAT_H
+#define INCLUDED_IMATHDUALQUAT_H
+
+#include "ImathExport.h"
+#include "ImathNamespace.h"
+
+#include "ImathMatrixAlgo.h"
+#include "ImathParallel.h"
+#include "ImathQuat.h"
+#include "ImathVecArray.h"
+
+#include <cmath>
+#include <iostream>
+#include <stddef.h>
+#include <string.h>
+
+IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
+
+///
+/// The DualQuat class implements dual quaternions `r + e d`, where `r`
+/// and `d` are quaternions and `e^2 = 0`. A unit dual quaternion, with
+/// `|r| = 1` and `r ^ d = 0`, represents a rigid transform: the
+/// rotation `r` followed by the translation `t`, with `d = t r / 2`.
+/// It takes 8 numbers instead of the 16 of a Matrix44, and blending
+/// unit dual quaternions and normalizing the result gives a rigid
+/// transform, which blending matrices does not.
+///
+/// As with Quat, the product `a * b` applies `b` first and then `a`,
+/// so `(a * b).toMatrix44() == b.toMatrix44() * a.toMatrix44()`.
+///
+
+template <class T> class IMATH_EXPORT_TEMPLATE_TYPE DualQuat
+{
+public:
+    /// @{
+    /// @name Direct access to elements
+
+    /// The real part: the rotation
+    Quat<T> r;
+
+    /// The dual part: half the translation times the rotation
+    Quat<T> d;
+
+    /// @}
+
+    /// @{
+    ///	@name Constructors
+
+    /// Default constructor is the identity transform
+    IMATH_HOSTDEVICE constexpr DualQuat () IMATH_NOEXCEPT;
+
+    /// Construct from a dual quaternion of another base type
+    template <class S>
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14
+    DualQuat (const DualQuat<S>& q) IMATH_NOEXCEPT;
+
+    /// Initialize with real part `real` and dual part `dual`
+    IMATH_HOSTDEVICE constexpr DualQuat (
+        const Quat<T>& real, const Quat<T>& dual) IMATH_NOEXCEPT;
+
+    /// The rigid transform that rotates by the unit quaternion
+    /// `rotation` and then translates by `translation`
+    IMATH_HOSTDEVICE constexpr DualQuat (
+        const Quat<T>& rotation, const Vec3<T>& translation) IMATH_NOEXCEPT;
+
+    /// The rigid transform of a matrix without scaling, shear or
+    /// projection, i.e. a rotation followed by a translation
+    explicit DualQuat (const Matrix44<T>& m) IMATH_NOEXCEPT;
+
+    /// The identity transform
+    IMATH_HOSTDEVICE constexpr static DualQuat<T> identity () IMATH_NOEXCEPT;
+
+    /// @}
+
+    /// @{
+    /// @name Basic Algebra
+    ///
+    /// Note that the operator return values are *NOT* normalized
+
+    /// Dual quaternion multiplication: this = this * q
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 const DualQuat<T>&
+    operator*= (const DualQuat<T>& q) IMATH_NOEXCEPT;
+
+    /// Scalar multiplication of both parts
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 const DualQuat<T>&
+    operator*= (T t) IMATH_NOEXCEPT;
+
+    /// Scalar division of both parts
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 const DualQuat<T>&
+    operator/= (T t) IMATH_NOEXCEPT;
+
+    /// Dual quaternion addition
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 const DualQuat<T>&
+    operator+= (const DualQuat<T>& q) IMATH_NOEXCEPT;
+
+    /// Dual quaternion subtraction
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 const DualQuat<T>&
+    operator-= (const DualQuat<T>& q) IMATH_NOEXCEPT;
+
+    /// Equality
+    template <class S>
+    IMATH_HOSTDEVICE constexpr bool
+    operator== (const DualQuat<S>& q) const IMATH_NOEXCEPT;
+
+    /// Inequality
+    template <class S>
+    IMATH_HOSTDEVICE constexpr bool
+    operator!= (const DualQuat<S>& q) const IMATH_NOEXCEPT;
+
+    /// @}
+
+    /// @{
+    /// @name Query
+
+    /// Return the rotation of a unit dual quaternion
+    IMATH_HOSTDEVICE constexpr Quat<T> rotation () const IMATH_NOEXCEPT;
+
+    /// Return the translation of a unit dual quaternion, `2 d r*`
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Vec3<T>
+    translation () const IMATH_NOEXCEPT;
+
+    /// Return the 4x4 matrix of the rigid transform of a unit dual
+    /// quaternion
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Matrix44<T>
+    toMatrix44 () const IMATH_NOEXCEPT;
+
+    /// @}
+
+    /// @{
+    /// @name Utility Methods
+
+    /// Invert in place: this = 1 / this.
+    /// @return const reference to this.
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 DualQuat<T>& invert () IMATH_NOEXCEPT;
+
+    /// Return 1/this, leaving this unchanged. For a unit dual
+    /// quaternion, this is the inverse transform.
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 DualQuat<T>
+    inverse () const IMATH_NOEXCEPT;
+
+    /// Normalize in place, making `|r| = 1` and `r ^ d = 0`. A dual
+    /// quaternion with `r = 0` becomes the identity.
+    /// @return const reference to this.
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 DualQuat<T>& normalize () IMATH_NOEXCEPT;
+
+    /// Return a normalized dual quaternion, leaving this unmodified.
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 DualQuat<T>
+    normalized () const IMATH_NOEXCEPT;
+
+    /// Transform the point `p` by the rigid transform of a unit dual
+    /// quaternion
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Vec3<T>
+    transformPoint (const Vec3<T>& p) const IMATH_NOEXCEPT;
+
+    /// @}
+
+    /// The base type: In templates that accept a parameter `V`, you
+    /// can refer to `T` as `V::BaseType`
+    typedef T BaseType;
+};
+
+template <class T>
+IMATH_HOSTDEVICE constexpr DualQuat<T>
+operator* (const DualQuat<T>& a, const DualQuat<T>& b) IMATH_NOEXCEPT;
+
+/// Dual quaternion of type float
+typedef DualQuat<float> DualQuatf;
+
+/// Dual quaternion of type double
+typedef DualQuat<double> DualQuatd;
+
+//---------------
+// Implementation
+//---------------
+
+template <class T>
+IMATH_HOSTDEVICE constexpr inline DualQuat<T>::DualQuat () IMATH_NOEXCEPT
+    : r (),
+      d (0, 0, 0, 0)
+{
+    // empty
+}
+
+template <class T>
+template <class S>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline DualQuat<T>::DualQuat (
+    const DualQuat<S>& q) IMATH_NOEXCEPT : r (q.r),
+                                           d (q.d)
+{
+    // empty
+}
+
+template <class T>
+IMATH_HOSTDEVICE constexpr inline DualQuat<T>::DualQuat (
+    const Quat<T>& real, const Quat<T>& dual) IMATH_NOEXCEPT : r (real),
+                                                               d (dual)
+{
+    // empty
+}
+
+template <class T>
+IMATH_HOSTDEVICE constexpr inline DualQuat<T>::DualQuat (
+    const Quat<T>& rotation, const Vec3<T>& translation) IMATH_NOEXCEPT
+    : r (rotation),
+      d (Quat<T> (0, translation * T (0.5)) * rotation)
+{
+    // empty
+}
+
+template <class T>
+inline DualQuat<T>::DualQuat (const Matrix44<T>& m) IMATH_NOEXCEPT
+    : r (extractQuat (m))
+{
+    d = Quat<T> (0, Vec3<T> (m[3][0], m[3][1], m[3][2]) * T (0.5)) * r;
+}
+
+template <class T>
+IMATH_HOSTDEVICE constexpr inline DualQuat<T>
+DualQuat<T>::identity () IMATH_NOEXCEPT
+{
+    return DualQuat<T> ();
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline const DualQuat<T>&
+DualQuat<T>::operator*= (const DualQuat<T>& q) IMATH_NOEXCEPT
+{
+    *this = *this * q;
+    return *this;
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline const DualQuat<T>&
+DualQuat<T>::operator*= (T t) IMATH_NOEXCEPT
+{
+    r *= t;
+    d *= t;
+    return *this;
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline const DualQuat<T>&
+DualQuat<T>::operator/= (T t) IMATH_NOEXCEPT
+{
+    r /= t;
+    d /= t;
+    return *this;
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline const DualQuat<T>&
+DualQuat<T>::operator+= (const DualQuat<T>& q) IMATH_NOEXCEPT
+{
+    r += q.r;
+    d += q.d;
+    return *this;
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline const DualQuat<T>&
+DualQuat<T>::operator-= (const DualQuat<T>& q) IMATH_NOEXCEPT
+{
+    r -= q.r;
+    d -= q.d;
+    return *this;
+}
+
+template <class T>
+template <class S>
+IMATH_HOSTDEVICE constexpr inline bool
+DualQuat<T>::operator== (const DualQuat<S>& q) const IMATH_NOEXCEPT
+{
+    return r == q.r && d == q.d;
+}
+
+template <class T>
+template <class S>
+IMATH_HOSTDEVICE constexpr inline bool
+DualQuat<T>::operator!= (const DualQuat<S>& q) const IMATH_NOEXCEPT
+{
+    return r != q.r || d != q.d;
+}
+
+template <class T>
+IMATH_HOSTDEVICE constexpr inline Quat<T>
+DualQuat<T>::rotation () const IMATH_NOEXCEPT
+{
+    return r;
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline Vec3<T>
+DualQuat<T>::translation () const IMATH_NOEXCEPT
+{
+    //
+    // The vector part of 2 d r*
+    //
+
+    return T (2) * (r.r * d.v - d.r * r.v + r.v % d.v);
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline Matrix44<T>
+DualQuat<T>::toMatrix44 () const IMATH_NOEXCEPT
+{
+    Matrix44<T>   m = r.toMatrix44 ();
+    const Vec3<T> t = translation ();
+
+    m[3][0] = t.x;
+    m[3][1] = t.y;
+    m[3][2] = t.z;
+    return m;
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline DualQuat<T>&
+DualQuat<T>::invert () IMATH_NOEXCEPT
+{
+    //
+    // (r + e d)^-1 = r^-1 - e r^-1 d r^-1
+    //
+
+    r.invert ();
+    d = -(r * d * r);
+    return *this;
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline DualQuat<T>
+DualQuat<T>::inverse () const IMATH_NOEXCEPT
+{
+    const Quat<T> ri = r.inverse ();
+    return DualQuat<T> (ri, -(ri * d * ri));
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline DualQuat<T>&
+DualQuat<T>::normalize () IMATH_NOEXCEPT
+{
+    if (T l = r.length ())
+    {
+        r /= l;
+        d /= l;
+        d -= r * (r ^ d);
+    }
+    else
+    {
+        *this = DualQuat<T> ();
+    }
+
+    return *this;
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline DualQuat<T>
+DualQuat<T>::normalized () const IMATH_NOEXCEPT
+{
+    DualQuat<T> q (*this);
+    return q.normalize ();
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline Vec3<T>
+DualQuat<T>::transformPoint (const Vec3<T>& p) const IMATH_NOEXCEPT
+{
+    return p * r + translation ();
+}
+
+/// Dual quaternion multiplication
+template <class T>
+IMATH_HOSTDEVICE constexpr inline DualQuat<T>
+operator* (const DualQuat<T>& a, const DualQuat<T>& b) IMATH_NOEXCEPT
+{
+    return DualQuat<T> (a.r * b.r, a.r * b.d + a.d * b.r);
+}
+
+/// Dual quaternion*scalar multiplication
+template <class T>
+IMATH_HOSTDEVICE constexpr inline DualQuat<T>
+operator* (const DualQuat<T>& q, T t) IMATH_NOEXCEPT
+{
+    return DualQuat<T> (q.r * t, q.d * t);
+}
+
+/// Scalar*dual quaternion multiplication
+template <class T>
+IMATH_HOSTDEVICE constexpr inline DualQuat<T>
+operator* (T t, const DualQuat<T>& q) IMATH_NOEXCEPT
+{
+    return DualQuat<T> (q.r * t, q.d * t);
+}
+
+/// Dual quaternion addition
+template <class T>
+IMATH_HOSTDEVICE constexpr inline DualQuat<T>
+operator+ (const DualQuat<T>& a, const DualQuat<T>& b) IMATH_NOEXCEPT
+{
+    return DualQuat<T> (a.r + b.r, a.d + b.d);
+}
+
+/// Dual quaternion subtraction
+template <class T>
+IMATH_HOSTDEVICE constexpr inline DualQuat<T>
+operator- (const DualQuat<T>& a, const DualQuat<T>& b) IMATH_NOEXCEPT
+{
+    return DualQuat<T> (a.r - b.r, a.d - b.d);
+}
+
+/// Negate the dual quaternion, which represents the same transform
+template <class T>
+IMATH_HOSTDEVICE constexpr inline DualQuat<T>
+operator- (const DualQuat<T>& q) IMATH_NOEXCEPT
+{
+    return DualQuat<T> (-q.r, -q.d);
+}
+
+/// Transform a point by the rigid transform of a unit dual quaternion
+/// @return p * q
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline Vec3<T>
+operator* (const Vec3<T>& p, const DualQuat<T>& q) IMATH_NOEXCEPT
+{
+    return q.transformPoint (p);
+}
+
+/// Stream output, as "(r d)"
+template <class T>
+std::ostream&
+operator<< (std::ostream& o, const DualQuat<T>& q)
+{
+    return o << "(" << q.r << " " << q.d << ")";
+}
+
+/// @cond Doxygen_Suppress
+
+namespace DualQuatDetail
+{
+
+//
+// Number of points processed per block. The blended transforms of a
+// block live on the stack.
+//
+
+const size_t blockSize = 64;
+
+//
+// Skin the points [begin, begin + n), n <= blockSize. The bones of each
+// point are blended in the hemisphere of its first bone, so that
+// antipodal dual quaternions, which represent the same transform, do
+// not cancel out. The sign is applied with copysign() rather than a
+// branch, which would be mispredicted for about half the bones.
+//
+
+template <class T>
+inline void
+skinBlock (
+    const DualQuat<T>*  bones,
+    const int*          boneIndex,
+    const T*            boneWeight,
+    int                 influences,
+    const Vec3Array<T>& points,
+    Vec3Array<T>&       result,
+    size_t              begin,
+    size_t              n) IMATH_NOEXCEPT
+{
+    T b[8][blockSize];
+    T l[blockSize];
+    T p[3][blockSize];
+
+    const int* index  = boneIndex + begin * influences;
+    const T*   weight = boneWeight + begin * influences;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const int*     k     = index + i * influences;
+        const T*       w     = weight + i * influences;
+        const Quat<T>& pivot = bones[k[0]].r;
+
+        T s[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+
+        for (int j = 0; j < influences; ++j)
+        {
+            const DualQuat<T>& q = bones[k[j]];
+            const T wj = w[j] * std::copysign (T (1), q.r ^ pivot);
+
+            s[0] += wj * q.r.r;
+            s[1] += wj * q.r.v.x;
+            s[2] += wj * q.r.v.y;
+            s[3] += wj * q.r.v.z;
+            s[4] += wj * q.d.r;
+            s[5] += wj * q.d.v.x;
+            s[6] += wj * q.d.v.y;
+            s[7] += wj * q.d.v.z;
+        }
+
+        for (int c = 0; c < 8; ++c)
+            b[c][i] = s[c];
+    }
+
+    for (size_t i = 0; i < n; ++i)
+        l[i] = b[0][i] * b[0][i] + b[1][i] * b[1][i] + b[2][i] * b[2][i] +
+               b[3][i] * b[3][i];
+
+    VecArrayDetail::sqrt (l, n);
+
+    for (size_t i = 0; i < n; ++i)
+        l[i] = l[i] != T (0) ? l[i] : T (1);
+
+    //
+    // Copy the points, which may be in the result array, to the stack,
+    // so that the compiler needs no aliasing checks on them.
+    //
+
+    for (int c = 0; c < 3; ++c)
+        memcpy (p[c], points.lane (c) + begin, n * sizeof (T));
+
+    T* IMATH_RESTRICT rx = result.x () + begin;
+    T* IMATH_RESTRICT ry = result.y () + begin;
+    T* IMATH_RESTRICT rz = result.z () + begin;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const T s  = T (1) / l[i];
+        const T qr = b[0][i] * s;
+        const T qx = b[1][i] * s;
+        const T qy = b[2][i] * s;
+        const T qz = b[3][i] * s;
+        const T dr = b[4][i] * s;
+        const T dx = b[5][i] * s;
+        const T dy = b[6][i] * s;
+        const T dz = b[7][i] * s;
+
+        //
+        // p * q + translation (), as in DualQuat::transformPoint()
+        //
+
+        const T x = p[0][i];
+        const T y = p[1][i];
+        const T z = p[2][i];
+
+        const T ax = qy * z - qz * y;
+        const T ay = qz * x - qx * z;
+        const T az = qx * y - qy * x;
+
+        const T bx = qy * az - qz * ay;
+        const T by = qz * ax - qx * az;
+        const T bz = qx * ay - qy * ax;
+
+        const T tx = qr * dx - dr * qx + (qy * dz - qz * dy);
+        const T ty = qr * dy - dr * qy + (qz * dx - qx * dz);
+        const T tz = qr * dz - dr * qz + (qx * dy - qy * dx);
+
+        rx[i] = x + T (2) * (qr * ax + bx + tx);
+        ry[i] = y + T (2) * (qr * ay + by + ty);
+        rz[i] = z + T (2) * (qr * az + bz + tz);
+    }
+}
+
+} // namespace DualQuatDetail
+
+/// @endcond
+
+/// @{
+/// @name Dual quaternion skinning
+///
+/// Transform each point `points[i]` by the normalized weighted sum of
+/// the unit dual quaternions of its bones ("dual quaternion linear
+/// blending", L. Kavan et al., "Geometric Skinning with Approximate
+/// Dual Quaternion Blending", 2008). Every point has `influences`
+/// bones: the indices of the bones of point `i` are `boneIndex[i *
+/// influences + j]` and their weights `boneWeight[i * influences +
+/// j]`, for `0 <= j < influences`. Points whose blended rotation is
+/// zero, such as points whose weights are all zero, are left in place.
+///
+/// The blended transforms are computed per block of points and
+/// applied with loops the compiler vectorizes. `result` is resized to
+/// `points.size()`, and may be the same array as `points`.
+
+/// Skin the points in `points` with the dual quaternions `bones`
+template <class T>
+inline void
+dualQuatSkinning (
+    const DualQuat<T>*  bones,
+    const int*          boneIndex,
+    const T*            boneWeight,
+    int                 influences,
+    const Vec3Array<T>& points,
+    Vec3Array<T>&       result)
+{
+    const size_t n     = points.size ();
+    const size_t block = DualQuatDetail::blockSize;
+
+    result.resize (n);
+
+    for (size_t begin = 0; begin < n; begin += block)
+    {
+        const size_t k = n - begin < block ? n - begin : block;
+
+        DualQuatDetail::skinBlock (
+            bones, boneIndex, boneWeight, influences, points, result, begin, k);
+    }
+}
+
+/// Skin the points in `points` with the dual quaternions `bones`, on
+/// up to `parallel.numThreads` threads
+template <class T>
+inline void
+dualQuatSkinning (
+    const DualQuat<T>*   bones,
+    const int*           boneIndex,
+    const T*             boneWeight,
+    int                  influences,
+    const Vec3Array<T>&  points,
+    Vec3Array<T>&        result,
+    const ParallelBuild& parallel)
+{
+    const size_t n     = points.size ();
+    const size_t block = DualQuatDetail::blockSize;
+
+    result.resize (n);
+
+    //
+    // Hand out whole blocks, so that each thread's range starts at a
+    // block boundary.
+    //
+
+    parallelFor (
+        0,
+        (n + block - 1) / block,
+        parallel.numThreads,
+        64,
+        [&] (size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i)
+            {
+                const size_t begin = i * block;
+                const size_t k = n - begin < block ? n - begin : block;
+
+                DualQuatDetail::skinBlock (
+                    bones,
+                    boneIndex,
+                    boneWeight,
+                    influences,
+                    points,
+                    result,
+                    begin,
+                    k);
+            }
+        });
+}
+
+/// @}
+
+IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif // INCLUDED_IMATHDUALQUAT_H
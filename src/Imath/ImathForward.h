@@ -31,6 +31,9 @@ template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Box;
 template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Color3;
 template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Color4;
 #endif
+#ifndef INCLUDED_IMATHDUALQUAT_H
+template <class T> class IMATH_EXPORT_TEMPLATE_TYPE DualQuat;
+#endif
 #ifndef INCLUDED_IMATHEULER_H
 template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Euler;
 #endif
@@ -68,6 +71,19 @@ template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Vec3;
 template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Vec4;
 #endif
 
+#ifndef INCLUDED_IMATHMATRIXBATCH_H
+template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Matrix44Array;
+#endif
+
+#ifndef INCLUDED_IMATHQUATARRAY_H
+template <class T> class IMATH_EXPORT_TEMPLATE_TYPE QuatArray;
+#endif
+
+#ifndef INCLUDED_IMATHVECARRAY_H
+template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Vec3Array;
+template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Vec4Array;
+#endif
+
 #ifndef INCLUDED_IMATHRANDOM_H
 class IMATH_EXPORT_TYPE Rand32;
 class IMATH_EXPORT_TYPE Rand48;
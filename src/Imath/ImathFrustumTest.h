@@ -23,9 +23,62 @@
 #include "ImathMatrix.h"
 #include "ImathSphere.h"
 #include "ImathVec.h"
+#include "ImathVecArray.h"
+
+#include <stddef.h>
+#include <stdint.h>
 
 IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
 
+/// @cond Doxygen_Suppress
+
+namespace FrustumTestDetail
+{
+
+//
+// The six planes of a FrustumTest, one array per component.
+//
+
+template <class T> struct Planes
+{
+    T normX[6];
+    T normY[6];
+    T normZ[6];
+    T normAbsX[6];
+    T normAbsY[6];
+    T normAbsZ[6];
+    T offset[6];
+};
+
+//
+// The separating axes for the exact box test: the six plane normals,
+// the three box axes, and the cross products of the box axes with the
+// six edge directions of the frustum, one array per component, with
+// the projection of the frustum onto each axis. Zero axes pad the
+// arrays to a multiple of the vector width.
+//
+
+template <class T> struct Axes
+{
+    enum
+    {
+        count = 32
+    };
+
+    T x[count];
+    T y[count];
+    T z[count];
+    T absX[count];
+    T absY[count];
+    T absZ[count];
+    T min[count];
+    T max[count];
+};
+
+} // namespace FrustumTestDetail
+
+/// @endcond
+
 ///
 /// template class FrustumTest<T>
 ///
@@ -55,6 +108,17 @@ IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
 ///    myFrustumTest.completelyContains(myBox)
 ///    myFrustumTest.completelyContains(mySphere)
 ///
+/// To reject the boxes that the test above lets through, at some
+/// extra cost for each visible box, use a FrustumExactTest made from
+/// the frustum test.
+///
+/// To test many spheres or boxes at once, store their centers, and
+/// their radii or extents (half the box sizes), as arrays, and call:
+///    myFrustumTest.isVisible(centers, radii, visibleBits)
+///    myFrustumTest.isVisible(centers, extents, visibleBits)
+///    myFrustumTest.visibleIndices(centers, radii, indices)
+///    myFrustumTest.visibleIndices(centers, extents, indices)
+///
 /// Explanation of how it works
 ///
 /// We store six world-space Frustum planes (nx, ny, nz, offset)
@@ -72,6 +136,12 @@ IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
 ///         sphere's radius. (the result is NOT exact, but will not return
 ///         false-negatives.)
 ///
+/// Exact:  To test an axis-aligned bbox exactly, first test it as above,
+///         then look for a separating axis among the box axes and the
+///         cross products of the box axes with the frustum edges. The
+///         projections of the frustum onto these axes are computed by
+///         FrustumExactTest. (the result is exact, up to rounding.)
+///
 ///
 /// SPECIAL NOTE: "Where are the dot products?"
 ///     Actual dot products are currently slow for most SIMD architectures.
@@ -81,6 +151,11 @@ IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
 ///     In order to do this, the plane equations are stored in "transpose"
 ///     form, with the X components grouped into an X vector, etc.
 ///
+/// Batches: The batched tests compute the same plane distances, in the
+///     same order, for one register's worth of spheres or boxes at a
+///     time, with SSE, AVX or NEON instructions where available. Their
+///     results are those of the single-object tests.
+///
 
 template <class T> class IMATH_EXPORT_TEMPLATE_TYPE FrustumTest
 {
@@ -153,6 +228,104 @@ public:
 
     /// @}
 
+    /// @{
+    /// @name Hierarchical Query
+    ///
+    /// These test only some of the six planes of the frustum, so that
+    /// the children of a bounding volume in a hierarchy skip the planes
+    /// their parent is already completely inside. Bit k of a plane
+    /// mask stands for plane k; `allPlanes` selects all of them.
+    ///
+    /// On entry, `planeMask` holds the planes to test: `allPlanes` for
+    /// the root of the hierarchy, and the mask returned for the parent
+    /// for any other volume. If the sphere or box is visible, the
+    /// functions return true and clear the bits of the planes it is
+    /// completely inside, so that `planeMask` is 0 if the sphere or
+    /// box is completely inside the frustum. Otherwise they return
+    /// false and leave `planeMask` unchanged.
+    ///
+    /// `lastPlane`, if given, is a coherency hint: the plane, from 0
+    /// to 5, to test first; other values are ignored. When a sphere or
+    /// box is not visible, it is set to the plane that rejected it,
+    /// which from one frame to the next is likely to reject it again.
+    /// Store it with each volume, initialized to 0.
+    ///
+    /// With `planeMask` set to `allPlanes`, the results are those of
+    /// isVisible() and completelyContains().
+
+    /// A plane mask that selects all six planes
+    static const unsigned allPlanes = 0x3f;
+
+    /// Return true if any part of the sphere is inside the planes of
+    /// `planeMask`, and clear the planes it is completely inside.
+    bool isVisible (const Sphere3<T>& sphere, unsigned& planeMask) const
+        IMATH_NOEXCEPT;
+
+    /// Return true if any part of the sphere is inside the planes of
+    /// `planeMask`, testing plane `lastPlane` first.
+    bool isVisible (
+        const Sphere3<T>& sphere,
+        unsigned&         planeMask,
+        unsigned&         lastPlane) const IMATH_NOEXCEPT;
+
+    /// Return true if any part of the box is inside the planes of
+    /// `planeMask`, and clear the planes it is completely inside.
+    bool isVisible (const Box<Vec3<T>>& box, unsigned& planeMask) const
+        IMATH_NOEXCEPT;
+
+    /// Return true if any part of the box is inside the planes of
+    /// `planeMask`, testing plane `lastPlane` first.
+    bool isVisible (
+        const Box<Vec3<T>>& box,
+        unsigned&           planeMask,
+        unsigned&           lastPlane) const IMATH_NOEXCEPT;
+
+    /// @}
+
+    /// @{
+    /// @name Batched Query
+    ///
+    /// Test `centers.size()` spheres, given by their centers and radii,
+    /// or boxes, given by their centers and extents, with the same
+    /// results as isVisible() for each sphere or box. A box with a
+    /// negative extent is empty, and not visible.
+
+    /// Set bit `i % 64` of `visible[i / 64]` if sphere `i` is visible,
+    /// and clear it otherwise. `visible` must hold
+    /// `(centers.size() + 63) / 64` words; the unused bits of the last
+    /// word are cleared.
+    void isVisible (
+        const Vec3Array<T>& centers,
+        const T*            radii,
+        uint64_t*           visible) const IMATH_NOEXCEPT;
+
+    /// Set bit `i % 64` of `visible[i / 64]` if box `i` is visible,
+    /// and clear it otherwise. `visible` must hold
+    /// `(centers.size() + 63) / 64` words; the unused bits of the last
+    /// word are cleared.
+    void isVisible (
+        const Vec3Array<T>& centers,
+        const Vec3Array<T>& extents,
+        uint64_t*           visible) const IMATH_NOEXCEPT;
+
+    /// Write the indices of the visible spheres, in increasing order,
+    /// to `indices`, and return their number. `indices` must hold
+    /// `centers.size()` values, which must be less than 2^32.
+    size_t visibleIndices (
+        const Vec3Array<T>& centers,
+        const T*            radii,
+        uint32_t*           indices) const IMATH_NOEXCEPT;
+
+    /// Write the indices of the visible boxes, in increasing order, to
+    /// `indices`, and return their number. `indices` must hold
+    /// `centers.size()` values, which must be less than 2^32.
+    size_t visibleIndices (
+        const Vec3Array<T>& centers,
+        const Vec3Array<T>& extents,
+        uint32_t*           indices) const IMATH_NOEXCEPT;
+
+    /// @}
+
 protected:
     // To understand why the planes are stored this way, see
     // the SPECIAL NOTE above.
@@ -174,6 +347,21 @@ protected:
     Frustum<T>  currFrustum;
     Matrix44<T> cameraMatrix;
 
+    // The planes, one array per component, for the batched tests.
+    void planes (FrustumTestDetail::Planes<T>& p) const IMATH_NOEXCEPT;
+
+    // Test a sphere, given by its center and radius, or a box, given
+    // by its center and extent, against plane k for the hierarchical
+    // tests: return false if it is outside, and otherwise clear bit k
+    // of mask if it is completely inside.
+    bool testPlane (unsigned k, const Vec3<T>& center, T radius, unsigned& mask)
+        const IMATH_NOEXCEPT;
+    bool testPlane (
+        unsigned       k,
+        const Vec3<T>& center,
+        const Vec3<T>& extent,
+        unsigned&      mask) const IMATH_NOEXCEPT;
+
     /// @endcond
 };
 
@@ -222,6 +410,7 @@ FrustumTest<T>::setFrustum (
             frustumPlanes[index + 1].distance,
             frustumPlanes[index + 2].distance);
     }
+
     currFrustum  = frustum;
     cameraMatrix = cameraMat;
 }
@@ -342,12 +531,869 @@ FrustumTest<T>::isVisible (const Vec3<T>& vec) const IMATH_NOEXCEPT
     return true;
 }
 
+template <class T> const unsigned FrustumTest<T>::allPlanes;
+
+template <typename T>
+inline bool
+FrustumTest<T>::testPlane (
+    unsigned k, const Vec3<T>& center, T radius, unsigned& mask) const
+    IMATH_NOEXCEPT
+{
+    const int i = k / 3;
+    const int j = k % 3;
+
+    // The same arithmetic as isVisible() and completelyContains()
+    const T d = planeNormX[i][j] * center.x + planeNormY[i][j] * center.y +
+                planeNormZ[i][j] * center.z;
+
+    if (d - radius - planeOffsetVec[i][j] >= 0) return false;
+
+    if (d + radius - planeOffsetVec[i][j] < 0) mask &= ~(1u << k);
+
+    return true;
+}
+
+template <typename T>
+inline bool
+FrustumTest<T>::testPlane (
+    unsigned       k,
+    const Vec3<T>& center,
+    const Vec3<T>& extent,
+    unsigned&      mask) const IMATH_NOEXCEPT
+{
+    const int i = k / 3;
+    const int j = k % 3;
+
+    // The same arithmetic as isVisible() and completelyContains()
+    const T d = planeNormX[i][j] * center.x + planeNormY[i][j] * center.y +
+                planeNormZ[i][j] * center.z;
+
+    if (d - planeNormAbsX[i][j] * extent.x - planeNormAbsY[i][j] * extent.y -
+            planeNormAbsZ[i][j] * extent.z - planeOffsetVec[i][j] >=
+        0)
+        return false;
+
+    if (d + planeNormAbsX[i][j] * extent.x + planeNormAbsY[i][j] * extent.y +
+            planeNormAbsZ[i][j] * extent.z - planeOffsetVec[i][j] <
+        0)
+        mask &= ~(1u << k);
+
+    return true;
+}
+
+template <typename T>
+bool
+FrustumTest<T>::isVisible (const Sphere3<T>& sphere, unsigned& planeMask) const
+    IMATH_NOEXCEPT
+{
+    unsigned lastPlane = 0;
+    return isVisible (sphere, planeMask, lastPlane);
+}
+
+template <typename T>
+bool
+FrustumTest<T>::isVisible (
+    const Sphere3<T>& sphere,
+    unsigned&         planeMask,
+    unsigned&         lastPlane) const IMATH_NOEXCEPT
+{
+    unsigned mask = planeMask;
+
+    if (lastPlane < 6 && (mask >> lastPlane & 1) &&
+        !testPlane (lastPlane, sphere.center, sphere.radius, mask))
+        return false;
+
+    for (unsigned k = 0; k < 6; ++k)
+    {
+        if (k == lastPlane || !(mask >> k & 1)) continue;
+
+        if (!testPlane (k, sphere.center, sphere.radius, mask))
+        {
+            lastPlane = k;
+            return false;
+        }
+    }
+
+    planeMask = mask;
+    return true;
+}
+
+template <typename T>
+bool
+FrustumTest<T>::isVisible (const Box<Vec3<T>>& box, unsigned& planeMask) const
+    IMATH_NOEXCEPT
+{
+    unsigned lastPlane = 0;
+    return isVisible (box, planeMask, lastPlane);
+}
+
+template <typename T>
+bool
+FrustumTest<T>::isVisible (
+    const Box<Vec3<T>>& box,
+    unsigned&           planeMask,
+    unsigned&           lastPlane) const IMATH_NOEXCEPT
+{
+    if (box.isEmpty ()) return false;
+
+    Vec3<T> center = (box.min + box.max) / 2;
+    Vec3<T> extent = (box.max - center);
+
+    unsigned mask = planeMask;
+
+    if (lastPlane < 6 && (mask >> lastPlane & 1) &&
+        !testPlane (lastPlane, center, extent, mask))
+        return false;
+
+    for (unsigned k = 0; k < 6; ++k)
+    {
+        if (k == lastPlane || !(mask >> k & 1)) continue;
+
+        if (!testPlane (k, center, extent, mask))
+        {
+            lastPlane = k;
+            return false;
+        }
+    }
+
+    planeMask = mask;
+    return true;
+}
+
+/// @cond Doxygen_Suppress
+
+namespace FrustumTestDetail
+{
+
+//
+// The radii of the spheres, or the extents of the boxes, for the
+// batched tests.
+//
+
+template <class T> struct Spheres
+{
+    const T* radius;
+};
+
+template <class T> struct Boxes
+{
+    const T* x;
+    const T* y;
+    const T* z;
+};
+
+//
+// Return true if sphere or box i is outside one of the planes. These
+// perform the same arithmetic operations, in the same order, as
+// FrustumTest::isVisible().
+//
+
+template <class T>
+inline bool
+outsideScalar (
+    const Planes<T>&    p,
+    const Vec3Array<T>& c,
+    const Spheres<T>&   s,
+    size_t              i) IMATH_NOEXCEPT
+{
+    const T x = c.x ()[i];
+    const T y = c.y ()[i];
+    const T z = c.z ()[i];
+    const T r = s.radius[i];
+
+    for (int k = 0; k < 6; ++k)
+    {
+        T d = p.normX[k] * x + p.normY[k] * y + p.normZ[k] * z - r -
+              p.offset[k];
+
+        if (d >= 0) return true;
+    }
+
+    return false;
+}
+
+template <class T>
+inline bool
+outsideScalar (
+    const Planes<T>&    p,
+    const Vec3Array<T>& c,
+    const Boxes<T>&     b,
+    size_t              i) IMATH_NOEXCEPT
+{
+    const T x  = c.x ()[i];
+    const T y  = c.y ()[i];
+    const T z  = c.z ()[i];
+    const T ex = b.x[i];
+    const T ey = b.y[i];
+    const T ez = b.z[i];
+
+    if (ex < 0 || ey < 0 || ez < 0) return true;
+
+    for (int k = 0; k < 6; ++k)
+    {
+        T d = p.normX[k] * x + p.normY[k] * y + p.normZ[k] * z -
+              p.normAbsX[k] * ex - p.normAbsY[k] * ey - p.normAbsZ[k] * ez -
+              p.offset[k];
+
+        if (d >= 0) return true;
+    }
+
+    return false;
+}
+
+//
+// Return true if one of the axes separates the box, given by its center
+// and extent, from the frustum.
+//
+
+template <class T>
+inline bool
+separated (
+    const Axes<T>& a, T cx, T cy, T cz, T ex, T ey, T ez) IMATH_NOEXCEPT
+{
+    int s = 0;
+
+    for (int k = 0; k < Axes<T>::count; ++k)
+    {
+        const T c = a.x[k] * cx + a.y[k] * cy + a.z[k] * cz;
+        const T r = a.absX[k] * ex + a.absY[k] * ey + a.absZ[k] * ez;
+
+        s |= (c - r > a.max[k]) | (c + r < a.min[k]);
+    }
+
+    return s != 0;
+}
+
+#if defined(IMATH_MATRIX_SIMD)
+
+using MatrixDetail::add;
+using MatrixDetail::bits;
+using MatrixDetail::either;
+using MatrixDetail::greaterEqual;
+using MatrixDetail::less;
+using MatrixDetail::load;
+using MatrixDetail::Mask;
+using MatrixDetail::mul;
+using MatrixDetail::splat;
+using MatrixDetail::sub;
+
+//
+// The register versions of outsideScalar(), for the spheres or boxes
+// [i, i + width), where width is the number of lanes of V. Bit j of
+// the result is set if sphere or box i + j is outside.
+//
+
+template <class V, class T>
+inline unsigned
+outsideVector (
+    const Planes<T>&    p,
+    const Vec3Array<T>& c,
+    const Spheres<T>&   s,
+    size_t              i) IMATH_NOEXCEPT
+{
+    V x, y, z, r, zero;
+    load (c.x () + i, x);
+    load (c.y () + i, y);
+    load (c.z () + i, z);
+    load (s.radius + i, r);
+    splat (T (0), zero);
+
+    // No sphere is outside yet
+    typename Mask<V>::Type m = less (zero, zero);
+
+    for (int k = 0; k < 6; ++k)
+    {
+        V nx, ny, nz, offset;
+        splat (p.normX[k], nx);
+        splat (p.normY[k], ny);
+        splat (p.normZ[k], nz);
+        splat (p.offset[k], offset);
+
+        V d = sub (
+            sub (add (add (mul (nx, x), mul (ny, y)), mul (nz, z)), r),
+            offset);
+
+        m = either (m, greaterEqual (d, zero));
+    }
+
+    return bits (m);
+}
+
+template <class V, class T>
+inline unsigned
+outsideVector (
+    const Planes<T>&    p,
+    const Vec3Array<T>& c,
+    const Boxes<T>&     b,
+    size_t              i) IMATH_NOEXCEPT
+{
+    V x, y, z, ex, ey, ez, zero;
+    load (c.x () + i, x);
+    load (c.y () + i, y);
+    load (c.z () + i, z);
+    load (b.x + i, ex);
+    load (b.y + i, ey);
+    load (b.z + i, ez);
+    splat (T (0), zero);
+
+    typename Mask<V>::Type m =
+        either (either (less (ex, zero), less (ey, zero)), less (ez, zero));
+
+    for (int k = 0; k < 6; ++k)
+    {
+        V nx, ny, nz, ax, ay, az, offset;
+        splat (p.normX[k], nx);
+        splat (p.normY[k], ny);
+        splat (p.normZ[k], nz);
+        splat (p.normAbsX[k], ax);
+        splat (p.normAbsY[k], ay);
+        splat (p.normAbsZ[k], az);
+        splat (p.offset[k], offset);
+
+        V d = add (add (mul (nx, x), mul (ny, y)), mul (nz, z));
+        d   = sub (sub (sub (d, mul (ax, ex)), mul (ay, ey)), mul (az, ez));
+        d   = sub (d, offset);
+
+        m = either (m, greaterEqual (d, zero));
+    }
+
+    return bits (m);
+}
+
+#endif
+
+//
+// Return bit j set if sphere or box begin + j is outside, for j in
+// [0, end - begin), where end - begin is at most 64.
+//
+
+template <class T, class Shape>
+inline uint64_t
+outside (
+    const Planes<T>&    p,
+    const Vec3Array<T>& c,
+    const Shape&        s,
+    size_t              begin,
+    size_t              end) IMATH_NOEXCEPT
+{
+    uint64_t m = 0;
+
+    for (size_t i = begin; i < end; ++i)
+        m |= uint64_t (outsideScalar (p, c, s, i)) << (i - begin);
+
+    return m;
+}
+
+#if defined(IMATH_MATRIX_SIMD)
+
+template <class V, class T, class Shape>
+inline uint64_t
+outsideSimd (
+    const Planes<T>&    p,
+    const Vec3Array<T>& c,
+    const Shape&        s,
+    size_t              begin,
+    size_t              end) IMATH_NOEXCEPT
+{
+    const size_t width = sizeof (V) / sizeof (T);
+
+    uint64_t m = 0;
+    size_t   i = begin;
+
+    for (; i + width <= end; i += width)
+        m |= uint64_t (outsideVector<V> (p, c, s, i)) << (i - begin);
+
+    for (; i < end; ++i)
+        m |= uint64_t (outsideScalar (p, c, s, i)) << (i - begin);
+
+    return m;
+}
+
+template <class Shape>
+inline uint64_t
+outside (
+    const Planes<float>&    p,
+    const Vec3Array<float>& c,
+    const Shape&            s,
+    size_t                  begin,
+    size_t                  end) IMATH_NOEXCEPT
+{
+#    if defined(__AVX__)
+    return outsideSimd<__m256> (p, c, s, begin, end);
+#    elif defined(IMATH_MATRIX_SSE2)
+    return outsideSimd<__m128> (p, c, s, begin, end);
+#    else
+    return outsideSimd<float32x4_t> (p, c, s, begin, end);
+#    endif
+}
+
+template <class Shape>
+inline uint64_t
+outside (
+    const Planes<double>&    p,
+    const Vec3Array<double>& c,
+    const Shape&             s,
+    size_t                   begin,
+    size_t                   end) IMATH_NOEXCEPT
+{
+#    if defined(__AVX__)
+    return outsideSimd<__m256d> (p, c, s, begin, end);
+#    elif defined(IMATH_MATRIX_SSE2)
+    return outsideSimd<__m128d> (p, c, s, begin, end);
+#    else
+    return outsideSimd<float64x2_t> (p, c, s, begin, end);
+#    endif
+}
+
+//
+// separated() for one box, testing one register's worth of axes at a
+// time.
+//
+
+template <class V, class T>
+inline bool
+separatedSimd (
+    const Axes<T>& a, T cx, T cy, T cz, T ex, T ey, T ez) IMATH_NOEXCEPT
+{
+    const int width = sizeof (V) / sizeof (T);
+
+    V x, y, z, ax, ay, az;
+    splat (cx, x);
+    splat (cy, y);
+    splat (cz, z);
+    splat (ex, ax);
+    splat (ey, ay);
+    splat (ez, az);
+
+    typename Mask<V>::Type m = less (x, x);
+
+    for (int k = 0; k < Axes<T>::count; k += width)
+    {
+        V nx, ny, nz, mx, my, mz, lo, hi;
+        load (a.x + k, nx);
+        load (a.y + k, ny);
+        load (a.z + k, nz);
+        load (a.absX + k, mx);
+        load (a.absY + k, my);
+        load (a.absZ + k, mz);
+        load (a.min + k, lo);
+        load (a.max + k, hi);
+
+        V c = add (add (mul (nx, x), mul (ny, y)), mul (nz, z));
+        V r = add (add (mul (mx, ax), mul (my, ay)), mul (mz, az));
+
+        m = either (m, either (less (hi, sub (c, r)), less (add (c, r), lo)));
+    }
+
+    return bits (m) != 0;
+}
+
+inline bool
+separated (
+    const Axes<float>& a,
+    float              cx,
+    float              cy,
+    float              cz,
+    float              ex,
+    float              ey,
+    float              ez) IMATH_NOEXCEPT
+{
+#    if defined(__AVX__)
+    return separatedSimd<__m256> (a, cx, cy, cz, ex, ey, ez);
+#    elif defined(IMATH_MATRIX_SSE2)
+    return separatedSimd<__m128> (a, cx, cy, cz, ex, ey, ez);
+#    else
+    return separatedSimd<float32x4_t> (a, cx, cy, cz, ex, ey, ez);
+#    endif
+}
+
+inline bool
+separated (
+    const Axes<double>& a,
+    double              cx,
+    double              cy,
+    double              cz,
+    double              ex,
+    double              ey,
+    double              ez) IMATH_NOEXCEPT
+{
+#    if defined(__AVX__)
+    return separatedSimd<__m256d> (a, cx, cy, cz, ex, ey, ez);
+#    elif defined(IMATH_MATRIX_SSE2)
+    return separatedSimd<__m128d> (a, cx, cy, cz, ex, ey, ez);
+#    else
+    return separatedSimd<float64x2_t> (a, cx, cy, cz, ex, ey, ez);
+#    endif
+}
+
+#endif
+
+//
+// The visibility bits of 64 spheres or boxes at a time, as a bit mask
+// or as a list of indices.
+//
+
+template <class T, class Shape>
+inline void
+visibleBits (
+    const Planes<T>&    p,
+    const Vec3Array<T>& c,
+    const Shape&        s,
+    uint64_t*           visible) IMATH_NOEXCEPT
+{
+    const size_t n = c.size ();
+
+    for (size_t begin = 0; begin < n; begin += 64)
+    {
+        const size_t end   = n - begin < 64 ? n : begin + 64;
+        const size_t count = end - begin;
+
+        const uint64_t all =
+            count == 64 ? ~uint64_t (0) : (uint64_t (1) << count) - 1;
+
+        visible[begin / 64] = ~outside (p, c, s, begin, end) & all;
+    }
+}
+
+template <class T, class Shape>
+inline size_t
+visibleIndices (
+    const Planes<T>&    p,
+    const Vec3Array<T>& c,
+    const Shape&        s,
+    uint32_t*           indices) IMATH_NOEXCEPT
+{
+    const size_t n     = c.size ();
+    size_t       count = 0;
+
+    for (size_t begin = 0; begin < n; begin += 64)
+    {
+        const size_t   end = n - begin < 64 ? n : begin + 64;
+        const uint64_t out = outside (p, c, s, begin, end);
+
+        //
+        // Write every index, but advance only past the visible ones.
+        // count never exceeds the index being written, so the writes
+        // stay within the n values of indices.
+        //
+
+        for (size_t i = begin; i < end; ++i)
+        {
+            indices[count] = uint32_t (i);
+            count += size_t (~out >> (i - begin) & 1);
+        }
+    }
+
+    return count;
+}
+
+} // namespace FrustumTestDetail
+
+/// @endcond
+
+template <class T>
+void
+FrustumTest<T>::planes (FrustumTestDetail::Planes<T>& p) const IMATH_NOEXCEPT
+{
+    for (int k = 0; k < 6; ++k)
+    {
+        p.normX[k]    = planeNormX[k / 3][k % 3];
+        p.normY[k]    = planeNormY[k / 3][k % 3];
+        p.normZ[k]    = planeNormZ[k / 3][k % 3];
+        p.normAbsX[k] = planeNormAbsX[k / 3][k % 3];
+        p.normAbsY[k] = planeNormAbsY[k / 3][k % 3];
+        p.normAbsZ[k] = planeNormAbsZ[k / 3][k % 3];
+        p.offset[k]   = planeOffsetVec[k / 3][k % 3];
+    }
+}
+
+template <typename T>
+void
+FrustumTest<T>::isVisible (
+    const Vec3Array<T>& centers,
+    const T*            radii,
+    uint64_t*           visible) const IMATH_NOEXCEPT
+{
+    FrustumTestDetail::Planes<T> p;
+    planes (p);
+
+    const FrustumTestDetail::Spheres<T> s = {radii};
+    FrustumTestDetail::visibleBits (p, centers, s, visible);
+}
+
+template <typename T>
+void
+FrustumTest<T>::isVisible (
+    const Vec3Array<T>& centers,
+    const Vec3Array<T>& extents,
+    uint64_t*           visible) const IMATH_NOEXCEPT
+{
+    FrustumTestDetail::Planes<T> p;
+    planes (p);
+
+    const FrustumTestDetail::Boxes<T> b = {
+        extents.x (), extents.y (), extents.z ()};
+    FrustumTestDetail::visibleBits (p, centers, b, visible);
+}
+
+template <typename T>
+size_t
+FrustumTest<T>::visibleIndices (
+    const Vec3Array<T>& centers,
+    const T*            radii,
+    uint32_t*           indices) const IMATH_NOEXCEPT
+{
+    FrustumTestDetail::Planes<T> p;
+    planes (p);
+
+    const FrustumTestDetail::Spheres<T> s = {radii};
+    return FrustumTestDetail::visibleIndices (p, centers, s, indices);
+}
+
+template <typename T>
+size_t
+FrustumTest<T>::visibleIndices (
+    const Vec3Array<T>& centers,
+    const Vec3Array<T>& extents,
+    uint32_t*           indices) const IMATH_NOEXCEPT
+{
+    FrustumTestDetail::Planes<T> p;
+    planes (p);
+
+    const FrustumTestDetail::Boxes<T> b = {
+        extents.x (), extents.y (), extents.z ()};
+    return FrustumTestDetail::visibleIndices (p, centers, b, indices);
+}
+
+///
+/// template class FrustumExactTest<T>
+///
+/// An exact visibility test for boxes, built from a FrustumTest. The
+/// boxes that FrustumTest::isVisible() accepts are tested again with
+/// the separating axis theorem, against the box axes and the cross
+/// products of the box axes with the frustum edges, which rejects the
+/// boxes near the edges and corners of the frustum that are in fact
+/// outside it. The axes and the projections of the frustum onto them
+/// take about 1 KiB (float) or 2 KiB (double), so they are kept here
+/// rather than in FrustumTest, and computed only by the code that
+/// needs them.
+///
+/// How to use this
+///
+/// Given a FrustumTest, make an exact test object:
+///    FrustumExactTest myExactTest(myFrustumTest)
+///
+/// Whenever the frustum test changes, call:
+///    myExactTest.setFrustumTest(myFrustumTest)
+///
+/// For each box you want to test for visibility, call:
+///    myExactTest.isVisible(myBox)
+///
+/// To remove the invisible boxes from the output of
+/// FrustumTest::visibleIndices(), call:
+///    myExactTest.refineVisibleIndices(centers, extents, indices, count)
+///
+
+template <class T> class IMATH_EXPORT_TEMPLATE_TYPE FrustumExactTest
+{
+public:
+    /// @{
+    /// @name Constructors
+
+    /// Initialize to the frustum of a default FrustumTest
+    FrustumExactTest () IMATH_NOEXCEPT { setFrustumTest (FrustumTest<T> ()); }
+
+    /// Initialize to the frustum of `frustumTest`
+    explicit FrustumExactTest (const FrustumTest<T>& frustumTest)
+        IMATH_NOEXCEPT
+    {
+        setFrustumTest (frustumTest);
+    }
+
+    /// @}
+
+    /// @{
+    /// @name Set Value
+
+    /// Update the exact test with a new frustum test. This should be
+    /// called whenever setFrustum() is called on the frustum test.
+    void setFrustumTest (const FrustumTest<T>& frustumTest) IMATH_NOEXCEPT;
+
+    /// @}
+
+    /// @{
+    /// @name Query
+
+    /// Return true if any part of the box is inside the frustum.
+    /// The result is exact, up to rounding.
+    bool isVisible (const Box<Vec3<T>>& box) const IMATH_NOEXCEPT;
+
+    /// Remove from the first `count` values of `indices`, which must
+    /// come from FrustumTest::visibleIndices(), the boxes that
+    /// isVisible() rejects, and return the number of indices left, in
+    /// the same order.
+    size_t refineVisibleIndices (
+        const Vec3Array<T>& centers,
+        const Vec3Array<T>& extents,
+        uint32_t*           indices,
+        size_t              count) const IMATH_NOEXCEPT;
+
+    /// Return the frustum test the exact test was built from
+    const FrustumTest<T>& frustumTest () const IMATH_NOEXCEPT
+    {
+        return conservativeTest;
+    }
+
+    /// @}
+
+protected:
+    /// @cond Doxygen_Suppress
+
+    // The test that the exact test refines
+    FrustumTest<T> conservativeTest;
+
+    // The separating axes, and the projections of the frustum onto
+    // them
+    FrustumTestDetail::Axes<T> separatingAxes;
+
+    /// @endcond
+};
+
+template <class T>
+void
+FrustumExactTest<T>::setFrustumTest (const FrustumTest<T>& frustumTest)
+    IMATH_NOEXCEPT
+{
+    const Frustum<T>  frustum   = frustumTest.currentFrustum ();
+    const Matrix44<T> cameraMat = frustumTest.cameraMat ();
+
+    Plane3<T> frustumPlanes[6];
+    frustum.planes (frustumPlanes, cameraMat);
+
+    // The corners of the frustum, computed as in Frustum::planes(),
+    // near corners first, and the directions of its edges.
+    const double s = frustum.orthographic ()
+                         ? 1.0
+                         : frustum.farPlane () / double (frustum.nearPlane ());
+
+    Vec3<T> corners[8];
+    for (int i = 0; i < 4; ++i)
+    {
+        const T x = (i & 1) ? frustum.right () : frustum.left ();
+        const T y = (i & 2) ? frustum.top () : frustum.bottom ();
+
+        corners[i]     = Vec3<T> (x, y, -frustum.nearPlane ()) * cameraMat;
+        corners[i + 4] =
+            Vec3<T> (T (s * x), T (s * y), -frustum.farPlane ()) * cameraMat;
+    }
+
+    const Vec3<T> edges[6] = {
+        corners[1] - corners[0],
+        corners[2] - corners[0],
+        corners[4] - corners[0],
+        corners[5] - corners[1],
+        corners[6] - corners[2],
+        corners[7] - corners[3]};
+
+    Vec3<T> axes[FrustumTestDetail::Axes<T>::count];
+    for (int k = 0; k < FrustumTestDetail::Axes<T>::count; ++k)
+        axes[k] = Vec3<T> (0, 0, 0);
+
+    for (int k = 0; k < 6; ++k)
+        axes[k] = frustumPlanes[k].normal;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        Vec3<T> e (0, 0, 0);
+        e[i] = 1;
+
+        axes[6 + i] = e;
+        for (int j = 0; j < 6; ++j)
+            axes[9 + 6 * i + j] = e % edges[j];
+    }
+
+    FrustumTestDetail::Axes<T>& a = separatingAxes;
+    for (int k = 0; k < FrustumTestDetail::Axes<T>::count; ++k)
+    {
+        a.x[k]    = axes[k].x;
+        a.y[k]    = axes[k].y;
+        a.z[k]    = axes[k].z;
+        a.absX[k] = std::abs (axes[k].x);
+        a.absY[k] = std::abs (axes[k].y);
+        a.absZ[k] = std::abs (axes[k].z);
+        a.min[k]  = a.max[k] = axes[k] ^ corners[0];
+
+        for (int i = 1; i < 8; ++i)
+        {
+            const T d = axes[k] ^ corners[i];
+            if (d < a.min[k]) a.min[k] = d;
+            if (d > a.max[k]) a.max[k] = d;
+        }
+    }
+
+    conservativeTest = frustumTest;
+}
+
+template <typename T>
+bool
+FrustumExactTest<T>::isVisible (const Box<Vec3<T>>& box) const IMATH_NOEXCEPT
+{
+    if (!conservativeTest.isVisible (box)) return false;
+
+    Vec3<T> center = (box.min + box.max) / 2;
+    Vec3<T> extent = (box.max - center);
+
+    return !FrustumTestDetail::separated (
+        separatingAxes,
+        center.x,
+        center.y,
+        center.z,
+        extent.x,
+        extent.y,
+        extent.z);
+}
+
+template <typename T>
+size_t
+FrustumExactTest<T>::refineVisibleIndices (
+    const Vec3Array<T>& centers,
+    const Vec3Array<T>& extents,
+    uint32_t*           indices,
+    size_t              count) const IMATH_NOEXCEPT
+{
+    const T* cx = centers.x ();
+    const T* cy = centers.y ();
+    const T* cz = centers.z ();
+    const T* ex = extents.x ();
+    const T* ey = extents.y ();
+    const T* ez = extents.z ();
+
+    size_t n = 0;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const uint32_t k = indices[i];
+        indices[n]       = k;
+
+        n += !FrustumTestDetail::separated (
+            separatingAxes, cx[k], cy[k], cz[k], ex[k], ey[k], ez[k]);
+    }
+
+    return n;
+}
+
 /// FrustymTest of type float
 typedef FrustumTest<float> FrustumTestf;
 
 /// FrustymTest of type double
 typedef FrustumTest<double> FrustumTestd;
 
+/// FrustumExactTest of type float
+typedef FrustumExactTest<float> FrustumExactTestf;
+
+/// FrustumExactTest of type double
+typedef FrustumExactTest<double> FrustumExactTestd;
+
 IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
 
 #endif // INCLUDED_IMATHFRUSTUMTEST_H
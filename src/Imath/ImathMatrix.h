@@ -24,6 +24,47 @@
 #include <limits>
 #include <string.h>
 
+//
+// The vector kernels need SSE2, or AVX where the code is compiled for
+// it. Only the header for the instruction set in use is included,
+// since <immintrin.h> is much larger than <emmintrin.h>.
+//
+
+#if !defined(__CUDACC__) &&                                                    \
+    (defined(__SSE2__) || defined(_M_X64) ||                                   \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#    if defined(__AVX__)
+#        include <immintrin.h>
+#    else
+#        include <emmintrin.h>
+#    endif
+#    define IMATH_MATRIX_SSE2
+#elif !defined(__CUDACC__) && defined(__ARM_NEON) && defined(__aarch64__)
+#    include <arm_neon.h>
+#    define IMATH_MATRIX_NEON
+#endif
+
+#if defined(IMATH_MATRIX_SSE2) || defined(IMATH_MATRIX_NEON)
+#    define IMATH_MATRIX_SIMD
+#endif
+
+//
+// The constexpr functions can use vector instructions only where the
+// compiler tells us whether they are being evaluated at compile time.
+//
+
+#if IMATH_CPLUSPLUS_VERSION < 14
+#    define IMATH_MATRIX_CONSTANT_EVALUATED() false
+#elif defined(__clang__)
+#    if __has_builtin(__builtin_is_constant_evaluated)
+#        define IMATH_MATRIX_CONSTANT_EVALUATED()                              \
+            __builtin_is_constant_evaluated ()
+#    endif
+#elif (defined(__GNUC__) && __GNUC__ >= 9) ||                                  \
+    (defined(_MSC_VER) && _MSC_VER >= 1925)
+#    define IMATH_MATRIX_CONSTANT_EVALUATED() __builtin_is_constant_evaluated ()
+#endif
+
 #if (defined _WIN32 || defined _WIN64) && defined _MSC_VER
 // suppress exception specification warnings
 #    pragma warning(disable : 4290)
@@ -1093,6 +1134,39 @@ public:
     IMATH_HOSTDEVICE void
     multDirMatrix (const Vec3<S>& src, Vec3<S>& dst) const IMATH_NOEXCEPT;
 
+    /// Vector-matrix multiplication of `n` points, equivalent to calling
+    /// `multVecMatrix (src[i], dst[i])` for each point. `src` and `dst`
+    /// may be the same array, but must not otherwise overlap.
+    /// @param[in] src The input points
+    /// @param[out] dst The output points
+    /// @param[in] n The number of points
+    template <class S>
+    void multVecMatrix (const Vec3<S>* src, Vec3<S>* dst, size_t n) const
+        IMATH_NOEXCEPT;
+
+    /// Vector-matrix multiplication of `n` points by an affine matrix,
+    /// i.e. one whose last column is (0 0 0 1). This is multVecMatrix()
+    /// without the division by the homogeneous coordinate, and gives the
+    /// same results for affine matrices.
+    /// @param[in] src The input points
+    /// @param[out] dst The output points
+    /// @param[in] n The number of points
+    template <class S>
+    void
+    multVecMatrixAffine (const Vec3<S>* src, Vec3<S>* dst, size_t n) const
+        IMATH_NOEXCEPT;
+
+    /// Vector-matrix multiplication of `n` directions, equivalent to
+    /// calling `multDirMatrix (src[i], dst[i])` for each direction.
+    /// `src` and `dst` may be the same array, but must not otherwise
+    /// overlap.
+    /// @param[in] src The input directions
+    /// @param[out] dst The output directions
+    /// @param[in] n The number of directions
+    template <class S>
+    void multDirMatrix (const Vec3<S>* src, Vec3<S>* dst, size_t n) const
+        IMATH_NOEXCEPT;
+
     /// @}
 
     /// @{
@@ -3954,272 +4028,1715 @@ operator* (T a, const Matrix44<T>& v) IMATH_NOEXCEPT
     return v * a;
 }
 
-template <class T>
-IMATH_HOSTDEVICE inline IMATH_CONSTEXPR14 Matrix44<T>
-Matrix44<T>::multiply (const Matrix44& a, const Matrix44& b) IMATH_NOEXCEPT
-{
-    const auto a00 = a.x[0][0];
-    const auto a01 = a.x[0][1];
-    const auto a02 = a.x[0][2];
-    const auto a03 = a.x[0][3];
-
-    const auto c00 =
-        a00 * b.x[0][0] + a01 * b.x[1][0] + a02 * b.x[2][0] + a03 * b.x[3][0];
-    const auto c01 =
-        a00 * b.x[0][1] + a01 * b.x[1][1] + a02 * b.x[2][1] + a03 * b.x[3][1];
-    const auto c02 =
-        a00 * b.x[0][2] + a01 * b.x[1][2] + a02 * b.x[2][2] + a03 * b.x[3][2];
-    const auto c03 =
-        a00 * b.x[0][3] + a01 * b.x[1][3] + a02 * b.x[2][3] + a03 * b.x[3][3];
+#if defined(IMATH_MATRIX_SIMD)
 
-    const auto a10 = a.x[1][0];
-    const auto a11 = a.x[1][1];
-    const auto a12 = a.x[1][2];
-    const auto a13 = a.x[1][3];
+namespace MatrixDetail
+{
 
-    const auto c10 =
-        a10 * b.x[0][0] + a11 * b.x[1][0] + a12 * b.x[2][0] + a13 * b.x[3][0];
-    const auto c11 =
-        a10 * b.x[0][1] + a11 * b.x[1][1] + a12 * b.x[2][1] + a13 * b.x[3][1];
-    const auto c12 =
-        a10 * b.x[0][2] + a11 * b.x[1][2] + a12 * b.x[2][2] + a13 * b.x[3][2];
-    const auto c13 =
-        a10 * b.x[0][3] + a11 * b.x[1][3] + a12 * b.x[2][3] + a13 * b.x[3][3];
+//
+// Thin overloaded wrappers around the vector instructions, so that the
+// kernels below and the batched transformations can be written once for
+// all register types.
+//
 
-    const auto a20 = a.x[2][0];
-    const auto a21 = a.x[2][1];
-    const auto a22 = a.x[2][2];
-    const auto a23 = a.x[2][3];
+#    if defined(IMATH_MATRIX_SSE2)
 
-    const auto c20 =
-        a20 * b.x[0][0] + a21 * b.x[1][0] + a22 * b.x[2][0] + a23 * b.x[3][0];
-    const auto c21 =
-        a20 * b.x[0][1] + a21 * b.x[1][1] + a22 * b.x[2][1] + a23 * b.x[3][1];
-    const auto c22 =
-        a20 * b.x[0][2] + a21 * b.x[1][2] + a22 * b.x[2][2] + a23 * b.x[3][2];
-    const auto c23 =
-        a20 * b.x[0][3] + a21 * b.x[1][3] + a22 * b.x[2][3] + a23 * b.x[3][3];
+inline __m128
+add (__m128 a, __m128 b) IMATH_NOEXCEPT
+{
+    return _mm_add_ps (a, b);
+}
 
-    const auto a30 = a.x[3][0];
-    const auto a31 = a.x[3][1];
-    const auto a32 = a.x[3][2];
-    const auto a33 = a.x[3][3];
+inline __m128
+sub (__m128 a, __m128 b) IMATH_NOEXCEPT
+{
+    return _mm_sub_ps (a, b);
+}
 
-    const auto c30 =
-        a30 * b.x[0][0] + a31 * b.x[1][0] + a32 * b.x[2][0] + a33 * b.x[3][0];
-    const auto c31 =
-        a30 * b.x[0][1] + a31 * b.x[1][1] + a32 * b.x[2][1] + a33 * b.x[3][1];
-    const auto c32 =
-        a30 * b.x[0][2] + a31 * b.x[1][2] + a32 * b.x[2][2] + a33 * b.x[3][2];
-    const auto c33 =
-        a30 * b.x[0][3] + a31 * b.x[1][3] + a32 * b.x[2][3] + a33 * b.x[3][3];
-    return Matrix44 (
-        c00,
-        c01,
-        c02,
-        c03,
-        c10,
-        c11,
-        c12,
-        c13,
-        c20,
-        c21,
-        c22,
-        c23,
-        c30,
-        c31,
-        c32,
-        c33);
+inline __m128
+mul (__m128 a, __m128 b) IMATH_NOEXCEPT
+{
+    return _mm_mul_ps (a, b);
 }
 
-template <class T>
-IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline const Matrix44<T>&
-Matrix44<T>::operator*= (const Matrix44<T>& v) IMATH_NOEXCEPT
+inline __m128
+div (__m128 a, __m128 b) IMATH_NOEXCEPT
 {
-    *this = multiply (*this, v);
-    return *this;
+    return _mm_div_ps (a, b);
 }
 
-template <class T>
-IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline Matrix44<T>
-Matrix44<T>::operator* (const Matrix44<T>& v) const IMATH_NOEXCEPT
+inline void
+splat (float a, __m128& r) IMATH_NOEXCEPT
 {
-    return multiply (*this, v);
+    r = _mm_set1_ps (a);
 }
 
-template <class T>
-IMATH_HOSTDEVICE inline void
-Matrix44<T>::multiply (
-    const Matrix44<T>& a, const Matrix44<T>& b, Matrix44<T>& c) IMATH_NOEXCEPT
+inline __m128d
+add (__m128d a, __m128d b) IMATH_NOEXCEPT
 {
-    c = multiply (a, b);
+    return _mm_add_pd (a, b);
 }
 
-template <class T>
-template <class S>
-IMATH_HOSTDEVICE inline void
-Matrix44<T>::multVecMatrix (const Vec3<S>& src, Vec3<S>& dst) const
-    IMATH_NOEXCEPT
+inline __m128d
+sub (__m128d a, __m128d b) IMATH_NOEXCEPT
 {
-    S a, b, c, w;
+    return _mm_sub_pd (a, b);
+}
 
-    a = src.x * x[0][0] + src.y * x[1][0] + src.z * x[2][0] + x[3][0];
-    b = src.x * x[0][1] + src.y * x[1][1] + src.z * x[2][1] + x[3][1];
-    c = src.x * x[0][2] + src.y * x[1][2] + src.z * x[2][2] + x[3][2];
-    w = src.x * x[0][3] + src.y * x[1][3] + src.z * x[2][3] + x[3][3];
+inline __m128d
+mul (__m128d a, __m128d b) IMATH_NOEXCEPT
+{
+    return _mm_mul_pd (a, b);
+}
 
-    dst.x = a / w;
-    dst.y = b / w;
-    dst.z = c / w;
+inline __m128d
+div (__m128d a, __m128d b) IMATH_NOEXCEPT
+{
+    return _mm_div_pd (a, b);
 }
 
-template <class T>
-template <class S>
-IMATH_HOSTDEVICE inline void
-Matrix44<T>::multDirMatrix (const Vec3<S>& src, Vec3<S>& dst) const
-    IMATH_NOEXCEPT
+inline void
+splat (double a, __m128d& r) IMATH_NOEXCEPT
 {
-    S a, b, c;
+    r = _mm_set1_pd (a);
+}
 
-    a = src.x * x[0][0] + src.y * x[1][0] + src.z * x[2][0];
-    b = src.x * x[0][1] + src.y * x[1][1] + src.z * x[2][1];
-    c = src.x * x[0][2] + src.y * x[1][2] + src.z * x[2][2];
+#        if defined(__AVX__)
 
-    dst.x = a;
-    dst.y = b;
-    dst.z = c;
+inline __m256
+add (__m256 a, __m256 b) IMATH_NOEXCEPT
+{
+    return _mm256_add_ps (a, b);
 }
 
-template <class T>
-IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline const Matrix44<T>&
-Matrix44<T>::operator/= (T a) IMATH_NOEXCEPT
+inline __m256
+sub (__m256 a, __m256 b) IMATH_NOEXCEPT
 {
-    x[0][0] /= a;
-    x[0][1] /= a;
-    x[0][2] /= a;
-    x[0][3] /= a;
-    x[1][0] /= a;
-    x[1][1] /= a;
-    x[1][2] /= a;
-    x[1][3] /= a;
-    x[2][0] /= a;
-    x[2][1] /= a;
-    x[2][2] /= a;
-    x[2][3] /= a;
-    x[3][0] /= a;
-    x[3][1] /= a;
-    x[3][2] /= a;
-    x[3][3] /= a;
+    return _mm256_sub_ps (a, b);
+}
 
-    return *this;
+inline __m256
+mul (__m256 a, __m256 b) IMATH_NOEXCEPT
+{
+    return _mm256_mul_ps (a, b);
 }
 
-template <class T>
-IMATH_HOSTDEVICE constexpr inline Matrix44<T>
-Matrix44<T>::operator/ (T a) const IMATH_NOEXCEPT
+inline __m256
+div (__m256 a, __m256 b) IMATH_NOEXCEPT
 {
-    return Matrix44 (
-        x[0][0] / a,
-        x[0][1] / a,
-        x[0][2] / a,
-        x[0][3] / a,
-        x[1][0] / a,
-        x[1][1] / a,
-        x[1][2] / a,
-        x[1][3] / a,
-        x[2][0] / a,
-        x[2][1] / a,
-        x[2][2] / a,
-        x[2][3] / a,
-        x[3][0] / a,
-        x[3][1] / a,
-        x[3][2] / a,
-        x[3][3] / a);
+    return _mm256_div_ps (a, b);
 }
 
-template <class T>
-IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline const Matrix44<T>&
-                 Matrix44<T>::transpose () IMATH_NOEXCEPT
+inline void
+splat (float a, __m256& r) IMATH_NOEXCEPT
 {
-    Matrix44 tmp (
-        x[0][0],
-        x[1][0],
-        x[2][0],
-        x[3][0],
-        x[0][1],
-        x[1][1],
-        x[2][1],
-        x[3][1],
-        x[0][2],
-        x[1][2],
-        x[2][2],
-        x[3][2],
-        x[0][3],
-        x[1][3],
-        x[2][3],
-        x[3][3]);
-    *this = tmp;
-    return *this;
+    r = _mm256_set1_ps (a);
 }
 
-template <class T>
-IMATH_HOSTDEVICE constexpr inline Matrix44<T>
-Matrix44<T>::transposed () const IMATH_NOEXCEPT
+inline __m256d
+add (__m256d a, __m256d b) IMATH_NOEXCEPT
 {
-    return Matrix44 (
-        x[0][0],
-        x[1][0],
-        x[2][0],
-        x[3][0],
-        x[0][1],
-        x[1][1],
-        x[2][1],
-        x[3][1],
-        x[0][2],
-        x[1][2],
-        x[2][2],
-        x[3][2],
-        x[0][3],
-        x[1][3],
-        x[2][3],
-        x[3][3]);
+    return _mm256_add_pd (a, b);
 }
 
-template <class T>
-IMATH_CONSTEXPR14 inline const Matrix44<T>&
-Matrix44<T>::gjInvert (bool singExc)
+inline __m256d
+sub (__m256d a, __m256d b) IMATH_NOEXCEPT
 {
-    *this = gjInverse (singExc);
-    return *this;
+    return _mm256_sub_pd (a, b);
 }
 
-template <class T>
-IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline const Matrix44<T>&
-                 Matrix44<T>::gjInvert () IMATH_NOEXCEPT
+inline __m256d
+mul (__m256d a, __m256d b) IMATH_NOEXCEPT
 {
-    *this = gjInverse ();
-    return *this;
+    return _mm256_mul_pd (a, b);
 }
 
-template <class T>
-inline Matrix44<T>
-Matrix44<T>::gjInverse (bool singExc) const
+inline __m256d
+div (__m256d a, __m256d b) IMATH_NOEXCEPT
 {
-    int      i, j, k;
-    Matrix44 s;
-    Matrix44 t (*this);
+    return _mm256_div_pd (a, b);
+}
 
-    // Forward elimination
+inline void
+splat (double a, __m256d& r) IMATH_NOEXCEPT
+{
+    r = _mm256_set1_pd (a);
+}
 
-    for (i = 0; i < 3; i++)
-    {
-        int pivot = i;
+#        endif
 
-        T pivotsize = t.x[i][i];
+#    elif defined(IMATH_MATRIX_NEON)
 
-        if (pivotsize < 0) pivotsize = -pivotsize;
+inline float32x4_t
+add (float32x4_t a, float32x4_t b) IMATH_NOEXCEPT
+{
+    return vaddq_f32 (a, b);
+}
 
-        for (j = i + 1; j < 4; j++)
+inline float32x4_t
+sub (float32x4_t a, float32x4_t b) IMATH_NOEXCEPT
+{
+    return vsubq_f32 (a, b);
+}
+
+inline float32x4_t
+mul (float32x4_t a, float32x4_t b) IMATH_NOEXCEPT
+{
+    return vmulq_f32 (a, b);
+}
+
+inline float32x4_t
+div (float32x4_t a, float32x4_t b) IMATH_NOEXCEPT
+{
+    return vdivq_f32 (a, b);
+}
+
+inline void
+splat (float a, float32x4_t& r) IMATH_NOEXCEPT
+{
+    r = vdupq_n_f32 (a);
+}
+
+inline float64x2_t
+add (float64x2_t a, float64x2_t b) IMATH_NOEXCEPT
+{
+    return vaddq_f64 (a, b);
+}
+
+inline float64x2_t
+sub (float64x2_t a, float64x2_t b) IMATH_NOEXCEPT
+{
+    return vsubq_f64 (a, b);
+}
+
+inline float64x2_t
+mul (float64x2_t a, float64x2_t b) IMATH_NOEXCEPT
+{
+    return vmulq_f64 (a, b);
+}
+
+inline float64x2_t
+div (float64x2_t a, float64x2_t b) IMATH_NOEXCEPT
+{
+    return vdivq_f64 (a, b);
+}
+
+inline void
+splat (double a, float64x2_t& r) IMATH_NOEXCEPT
+{
+    r = vdupq_n_f64 (a);
+}
+
+#    endif
+
+//
+// Loads, stores and comparisons for the batched tests of
+// ImathFrustumTest.h and ImathBoxBatch.h. load() and store() move a
+// register from and to memory. maximum() and minimum() return the
+// second register in the lanes where the first is NaN. less(),
+// lessEqual() and greaterEqual() compare two registers, giving a mask
+// of type Mask<V>::Type, either() combines two masks, select() picks
+// the lanes of its first register where a mask is set and those of
+// its second elsewhere, and bits() returns bit i set if lane i of a
+// mask is set.
+//
+
+template <class V> struct Mask
+{
+    typedef V Type;
+};
+
+#    if defined(IMATH_MATRIX_SSE2)
+
+inline void
+load (const float* p, __m128& r) IMATH_NOEXCEPT
+{
+    r = _mm_loadu_ps (p);
+}
+
+inline void
+store (float* p, __m128 a) IMATH_NOEXCEPT
+{
+    _mm_storeu_ps (p, a);
+}
+
+inline __m128
+maximum (__m128 a, __m128 b) IMATH_NOEXCEPT
+{
+    return _mm_max_ps (a, b);
+}
+
+inline __m128
+minimum (__m128 a, __m128 b) IMATH_NOEXCEPT
+{
+    return _mm_min_ps (a, b);
+}
+
+inline __m128
+less (__m128 a, __m128 b) IMATH_NOEXCEPT
+{
+    return _mm_cmplt_ps (a, b);
+}
+
+inline __m128
+lessEqual (__m128 a, __m128 b) IMATH_NOEXCEPT
+{
+    return _mm_cmple_ps (a, b);
+}
+
+inline __m128
+greaterEqual (__m128 a, __m128 b) IMATH_NOEXCEPT
+{
+    return _mm_cmpge_ps (a, b);
+}
+
+inline __m128
+either (__m128 a, __m128 b) IMATH_NOEXCEPT
+{
+    return _mm_or_ps (a, b);
+}
+
+inline __m128
+select (__m128 m, __m128 a, __m128 b) IMATH_NOEXCEPT
+{
+    return _mm_or_ps (_mm_and_ps (m, a), _mm_andnot_ps (m, b));
+}
+
+inline unsigned
+bits (__m128 m) IMATH_NOEXCEPT
+{
+    return unsigned (_mm_movemask_ps (m));
+}
+
+inline void
+load (const double* p, __m128d& r) IMATH_NOEXCEPT
+{
+    r = _mm_loadu_pd (p);
+}
+
+inline void
+store (double* p, __m128d a) IMATH_NOEXCEPT
+{
+    _mm_storeu_pd (p, a);
+}
+
+inline __m128d
+maximum (__m128d a, __m128d b) IMATH_NOEXCEPT
+{
+    return _mm_max_pd (a, b);
+}
+
+inline __m128d
+minimum (__m128d a, __m128d b) IMATH_NOEXCEPT
+{
+    return _mm_min_pd (a, b);
+}
+
+inline __m128d
+less (__m128d a, __m128d b) IMATH_NOEXCEPT
+{
+    return _mm_cmplt_pd (a, b);
+}
+
+inline __m128d
+lessEqual (__m128d a, __m128d b) IMATH_NOEXCEPT
+{
+    return _mm_cmple_pd (a, b);
+}
+
+inline __m128d
+greaterEqual (__m128d a, __m128d b) IMATH_NOEXCEPT
+{
+    return _mm_cmpge_pd (a, b);
+}
+
+inline __m128d
+either (__m128d a, __m128d b) IMATH_NOEXCEPT
+{
+    return _mm_or_pd (a, b);
+}
+
+inline __m128d
+select (__m128d m, __m128d a, __m128d b) IMATH_NOEXCEPT
+{
+    return _mm_or_pd (_mm_and_pd (m, a), _mm_andnot_pd (m, b));
+}
+
+inline unsigned
+bits (__m128d m) IMATH_NOEXCEPT
+{
+    return unsigned (_mm_movemask_pd (m));
+}
+
+#        if defined(__AVX__)
+
+inline void
+load (const float* p, __m256& r) IMATH_NOEXCEPT
+{
+    r = _mm256_loadu_ps (p);
+}
+
+inline void
+store (float* p, __m256 a) IMATH_NOEXCEPT
+{
+    _mm256_storeu_ps (p, a);
+}
+
+inline __m256
+maximum (__m256 a, __m256 b) IMATH_NOEXCEPT
+{
+    return _mm256_max_ps (a, b);
+}
+
+inline __m256
+minimum (__m256 a, __m256 b) IMATH_NOEXCEPT
+{
+    return _mm256_min_ps (a, b);
+}
+
+inline __m256
+less (__m256 a, __m256 b) IMATH_NOEXCEPT
+{
+    return _mm256_cmp_ps (a, b, _CMP_LT_OQ);
+}
+
+inline __m256
+lessEqual (__m256 a, __m256 b) IMATH_NOEXCEPT
+{
+    return _mm256_cmp_ps (a, b, _CMP_LE_OQ);
+}
+
+inline __m256
+greaterEqual (__m256 a, __m256 b) IMATH_NOEXCEPT
+{
+    return _mm256_cmp_ps (a, b, _CMP_GE_OQ);
+}
+
+inline __m256
+either (__m256 a, __m256 b) IMATH_NOEXCEPT
+{
+    return _mm256_or_ps (a, b);
+}
+
+inline __m256
+select (__m256 m, __m256 a, __m256 b) IMATH_NOEXCEPT
+{
+    return _mm256_blendv_ps (b, a, m);
+}
+
+inline unsigned
+bits (__m256 m) IMATH_NOEXCEPT
+{
+    return unsigned (_mm256_movemask_ps (m));
+}
+
+inline void
+load (const double* p, __m256d& r) IMATH_NOEXCEPT
+{
+    r = _mm256_loadu_pd (p);
+}
+
+inline void
+store (double* p, __m256d a) IMATH_NOEXCEPT
+{
+    _mm256_storeu_pd (p, a);
+}
+
+inline __m256d
+maximum (__m256d a, __m256d b) IMATH_NOEXCEPT
+{
+    return _mm256_max_pd (a, b);
+}
+
+inline __m256d
+minimum (__m256d a, __m256d b) IMATH_NOEXCEPT
+{
+    return _mm256_min_pd (a, b);
+}
+
+inline __m256d
+less (__m256d a, __m256d b) IMATH_NOEXCEPT
+{
+    return _mm256_cmp_pd (a, b, _CMP_LT_OQ);
+}
+
+inline __m256d
+lessEqual (__m256d a, __m256d b) IMATH_NOEXCEPT
+{
+    return _mm256_cmp_pd (a, b, _CMP_LE_OQ);
+}
+
+inline __m256d
+greaterEqual (__m256d a, __m256d b) IMATH_NOEXCEPT
+{
+    return _mm256_cmp_pd (a, b, _CMP_GE_OQ);
+}
+
+inline __m256d
+either (__m256d a, __m256d b) IMATH_NOEXCEPT
+{
+    return _mm256_or_pd (a, b);
+}
+
+inline __m256d
+select (__m256d m, __m256d a, __m256d b) IMATH_NOEXCEPT
+{
+    return _mm256_blendv_pd (b, a, m);
+}
+
+inline unsigned
+bits (__m256d m) IMATH_NOEXCEPT
+{
+    return unsigned (_mm256_movemask_pd (m));
+}
+
+#        endif
+
+#    elif defined(IMATH_MATRIX_NEON)
+
+template <> struct Mask<float32x4_t>
+{
+    typedef uint32x4_t Type;
+};
+
+template <> struct Mask<float64x2_t>
+{
+    typedef uint64x2_t Type;
+};
+
+inline void
+load (const float* p, float32x4_t& r) IMATH_NOEXCEPT
+{
+    r = vld1q_f32 (p);
+}
+
+inline void
+store (float* p, float32x4_t a) IMATH_NOEXCEPT
+{
+    vst1q_f32 (p, a);
+}
+
+inline float32x4_t
+maximum (float32x4_t a, float32x4_t b) IMATH_NOEXCEPT
+{
+    return vmaxnmq_f32 (a, b);
+}
+
+inline float32x4_t
+minimum (float32x4_t a, float32x4_t b) IMATH_NOEXCEPT
+{
+    return vminnmq_f32 (a, b);
+}
+
+inline uint32x4_t
+less (float32x4_t a, float32x4_t b) IMATH_NOEXCEPT
+{
+    return vcltq_f32 (a, b);
+}
+
+inline uint32x4_t
+lessEqual (float32x4_t a, float32x4_t b) IMATH_NOEXCEPT
+{
+    return vcleq_f32 (a, b);
+}
+
+inline uint32x4_t
+greaterEqual (float32x4_t a, float32x4_t b) IMATH_NOEXCEPT
+{
+    return vcgeq_f32 (a, b);
+}
+
+inline uint32x4_t
+either (uint32x4_t a, uint32x4_t b) IMATH_NOEXCEPT
+{
+    return vorrq_u32 (a, b);
+}
+
+inline float32x4_t
+select (uint32x4_t m, float32x4_t a, float32x4_t b) IMATH_NOEXCEPT
+{
+    return vbslq_f32 (m, a, b);
+}
+
+inline unsigned
+bits (uint32x4_t m) IMATH_NOEXCEPT
+{
+    static const uint32_t lane[4] = {1, 2, 4, 8};
+    return unsigned (vaddvq_u32 (vandq_u32 (m, vld1q_u32 (lane))));
+}
+
+inline void
+load (const double* p, float64x2_t& r) IMATH_NOEXCEPT
+{
+    r = vld1q_f64 (p);
+}
+
+inline void
+store (double* p, float64x2_t a) IMATH_NOEXCEPT
+{
+    vst1q_f64 (p, a);
+}
+
+inline float64x2_t
+maximum (float64x2_t a, float64x2_t b) IMATH_NOEXCEPT
+{
+    return vmaxnmq_f64 (a, b);
+}
+
+inline float64x2_t
+minimum (float64x2_t a, float64x2_t b) IMATH_NOEXCEPT
+{
+    return vminnmq_f64 (a, b);
+}
+
+inline uint64x2_t
+less (float64x2_t a, float64x2_t b) IMATH_NOEXCEPT
+{
+    return vcltq_f64 (a, b);
+}
+
+inline uint64x2_t
+lessEqual (float64x2_t a, float64x2_t b) IMATH_NOEXCEPT
+{
+    return vcleq_f64 (a, b);
+}
+
+inline uint64x2_t
+greaterEqual (float64x2_t a, float64x2_t b) IMATH_NOEXCEPT
+{
+    return vcgeq_f64 (a, b);
+}
+
+inline uint64x2_t
+either (uint64x2_t a, uint64x2_t b) IMATH_NOEXCEPT
+{
+    return vorrq_u64 (a, b);
+}
+
+inline float64x2_t
+select (uint64x2_t m, float64x2_t a, float64x2_t b) IMATH_NOEXCEPT
+{
+    return vbslq_f64 (m, a, b);
+}
+
+inline unsigned
+bits (uint64x2_t m) IMATH_NOEXCEPT
+{
+    static const uint64_t lane[2] = {1, 2};
+    return unsigned (vaddvq_u64 (vandq_u64 (m, vld1q_u64 (lane))));
+}
+
+#    endif
+
+//
+// A matrix row of doubles, for registers that hold only two of them.
+//
+
+#    if defined(IMATH_MATRIX_SSE2)
+typedef __m128d Double2;
+#    else
+typedef float64x2_t Double2;
+#    endif
+
+struct Double4
+{
+    Double2 lo;
+    Double2 hi;
+};
+
+inline Double4
+add (const Double4& a, const Double4& b) IMATH_NOEXCEPT
+{
+    Double4 r = {add (a.lo, b.lo), add (a.hi, b.hi)};
+    return r;
+}
+
+inline Double4
+sub (const Double4& a, const Double4& b) IMATH_NOEXCEPT
+{
+    Double4 r = {sub (a.lo, b.lo), sub (a.hi, b.hi)};
+    return r;
+}
+
+inline Double4
+mul (const Double4& a, const Double4& b) IMATH_NOEXCEPT
+{
+    Double4 r = {mul (a.lo, b.lo), mul (a.hi, b.hi)};
+    return r;
+}
+
+inline Double4
+div (const Double4& a, const Double4& b) IMATH_NOEXCEPT
+{
+    Double4 r = {div (a.lo, b.lo), div (a.hi, b.hi)};
+    return r;
+}
+
+inline void
+splat (double a, Double4& r) IMATH_NOEXCEPT
+{
+    splat (a, r.lo);
+    splat (a, r.hi);
+}
+
+//
+// RowF and RowD hold one row of a M44f or M44d. load4() and store4()
+// move a row between memory and a register, and allGreater (a, r)
+// returns true if a > |r[i]| for every element of r.
+//
+
+#    if defined(IMATH_MATRIX_SSE2)
+
+typedef __m128 RowF;
+
+inline void
+load4 (const float* p, __m128& r) IMATH_NOEXCEPT
+{
+    r = _mm_loadu_ps (p);
+}
+
+inline void
+store4 (float* p, __m128 r) IMATH_NOEXCEPT
+{
+    _mm_storeu_ps (p, r);
+}
+
+inline bool
+allGreater (float a, __m128 r) IMATH_NOEXCEPT
+{
+    __m128 m = _mm_andnot_ps (_mm_set1_ps (-0.0f), r);
+    return _mm_movemask_ps (_mm_cmpgt_ps (_mm_set1_ps (a), m)) == 15;
+}
+
+#        if defined(__AVX__)
+
+typedef __m256d RowD;
+
+inline void
+load4 (const double* p, __m256d& r) IMATH_NOEXCEPT
+{
+    r = _mm256_loadu_pd (p);
+}
+
+inline void
+store4 (double* p, __m256d r) IMATH_NOEXCEPT
+{
+    _mm256_storeu_pd (p, r);
+}
+
+inline bool
+allGreater (double a, __m256d r) IMATH_NOEXCEPT
+{
+    __m256d m = _mm256_andnot_pd (_mm256_set1_pd (-0.0), r);
+    __m256d c = _mm256_cmp_pd (_mm256_set1_pd (a), m, _CMP_GT_OQ);
+    return _mm256_movemask_pd (c) == 15;
+}
+
+#        else
+
+typedef Double4 RowD;
+
+inline void
+load4 (const double* p, Double4& r) IMATH_NOEXCEPT
+{
+    r.lo = _mm_loadu_pd (p);
+    r.hi = _mm_loadu_pd (p + 2);
+}
+
+inline void
+store4 (double* p, const Double4& r) IMATH_NOEXCEPT
+{
+    _mm_storeu_pd (p, r.lo);
+    _mm_storeu_pd (p + 2, r.hi);
+}
+
+inline bool
+allGreater (double a, const Double4& r) IMATH_NOEXCEPT
+{
+    __m128d s  = _mm_set1_pd (-0.0);
+    __m128d v  = _mm_set1_pd (a);
+    __m128d lo = _mm_cmpgt_pd (v, _mm_andnot_pd (s, r.lo));
+    __m128d hi = _mm_cmpgt_pd (v, _mm_andnot_pd (s, r.hi));
+    return _mm_movemask_pd (_mm_and_pd (lo, hi)) == 3;
+}
+
+#        endif
+
+#    elif defined(IMATH_MATRIX_NEON)
+
+typedef float32x4_t RowF;
+typedef Double4     RowD;
+
+inline void
+load4 (const float* p, float32x4_t& r) IMATH_NOEXCEPT
+{
+    r = vld1q_f32 (p);
+}
+
+inline void
+store4 (float* p, float32x4_t r) IMATH_NOEXCEPT
+{
+    vst1q_f32 (p, r);
+}
+
+inline bool
+allGreater (float a, float32x4_t r) IMATH_NOEXCEPT
+{
+    return vminvq_u32 (vcgtq_f32 (vdupq_n_f32 (a), vabsq_f32 (r))) != 0;
+}
+
+inline void
+load4 (const double* p, Double4& r) IMATH_NOEXCEPT
+{
+    r.lo = vld1q_f64 (p);
+    r.hi = vld1q_f64 (p + 2);
+}
+
+inline void
+store4 (double* p, const Double4& r) IMATH_NOEXCEPT
+{
+    vst1q_f64 (p, r.lo);
+    vst1q_f64 (p + 2, r.hi);
+}
+
+inline bool
+allGreater (double a, const Double4& r) IMATH_NOEXCEPT
+{
+    float64x2_t v = vdupq_n_f64 (a);
+    uint64x2_t  m = vandq_u64 (
+        vcgtq_f64 (v, vabsq_f64 (r.lo)), vcgtq_f64 (v, vabsq_f64 (r.hi)));
+    return (vgetq_lane_u64 (m, 0) & vgetq_lane_u64 (m, 1)) != 0;
+}
+
+#    endif
+
+//
+// Row-oriented versions of Matrix44 multiply(), gjInverse() and the
+// affine case of inverse(). They perform the same arithmetic operations,
+// in the same order, as the scalar code, four matrix elements at a time,
+// so the results are identical. The inversion kernels return false if
+// the matrix is singular.
+//
+
+template <class R, class T>
+inline void
+multiplyRows (const T a[4][4], const T b[4][4], T c[4][4]) IMATH_NOEXCEPT
+{
+    R b0, b1, b2, b3;
+    load4 (b[0], b0);
+    load4 (b[1], b1);
+    load4 (b[2], b2);
+    load4 (b[3], b3);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        R a0, a1, a2, a3;
+        splat (a[i][0], a0);
+        splat (a[i][1], a1);
+        splat (a[i][2], a2);
+        splat (a[i][3], a3);
+
+        store4 (
+            c[i],
+            add (add (add (mul (a0, b0), mul (a1, b1)), mul (a2, b2)),
+                 mul (a3, b3)));
+    }
+}
+
+template <class R, class T>
+inline bool
+gjInverseRows (const T m[4][4], T s[4][4]) IMATH_NOEXCEPT
+{
+    T t[4][4];
+    memcpy (t, m, sizeof (t));
+
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 4; ++j)
+            s[i][j] = (i == j) ? T (1) : T (0);
+
+    // Forward elimination
+
+    for (int i = 0; i < 3; i++)
+    {
+        int pivot = i;
+
+        T pivotsize = t[i][i];
+
+        if (pivotsize < 0) pivotsize = -pivotsize;
+
+        for (int j = i + 1; j < 4; j++)
+        {
+            T tmp = t[j][i];
+
+            if (tmp < 0) tmp = -tmp;
+
+            if (tmp > pivotsize)
+            {
+                pivot     = j;
+                pivotsize = tmp;
+            }
+        }
+
+        if (pivotsize == 0) return false;
+
+        R ti, si;
+
+        if (pivot != i)
+        {
+            R tp, sp;
+            load4 (t[i], ti);
+            load4 (s[i], si);
+            load4 (t[pivot], tp);
+            load4 (s[pivot], sp);
+            store4 (t[i], tp);
+            store4 (s[i], sp);
+            store4 (t[pivot], ti);
+            store4 (s[pivot], si);
+        }
+
+        load4 (t[i], ti);
+        load4 (s[i], si);
+
+        for (int j = i + 1; j < 4; j++)
+        {
+            R f, tj, sj;
+            splat (t[j][i] / t[i][i], f);
+            load4 (t[j], tj);
+            load4 (s[j], sj);
+            store4 (t[j], sub (tj, mul (f, ti)));
+            store4 (s[j], sub (sj, mul (f, si)));
+        }
+    }
+
+    // Backward substitution
+
+    for (int i = 3; i >= 0; --i)
+    {
+        if (t[i][i] == 0) return false;
+
+        R f, ti, si;
+        splat (t[i][i], f);
+        load4 (t[i], ti);
+        load4 (s[i], si);
+        ti = div (ti, f);
+        si = div (si, f);
+        store4 (t[i], ti);
+        store4 (s[i], si);
+
+        for (int j = 0; j < i; j++)
+        {
+            R g, tj, sj;
+            splat (t[j][i], g);
+            load4 (t[j], tj);
+            load4 (s[j], sj);
+            store4 (t[j], sub (tj, mul (g, ti)));
+            store4 (s[j], sub (sj, mul (g, si)));
+        }
+    }
+
+    return true;
+}
+
+template <class R, class T>
+inline bool
+affineInverseRows (const T x[4][4], T s[4][4]) IMATH_NOEXCEPT
+{
+    s[0][0] = x[1][1] * x[2][2] - x[2][1] * x[1][2];
+    s[0][1] = x[2][1] * x[0][2] - x[0][1] * x[2][2];
+    s[0][2] = x[0][1] * x[1][2] - x[1][1] * x[0][2];
+    s[0][3] = 0;
+
+    s[1][0] = x[2][0] * x[1][2] - x[1][0] * x[2][2];
+    s[1][1] = x[0][0] * x[2][2] - x[2][0] * x[0][2];
+    s[1][2] = x[1][0] * x[0][2] - x[0][0] * x[1][2];
+    s[1][3] = 0;
+
+    s[2][0] = x[1][0] * x[2][1] - x[2][0] * x[1][1];
+    s[2][1] = x[2][0] * x[0][1] - x[0][0] * x[2][1];
+    s[2][2] = x[0][0] * x[1][1] - x[1][0] * x[0][1];
+    s[2][3] = 0;
+
+    T r = x[0][0] * s[0][0] + x[0][1] * s[1][0] + x[0][2] * s[2][0];
+
+    R s0, s1, s2, d;
+    load4 (s[0], s0);
+    load4 (s[1], s1);
+    load4 (s[2], s2);
+    splat (r, d);
+
+    if (!(IMATH_INTERNAL_NAMESPACE::abs (r) >= 1))
+    {
+        T mr =
+            IMATH_INTERNAL_NAMESPACE::abs (r) / std::numeric_limits<T>::min ();
+
+        if (!(allGreater (mr, s0) && allGreater (mr, s1) &&
+              allGreater (mr, s2)))
+            return false;
+    }
+
+    s0 = div (s0, d);
+    s1 = div (s1, d);
+    s2 = div (s2, d);
+
+    R x0, x1, x2;
+    splat (-x[3][0], x0);
+    splat (x[3][1], x1);
+    splat (x[3][2], x2);
+
+    store4 (s[0], s0);
+    store4 (s[1], s1);
+    store4 (s[2], s2);
+    store4 (s[3], sub (sub (mul (x0, s0), mul (x1, s1)), mul (x2, s2)));
+
+    s[0][3] = 0;
+    s[1][3] = 0;
+    s[2][3] = 0;
+    s[3][3] = 1;
+
+    return true;
+}
+
+//
+// HasRowKernels<T>::value is true if the row-oriented kernels support
+// Matrix44<T>. The generic overloads below are never called.
+//
+
+template <class T> struct HasRowKernels
+{
+    static const bool value = false;
+};
+
+template <> struct HasRowKernels<float>
+{
+    static const bool value = true;
+};
+
+template <> struct HasRowKernels<double>
+{
+    static const bool value = true;
+};
+
+template <class T>
+inline void
+multiply (const Matrix44<T>&, const Matrix44<T>&, Matrix44<T>&) IMATH_NOEXCEPT
+{}
+
+template <class T>
+inline bool
+gjInverse (const Matrix44<T>&, Matrix44<T>&) IMATH_NOEXCEPT
+{
+    return false;
+}
+
+template <class T>
+inline bool
+affineInverse (const Matrix44<T>&, Matrix44<T>&) IMATH_NOEXCEPT
+{
+    return false;
+}
+
+inline void
+multiply (
+    const Matrix44<float>& a,
+    const Matrix44<float>& b,
+    Matrix44<float>&       c) IMATH_NOEXCEPT
+{
+    multiplyRows<RowF> (a.x, b.x, c.x);
+}
+
+inline void
+multiply (
+    const Matrix44<double>& a,
+    const Matrix44<double>& b,
+    Matrix44<double>&       c) IMATH_NOEXCEPT
+{
+    multiplyRows<RowD> (a.x, b.x, c.x);
+}
+
+inline bool
+gjInverse (const Matrix44<float>& m, Matrix44<float>& s) IMATH_NOEXCEPT
+{
+    return gjInverseRows<RowF> (m.x, s.x);
+}
+
+inline bool
+gjInverse (const Matrix44<double>& m, Matrix44<double>& s) IMATH_NOEXCEPT
+{
+    return gjInverseRows<RowD> (m.x, s.x);
+}
+
+inline bool
+affineInverse (const Matrix44<float>& m, Matrix44<float>& s) IMATH_NOEXCEPT
+{
+    return affineInverseRows<RowF> (m.x, s.x);
+}
+
+inline bool
+affineInverse (const Matrix44<double>& m, Matrix44<double>& s) IMATH_NOEXCEPT
+{
+    return affineInverseRows<RowD> (m.x, s.x);
+}
+
+} // namespace MatrixDetail
+
+#endif
+
+template <class T>
+IMATH_HOSTDEVICE inline IMATH_CONSTEXPR14 Matrix44<T>
+Matrix44<T>::multiply (const Matrix44& a, const Matrix44& b) IMATH_NOEXCEPT
+{
+#if defined(IMATH_MATRIX_SIMD) && defined(IMATH_MATRIX_CONSTANT_EVALUATED)
+    if (MatrixDetail::HasRowKernels<T>::value &&
+        !IMATH_MATRIX_CONSTANT_EVALUATED ())
+    {
+        Matrix44 c (UNINITIALIZED);
+        MatrixDetail::multiply (a, b, c);
+        return c;
+    }
+#endif
+
+    const auto a00 = a.x[0][0];
+    const auto a01 = a.x[0][1];
+    const auto a02 = a.x[0][2];
+    const auto a03 = a.x[0][3];
+
+    const auto c00 =
+        a00 * b.x[0][0] + a01 * b.x[1][0] + a02 * b.x[2][0] + a03 * b.x[3][0];
+    const auto c01 =
+        a00 * b.x[0][1] + a01 * b.x[1][1] + a02 * b.x[2][1] + a03 * b.x[3][1];
+    const auto c02 =
+        a00 * b.x[0][2] + a01 * b.x[1][2] + a02 * b.x[2][2] + a03 * b.x[3][2];
+    const auto c03 =
+        a00 * b.x[0][3] + a01 * b.x[1][3] + a02 * b.x[2][3] + a03 * b.x[3][3];
+
+    const auto a10 = a.x[1][0];
+    const auto a11 = a.x[1][1];
+    const auto a12 = a.x[1][2];
+    const auto a13 = a.x[1][3];
+
+    const auto c10 =
+        a10 * b.x[0][0] + a11 * b.x[1][0] + a12 * b.x[2][0] + a13 * b.x[3][0];
+    const auto c11 =
+        a10 * b.x[0][1] + a11 * b.x[1][1] + a12 * b.x[2][1] + a13 * b.x[3][1];
+    const auto c12 =
+        a10 * b.x[0][2] + a11 * b.x[1][2] + a12 * b.x[2][2] + a13 * b.x[3][2];
+    const auto c13 =
+        a10 * b.x[0][3] + a11 * b.x[1][3] + a12 * b.x[2][3] + a13 * b.x[3][3];
+
+    const auto a20 = a.x[2][0];
+    const auto a21 = a.x[2][1];
+    const auto a22 = a.x[2][2];
+    const auto a23 = a.x[2][3];
+
+    const auto c20 =
+        a20 * b.x[0][0] + a21 * b.x[1][0] + a22 * b.x[2][0] + a23 * b.x[3][0];
+    const auto c21 =
+        a20 * b.x[0][1] + a21 * b.x[1][1] + a22 * b.x[2][1] + a23 * b.x[3][1];
+    const auto c22 =
+        a20 * b.x[0][2] + a21 * b.x[1][2] + a22 * b.x[2][2] + a23 * b.x[3][2];
+    const auto c23 =
+        a20 * b.x[0][3] + a21 * b.x[1][3] + a22 * b.x[2][3] + a23 * b.x[3][3];
+
+    const auto a30 = a.x[3][0];
+    const auto a31 = a.x[3][1];
+    const auto a32 = a.x[3][2];
+    const auto a33 = a.x[3][3];
+
+    const auto c30 =
+        a30 * b.x[0][0] + a31 * b.x[1][0] + a32 * b.x[2][0] + a33 * b.x[3][0];
+    const auto c31 =
+        a30 * b.x[0][1] + a31 * b.x[1][1] + a32 * b.x[2][1] + a33 * b.x[3][1];
+    const auto c32 =
+        a30 * b.x[0][2] + a31 * b.x[1][2] + a32 * b.x[2][2] + a33 * b.x[3][2];
+    const auto c33 =
+        a30 * b.x[0][3] + a31 * b.x[1][3] + a32 * b.x[2][3] + a33 * b.x[3][3];
+    return Matrix44 (
+        c00,
+        c01,
+        c02,
+        c03,
+        c10,
+        c11,
+        c12,
+        c13,
+        c20,
+        c21,
+        c22,
+        c23,
+        c30,
+        c31,
+        c32,
+        c33);
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline const Matrix44<T>&
+Matrix44<T>::operator*= (const Matrix44<T>& v) IMATH_NOEXCEPT
+{
+    *this = multiply (*this, v);
+    return *this;
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline Matrix44<T>
+Matrix44<T>::operator* (const Matrix44<T>& v) const IMATH_NOEXCEPT
+{
+    return multiply (*this, v);
+}
+
+template <class T>
+IMATH_HOSTDEVICE inline void
+Matrix44<T>::multiply (
+    const Matrix44<T>& a, const Matrix44<T>& b, Matrix44<T>& c) IMATH_NOEXCEPT
+{
+    c = multiply (a, b);
+}
+
+template <class T>
+template <class S>
+IMATH_HOSTDEVICE inline void
+Matrix44<T>::multVecMatrix (const Vec3<S>& src, Vec3<S>& dst) const
+    IMATH_NOEXCEPT
+{
+    S a, b, c, w;
+
+    a = src.x * x[0][0] + src.y * x[1][0] + src.z * x[2][0] + x[3][0];
+    b = src.x * x[0][1] + src.y * x[1][1] + src.z * x[2][1] + x[3][1];
+    c = src.x * x[0][2] + src.y * x[1][2] + src.z * x[2][2] + x[3][2];
+    w = src.x * x[0][3] + src.y * x[1][3] + src.z * x[2][3] + x[3][3];
+
+    dst.x = a / w;
+    dst.y = b / w;
+    dst.z = c / w;
+}
+
+template <class T>
+template <class S>
+IMATH_HOSTDEVICE inline void
+Matrix44<T>::multDirMatrix (const Vec3<S>& src, Vec3<S>& dst) const
+    IMATH_NOEXCEPT
+{
+    S a, b, c;
+
+    a = src.x * x[0][0] + src.y * x[1][0] + src.z * x[2][0];
+    b = src.x * x[0][1] + src.y * x[1][1] + src.z * x[2][1];
+    c = src.x * x[0][2] + src.y * x[1][2] + src.z * x[2][2];
+
+    dst.x = a;
+    dst.y = b;
+    dst.z = c;
+}
+
+namespace MatrixDetail
+{
+
+//
+// Kernels for the batched Matrix44 point and direction transformations.
+// The vector kernels perform the same arithmetic operations, in the same
+// order, as the scalar multVecMatrix() and multDirMatrix() functions.
+//
+
+enum TransformKind
+{
+    Projective,
+    Affine,
+    Direction
+};
+
+template <int Kind, class T, class S>
+inline void
+transformScalar (const Matrix44<T>& m, const Vec3<S>& src, Vec3<S>& dst)
+    IMATH_NOEXCEPT
+{
+    if (Kind == Projective)
+    {
+        m.multVecMatrix (src, dst);
+    }
+    else if (Kind == Direction)
+    {
+        m.multDirMatrix (src, dst);
+    }
+    else
+    {
+        S a, b, c;
+
+        a = src.x * m.x[0][0] + src.y * m.x[1][0] + src.z * m.x[2][0] +
+            m.x[3][0];
+        b = src.x * m.x[0][1] + src.y * m.x[1][1] + src.z * m.x[2][1] +
+            m.x[3][1];
+        c = src.x * m.x[0][2] + src.y * m.x[1][2] + src.z * m.x[2][2] +
+            m.x[3][2];
+
+        dst.x = a;
+        dst.y = b;
+        dst.z = c;
+    }
+}
+
+#if defined(IMATH_MATRIX_SSE2)
+
+//
+// Conversion between four interleaved Vec3<float>s, x0 y0 z0 x1 y1 z1 ...,
+// and one register per component.
+//
+
+inline void
+load3 (const float* p, __m128& x, __m128& y, __m128& z) IMATH_NOEXCEPT
+{
+    __m128 v0 = _mm_loadu_ps (p);     // x0 y0 z0 x1
+    __m128 v1 = _mm_loadu_ps (p + 4); // y1 z1 x2 y2
+    __m128 v2 = _mm_loadu_ps (p + 8); // z2 x3 y3 z3
+
+    __m128 t0 = _mm_shuffle_ps (v1, v2, _MM_SHUFFLE (2, 1, 3, 2));
+    __m128 t1 = _mm_shuffle_ps (v0, v1, _MM_SHUFFLE (1, 0, 2, 1));
+
+    x = _mm_shuffle_ps (v0, t0, _MM_SHUFFLE (2, 0, 3, 0));
+    y = _mm_shuffle_ps (t1, t0, _MM_SHUFFLE (3, 1, 2, 0));
+    z = _mm_shuffle_ps (t1, v2, _MM_SHUFFLE (3, 0, 3, 1));
+}
+
+inline void
+store3 (float* p, __m128 x, __m128 y, __m128 z) IMATH_NOEXCEPT
+{
+    __m128 p0 = _mm_shuffle_ps (x, y, _MM_SHUFFLE (0, 0, 1, 0));
+    __m128 q0 = _mm_shuffle_ps (z, x, _MM_SHUFFLE (1, 1, 0, 0));
+    __m128 p1 = _mm_shuffle_ps (y, z, _MM_SHUFFLE (1, 1, 1, 1));
+    __m128 q1 = _mm_shuffle_ps (x, y, _MM_SHUFFLE (2, 2, 2, 2));
+    __m128 p2 = _mm_shuffle_ps (z, x, _MM_SHUFFLE (3, 3, 2, 2));
+    __m128 q2 = _mm_shuffle_ps (y, z, _MM_SHUFFLE (3, 3, 3, 3));
+
+    _mm_storeu_ps (p, _mm_shuffle_ps (p0, q0, _MM_SHUFFLE (2, 0, 2, 0)));
+    _mm_storeu_ps (p + 4, _mm_shuffle_ps (p1, q1, _MM_SHUFFLE (2, 0, 2, 0)));
+    _mm_storeu_ps (p + 8, _mm_shuffle_ps (p2, q2, _MM_SHUFFLE (2, 0, 2, 0)));
+}
+
+inline void
+load3 (const double* p, __m128d& x, __m128d& y, __m128d& z) IMATH_NOEXCEPT
+{
+    __m128d v0 = _mm_loadu_pd (p);     // x0 y0
+    __m128d v1 = _mm_loadu_pd (p + 2); // z0 x1
+    __m128d v2 = _mm_loadu_pd (p + 4); // y1 z1
+
+    x = _mm_shuffle_pd (v0, v1, 2);
+    y = _mm_shuffle_pd (v0, v2, 1);
+    z = _mm_shuffle_pd (v1, v2, 2);
+}
+
+inline void
+store3 (double* p, __m128d x, __m128d y, __m128d z) IMATH_NOEXCEPT
+{
+    _mm_storeu_pd (p, _mm_shuffle_pd (x, y, 0));
+    _mm_storeu_pd (p + 2, _mm_shuffle_pd (z, x, 2));
+    _mm_storeu_pd (p + 4, _mm_shuffle_pd (y, z, 3));
+}
+
+#    if defined(__AVX__)
+
+//
+// The 256-bit versions load the first four (or two) vectors into the
+// lower half of each register and the next four (or two) into the upper
+// half, so the same in-lane shuffles as above apply.
+//
+
+inline void
+load3 (const float* p, __m256& x, __m256& y, __m256& z) IMATH_NOEXCEPT
+{
+    __m256 v0 = _mm256_insertf128_ps (
+        _mm256_castps128_ps256 (_mm_loadu_ps (p)), _mm_loadu_ps (p + 12), 1);
+    __m256 v1 = _mm256_insertf128_ps (
+        _mm256_castps128_ps256 (_mm_loadu_ps (p + 4)),
+        _mm_loadu_ps (p + 16),
+        1);
+    __m256 v2 = _mm256_insertf128_ps (
+        _mm256_castps128_ps256 (_mm_loadu_ps (p + 8)),
+        _mm_loadu_ps (p + 20),
+        1);
+
+    __m256 t0 = _mm256_shuffle_ps (v1, v2, _MM_SHUFFLE (2, 1, 3, 2));
+    __m256 t1 = _mm256_shuffle_ps (v0, v1, _MM_SHUFFLE (1, 0, 2, 1));
+
+    x = _mm256_shuffle_ps (v0, t0, _MM_SHUFFLE (2, 0, 3, 0));
+    y = _mm256_shuffle_ps (t1, t0, _MM_SHUFFLE (3, 1, 2, 0));
+    z = _mm256_shuffle_ps (t1, v2, _MM_SHUFFLE (3, 0, 3, 1));
+}
+
+inline void
+store3 (float* p, __m256 x, __m256 y, __m256 z) IMATH_NOEXCEPT
+{
+    __m256 p0 = _mm256_shuffle_ps (x, y, _MM_SHUFFLE (0, 0, 1, 0));
+    __m256 q0 = _mm256_shuffle_ps (z, x, _MM_SHUFFLE (1, 1, 0, 0));
+    __m256 p1 = _mm256_shuffle_ps (y, z, _MM_SHUFFLE (1, 1, 1, 1));
+    __m256 q1 = _mm256_shuffle_ps (x, y, _MM_SHUFFLE (2, 2, 2, 2));
+    __m256 p2 = _mm256_shuffle_ps (z, x, _MM_SHUFFLE (3, 3, 2, 2));
+    __m256 q2 = _mm256_shuffle_ps (y, z, _MM_SHUFFLE (3, 3, 3, 3));
+
+    __m256 v0 = _mm256_shuffle_ps (p0, q0, _MM_SHUFFLE (2, 0, 2, 0));
+    __m256 v1 = _mm256_shuffle_ps (p1, q1, _MM_SHUFFLE (2, 0, 2, 0));
+    __m256 v2 = _mm256_shuffle_ps (p2, q2, _MM_SHUFFLE (2, 0, 2, 0));
+
+    _mm_storeu_ps (p, _mm256_castps256_ps128 (v0));
+    _mm_storeu_ps (p + 4, _mm256_castps256_ps128 (v1));
+    _mm_storeu_ps (p + 8, _mm256_castps256_ps128 (v2));
+    _mm_storeu_ps (p + 12, _mm256_extractf128_ps (v0, 1));
+    _mm_storeu_ps (p + 16, _mm256_extractf128_ps (v1, 1));
+    _mm_storeu_ps (p + 20, _mm256_extractf128_ps (v2, 1));
+}
+
+inline void
+load3 (const double* p, __m256d& x, __m256d& y, __m256d& z) IMATH_NOEXCEPT
+{
+    __m256d v0 = _mm256_insertf128_pd (
+        _mm256_castpd128_pd256 (_mm_loadu_pd (p)), _mm_loadu_pd (p + 6), 1);
+    __m256d v1 = _mm256_insertf128_pd (
+        _mm256_castpd128_pd256 (_mm_loadu_pd (p + 2)), _mm_loadu_pd (p + 8), 1);
+    __m256d v2 = _mm256_insertf128_pd (
+        _mm256_castpd128_pd256 (_mm_loadu_pd (p + 4)),
+        _mm_loadu_pd (p + 10),
+        1);
+
+    x = _mm256_shuffle_pd (v0, v1, 10);
+    y = _mm256_shuffle_pd (v0, v2, 5);
+    z = _mm256_shuffle_pd (v1, v2, 10);
+}
+
+inline void
+store3 (double* p, __m256d x, __m256d y, __m256d z) IMATH_NOEXCEPT
+{
+    __m256d v0 = _mm256_shuffle_pd (x, y, 0);
+    __m256d v1 = _mm256_shuffle_pd (z, x, 10);
+    __m256d v2 = _mm256_shuffle_pd (y, z, 15);
+
+    _mm_storeu_pd (p, _mm256_castpd256_pd128 (v0));
+    _mm_storeu_pd (p + 2, _mm256_castpd256_pd128 (v1));
+    _mm_storeu_pd (p + 4, _mm256_castpd256_pd128 (v2));
+    _mm_storeu_pd (p + 6, _mm256_extractf128_pd (v0, 1));
+    _mm_storeu_pd (p + 8, _mm256_extractf128_pd (v1, 1));
+    _mm_storeu_pd (p + 10, _mm256_extractf128_pd (v2, 1));
+}
+
+#    endif
+
+#elif defined(IMATH_MATRIX_NEON)
+
+inline void
+load3 (const float* p, float32x4_t& x, float32x4_t& y, float32x4_t& z)
+    IMATH_NOEXCEPT
+{
+    float32x4x3_t v = vld3q_f32 (p);
+    x               = v.val[0];
+    y               = v.val[1];
+    z               = v.val[2];
+}
+
+inline void
+store3 (float* p, float32x4_t x, float32x4_t y, float32x4_t z) IMATH_NOEXCEPT
+{
+    float32x4x3_t v = {{x, y, z}};
+    vst3q_f32 (p, v);
+}
+
+inline void
+load3 (const double* p, float64x2_t& x, float64x2_t& y, float64x2_t& z)
+    IMATH_NOEXCEPT
+{
+    float64x2x3_t v = vld3q_f64 (p);
+    x               = v.val[0];
+    y               = v.val[1];
+    z               = v.val[2];
+}
+
+inline void
+store3 (double* p, float64x2_t x, float64x2_t y, float64x2_t z)
+    IMATH_NOEXCEPT
+{
+    float64x2x3_t v = {{x, y, z}};
+    vst3q_f64 (p, v);
+}
+
+#endif
+
+//
+// Transform as many whole registers' worth of the n vectors at src as
+// possible, and return the number of vectors transformed. V is the
+// register type, S the component type of the vectors and the matrix.
+//
+
+template <int Kind, class V, class S>
+inline size_t
+transformVector (const Matrix44<S>& m, const S* src, S* dst, size_t n)
+    IMATH_NOEXCEPT
+{
+    const size_t width = sizeof (V) / sizeof (S);
+
+    V r[4][4];
+
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 4; ++j)
+            splat (m.x[i][j], r[i][j]);
+
+    size_t i = 0;
+
+    for (; i + width <= n; i += width)
+    {
+        V x, y, z;
+        load3 (src + 3 * i, x, y, z);
+
+        V a = add (add (mul (x, r[0][0]), mul (y, r[1][0])), mul (z, r[2][0]));
+        V b = add (add (mul (x, r[0][1]), mul (y, r[1][1])), mul (z, r[2][1]));
+        V c = add (add (mul (x, r[0][2]), mul (y, r[1][2])), mul (z, r[2][2]));
+
+        if (Kind != Direction)
+        {
+            a = add (a, r[3][0]);
+            b = add (b, r[3][1]);
+            c = add (c, r[3][2]);
+        }
+
+        if (Kind == Projective)
+        {
+            V w = add (
+                add (
+                    add (mul (x, r[0][3]), mul (y, r[1][3])),
+                    mul (z, r[2][3])),
+                r[3][3]);
+
+            a = div (a, w);
+            b = div (b, w);
+            c = div (c, w);
+        }
+
+        store3 (dst + 3 * i, a, b, c);
+    }
+
+    return i;
+}
+
+template <int Kind, class T, class S>
+inline void
+transform (const Matrix44<T>& m, const Vec3<S>* src, Vec3<S>* dst, size_t n)
+    IMATH_NOEXCEPT
+{
+    for (size_t i = 0; i < n; ++i)
+        transformScalar<Kind> (m, src[i], dst[i]);
+}
+
+template <int Kind>
+inline void
+transform (
+    const Matrix44<float>& m,
+    const Vec3<float>*     src,
+    Vec3<float>*           dst,
+    size_t                 n) IMATH_NOEXCEPT
+{
+    size_t i = 0;
+
+#if defined(__AVX__)
+    if (n) i = transformVector<Kind, __m256> (m, &src->x, &dst->x, n);
+#elif defined(IMATH_MATRIX_SSE2)
+    if (n) i = transformVector<Kind, __m128> (m, &src->x, &dst->x, n);
+#elif defined(IMATH_MATRIX_NEON)
+    if (n) i = transformVector<Kind, float32x4_t> (m, &src->x, &dst->x, n);
+#endif
+
+    for (; i < n; ++i)
+        transformScalar<Kind> (m, src[i], dst[i]);
+}
+
+template <int Kind>
+inline void
+transform (
+    const Matrix44<double>& m,
+    const Vec3<double>*     src,
+    Vec3<double>*           dst,
+    size_t                  n) IMATH_NOEXCEPT
+{
+    size_t i = 0;
+
+#if defined(__AVX__)
+    if (n) i = transformVector<Kind, __m256d> (m, &src->x, &dst->x, n);
+#elif defined(IMATH_MATRIX_SSE2)
+    if (n) i = transformVector<Kind, __m128d> (m, &src->x, &dst->x, n);
+#elif defined(IMATH_MATRIX_NEON)
+    if (n) i = transformVector<Kind, float64x2_t> (m, &src->x, &dst->x, n);
+#endif
+
+    for (; i < n; ++i)
+        transformScalar<Kind> (m, src[i], dst[i]);
+}
+
+} // namespace MatrixDetail
+
+template <class T>
+template <class S>
+inline void
+Matrix44<T>::multVecMatrix (const Vec3<S>* src, Vec3<S>* dst, size_t n) const
+    IMATH_NOEXCEPT
+{
+    MatrixDetail::transform<MatrixDetail::Projective> (*this, src, dst, n);
+}
+
+template <class T>
+template <class S>
+inline void
+Matrix44<T>::multVecMatrixAffine (
+    const Vec3<S>* src, Vec3<S>* dst, size_t n) const IMATH_NOEXCEPT
+{
+    MatrixDetail::transform<MatrixDetail::Affine> (*this, src, dst, n);
+}
+
+template <class T>
+template <class S>
+inline void
+Matrix44<T>::multDirMatrix (const Vec3<S>* src, Vec3<S>* dst, size_t n) const
+    IMATH_NOEXCEPT
+{
+    MatrixDetail::transform<MatrixDetail::Direction> (*this, src, dst, n);
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline const Matrix44<T>&
+Matrix44<T>::operator/= (T a) IMATH_NOEXCEPT
+{
+    x[0][0] /= a;
+    x[0][1] /= a;
+    x[0][2] /= a;
+    x[0][3] /= a;
+    x[1][0] /= a;
+    x[1][1] /= a;
+    x[1][2] /= a;
+    x[1][3] /= a;
+    x[2][0] /= a;
+    x[2][1] /= a;
+    x[2][2] /= a;
+    x[2][3] /= a;
+    x[3][0] /= a;
+    x[3][1] /= a;
+    x[3][2] /= a;
+    x[3][3] /= a;
+
+    return *this;
+}
+
+template <class T>
+IMATH_HOSTDEVICE constexpr inline Matrix44<T>
+Matrix44<T>::operator/ (T a) const IMATH_NOEXCEPT
+{
+    return Matrix44 (
+        x[0][0] / a,
+        x[0][1] / a,
+        x[0][2] / a,
+        x[0][3] / a,
+        x[1][0] / a,
+        x[1][1] / a,
+        x[1][2] / a,
+        x[1][3] / a,
+        x[2][0] / a,
+        x[2][1] / a,
+        x[2][2] / a,
+        x[2][3] / a,
+        x[3][0] / a,
+        x[3][1] / a,
+        x[3][2] / a,
+        x[3][3] / a);
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline const Matrix44<T>&
+                 Matrix44<T>::transpose () IMATH_NOEXCEPT
+{
+    Matrix44 tmp (
+        x[0][0],
+        x[1][0],
+        x[2][0],
+        x[3][0],
+        x[0][1],
+        x[1][1],
+        x[2][1],
+        x[3][1],
+        x[0][2],
+        x[1][2],
+        x[2][2],
+        x[3][2],
+        x[0][3],
+        x[1][3],
+        x[2][3],
+        x[3][3]);
+    *this = tmp;
+    return *this;
+}
+
+template <class T>
+IMATH_HOSTDEVICE constexpr inline Matrix44<T>
+Matrix44<T>::transposed () const IMATH_NOEXCEPT
+{
+    return Matrix44 (
+        x[0][0],
+        x[1][0],
+        x[2][0],
+        x[3][0],
+        x[0][1],
+        x[1][1],
+        x[2][1],
+        x[3][1],
+        x[0][2],
+        x[1][2],
+        x[2][2],
+        x[3][2],
+        x[0][3],
+        x[1][3],
+        x[2][3],
+        x[3][3]);
+}
+
+template <class T>
+IMATH_CONSTEXPR14 inline const Matrix44<T>&
+Matrix44<T>::gjInvert (bool singExc)
+{
+    *this = gjInverse (singExc);
+    return *this;
+}
+
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline const Matrix44<T>&
+                 Matrix44<T>::gjInvert () IMATH_NOEXCEPT
+{
+    *this = gjInverse ();
+    return *this;
+}
+
+template <class T>
+inline Matrix44<T>
+Matrix44<T>::gjInverse (bool singExc) const
+{
+#if defined(IMATH_MATRIX_SIMD)
+    if (MatrixDetail::HasRowKernels<T>::value)
+    {
+        Matrix44 s (UNINITIALIZED);
+
+        if (MatrixDetail::gjInverse (*this, s)) return s;
+
+        if (singExc)
+            throw std::invalid_argument ("Cannot invert singular matrix.");
+
+        return Matrix44 ();
+    }
+#endif
+
+    int      i, j, k;
+    Matrix44 s;
+    Matrix44 t (*this);
+
+    // Forward elimination
+
+    for (i = 0; i < 3; i++)
+    {
+        int pivot = i;
+
+        T pivotsize = t.x[i][i];
+
+        if (pivotsize < 0) pivotsize = -pivotsize;
+
+        for (j = i + 1; j < 4; j++)
         {
             T tmp = t.x[j][i];
 
@@ -4307,6 +5824,17 @@ template <class T>
 IMATH_HOSTDEVICE inline Matrix44<T>
 Matrix44<T>::gjInverse () const IMATH_NOEXCEPT
 {
+#if defined(IMATH_MATRIX_SIMD)
+    if (MatrixDetail::HasRowKernels<T>::value)
+    {
+        Matrix44 s (UNINITIALIZED);
+
+        if (MatrixDetail::gjInverse (*this, s)) return s;
+
+        return Matrix44 ();
+    }
+#endif
+
     int      i, j, k;
     Matrix44 s;
     Matrix44 t (*this);
@@ -4416,6 +5944,21 @@ Matrix44<T>::inverse (bool singExc) const
     if (x[0][3] != 0 || x[1][3] != 0 || x[2][3] != 0 || x[3][3] != 1)
         return gjInverse (singExc);
 
+#if defined(IMATH_MATRIX_SIMD) && defined(IMATH_MATRIX_CONSTANT_EVALUATED)
+    if (MatrixDetail::HasRowKernels<T>::value &&
+        !IMATH_MATRIX_CONSTANT_EVALUATED ())
+    {
+        Matrix44 s (UNINITIALIZED);
+
+        if (MatrixDetail::affineInverse (*this, s)) return s;
+
+        if (singExc)
+            throw std::invalid_argument ("Cannot invert singular matrix.");
+
+        return Matrix44 ();
+    }
+#endif
+
     Matrix44 s (
         x[1][1] * x[2][2] - x[2][1] * x[1][2],
         x[2][1] * x[0][2] - x[0][1] * x[2][2],
@@ -4491,6 +6034,18 @@ IMATH_HOSTDEVICE IMATH_CONSTEXPR14 inline Matrix44<T>
     if (x[0][3] != 0 || x[1][3] != 0 || x[2][3] != 0 || x[3][3] != 1)
         return gjInverse ();
 
+#if defined(IMATH_MATRIX_SIMD) && defined(IMATH_MATRIX_CONSTANT_EVALUATED)
+    if (MatrixDetail::HasRowKernels<T>::value &&
+        !IMATH_MATRIX_CONSTANT_EVALUATED ())
+    {
+        Matrix44 s (UNINITIALIZED);
+
+        if (MatrixDetail::affineInverse (*this, s)) return s;
+
+        return Matrix44 ();
+    }
+#endif
+
     Matrix44 s (
         x[1][1] * x[2][2] - x[2][1] * x[1][2],
         x[2][1] * x[0][2] - x[0][1] * x[2][2],
@@ -15,6 +15,7 @@
 #include "ImathMatrixAlgo.h"
 #include <algorithm>
 #include <cmath>
+#include <vector>
 
 #if defined(IMATH_DLL)
 #    define EXPORT_CONST __declspec(dllexport)
@@ -247,6 +248,209 @@ procrustesRotationAndTranslation (
         A, B, (const T*) 0, numPoints, doScale);
 } // procrustesRotationAndTranslation
 
+ProcrustesAccumulator::ProcrustesAccumulator ()
+    : _numPoints (0)
+    , _weight (0.0)
+    , _Acenter (0.0)
+    , _Bcenter (0.0)
+    , _covariance (0.0)
+    , _traceATA (0.0)
+{}
+
+void
+ProcrustesAccumulator::clear ()
+{
+    *this = ProcrustesAccumulator ();
+}
+
+template <typename T>
+void
+ProcrustesAccumulator::add (
+    const Vec3<T>* A,
+    const Vec3<T>* B,
+    const T*       weights,
+    const size_t   numPoints)
+{
+    if (numPoints == 0) return;
+
+    //
+    // Reduce the chunk to its own center, cross-covariance and spread
+    // with the same two passes as procrustesRotationAndTranslation(),
+    // then fold it in with merge().
+    //
+
+    ProcrustesAccumulator chunk;
+    chunk._numPoints = numPoints;
+
+    if (weights == 0)
+    {
+        for (size_t i = 0; i < numPoints; ++i)
+        {
+            chunk._Acenter += (V3d) A[i];
+            chunk._Bcenter += (V3d) B[i];
+        }
+        chunk._weight = (double) numPoints;
+    }
+    else
+    {
+        for (size_t i = 0; i < numPoints; ++i)
+        {
+            const double w = weights[i];
+            chunk._weight += w;
+
+            chunk._Acenter += w * (V3d) A[i];
+            chunk._Bcenter += w * (V3d) B[i];
+        }
+    }
+
+    if (chunk._weight == 0)
+    {
+        _numPoints += numPoints;
+        return;
+    }
+
+    chunk._Acenter /= chunk._weight;
+    chunk._Bcenter /= chunk._weight;
+
+    KahanSum traceATA;
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+        const double w = weights ? (double) weights[i] : 1.0;
+        const V3d    a = (V3d) A[i] - chunk._Acenter;
+
+        chunk._covariance +=
+            outerProduct (w * ((V3d) B[i] - chunk._Bcenter), a);
+        traceATA += w * a.length2 ();
+    }
+    chunk._traceATA = traceATA.get ();
+
+    merge (chunk);
+}
+
+template <typename T>
+void
+ProcrustesAccumulator::add (
+    const Vec3<T>*       A,
+    const Vec3<T>*       B,
+    const T*             weights,
+    const size_t         numPoints,
+    const ParallelBuild& parallel)
+{
+    const unsigned int t =
+        parallelThreadCount (parallel.numThreads, numPoints, 16384);
+
+    if (t <= 1)
+    {
+        add (A, B, weights, numPoints);
+        return;
+    }
+
+    //
+    // One partial accumulator per slice, merged in slice order so the
+    // result does not depend on thread scheduling.
+    //
+
+    std::vector<ProcrustesAccumulator> partial (t);
+
+    parallelFor (0, t, t, 1, [&] (size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const size_t b = numPoints * i / t;
+            const size_t e = numPoints * (i + 1) / t;
+            partial[i].add (A + b, B + b, weights ? weights + b : 0, e - b);
+        }
+    });
+
+    for (unsigned int i = 0; i < t; ++i)
+        merge (partial[i]);
+}
+
+void
+ProcrustesAccumulator::merge (const ProcrustesAccumulator& other)
+{
+    if (other._weight == 0)
+    {
+        _numPoints += other._numPoints;
+        return;
+    }
+
+    if (_weight == 0)
+    {
+        const size_t n = _numPoints;
+        *this          = other;
+        _numPoints += n;
+        return;
+    }
+
+    //
+    // Pairwise update of the weighted moments (Chan, Golub and
+    // LeVeque): the centers move towards the other set's centers in
+    // proportion to its weight, and the second moments gain a term
+    // for the offset between the two centers.
+    //
+
+    const double weight = _weight + other._weight;
+    const double f      = other._weight / weight;
+    const V3d    dA     = other._Acenter - _Acenter;
+    const V3d    dB     = other._Bcenter - _Bcenter;
+
+    _covariance += other._covariance + outerProduct ((_weight * f) * dB, dA);
+    _traceATA += other._traceATA + (_weight * f) * dA.length2 ();
+    _Acenter += f * dA;
+    _Bcenter += f * dB;
+    _weight = weight;
+    _numPoints += other._numPoints;
+}
+
+M44d
+ProcrustesAccumulator::transform (const bool doScale) const
+{
+    if (_weight == 0) return M44d ();
+
+    //
+    // The rest matches procrustesRotationAndTranslation(); see the
+    // derivation there.
+    //
+
+    M33d U, V;
+    V3d  S;
+    jacobiSVD (
+        _covariance, U, S, V, std::numeric_limits<double>::epsilon (), true);
+
+    const M33d Qt = V * U.transposed ();
+
+    double s = 1.0;
+    if (doScale && _numPoints > 1)
+    {
+        KahanSum traceBATQ;
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j)
+                traceBATQ += Qt[j][i] * _covariance[i][j];
+
+        s = traceBATQ.get () / _traceATA;
+    }
+
+    const V3d translate = _Bcenter - s * _Acenter * Qt;
+
+    return M44d (
+        s * Qt.x[0][0],
+        s * Qt.x[0][1],
+        s * Qt.x[0][2],
+        0.0,
+        s * Qt.x[1][0],
+        s * Qt.x[1][1],
+        s * Qt.x[1][2],
+        0.0,
+        s * Qt.x[2][0],
+        s * Qt.x[2][1],
+        s * Qt.x[2][2],
+        0.0,
+        translate.x,
+        translate.y,
+        translate.z,
+        1.0);
+}
+
 /// TODO
 template IMATH_EXPORT M44d procrustesRotationAndTranslation (
     const V3d* from, const V3d* to, const size_t numPoints, const bool doScale);
@@ -268,6 +472,23 @@ template IMATH_EXPORT M44d procrustesRotationAndTranslation (
     const size_t numPoints,
     const bool   doScale);
 
+template IMATH_EXPORT void ProcrustesAccumulator::add (
+    const V3f* A, const V3f* B, const float* weights, const size_t numPoints);
+template IMATH_EXPORT void ProcrustesAccumulator::add (
+    const V3d* A, const V3d* B, const double* weights, const size_t numPoints);
+template IMATH_EXPORT void ProcrustesAccumulator::add (
+    const V3f*           A,
+    const V3f*           B,
+    const float*         weights,
+    const size_t         numPoints,
+    const ParallelBuild& parallel);
+template IMATH_EXPORT void ProcrustesAccumulator::add (
+    const V3d*           A,
+    const V3d*           B,
+    const double*        weights,
+    const size_t         numPoints,
+    const ParallelBuild& parallel);
+
 namespace
 {
 
@@ -979,6 +1200,245 @@ template IMATH_EXPORT void jacobiSVD (
 namespace
 {
 
+//
+// Determinant of m, expanded along the first row, with the cofactors
+// computed as in polarNewtonStep().
+//
+
+template <typename T>
+inline T
+polarDeterminant (const Matrix33<T>& m)
+{
+    return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) +
+           m[0][1] * (m[1][2] * m[2][0] - m[1][0] * m[2][2]) +
+           m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+}
+
+//
+// One step of the scaled Newton iteration for the orthogonal polar
+// factor of a nonsingular matrix X (Higham, "Computing the Polar
+// Decomposition - with Applications", 1986):
+//
+//     X' = (g * X + X^-T / g) / 2,   g = (|X^-1|_F / |X|_F)^(1/2)
+//
+// The rows of X^-T are the cross products of the rows of X divided by
+// det(X). Returns |X' - X|_F^2 and stores |X|_F^2 in norm2.
+//
+// The batched polarDecomposition() in ImathMatrixBatch.h evaluates the
+// same expressions in the same order.
+//
+
+template <typename T>
+T
+polarNewtonStep (Matrix33<T>& x, T& norm2)
+{
+    T c[3][3];
+
+    for (int i = 0; i < 3; ++i)
+    {
+        const T* u = x[(i + 1) % 3];
+        const T* v = x[(i + 2) % 3];
+
+        c[i][0] = u[1] * v[2] - u[2] * v[1];
+        c[i][1] = u[2] * v[0] - u[0] * v[2];
+        c[i][2] = u[0] * v[1] - u[1] * v[0];
+    }
+
+    const T det = x[0][0] * c[0][0] + x[0][1] * c[0][1] + x[0][2] * c[0][2];
+
+    T nx = 0;
+    T nc = 0;
+
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+        {
+            nx += x[i][j] * x[i][j];
+            nc += c[i][j] * c[i][j];
+        }
+
+    const T g = std::sqrt (std::sqrt (nc / (det * det * nx)));
+    const T a = T (0.5) * g;
+    const T b = T (0.5) / (g * det);
+
+    T d = 0;
+
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+        {
+            const T y = a * x[i][j] + b * c[i][j];
+            d += (y - x[i][j]) * (y - x[i][j]);
+            x[i][j] = y;
+        }
+
+    norm2 = nx;
+    return d;
+}
+
+//
+// Polar decomposition A = S * R with the Newton iteration. If
+// numIterations is positive, exactly that many steps are taken;
+// otherwise the iteration stops one step after the change falls below
+// sqrt(tol) relative to |X|_F, or after polarMaxIterations steps.
+//
+
+const int polarMaxIterations = 20;
+
+template <typename T>
+bool
+polarNewton (
+    const Matrix33<T>& A,
+    Matrix33<T>&       R,
+    Matrix33<T>&       S,
+    const T            tol,
+    const int          numIterations)
+{
+    const T det = polarDeterminant (A);
+
+    if (!(det != 0) || !std::isfinite (det))
+    {
+        R.makeIdentity ();
+        S = A;
+        return false;
+    }
+
+    //
+    // Starting from -A when det(A) < 0 makes the orthogonal factor a
+    // rotation; S then absorbs the reflection.
+    //
+
+    Matrix33<T> x = det < 0 ? -A : A;
+    bool        converged = numIterations > 0;
+
+    if (numIterations > 0)
+    {
+        T norm2;
+
+        for (int k = 0; k < numIterations; ++k)
+            polarNewtonStep (x, norm2);
+    }
+    else
+    {
+        bool last = false;
+
+        for (int k = 0; k < polarMaxIterations; ++k)
+        {
+            T       norm2;
+            const T d = polarNewtonStep (x, norm2);
+
+            if (last)
+            {
+                converged = true;
+                break;
+            }
+
+            last = d <= tol * norm2;
+        }
+    }
+
+    R = x;
+
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            S[i][j] = A[i][0] * R[j][0] + A[i][1] * R[j][1] + A[i][2] * R[j][2];
+
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < i; ++j)
+            S[i][j] = S[j][i] = T (0.5) * (S[i][j] + S[j][i]);
+
+    return converged;
+}
+
+template <typename T>
+bool
+polarNewton (
+    const Matrix44<T>& A,
+    Matrix44<T>&       R,
+    Matrix44<T>&       S,
+    const T            tol,
+    const int          numIterations)
+{
+    Matrix33<T> a, r, s;
+
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            a[i][j] = A[i][j];
+
+    const bool ok = polarNewton (a, r, s, tol, numIterations);
+
+    R.makeIdentity ();
+    S.makeIdentity ();
+
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+        {
+            R[i][j] = r[i][j];
+            S[i][j] = s[i][j];
+        }
+
+    return ok;
+}
+
+} // namespace
+
+template <typename T>
+bool
+polarDecomposition (
+    const Matrix33<T>& A, Matrix33<T>& R, Matrix33<T>& S, const T tol)
+{
+    return polarNewton (A, R, S, tol, 0);
+}
+
+template <typename T>
+bool
+polarDecomposition (
+    const Matrix44<T>& A, Matrix44<T>& R, Matrix44<T>& S, const T tol)
+{
+    return polarNewton (A, R, S, tol, 0);
+}
+
+template <typename T>
+bool
+fastPolarDecomposition (
+    const Matrix33<T>& A,
+    Matrix33<T>&       R,
+    Matrix33<T>&       S,
+    const int          numIterations)
+{
+    return polarNewton (A, R, S, T (0), std::max (numIterations, 1));
+}
+
+template <typename T>
+bool
+fastPolarDecomposition (
+    const Matrix44<T>& A,
+    Matrix44<T>&       R,
+    Matrix44<T>&       S,
+    const int          numIterations)
+{
+    return polarNewton (A, R, S, T (0), std::max (numIterations, 1));
+}
+
+template IMATH_EXPORT bool polarDecomposition (
+    const M33f& A, M33f& R, M33f& S, const float tol);
+template IMATH_EXPORT bool polarDecomposition (
+    const M33d& A, M33d& R, M33d& S, const double tol);
+template IMATH_EXPORT bool polarDecomposition (
+    const M44f& A, M44f& R, M44f& S, const float tol);
+template IMATH_EXPORT bool polarDecomposition (
+    const M44d& A, M44d& R, M44d& S, const double tol);
+
+template IMATH_EXPORT bool fastPolarDecomposition (
+    const M33f& A, M33f& R, M33f& S, const int numIterations);
+template IMATH_EXPORT bool fastPolarDecomposition (
+    const M33d& A, M33d& R, M33d& S, const int numIterations);
+template IMATH_EXPORT bool fastPolarDecomposition (
+    const M44f& A, M44f& R, M44f& S, const int numIterations);
+template IMATH_EXPORT bool fastPolarDecomposition (
+    const M44d& A, M44d& R, M44d& S, const int numIterations);
+
+namespace
+{
+
 template <int j, int k, typename TM>
 inline void
 jacobiRotateRight (
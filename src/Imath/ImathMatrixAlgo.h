@@ -17,6 +17,7 @@
 #include "ImathExport.h"
 #include "ImathMatrix.h"
 #include "ImathNamespace.h"
+#include "ImathParallel.h"
 #include "ImathQuat.h"
 #include "ImathVec.h"
 #include <math.h>
@@ -1462,6 +1463,79 @@ M44d procrustesRotationAndTranslation (
     const size_t   numPoints,
     const bool     doScaling = false);
 
+///
+/// Incremental form of procrustesRotationAndTranslation() for point
+/// sets that are too large to hold in memory at once.
+///
+/// The accumulator keeps only the weighted centers of the 'from' and
+/// 'to' points, their weighted cross-covariance and the weighted
+/// spread of the 'from' points, all in double precision. Chunks of
+/// points are absorbed with add(), and accumulators filled
+/// independently (for instance one per thread) are combined with
+/// merge(). Once every point has been added, transform() returns the
+/// same rotation, translation and optional uniform scale that
+/// procrustesRotationAndTranslation() computes over the whole set, up
+/// to rounding.
+///
+/// Example:
+///
+///     ProcrustesAccumulator acc;
+///     while (readChunk (from, to, weights, n))
+///         acc.add (from, to, weights, n, ParallelBuild ());
+///     M44d m = acc.transform (true);
+///
+
+class IMATH_EXPORT_TYPE ProcrustesAccumulator
+{
+  public:
+    /// Construct an empty accumulator
+    IMATH_EXPORT ProcrustesAccumulator ();
+
+    /// Add `numPoints` point pairs with the given per-point weights.
+    /// If `weights` is null, every point has weight 1.
+    template <typename T>
+    IMATH_EXPORT void add (
+        const Vec3<T>* A,
+        const Vec3<T>* B,
+        const T*       weights,
+        const size_t   numPoints);
+
+    /// Add `numPoints` point pairs, splitting the chunk across threads.
+    /// If `weights` is null, every point has weight 1.
+    template <typename T>
+    IMATH_EXPORT void add (
+        const Vec3<T>*       A,
+        const Vec3<T>*       B,
+        const T*             weights,
+        const size_t         numPoints,
+        const ParallelBuild& parallel);
+
+    /// Combine the points added to `other` into this accumulator.
+    IMATH_EXPORT void merge (const ProcrustesAccumulator& other);
+
+    /// Forget every point added so far.
+    IMATH_EXPORT void clear ();
+
+    /// The number of points added so far
+    size_t numPoints () const { return _numPoints; }
+
+    /// The sum of the weights added so far
+    double weight () const { return _weight; }
+
+    /// Return the procrustes transformation of the points added so
+    /// far, the identity if there are none or their weights sum to
+    /// zero. If `doScaling` is true, a uniform scale is allowed also.
+    IMATH_EXPORT M44d transform (const bool doScaling = false) const;
+
+  private:
+    size_t _numPoints;
+    double _weight;
+    V3d    _Acenter;
+    V3d    _Bcenter;
+    M33d   _covariance;
+    double _traceATA;
+};
+
 /// Compute the SVD of a 3x3 matrix using Jacobi transformations.  This method
 /// should be quite accurate (competitive with LAPACK) even for poorly
 /// conditioned matrices, and because it has been written specifically for the
@@ -1510,6 +1584,68 @@ void jacobiSVD (
     const T            tol = std::numeric_limits<T>::epsilon (),
     const bool         forcePositiveDeterminant = false);
 
+/// Compute the polar decomposition of a 3x3 matrix with Higham's scaled
+/// Newton iteration. This is much faster than going through jacobiSVD()
+/// when only the rotation is needed.
+///
+/// The polar decomposition of A is defined as follows:
+///     A = S * R
+/// where R is a rotation and S is symmetric. With Imath's row vector
+/// convention, A applies the stretch S first and then the rotation R,
+/// as in the S * H * R * T order of extractSHRT(). S is positive
+/// definite if A has a positive determinant. If A has a negative
+/// determinant, its nearest orthogonal matrix is a reflection; R is then
+/// the negated reflection, and S is negative definite.
+///
+/// The iteration stops once it has converged to within `tol`.
+///
+/// Currently only available for single- and double-precision matrices.
+/// @return false if A is singular or the iteration did not converge, in
+/// which case R and S are invalid
+template <typename T>
+bool polarDecomposition (
+    const Matrix33<T>& A,
+    Matrix33<T>&       R,
+    Matrix33<T>&       S,
+    const T            tol = std::numeric_limits<T>::epsilon ());
+
+/// Compute the polar decomposition A = S * R of the upper left 3x3
+/// block of a 4x4 matrix, as above. The translation of A is ignored; R
+/// and S hold the rotation and the stretch in their upper left 3x3
+/// blocks and are the identity elsewhere.
+/// @return false if A is singular or the iteration did not converge, in
+/// which case R and S are invalid
+template <typename T>
+bool polarDecomposition (
+    const Matrix44<T>& A,
+    Matrix44<T>&       R,
+    Matrix44<T>&       S,
+    const T            tol = std::numeric_limits<T>::epsilon ());
+
+/// Compute the polar decomposition A = S * R of a 3x3 matrix, as
+/// polarDecomposition() does, but with a fixed number of iterations
+/// instead of a convergence test. Each iteration roughly squares the
+/// error once it is below one; the default of 5 reaches single
+/// precision for condition numbers up to about 10^4, and double
+/// precision needs one more iteration.
+/// @return false if A is singular, in which case R and S are invalid
+template <typename T>
+bool fastPolarDecomposition (
+    const Matrix33<T>& A,
+    Matrix33<T>&       R,
+    Matrix33<T>&       S,
+    const int          numIterations = 5);
+
+/// Compute the polar decomposition A = S * R of the upper left 3x3
+/// block of a 4x4 matrix with a fixed number of iterations, as above.
+/// @return false if A is singular, in which case R and S are invalid
+template <typename T>
+bool fastPolarDecomposition (
+    const Matrix44<T>& A,
+    Matrix44<T>&       R,
+    Matrix44<T>&       S,
+    const int          numIterations = 5);
+
 /// Compute the eigenvalues (S) and the eigenvectors (V) of a real
 /// symmetric matrix using Jacobi transformation, using a given
 /// tolerance `tol`.
@@ -0,0 +1,2455 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+//
+// Bulk operations on many 4x4 matrices at once:
+//
+// - Matrix-matrix multiplication, for composing the transforms of many
+//   objects or of the nodes of a transform hierarchy. Each product is
+//   computed with Matrix44<T>::multiply(), which uses the SSE/AVX or
+//   NEON kernels for M44f and M44d, so the results are identical to
+//   multiplying the matrices one pair at a time. The variants taking a
+//   ParallelBuild additionally split the work across threads.
+//
+// - Decomposition of matrices stored as a structure of arrays, in a
+//   Matrix44Array, into scale, shear, rotation and translation. The
+//   scale and shear extraction processes blocks of matrices with loops
+//   the compiler vectorizes, and reports failures per matrix instead of
+//   throwing. The results are identical to those of the corresponding
+//   functions in ImathMatrixAlgo.h.
+//
+// - Eigendecomposition of symmetric 3x3 matrices and singular value
+//   decomposition of 3x3 matrices, with the Jacobi methods of
+//   jacobiEigenSolver() and jacobiSVD(), for blocks of matrices at a
+//   time without branching per matrix.
+//
+// - Polar decomposition of 3x3 matrices into a stretch and a rotation,
+//   with the Newton iteration of polarDecomposition(), vectorized
+//   across blocks of matrices in the same way.
+//
+// - Conversion between arrays of quaternions and arrays of rotation
+//   matrices, with the pivot of the matrix-to-quaternion conversion
+//   chosen per matrix without branching.
+//
+// - Conversion between arrays of Euler angles and arrays of rotation
+//   matrices, for an order of the angles fixed at compile time, with
+//   vectorized sines, cosines and arc tangents.
+//
+
+#ifndef INCLUDED_IMATHMATRIXBATCH_H
+#define INCLUDED_IMATHMATRIXBATCH_H
+
+#include "ImathExport.h"
+#include "ImathNamespace.h"
+
+#include "ImathBatchMath.h"
+#include "ImathEuler.h"
+#include "ImathMatrix.h"
+#include "ImathMatrixAlgo.h"
+#include "ImathParallel.h"
+#include "ImathQuatArray.h"
+#include "ImathVecArray.h"
+
+#include <limits>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
+
+///
+/// A structure-of-arrays container of 4x4 matrices: entry `[i][j]` of
+/// every matrix is stored in lane `4 * i + j`.
+///
+
+template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Matrix44Array
+    : public VecArrayBase<T, 16>
+{
+public:
+    /// @{
+    /// @name Constructors and Assignment
+
+    /// An empty array
+    Matrix44Array () IMATH_NOEXCEPT {}
+
+    /// An array of `n` uninitialized matrices
+    explicit Matrix44Array (size_t n) : VecArrayBase<T, 16> (n) {}
+
+    /// Copy `n` matrices from `m`
+    Matrix44Array (const Matrix44<T>* m, size_t n);
+
+    /// Copy the matrices in `m`
+    explicit Matrix44Array (const std::vector<Matrix44<T>>& m);
+
+    /// @}
+
+    /// @{
+    /// @name Direct access to the entry arrays
+
+    /// The array of entries `[i][j]`
+    T* entry (int i, int j) IMATH_NOEXCEPT { return this->lane (4 * i + j); }
+
+    /// The array of entries `[i][j]`
+    const T* entry (int i, int j) const IMATH_NOEXCEPT
+    {
+        return this->lane (4 * i + j);
+    }
+
+    /// @}
+
+    /// @{
+    /// @name Element access and conversion
+
+    /// Return matrix `k`
+    Matrix44<T> operator[] (size_t k) const IMATH_NOEXCEPT;
+
+    /// Set matrix `k`
+    void set (size_t k, const Matrix44<T>& m) IMATH_NOEXCEPT;
+
+    /// Replace the contents with `n` matrices copied from `m`
+    void assign (const Matrix44<T>* m, size_t n);
+
+    /// Copy the matrices to `m`, which must hold `size()` matrices
+    void copyTo (Matrix44<T>* m) const IMATH_NOEXCEPT;
+
+    /// Return the matrices as an array of structs
+    std::vector<Matrix44<T>> toVector () const;
+
+    /// @}
+};
+
+/// Matrix44Array of float
+typedef Matrix44Array<float> M44fArray;
+
+/// Matrix44Array of double
+typedef Matrix44Array<double> M44dArray;
+
+template <class T>
+inline Matrix44Array<T>::Matrix44Array (const Matrix44<T>* m, size_t n)
+{
+    assign (m, n);
+}
+
+template <class T>
+inline Matrix44Array<T>::Matrix44Array (const std::vector<Matrix44<T>>& m)
+{
+    assign (m.data (), m.size ());
+}
+
+template <class T>
+inline Matrix44<T>
+Matrix44Array<T>::operator[] (size_t k) const IMATH_NOEXCEPT
+{
+    Matrix44<T> m (UNINITIALIZED);
+
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 4; ++j)
+            m.x[i][j] = entry (i, j)[k];
+
+    return m;
+}
+
+template <class T>
+inline void
+Matrix44Array<T>::set (size_t k, const Matrix44<T>& m) IMATH_NOEXCEPT
+{
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 4; ++j)
+            entry (i, j)[k] = m.x[i][j];
+}
+
+template <class T>
+inline void
+Matrix44Array<T>::assign (const Matrix44<T>* m, size_t n)
+{
+    this->resize (n);
+
+    for (size_t k = 0; k < n; ++k)
+        set (k, m[k]);
+}
+
+template <class T>
+inline void
+Matrix44Array<T>::copyTo (Matrix44<T>* m) const IMATH_NOEXCEPT
+{
+    for (size_t k = 0; k < this->size (); ++k)
+        m[k] = (*this)[k];
+}
+
+template <class T>
+inline std::vector<Matrix44<T>>
+Matrix44Array<T>::toVector () const
+{
+    std::vector<Matrix44<T>> m (this->size ());
+
+    if (!m.empty ()) copyTo (m.data ());
+
+    return m;
+}
+
+/// @cond Doxygen_Suppress
+
+namespace MatrixBatchDetail
+{
+
+//
+// Smallest number of matrix products worth handing to a thread.
+//
+
+const size_t grainSize = 4096;
+
+template <class T>
+inline void
+multiplyRange (
+    const Matrix44<T>* a,
+    const Matrix44<T>* b,
+    Matrix44<T>*       c,
+    size_t             begin,
+    size_t             end) IMATH_NOEXCEPT
+{
+    for (size_t i = begin; i < end; ++i)
+        Matrix44<T>::multiply (a[i], b[i], c[i]);
+}
+
+template <class T>
+inline void
+composeNode (
+    const Matrix44<T>* local,
+    const int*         parent,
+    Matrix44<T>*       world,
+    size_t             i) IMATH_NOEXCEPT
+{
+    if (parent[i] < 0)
+        world[i] = local[i];
+    else
+        Matrix44<T>::multiply (local[i], world[parent[i]], world[i]);
+}
+
+//
+// Number of matrices processed per block by the decomposition and
+// solvers below. The intermediate values of a block live on the stack.
+//
+
+const size_t blockSize = 64;
+
+template <class T> struct DecomposeBlock
+{
+    T   row[3][3][blockSize];
+    T   maxVal[blockSize];
+    T   scl[3][blockSize];
+    T   shr[3][blockSize];
+    int fail[blockSize];
+};
+
+//
+// Nonzero if checkForZeroScaleInRow (s, Vec3<T> (x, y, z)) fails.
+//
+
+template <class T>
+inline int
+zeroScale (T s, T x, T y, T z) IMATH_NOEXCEPT
+{
+    const T a = IMATH_INTERNAL_NAMESPACE::abs (s);
+    const T m = (std::numeric_limits<T>::max) () * a;
+
+    return int (a < 1) & (int (IMATH_INTERNAL_NAMESPACE::abs (x) >= m) |
+                          int (IMATH_INTERNAL_NAMESPACE::abs (y) >= m) |
+                          int (IMATH_INTERNAL_NAMESPACE::abs (z) >= m));
+}
+
+//
+// Lengths of n rows, as computed by Vec3::length().
+//
+
+template <class T>
+inline void
+rowLength (
+    const T* IMATH_RESTRICT x,
+    const T* IMATH_RESTRICT y,
+    const T* IMATH_RESTRICT z,
+    T* IMATH_RESTRICT       l,
+    size_t                  n) IMATH_NOEXCEPT
+{
+    const T limit = T (2) * std::numeric_limits<T>::min ();
+    int     tiny  = 0;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        l[i] = x[i] * x[i] + y[i] * y[i] + z[i] * z[i];
+        tiny |= int (l[i] < limit);
+    }
+
+    VecArrayDetail::sqrt (l, n);
+
+    if (IMATH_UNLIKELY (tiny))
+    {
+        for (size_t i = 0; i < n; ++i)
+            if (l[i] * l[i] < T (4) * limit)
+                l[i] = Vec3<T> (x[i], y[i], z[i]).length ();
+    }
+}
+
+//
+// extractAndRemoveScalingAndShear() for matrices [begin, begin + n),
+// n <= blockSize. Every step is applied to all the matrices
+// in the block, in the same order as in the scalar version, with the
+// failure checks accumulated in b.fail instead of returning early. The
+// results for matrices whose fail flag is set are meaningless.
+//
+
+template <class T>
+void
+removeScalingAndShear (
+    const Matrix44Array<T>& m,
+    size_t                  begin,
+    size_t                  n,
+    DecomposeBlock<T>&      b) IMATH_NOEXCEPT
+{
+    T (*row)[3][blockSize]     = b.row;
+    T* IMATH_RESTRICT   maxVal = b.maxVal;
+    int* IMATH_RESTRICT fail   = b.fail;
+
+    for (int r = 0; r < 3; ++r)
+        for (int c = 0; c < 3; ++c)
+        {
+            const T* e = m.entry (r, c) + begin;
+
+            for (size_t i = 0; i < n; ++i)
+                row[r][c][i] = e[i];
+        }
+
+    //
+    // Normalize the 3x3 matrix by its largest entry
+    //
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        maxVal[i] = 0;
+        fail[i]   = 0;
+    }
+
+    for (int r = 0; r < 3; ++r)
+        for (int c = 0; c < 3; ++c)
+            for (size_t i = 0; i < n; ++i)
+            {
+                const T a = IMATH_INTERNAL_NAMESPACE::abs (row[r][c][i]);
+                maxVal[i] = a > maxVal[i] ? a : maxVal[i];
+            }
+
+    for (int r = 0; r < 3; ++r)
+    {
+        T* IMATH_RESTRICT x = row[r][0];
+        T* IMATH_RESTRICT y = row[r][1];
+        T* IMATH_RESTRICT z = row[r][2];
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            const T mv = maxVal[i];
+            const T d  = mv != 0 ? mv : T (1);
+
+            fail[i] |= int (mv != 0) & zeroScale (mv, x[i], y[i], z[i]);
+
+            x[i] /= d;
+            y[i] /= d;
+            z[i] /= d;
+        }
+    }
+
+    //
+    // Gram-Schmidt orthogonalization, extracting the scale of each row
+    // and the shear between the rows
+    //
+
+    T* IMATH_RESTRICT x0 = row[0][0];
+    T* IMATH_RESTRICT y0 = row[0][1];
+    T* IMATH_RESTRICT z0 = row[0][2];
+    T* IMATH_RESTRICT x1 = row[1][0];
+    T* IMATH_RESTRICT y1 = row[1][1];
+    T* IMATH_RESTRICT z1 = row[1][2];
+    T* IMATH_RESTRICT x2 = row[2][0];
+    T* IMATH_RESTRICT y2 = row[2][1];
+    T* IMATH_RESTRICT z2 = row[2][2];
+    T* IMATH_RESTRICT sx = b.scl[0];
+    T* IMATH_RESTRICT sy = b.scl[1];
+    T* IMATH_RESTRICT sz = b.scl[2];
+    T* IMATH_RESTRICT h0 = b.shr[0];
+    T* IMATH_RESTRICT h1 = b.shr[1];
+    T* IMATH_RESTRICT h2 = b.shr[2];
+
+    rowLength (x0, y0, z0, sx, n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        fail[i] |= zeroScale (sx[i], x0[i], y0[i], z0[i]);
+
+        x0[i] /= sx[i];
+        y0[i] /= sx[i];
+        z0[i] /= sx[i];
+
+        h0[i] = x0[i] * x1[i] + y0[i] * y1[i] + z0[i] * z1[i];
+
+        x1[i] -= h0[i] * x0[i];
+        y1[i] -= h0[i] * y0[i];
+        z1[i] -= h0[i] * z0[i];
+    }
+
+    rowLength (x1, y1, z1, sy, n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        fail[i] |= zeroScale (sy[i], x1[i], y1[i], z1[i]);
+
+        x1[i] /= sy[i];
+        y1[i] /= sy[i];
+        z1[i] /= sy[i];
+        h0[i] /= sy[i];
+
+        h1[i] = x0[i] * x2[i] + y0[i] * y2[i] + z0[i] * z2[i];
+
+        x2[i] -= h1[i] * x0[i];
+        y2[i] -= h1[i] * y0[i];
+        z2[i] -= h1[i] * z0[i];
+
+        h2[i] = x1[i] * x2[i] + y1[i] * y2[i] + z1[i] * z2[i];
+
+        x2[i] -= h2[i] * x1[i];
+        y2[i] -= h2[i] * y1[i];
+        z2[i] -= h2[i] * z1[i];
+    }
+
+    rowLength (x2, y2, z2, sz, n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        fail[i] |= zeroScale (sz[i], x2[i], y2[i], z2[i]);
+
+        x2[i] /= sz[i];
+        y2[i] /= sz[i];
+        z2[i] /= sz[i];
+        h1[i] /= sz[i];
+        h2[i] /= sz[i];
+
+        //
+        // Negate the rows and the scale if the coordinate system is
+        // flipped, and undo the normalization of the scale
+        //
+
+        const T det = x0[i] * (y1[i] * z2[i] - z1[i] * y2[i]) +
+                      y0[i] * (z1[i] * x2[i] - x1[i] * z2[i]) +
+                      z0[i] * (x1[i] * y2[i] - y1[i] * x2[i]);
+
+        const T f = det < 0 ? T (-1) : T (1);
+
+        x0[i] *= f;
+        y0[i] *= f;
+        z0[i] *= f;
+        x1[i] *= f;
+        y1[i] *= f;
+        z1[i] *= f;
+        x2[i] *= f;
+        y2[i] *= f;
+        z2[i] *= f;
+
+        sx[i] = sx[i] * f * maxVal[i];
+        sy[i] = sy[i] * f * maxVal[i];
+        sz[i] = sz[i] * f * maxVal[i];
+    }
+}
+
+//
+// Store the scale and shear of a decomposed block, and report which
+// matrices failed. Returns true if none did.
+//
+
+template <class T>
+inline bool
+storeScalingAndShear (
+    const DecomposeBlock<T>& b,
+    size_t                   begin,
+    size_t                   n,
+    Vec3Array<T>&            scl,
+    Vec3Array<T>&            shr,
+    bool*                    ok) IMATH_NOEXCEPT
+{
+    int failed = 0;
+
+    for (int c = 0; c < 3; ++c)
+    {
+        T* IMATH_RESTRICT s = scl.lane (c) + begin;
+        T* IMATH_RESTRICT h = shr.lane (c) + begin;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            s[i] = b.scl[c][i];
+            h[i] = b.shr[c][i];
+        }
+    }
+
+    for (size_t i = 0; i < n; ++i)
+        failed |= b.fail[i];
+
+    if (ok)
+    {
+        for (size_t i = 0; i < n; ++i)
+            ok[begin + i] = !b.fail[i];
+    }
+
+    return !failed;
+}
+
+//
+// Jacobi eigensolver and SVD for blocks of symmetric or general 3x3
+// matrices. These apply the same rotations as jacobiEigenSolver() and
+// jacobiSVD() in ImathMatrixAlgo.cpp to every matrix in a block. Rather
+// than branching, each step computes its result for all the matrices
+// and selects per matrix whether to keep it, and a matrix whose
+// iteration has finished is carried along unchanged until the whole
+// block is done. This gives the same results as the scalar functions.
+//
+
+const int jacobiMaxIter = 20;
+
+//
+// Return m ? a : b. Compilers move a computation that feeds only one
+// side of ?: into a branch, and then cannot vectorize the loop because
+// floating-point operations may trap; selecting with bit masks keeps
+// the loops branch-free.
+//
+
+template <class T> struct SelectBits;
+template <> struct SelectBits<float>
+{
+    typedef uint32_t Type;
+};
+template <> struct SelectBits<double>
+{
+    typedef uint64_t Type;
+};
+
+template <class T>
+inline T
+select (int m, T a, T b) IMATH_NOEXCEPT
+{
+    typedef typename SelectBits<T>::Type U;
+
+    U ua, ub;
+    memcpy (&ua, &a, sizeof (a));
+    memcpy (&ub, &b, sizeof (b));
+
+    const U mask = U (0) - U (m != 0);
+    const U r    = (ua & mask) | (ub & ~mask);
+
+    T x;
+    memcpy (&x, &r, sizeof (x));
+    return x;
+}
+
+template <class T> struct JacobiBlock
+{
+    T   a[3][3][blockSize];
+    T   u[3][3][blockSize];
+    T   v[3][3][blockSize];
+    T   s[3][blockSize];
+    T   z[3][blockSize];
+    T   absTol[blockSize];
+    T   tmp[4][blockSize];
+    int flag[2][blockSize];
+    int done[blockSize];
+    int changed[blockSize];
+};
+
+template <class T>
+inline void
+setIdentity (T m[3][3][blockSize], size_t n) IMATH_NOEXCEPT
+{
+    for (int r = 0; r < 3; ++r)
+        for (int c = 0; c < 3; ++c)
+            for (size_t i = 0; i < n; ++i)
+                m[r][c][i] = r == c ? T (1) : T (0);
+}
+
+template <class T>
+inline void
+load (const Matrix33<T>* m, T b[3][3][blockSize], size_t n) IMATH_NOEXCEPT
+{
+    for (size_t i = 0; i < n; ++i)
+        for (int r = 0; r < 3; ++r)
+            for (int c = 0; c < 3; ++c)
+                b[r][c][i] = m[i][r][c];
+}
+
+template <class T>
+inline void
+store (const T b[3][3][blockSize], Matrix33<T>* m, size_t n) IMATH_NOEXCEPT
+{
+    for (size_t i = 0; i < n; ++i)
+        for (int r = 0; r < 3; ++r)
+            for (int c = 0; c < 3; ++c)
+                m[i][r][c] = b[r][c][i];
+}
+
+//
+// Maximum of |a[r][c]| over the entries (r, c) in the list, ignoring
+// NaNs like std::max() does.
+//
+
+template <class T>
+inline void
+maxAbs (
+    const T a[3][3][blockSize],
+    const int (*entries)[2],
+    int               count,
+    T* IMATH_RESTRICT result,
+    size_t            n) IMATH_NOEXCEPT
+{
+    for (size_t i = 0; i < n; ++i)
+        result[i] = 0;
+
+    for (int e = 0; e < count; ++e)
+    {
+        const T* IMATH_RESTRICT x = a[entries[e][0]][entries[e][1]];
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            const T y = std::abs (x[i]);
+            result[i] = result[i] < y ? y : result[i];
+        }
+    }
+}
+
+const int upperEntries[3][2]   = {{0, 1}, {0, 2}, {1, 2}};
+const int offDiagEntries[6][2] = {
+    {0, 1}, {0, 2}, {1, 0}, {1, 2}, {2, 0}, {2, 1}};
+
+//
+// Mark the matrices whose iteration has finished, and return whether
+// any has not.
+//
+
+template <class T>
+inline bool
+updateDone (JacobiBlock<T>& b, const T* IMATH_RESTRICT off, size_t n)
+    IMATH_NOEXCEPT
+{
+    int active = 0;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        b.done[i] |= int (!b.changed[i]) | int (!(off[i] > b.absTol[i]));
+        active |= !b.done[i];
+    }
+
+    return active != 0;
+}
+
+//
+// One rotation of jacobiEigenSolver(), zeroing entry [j][k] of the
+// upper triangle of each matrix.
+//
+
+template <int j, int k, int l, class T>
+void
+eigenRotation (JacobiBlock<T>& b, size_t n, const T tol) IMATH_NOEXCEPT
+{
+    T* IMATH_RESTRICT         ajj  = b.a[j][j];
+    T* IMATH_RESTRICT         ajk  = b.a[j][k];
+    T* IMATH_RESTRICT         akk  = b.a[k][k];
+    T* IMATH_RESTRICT         off1 = l < j ? b.a[l][j] : b.a[j][l];
+    T* IMATH_RESTRICT         off2 = l < k ? b.a[l][k] : b.a[k][l];
+    T* IMATH_RESTRICT         zj   = b.z[j];
+    T* IMATH_RESTRICT         zk   = b.z[k];
+    T* IMATH_RESTRICT         t    = b.tmp[0];
+    T* IMATH_RESTRICT         q    = b.tmp[1];
+    int* IMATH_RESTRICT       rot  = b.flag[0];
+    const int* IMATH_RESTRICT done = b.done;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const T mu1 = akk[i] - ajj[i];
+        const T mu2 = T (2) * ajk[i];
+
+        rot[i] = int (!done[i]) &
+                 int (!(std::abs (mu2) <= tol * std::abs (mu1)));
+        t[i]   = mu1 / mu2;
+        q[i]   = T (1) + t[i] * t[i];
+    }
+
+    VecArrayDetail::sqrt (q, n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const T rho = t[i];
+        const T tt  = (rho < 0 ? T (-1) : T (1)) / (std::abs (rho) + q[i]);
+
+        t[i] = select (rot[i], tt, T (0));
+        q[i] = T (1) + t[i] * t[i];
+    }
+
+    VecArrayDetail::sqrt (q, n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const T c   = T (1) / q[i];
+        const T s   = t[i] * c;
+        const T tau = s / (T (1) + c);
+        const T th  = t[i] * ajk[i];
+        const T h   = select (rot[i], th, T (0));
+
+        zj[i] -= h;
+        zk[i] += h;
+        ajj[i] -= h;
+        akk[i] += h;
+        ajk[i] = done[i] ? ajk[i] : T (0);
+
+        const T nu1 = off1[i];
+        const T nu2 = off2[i];
+        const T o1  = nu1 - s * (nu2 + tau * nu1);
+        const T o2  = nu2 + s * (nu1 - tau * nu2);
+
+        off1[i] = select (rot[i], o1, nu1);
+        off2[i] = select (rot[i], o2, nu2);
+
+        for (int r = 0; r < 3; ++r)
+        {
+            const T v1 = b.v[r][j][i];
+            const T v2 = b.v[r][k][i];
+            const T w1 = v1 - s * (v2 + tau * v1);
+            const T w2 = v2 + s * (v1 - tau * v2);
+
+            b.v[r][j][i] = select (rot[i], w1, v1);
+            b.v[r][k][i] = select (rot[i], w2, v2);
+        }
+
+        b.changed[i] |= rot[i];
+    }
+}
+
+//
+// jacobiEigenSolver() for n <= blockSize symmetric matrices in b.a.
+//
+
+template <class T>
+void
+eigenSolve (JacobiBlock<T>& b, size_t n, const T tol) IMATH_NOEXCEPT
+{
+    T* IMATH_RESTRICT off = b.tmp[2];
+
+    setIdentity (b.v, n);
+
+    for (int c = 0; c < 3; ++c)
+        for (size_t i = 0; i < n; ++i)
+            b.s[c][i] = b.a[c][c][i];
+
+    maxAbs (b.a, upperEntries, 3, off, n);
+
+    int active = 0;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        b.absTol[i] = tol * off[i];
+        b.done[i]   = b.absTol[i] == 0;
+        active |= !b.done[i];
+    }
+
+    for (int iter = 0; active && iter < jacobiMaxIter; ++iter)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            b.z[0][i]    = 0;
+            b.z[1][i]    = 0;
+            b.z[2][i]    = 0;
+            b.changed[i] = 0;
+        }
+
+        eigenRotation<0, 1, 2> (b, n, tol);
+        eigenRotation<0, 2, 1> (b, n, tol);
+        eigenRotation<1, 2, 0> (b, n, tol);
+
+        //
+        // Add the changes accumulated during the sweep to the eigenvalues
+        //
+
+        for (int c = 0; c < 3; ++c)
+            for (size_t i = 0; i < n; ++i)
+            {
+                const T s = b.s[c][i] + b.z[c][i];
+
+                b.s[c][i]    = select (b.done[i], b.s[c][i], s);
+                b.a[c][c][i] = b.s[c][i];
+            }
+
+        maxAbs (b.a, upperEntries, 3, off, n);
+        active = updateDone (b, off, n);
+    }
+}
+
+//
+// One rotation of jacobiSVD(), zeroing entries [j][k] and [k][j] of each
+// matrix.
+//
+
+template <int j, int k, int l, class T>
+void
+svdRotation (JacobiBlock<T>& b, size_t n, const T tol) IMATH_NOEXCEPT
+{
+    T* IMATH_RESTRICT         ajj   = b.a[j][j];
+    T* IMATH_RESTRICT         ajk   = b.a[j][k];
+    T* IMATH_RESTRICT         akj   = b.a[k][j];
+    T* IMATH_RESTRICT         akk   = b.a[k][k];
+    T* IMATH_RESTRICT         cs    = b.tmp[0];
+    T* IMATH_RESTRICT         sn    = b.tmp[1];
+    T* IMATH_RESTRICT         t     = b.tmp[2];
+    T* IMATH_RESTRICT         q     = b.tmp[3];
+    int* IMATH_RESTRICT       sym   = b.flag[0];
+    int* IMATH_RESTRICT       small = b.flag[1];
+    const int* IMATH_RESTRICT done  = b.done;
+
+    //
+    // Symmetrize the 2x2 submatrix
+    //
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const T mu1 = ajj[i] + akk[i];
+        const T mu2 = ajk[i] - akj[i];
+
+        sym[i] = std::abs (mu2) <= tol * std::abs (mu1);
+        t[i]   = mu1 / mu2;
+        q[i]   = T (1) + t[i] * t[i];
+    }
+
+    VecArrayDetail::sqrt (q, n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const T w   = ajj[i];
+        const T x   = ajk[i];
+        const T y   = akj[i];
+        const T z   = akk[i];
+        const T rho = t[i];
+
+        T s = T (1) / q[i];
+        s   = rho < 0 ? -s : s;
+        T c = s * rho;
+
+        c = select (sym[i], T (1), c);
+        s = select (sym[i], T (0), s);
+
+        const T mu1 = select (sym[i], z - w, s * (x + y) + c * (z - w));
+        const T mu2 = select (sym[i], x + y, T (2) * (c * x - s * z));
+
+        small[i] = std::abs (mu2) <= tol * std::abs (mu1);
+        cs[i]    = c;
+        sn[i]    = s;
+        t[i]     = mu1 / mu2;
+        q[i]     = T (1) + t[i] * t[i];
+    }
+
+    //
+    // Diagonalize the symmetric 2x2 matrix
+    //
+
+    VecArrayDetail::sqrt (q, n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const T rho = t[i];
+        const T t2  = T (1) / (std::abs (rho) + q[i]);
+
+        t[i] = rho < 0 ? -t2 : t2;
+        q[i] = T (1) + t[i] * t[i];
+    }
+
+    VecArrayDetail::sqrt (q, n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const T w = ajj[i];
+        const T x = ajk[i];
+        const T y = akj[i];
+        const T z = akk[i];
+
+        T c2 = T (1) / q[i];
+        T s2 = c2 * t[i];
+
+        c2 = select (small[i], T (1), c2);
+        s2 = select (small[i], T (0), s2);
+
+        const T c1 = c2 * cs[i] - s2 * sn[i];
+        const T s1 = s2 * cs[i] + c2 * sn[i];
+
+        const int rot = int (!done[i]) & (int (!sym[i]) | int (!small[i]));
+
+        const T d1 = c1 * (w * c2 - x * s2) - s1 * (y * c2 - z * s2);
+        const T d2 = s1 * (w * s2 + x * c2) + c1 * (y * s2 + z * c2);
+
+        ajj[i] = select (rot, d1, w);
+        akk[i] = select (rot, d2, z);
+        ajk[i] = done[i] ? x : T (0);
+        akj[i] = done[i] ? y : T (0);
+
+        //
+        // Rotate the rows and columns of the entries that were not
+        // involved in the 2x2 SVD, and accumulate the rotations in U
+        // and V
+        //
+
+        T r1 = b.a[j][l][i];
+        T r2 = b.a[k][l][i];
+
+        b.a[j][l][i] = select (rot, c1 * r1 - s1 * r2, r1);
+        b.a[k][l][i] = select (rot, s1 * r1 + c1 * r2, r2);
+
+        r1 = b.a[l][j][i];
+        r2 = b.a[l][k][i];
+
+        b.a[l][j][i] = select (rot, c2 * r1 - s2 * r2, r1);
+        b.a[l][k][i] = select (rot, s2 * r1 + c2 * r2, r2);
+
+        for (int r = 0; r < 3; ++r)
+        {
+            T u1 = b.u[r][j][i];
+            T u2 = b.u[r][k][i];
+
+            b.u[r][j][i] = select (rot, c1 * u1 - s1 * u2, u1);
+            b.u[r][k][i] = select (rot, s1 * u1 + c1 * u2, u2);
+
+            u1 = b.v[r][j][i];
+            u2 = b.v[r][k][i];
+
+            b.v[r][j][i] = select (rot, c2 * u1 - s2 * u2, u1);
+            b.v[r][k][i] = select (rot, s2 * u1 + c2 * u2, u2);
+        }
+
+        b.changed[i] |= rot;
+    }
+}
+
+//
+// Column operations on the matrices i of a block for which flag[i] is
+// set.
+//
+
+template <class T>
+inline void
+swapColumns (
+    T                         m[3][3][blockSize],
+    int                       j,
+    int                       k,
+    const int* IMATH_RESTRICT flag,
+    size_t                    n) IMATH_NOEXCEPT
+{
+    for (int r = 0; r < 3; ++r)
+    {
+        T* IMATH_RESTRICT x = m[r][j];
+        T* IMATH_RESTRICT y = m[r][k];
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            const T xi = x[i];
+            const T yi = y[i];
+
+            x[i] = flag[i] ? yi : xi;
+            y[i] = flag[i] ? xi : yi;
+        }
+    }
+}
+
+template <class T>
+inline void
+negateColumn (
+    T m[3][3][blockSize], int j, const int* IMATH_RESTRICT flag, size_t n)
+    IMATH_NOEXCEPT
+{
+    for (int r = 0; r < 3; ++r)
+    {
+        T* IMATH_RESTRICT x = m[r][j];
+
+        for (size_t i = 0; i < n; ++i)
+            x[i] = flag[i] ? -x[i] : x[i];
+    }
+}
+
+template <class T>
+inline void
+negativeDeterminant (
+    const T m[3][3][blockSize], int* IMATH_RESTRICT flag, size_t n)
+    IMATH_NOEXCEPT
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        const T d =
+            m[0][0][i] * (m[1][1][i] * m[2][2][i] - m[1][2][i] * m[2][1][i]) +
+            m[0][1][i] * (m[1][2][i] * m[2][0][i] - m[1][0][i] * m[2][2][i]) +
+            m[0][2][i] * (m[1][0][i] * m[2][1][i] - m[1][1][i] * m[2][0][i]);
+
+        flag[i] = d < 0;
+    }
+}
+
+//
+// jacobiSVD() for n <= blockSize matrices in b.a. The singular values
+// are returned in b.s.
+//
+
+template <class T>
+void
+svd (
+    JacobiBlock<T>& b,
+    size_t          n,
+    const T         tol,
+    bool            forcePositiveDeterminant) IMATH_NOEXCEPT
+{
+    T* IMATH_RESTRICT off = b.tmp[0];
+
+    setIdentity (b.u, n);
+    setIdentity (b.v, n);
+
+    maxAbs (b.a, offDiagEntries, 6, off, n);
+
+    int active = 0;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        b.absTol[i] = tol * off[i];
+        b.done[i]   = b.absTol[i] == 0;
+        active |= !b.done[i];
+    }
+
+    for (int iter = 0; active && iter < jacobiMaxIter; ++iter)
+    {
+        for (size_t i = 0; i < n; ++i)
+            b.changed[i] = 0;
+
+        svdRotation<0, 1, 2> (b, n, tol);
+        svdRotation<0, 2, 1> (b, n, tol);
+        svdRotation<1, 2, 0> (b, n, tol);
+
+        maxAbs (b.a, offDiagEntries, 6, off, n);
+        active = updateDone (b, off, n);
+    }
+
+    //
+    // Make the singular values positive, flipping the corresponding
+    // columns of U, and sort them from largest to smallest
+    //
+
+    int* IMATH_RESTRICT flag = b.flag[0];
+
+    for (int c = 0; c < 3; ++c)
+    {
+        T* IMATH_RESTRICT s = b.s[c];
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            const T x = b.a[c][c][i];
+
+            flag[i] = x < 0;
+            s[i]    = flag[i] ? -x : x;
+        }
+
+        negateColumn (b.u, c, flag, n);
+    }
+
+    for (int p = 0; p < 2; ++p)
+        for (int c = 0; c < 2 - p; ++c)
+        {
+            T* IMATH_RESTRICT x = b.s[c];
+            T* IMATH_RESTRICT y = b.s[c + 1];
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                const T xi = x[i];
+                const T yi = y[i];
+
+                flag[i] = xi < yi;
+                x[i]    = flag[i] ? yi : xi;
+                y[i]    = flag[i] ? xi : yi;
+            }
+
+            swapColumns (b.u, c, c + 1, flag, n);
+            swapColumns (b.v, c, c + 1, flag, n);
+        }
+
+    //
+    // Make the determinants of U and V positive by negating their last
+    // columns and the smallest singular value
+    //
+
+    if (forcePositiveDeterminant)
+    {
+        T (*m[2])[3][blockSize] = {b.u, b.v};
+
+        for (int k = 0; k < 2; ++k)
+        {
+            negativeDeterminant (m[k], flag, n);
+            negateColumn (m[k], 2, flag, n);
+
+            for (size_t i = 0; i < n; ++i)
+                b.s[2][i] = flag[i] ? -b.s[2][i] : b.s[2][i];
+        }
+    }
+}
+
+//
+// Polar decomposition for blocks of 3x3 matrices, with the scaled
+// Newton iteration of polarDecomposition() in ImathMatrixAlgo.cpp. As
+// in the Jacobi solvers, a matrix whose iteration has finished is
+// carried along unchanged until the whole block is done.
+//
+
+const int polarMaxIter = 20;
+
+template <class T> struct PolarBlock
+{
+    T   a[3][3][blockSize];
+    T   x[3][3][blockSize];
+    T   c[3][3][blockSize];
+    T   det[blockSize];
+    T   g[blockSize];
+    T   d[blockSize];
+    T   nx[blockSize];
+    int fail[blockSize];
+    int last[blockSize];
+    int done[blockSize];
+};
+
+//
+// Start the iteration from A, or from -A if det(A) < 0, and flag the
+// singular matrices, which start from the identity instead.
+//
+
+template <class T>
+inline void
+polarStart (PolarBlock<T>& b, size_t n) IMATH_NOEXCEPT
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        const T det =
+            b.a[0][0][i] *
+                (b.a[1][1][i] * b.a[2][2][i] - b.a[1][2][i] * b.a[2][1][i]) +
+            b.a[0][1][i] *
+                (b.a[1][2][i] * b.a[2][0][i] - b.a[1][0][i] * b.a[2][2][i]) +
+            b.a[0][2][i] *
+                (b.a[1][0][i] * b.a[2][1][i] - b.a[1][1][i] * b.a[2][0][i]);
+
+        const int fail = !(det != 0) | !(det - det == 0);
+        const T   sign = select (det < 0, T (-1), T (1));
+
+        for (int r = 0; r < 3; ++r)
+            for (int c = 0; c < 3; ++c)
+                b.x[r][c][i] =
+                    select (fail, T (r == c), sign * b.a[r][c][i]);
+
+        b.fail[i] = fail;
+        b.last[i] = 0;
+        b.done[i] = 0;
+    }
+}
+
+//
+// One Newton step for the matrices whose done flag is clear, computing
+// the same expressions as polarNewtonStep() in ImathMatrixAlgo.cpp.
+// The change |X' - X|^2 is left in b.d and |X|^2 in b.nx.
+//
+
+template <class T>
+inline void
+polarStep (PolarBlock<T>& b, size_t n) IMATH_NOEXCEPT
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        T nx = 0;
+        T nc = 0;
+
+        for (int r = 0; r < 3; ++r)
+        {
+            const int u = (r + 1) % 3;
+            const int v = (r + 2) % 3;
+
+            b.c[r][0][i] = b.x[u][1][i] * b.x[v][2][i] -
+                           b.x[u][2][i] * b.x[v][1][i];
+            b.c[r][1][i] = b.x[u][2][i] * b.x[v][0][i] -
+                           b.x[u][0][i] * b.x[v][2][i];
+            b.c[r][2][i] = b.x[u][0][i] * b.x[v][1][i] -
+                           b.x[u][1][i] * b.x[v][0][i];
+        }
+
+        const T det = b.x[0][0][i] * b.c[0][0][i] +
+                      b.x[0][1][i] * b.c[0][1][i] +
+                      b.x[0][2][i] * b.c[0][2][i];
+
+        for (int r = 0; r < 3; ++r)
+            for (int c = 0; c < 3; ++c)
+            {
+                nx += b.x[r][c][i] * b.x[r][c][i];
+                nc += b.c[r][c][i] * b.c[r][c][i];
+            }
+
+        b.det[i] = det;
+        b.nx[i]  = nx;
+        b.g[i]   = nc / (det * det * nx);
+    }
+
+    VecArrayDetail::sqrt (b.g, n);
+    VecArrayDetail::sqrt (b.g, n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const T g  = b.g[i];
+        const T ga = T (0.5) * g;
+        const T gb = T (0.5) / (g * b.det[i]);
+        T       d  = 0;
+
+        for (int r = 0; r < 3; ++r)
+            for (int c = 0; c < 3; ++c)
+            {
+                const T x = b.x[r][c][i];
+                const T y = ga * x + gb * b.c[r][c][i];
+                d += (y - x) * (y - x);
+                b.x[r][c][i] = select (b.done[i], x, y);
+            }
+
+        b.d[i] = d;
+    }
+}
+
+//
+// Iterate until every matrix has converged, or for exactly
+// numIterations steps if that is positive. Returns the rotations in
+// b.x and the stretches in b.c.
+//
+
+template <class T>
+inline void
+polarSolve (PolarBlock<T>& b, size_t n, const T tol, int numIterations)
+    IMATH_NOEXCEPT
+{
+    polarStart (b, n);
+
+    if (numIterations > 0)
+    {
+        for (int k = 0; k < numIterations; ++k)
+            polarStep (b, n);
+
+        for (size_t i = 0; i < n; ++i)
+            b.done[i] = 1;
+    }
+    else
+    {
+        for (int k = 0; k < polarMaxIter; ++k)
+        {
+            polarStep (b, n);
+
+            int more = 0;
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                const int done = b.done[i] | b.last[i];
+                b.last[i] |= b.d[i] <= tol * b.nx[i];
+                b.done[i] = done;
+                more |= !done;
+            }
+
+            if (!more) break;
+        }
+    }
+
+    //
+    // S = A * R^T, symmetrized; S = A for singular matrices.
+    //
+
+    for (size_t i = 0; i < n; ++i)
+        for (int r = 0; r < 3; ++r)
+            for (int c = 0; c < 3; ++c)
+                b.c[r][c][i] = b.a[r][0][i] * b.x[c][0][i] +
+                               b.a[r][1][i] * b.x[c][1][i] +
+                               b.a[r][2][i] * b.x[c][2][i];
+
+    for (int r = 0; r < 3; ++r)
+        for (int c = 0; c < r; ++c)
+            for (size_t i = 0; i < n; ++i)
+            {
+                const T s = T (0.5) * (b.c[r][c][i] + b.c[c][r][i]);
+                b.c[r][c][i] = select (b.fail[i], b.a[r][c][i], s);
+                b.c[c][r][i] = select (b.fail[i], b.a[c][r][i], s);
+            }
+
+    for (int r = 0; r < 3; ++r)
+        for (size_t i = 0; i < n; ++i)
+            b.c[r][r][i] = select (b.fail[i], b.a[r][r][i], b.c[r][r][i]);
+}
+
+//
+// Conversion between quaternions and rotation matrices. The upper-left
+// 3x3 blocks of the matrices are gathered into, or scattered from, the
+// entry arrays of a block, whatever the layout of the matrices.
+//
+
+template <class T>
+inline void
+load (const Matrix44<T>* m, T b[3][3][blockSize], size_t n) IMATH_NOEXCEPT
+{
+    for (size_t i = 0; i < n; ++i)
+        for (int r = 0; r < 3; ++r)
+            for (int c = 0; c < 3; ++c)
+                b[r][c][i] = m[i][r][c];
+}
+
+template <class T>
+inline void
+load (
+    const Matrix44Array<T>& m,
+    size_t                  begin,
+    T                       b[3][3][blockSize],
+    size_t                  n) IMATH_NOEXCEPT
+{
+    for (int r = 0; r < 3; ++r)
+        for (int c = 0; c < 3; ++c)
+            memcpy (b[r][c], m.entry (r, c) + begin, n * sizeof (T));
+}
+
+//
+// Store the rotations of a block as 4x4 matrices without translation
+// or projection.
+//
+
+template <class T>
+inline void
+store (const T b[3][3][blockSize], Matrix44<T>* m, size_t n) IMATH_NOEXCEPT
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (int r = 0; r < 3; ++r)
+        {
+            for (int c = 0; c < 3; ++c)
+                m[i][r][c] = b[r][c][i];
+
+            m[i][r][3] = 0;
+            m[i][3][r] = 0;
+        }
+
+        m[i][3][3] = 1;
+    }
+}
+
+template <class T>
+inline void
+store (
+    const T           b[3][3][blockSize],
+    Matrix44Array<T>& m,
+    size_t            begin,
+    size_t            n) IMATH_NOEXCEPT
+{
+    for (int r = 0; r < 4; ++r)
+        for (int c = 0; c < 4; ++c)
+        {
+            T* IMATH_RESTRICT e = m.entry (r, c) + begin;
+
+            if (r < 3 && c < 3)
+                memcpy (e, b[r][c], n * sizeof (T));
+            else
+                for (size_t i = 0; i < n; ++i)
+                    e[i] = T (r == c);
+        }
+}
+
+//
+// Quat::toMatrix33() of n quaternions.
+//
+
+template <class T>
+inline void
+quatToMatrix (
+    const QuatArrayDetail::Lanes<T>& q,
+    T                                b[3][3][blockSize],
+    size_t                           n) IMATH_NOEXCEPT
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        const T r = q.p[0][i];
+        const T x = q.p[1][i];
+        const T y = q.p[2][i];
+        const T z = q.p[3][i];
+
+        b[0][0][i] = 1 - 2 * (y * y + z * z);
+        b[0][1][i] = 2 * (x * y + z * r);
+        b[0][2][i] = 2 * (z * x - y * r);
+        b[1][0][i] = 2 * (x * y - z * r);
+        b[1][1][i] = 1 - 2 * (z * z + x * x);
+        b[1][2][i] = 2 * (y * z + x * r);
+        b[2][0][i] = 2 * (z * x + y * r);
+        b[2][1][i] = 2 * (y * z - x * r);
+        b[2][2][i] = 1 - 2 * (y * y + x * x);
+    }
+}
+
+//
+// extractQuat() of n matrices. The scalar version takes the square
+// root of the largest of 4r^2, 4x^2, 4y^2 and 4z^2, as found from the
+// trace and the diagonal, and divides the sums and differences of the
+// off-diagonal entries by it. Here the pivot is chosen per matrix in
+// the same way, and each component selects the expression that the
+// scalar version would have computed for it.
+//
+
+template <class T>
+inline void
+matrixToQuat (
+    const T                          b[3][3][blockSize],
+    const QuatArrayDetail::Lanes<T>& q,
+    size_t                           n) IMATH_NOEXCEPT
+{
+    T   s[blockSize];
+    int pivot[blockSize];
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const T m00 = b[0][0][i];
+        const T m11 = b[1][1][i];
+        const T m22 = b[2][2][i];
+        const T tr  = m00 + m11 + m22;
+
+        const int c0 = tr > 0;
+        const int c1 = m11 > m00;
+        const int c2 = m22 > select (c1, m11, m00);
+
+        // 0 for r, 1 to 3 for x, y and z
+        const int p = (1 - c0) * (1 + c1 + c2 * (2 - c1));
+
+        const T d = select (
+            c0,
+            tr,
+            select (
+                c2,
+                m22 - (m00 + m11),
+                select (c1, m11 - (m22 + m00), m00 - (m11 + m22))));
+
+        s[i]     = d + T (1);
+        pivot[i] = p;
+    }
+
+    VecArrayDetail::sqrt (s, n);
+
+    T* IMATH_RESTRICT qr = q.p[0];
+    T* IMATH_RESTRICT qx = q.p[1];
+    T* IMATH_RESTRICT qy = q.p[2];
+    T* IMATH_RESTRICT qz = q.p[3];
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const int p   = pivot[i];
+        const T   h   = s[i] * T (0.5);
+        const T   inv = select (s[i] != 0, T (0.5) / s[i], T (0));
+
+        const T rx = (b[1][2][i] - b[2][1][i]) * inv;
+        const T ry = (b[2][0][i] - b[0][2][i]) * inv;
+        const T rz = (b[0][1][i] - b[1][0][i]) * inv;
+        const T xy = (b[0][1][i] + b[1][0][i]) * inv;
+        const T xz = (b[0][2][i] + b[2][0][i]) * inv;
+        const T yz = (b[1][2][i] + b[2][1][i]) * inv;
+
+        qr[i] = select (
+            p == 0, h, select (p == 1, rx, select (p == 2, ry, rz)));
+        qx[i] = select (
+            p == 1, h, select (p == 0, rx, select (p == 2, xy, xz)));
+        qy[i] = select (
+            p == 2, h, select (p == 0, ry, select (p == 1, xy, yz)));
+        qz[i] = select (
+            p == 3, h, select (p == 0, rz, select (p == 1, xz, yz)));
+    }
+}
+
+//
+// The axes and flags of the Euler<T>::Order Order, as Euler::set() and
+// Euler::angleOrder() decode them at run time.
+//
+
+template <int Order> struct EulerAxes
+{
+    static_assert (
+        (Order & ~0x3111) == 0 && (Order & 0x3000) != 0x3000,
+        "Order must be an Euler<T>::Order");
+
+    static const int  i = (Order & 0x2000) ? 2 : ((Order & 0x1000) ? 1 : 0);
+    static const bool frameStatic     = (Order & 0x0001) != 0;
+    static const bool parityEven      = (Order & 0x0100) != 0;
+    static const bool initialRepeated = (Order & 0x0010) != 0;
+
+    static const int j = parityEven ? (i + 1) % 3 : (i > 0 ? i - 1 : 2);
+    static const int k = parityEven ? (i > 0 ? i - 1 : 2) : (i + 1) % 3;
+};
+
+//
+// Euler::toMatrix33() of the angles [begin, begin + n), with the order
+// fixed at compile time.
+//
+
+template <int Order, class T>
+inline void
+eulerToMatrix (
+    const Vec3Array<T>& angles,
+    size_t              begin,
+    T                   b[3][3][blockSize],
+    size_t              n) IMATH_NOEXCEPT
+{
+    typedef EulerAxes<Order> E;
+
+    const int i = E::i;
+    const int j = E::j;
+    const int k = E::k;
+
+    // The angles about axes i, j and k, in the order they apply
+    T a[3][blockSize], s[3][blockSize], c[3][blockSize];
+
+    for (int l = 0; l < 3; ++l)
+    {
+        const T* IMATH_RESTRICT v =
+            angles.lane (E::frameStatic ? l : 2 - l) + begin;
+
+        for (size_t m = 0; m < n; ++m)
+            a[l][m] = E::parityEven ? v[m] : -v[m];
+
+        BatchMathDetail::sincos<T, BatchMathFast> (a[l], s[l], c[l], n);
+    }
+
+    for (size_t m = 0; m < n; ++m)
+    {
+        const T ci = c[0][m], cj = c[1][m], ch = c[2][m];
+        const T si = s[0][m], sj = s[1][m], sh = s[2][m];
+
+        const T cc = ci * ch;
+        const T cs = ci * sh;
+        const T sc = si * ch;
+        const T ss = si * sh;
+
+        if (E::initialRepeated)
+        {
+            b[i][i][m] = cj;
+            b[j][i][m] = sj * si;
+            b[k][i][m] = sj * ci;
+            b[i][j][m] = sj * sh;
+            b[j][j][m] = -cj * ss + cc;
+            b[k][j][m] = -cj * cs - sc;
+            b[i][k][m] = -sj * ch;
+            b[j][k][m] = cj * sc + cs;
+            b[k][k][m] = cj * cc - ss;
+        }
+        else
+        {
+            b[i][i][m] = cj * ch;
+            b[j][i][m] = sj * sc - cs;
+            b[k][i][m] = sj * cc + ss;
+            b[i][j][m] = cj * sh;
+            b[j][j][m] = sj * ss + cc;
+            b[k][j][m] = sj * cs - sc;
+            b[i][k][m] = -sj;
+            b[j][k][m] = cj * si;
+            b[k][k][m] = cj * ci;
+        }
+    }
+}
+
+//
+// Euler::extract() of n matrices into the angles [begin, begin + n),
+// with the order fixed at compile time. Removing the first rotation
+// from a matrix, as the scalar version does with Matrix44::rotate(),
+// only mixes rows j and k, so just the entries needed for the other two
+// angles are computed.
+//
+
+template <int Order, class T>
+inline void
+matrixToEuler (
+    const T       b[3][3][blockSize],
+    Vec3Array<T>& angles,
+    size_t        begin,
+    size_t        n) IMATH_NOEXCEPT
+{
+    typedef EulerAxes<Order> E;
+
+    const int i = E::i;
+    const int j = E::j;
+    const int k = E::k;
+
+    // The angles about axes i, j and k, and the arguments of atan2().
+    // Only the first n arguments are set; zeroing the rest keeps the
+    // compiler from warning that atan2() may read uninitialized values.
+    T a[3][blockSize], s[blockSize], c[blockSize];
+    T y[2][blockSize], x[2][blockSize];
+
+    for (size_t m = n; m < blockSize; ++m)
+        y[0][m] = y[1][m] = x[0][m] = x[1][m] = 0;
+
+    if (E::initialRepeated)
+        BatchMathDetail::atan2<T, BatchMathFast> (b[j][i], b[k][i], a[0], n);
+    else
+        BatchMathDetail::atan2<T, BatchMathFast> (b[j][k], b[k][k], a[0], n);
+
+    BatchMathDetail::sincos<T, BatchMathFast> (a[0], s, c, n);
+
+    for (size_t m = 0; m < n; ++m)
+    {
+        // Row j of the matrix without the first rotation
+        const T nji = c[m] * b[j][i][m] - s[m] * b[k][i][m];
+        const T njj = c[m] * b[j][j][m] - s[m] * b[k][j][m];
+        const T njk = c[m] * b[j][k][m] - s[m] * b[k][k][m];
+
+        if (E::initialRepeated)
+        {
+            y[0][m] = b[j][i][m] * b[j][i][m] + b[k][i][m] * b[k][i][m];
+            x[0][m] = b[i][i][m];
+            y[1][m] = njk;
+            x[1][m] = njj;
+        }
+        else
+        {
+            y[0][m] = -b[i][k][m];
+            x[0][m] = b[i][i][m] * b[i][i][m] + b[i][j][m] * b[i][j][m];
+            y[1][m] = -nji;
+            x[1][m] = njj;
+        }
+    }
+
+    VecArrayDetail::sqrt (E::initialRepeated ? y[0] : x[0], n);
+
+    BatchMathDetail::atan2<T, BatchMathFast> (y[0], x[0], a[1], n);
+    BatchMathDetail::atan2<T, BatchMathFast> (y[1], x[1], a[2], n);
+
+    for (int l = 0; l < 3; ++l)
+    {
+        T* IMATH_RESTRICT v = angles.lane (E::frameStatic ? l : 2 - l) + begin;
+
+        for (size_t m = 0; m < n; ++m)
+            v[m] = E::parityEven ? a[l][m] : -a[l][m];
+    }
+}
+
+//
+// The rotations of n matrices as Euler angles in the order Order, in
+// the layout of Euler::toXYZVector(), stored into the angles [begin,
+// begin + n) for which fail is zero. tmp holds at least n angles.
+//
+
+template <int Order, class T>
+inline void
+matrixToXYZVector (
+    const T       b[3][3][blockSize],
+    const int*    fail,
+    Vec3Array<T>& angles,
+    size_t        begin,
+    size_t        n,
+    Vec3Array<T>& tmp)
+{
+    matrixToEuler<Order> (b, tmp, 0, n);
+
+    typedef typename Euler<T>::Order EulerOrder;
+
+    const Euler<T> e (static_cast<EulerOrder> (Order));
+    int            l[3];
+
+    e.angleMapping (l[0], l[1], l[2]);
+
+    for (int c = 0; c < 3; ++c)
+    {
+        const T* IMATH_RESTRICT a = tmp.lane (l[c]);
+        T* IMATH_RESTRICT       v = angles.lane (c) + begin;
+
+        for (size_t m = 0; m < n; ++m)
+            v[m] = fail[m] ? v[m] : a[m];
+    }
+}
+
+//
+// matrixToXYZVector() with the order chosen at run time
+//
+
+template <class T>
+inline void
+matrixToXYZVector (
+    const T                  b[3][3][blockSize],
+    const int*               fail,
+    Vec3Array<T>&            angles,
+    size_t                   begin,
+    size_t                   n,
+    typename Euler<T>::Order order,
+    Vec3Array<T>&            tmp)
+{
+    switch (order)
+    {
+        case Euler<T>::XZY:
+            matrixToXYZVector<Euler<T>::XZY> (b, fail, angles, begin, n, tmp);
+            break;
+        case Euler<T>::YZX:
+            matrixToXYZVector<Euler<T>::YZX> (b, fail, angles, begin, n, tmp);
+            break;
+        case Euler<T>::YXZ:
+            matrixToXYZVector<Euler<T>::YXZ> (b, fail, angles, begin, n, tmp);
+            break;
+        case Euler<T>::ZXY:
+            matrixToXYZVector<Euler<T>::ZXY> (b, fail, angles, begin, n, tmp);
+            break;
+        case Euler<T>::ZYX:
+            matrixToXYZVector<Euler<T>::ZYX> (b, fail, angles, begin, n, tmp);
+            break;
+        case Euler<T>::XZX:
+            matrixToXYZVector<Euler<T>::XZX> (b, fail, angles, begin, n, tmp);
+            break;
+        case Euler<T>::XYX:
+            matrixToXYZVector<Euler<T>::XYX> (b, fail, angles, begin, n, tmp);
+            break;
+        case Euler<T>::YXY:
+            matrixToXYZVector<Euler<T>::YXY> (b, fail, angles, begin, n, tmp);
+            break;
+        case Euler<T>::YZY:
+            matrixToXYZVector<Euler<T>::YZY> (b, fail, angles, begin, n, tmp);
+            break;
+        case Euler<T>::ZYZ:
+            matrixToXYZVector<Euler<T>::ZYZ> (b, fail, angles, begin, n, tmp);
+            break;
+        case Euler<T>::ZXZ:
+            matrixToXYZVector<Euler<T>::ZXZ> (b, fail, angles, begin, n, tmp);
+            break;
+        case Euler<T>::XYZr:
+            matrixToXYZVector<Euler<T>::XYZr> (b, fail, angles, begin, n, tmp);
+            break;
+        case Euler<T>::XZYr:
+            matrixToXYZVector<Euler<T>::XZYr> (b, fail, angles, begin, n, tmp);
+            break;
+        case Euler<T>::YZXr:
+            matrixToXYZVector<Euler<T>::YZXr> (b, fail, angles, begin, n, tmp);
+            break;
+        case Euler<T>::YXZr:
+            matrixToXYZVector<Euler<T>::YXZr> (b, fail, angles, begin, n, tmp);
+            break;
+        case Euler<T>::ZXYr:
+            matrixToXYZVector<Euler<T>::ZXYr> (b, fail, angles, begin, n, tmp);
+            break;
+        case Euler<T>::ZYXr:
+            matrixToXYZVector<Euler<T>::ZYXr> (b, fail, angles, begin, n, tmp);
+            break;
+        case Euler<T>::XZXr:
+            matrixToXYZVector<Euler<T>::XZXr> (b, fail, angles, begin, n, tmp);
+            break;
+        case Euler<T>::XYXr:
+            matrixToXYZVector<Euler<T>::XYXr> (b, fail, angles, begin, n, tmp);
+            break;
+        case Euler<T>::YXYr:
+            matrixToXYZVector<Euler<T>::YXYr> (b, fail, angles, begin, n, tmp);
+            break;
+        case Euler<T>::YZYr:
+            matrixToXYZVector<Euler<T>::YZYr> (b, fail, angles, begin, n, tmp);
+            break;
+        case Euler<T>::ZYZr:
+            matrixToXYZVector<Euler<T>::ZYZr> (b, fail, angles, begin, n, tmp);
+            break;
+        case Euler<T>::ZXZr:
+            matrixToXYZVector<Euler<T>::ZXZr> (b, fail, angles, begin, n, tmp);
+            break;
+        default:
+            matrixToXYZVector<Euler<T>::XYZ> (b, fail, angles, begin, n, tmp);
+            break;
+    }
+}
+
+} // namespace MatrixBatchDetail
+
+/// @endcond
+
+/// @{
+/// @name Bulk matrix multiplication
+
+/// Multiply `n` pairs of matrices, `c[i] = a[i] * b[i]`. `c` may be the
+/// same array as `a` or `b`, but must not otherwise overlap them.
+template <class T>
+inline void
+multiply (
+    const Matrix44<T>* a,
+    const Matrix44<T>* b,
+    Matrix44<T>*       c,
+    size_t             n) IMATH_NOEXCEPT
+{
+    MatrixBatchDetail::multiplyRange (a, b, c, 0, n);
+}
+
+/// Multiply `n` pairs of matrices, `c[i] = a[i] * b[i]`, on up to
+/// `parallel.numThreads` threads.
+template <class T>
+inline void
+multiply (
+    const Matrix44<T>*   a,
+    const Matrix44<T>*   b,
+    Matrix44<T>*         c,
+    size_t               n,
+    const ParallelBuild& parallel)
+{
+    parallelFor (
+        0,
+        n,
+        parallel.numThreads,
+        MatrixBatchDetail::grainSize,
+        [a, b, c] (size_t begin, size_t end) {
+            MatrixBatchDetail::multiplyRange (a, b, c, begin, end);
+        });
+}
+
+/// Compute the world transforms of the `n` nodes of a transform
+/// hierarchy from their local transforms. `parent[i]` is the index of
+/// the parent of node `i`, or a negative number if node `i` is a root.
+/// The nodes must be sorted so that every parent comes before its
+/// children, i.e. `parent[i] < i`.
+///
+/// With Imath's row vector convention, `world[i] = local[i] *
+/// world[parent[i]]`, and `world[i] = local[i]` for roots. `world` may
+/// be the same array as `local`.
+template <class T>
+inline void
+composeHierarchy (
+    const Matrix44<T>* local,
+    const int*         parent,
+    Matrix44<T>*       world,
+    size_t             n) IMATH_NOEXCEPT
+{
+    for (size_t i = 0; i < n; ++i)
+        MatrixBatchDetail::composeNode (local, parent, world, i);
+}
+
+/// Compute the world transforms of a transform hierarchy, as above, on
+/// up to `parallel.numThreads` threads. The nodes are grouped by their
+/// depth in the hierarchy, and the nodes at each depth are processed in
+/// parallel once their parents are done. This needs temporary memory
+/// for two integers per node.
+template <class T>
+void
+composeHierarchy (
+    const Matrix44<T>*   local,
+    const int*           parent,
+    Matrix44<T>*         world,
+    size_t               n,
+    const ParallelBuild& parallel)
+{
+    const size_t grain = MatrixBatchDetail::grainSize;
+
+    if (parallelThreadCount (parallel.numThreads, n, grain) == 1)
+    {
+        composeHierarchy (local, parent, world, n);
+        return;
+    }
+
+    //
+    // Sort the nodes by depth, keeping the nodes at each depth in their
+    // original order.
+    //
+
+    std::vector<size_t> depth (n);
+    std::vector<size_t> levels (1, 0);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        depth[i] = parent[i] < 0 ? 0 : depth[parent[i]] + 1;
+
+        if (depth[i] + 1 >= levels.size ()) levels.resize (depth[i] + 2, 0);
+
+        ++levels[depth[i] + 1];
+    }
+
+    for (size_t d = 1; d < levels.size (); ++d)
+        levels[d] += levels[d - 1];
+
+    std::vector<size_t> order (n);
+    std::vector<size_t> next (levels.begin (), levels.end () - 1);
+
+    for (size_t i = 0; i < n; ++i)
+        order[next[depth[i]]++] = i;
+
+    //
+    // Process one depth at a time. Depths with few nodes run on the
+    // calling thread.
+    //
+
+    const size_t* nodes = order.data ();
+
+    for (size_t d = 0; d + 1 < levels.size (); ++d)
+    {
+        parallelFor (
+            levels[d],
+            levels[d + 1],
+            parallel.numThreads,
+            grain,
+            [local, parent, world, nodes] (size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    MatrixBatchDetail::composeNode (
+                        local, parent, world, nodes[i]);
+                }
+            });
+    }
+}
+
+/// @}
+
+/// @{
+/// @name Batched decomposition
+///
+/// These functions decompose every matrix in a Matrix44Array like the
+/// corresponding functions in ImathMatrixAlgo.h called with `exc =
+/// false`, with identical results, except that the Euler angles from
+/// extractSHRT() are computed with the BatchMathFast arc tangent of
+/// ImathBatchMath.h and agree to within a few ulp. Instead of throwing
+/// or stopping at the first matrix that cannot be decomposed, they set
+/// `ok[i]` to false for every such matrix `i` and carry on with the
+/// others. The outputs for those matrices are invalid. `ok` may be
+/// null; if not, it must hold `m.size()` flags. The output arrays are
+/// resized to `m.size()`.
+
+/// Remove scaling and shear from each matrix in `m`, returning the
+/// scaling in `scl` and the shear in `shr`. Matrices that cannot be
+/// decomposed are left unchanged.
+/// @return true if all the matrices were decomposed
+template <class T>
+bool
+extractAndRemoveScalingAndShear (
+    Matrix44Array<T>& m, Vec3Array<T>& scl, Vec3Array<T>& shr, bool* ok)
+{
+    const size_t n     = m.size ();
+    const size_t block = MatrixBatchDetail::blockSize;
+    bool         all   = true;
+
+    scl.resize (n);
+    shr.resize (n);
+
+    MatrixBatchDetail::DecomposeBlock<T> b;
+
+    for (size_t begin = 0; begin < n; begin += block)
+    {
+        const size_t k = n - begin < block ? n - begin : block;
+
+        MatrixBatchDetail::removeScalingAndShear (m, begin, k, b);
+
+        all &= MatrixBatchDetail::storeScalingAndShear (
+            b, begin, k, scl, shr, ok);
+
+        for (int r = 0; r < 3; ++r)
+            for (int c = 0; c < 3; ++c)
+            {
+                T* e = m.entry (r, c) + begin;
+
+                for (size_t i = 0; i < k; ++i)
+                    e[i] = b.fail[i] ? e[i] : b.row[r][c][i];
+            }
+    }
+
+    return all;
+}
+
+/// Extract the scaling `s`, shear `h`, rotation `r` and translation `t`
+/// of each matrix in `m`. The rotation is returned as Euler angles in
+/// order `rOrder`, in the layout of `Euler::toXYZVector()`.
+/// @return true if all the matrices were decomposed
+template <class T>
+bool
+extractSHRT (
+    const Matrix44Array<T>&  m,
+    Vec3Array<T>&            s,
+    Vec3Array<T>&            h,
+    Vec3Array<T>&            r,
+    Vec3Array<T>&            t,
+    bool*                    ok,
+    typename Euler<T>::Order rOrder = Euler<T>::XYZ)
+{
+    const size_t n     = m.size ();
+    const size_t block = MatrixBatchDetail::blockSize;
+    bool         all   = true;
+
+    s.resize (n);
+    h.resize (n);
+    r.resize (n);
+    t.resize (n);
+
+    MatrixBatchDetail::DecomposeBlock<T> b;
+    Vec3Array<T>                         angles (n < block ? n : block);
+
+    for (size_t begin = 0; begin < n; begin += block)
+    {
+        const size_t k = n - begin < block ? n - begin : block;
+
+        MatrixBatchDetail::removeScalingAndShear (m, begin, k, b);
+        all &= MatrixBatchDetail::storeScalingAndShear (
+            b, begin, k, s, h, ok);
+
+        MatrixBatchDetail::matrixToXYZVector (
+            b.row, b.fail, r, begin, k, rOrder, angles);
+    }
+
+    for (int c = 0; c < 3; ++c)
+    {
+        const T* IMATH_RESTRICT e = m.entry (3, c);
+        T* IMATH_RESTRICT       v = t.lane (c);
+
+        for (size_t i = 0; i < n; ++i)
+            v[i] = e[i];
+    }
+
+    return all;
+}
+
+/// @}
+
+/// @{
+/// @name Batched eigen and singular value decomposition
+
+/// Compute the eigenvalues `S[i]` and eigenvectors `V[i]` of `n`
+/// symmetric 3x3 matrices `A[i]`, like jacobiEigenSolver(), with
+/// identical results. Only the diagonal and upper triangle of each
+/// matrix are used, and `A` is not modified.
+///
+/// The matrices are processed in blocks, with each step of the Jacobi
+/// iteration vectorized across the matrices of a block. A block
+/// iterates until its slowest matrix has converged, so this is fastest
+/// when the matrices need a similar number of sweeps.
+template <class T>
+void
+jacobiEigenSolver (
+    const Matrix33<T>* A,
+    Vec3<T>*           S,
+    Matrix33<T>*       V,
+    size_t             n,
+    const T            tol = std::numeric_limits<T>::epsilon ())
+{
+    const size_t block = MatrixBatchDetail::blockSize;
+
+    MatrixBatchDetail::JacobiBlock<T> b;
+
+    for (size_t begin = 0; begin < n; begin += block)
+    {
+        const size_t k = n - begin < block ? n - begin : block;
+
+        MatrixBatchDetail::load (A + begin, b.a, k);
+        MatrixBatchDetail::eigenSolve (b, k, tol);
+        MatrixBatchDetail::store (b.v, V + begin, k);
+
+        for (size_t i = 0; i < k; ++i)
+            S[begin + i] = Vec3<T> (b.s[0][i], b.s[1][i], b.s[2][i]);
+    }
+}
+
+/// Compute the singular value decompositions `A[i] = U[i] * S[i] *
+/// V[i]^T` of `n` 3x3 matrices, like jacobiSVD(), with identical
+/// results. The singular values are sorted from the largest to the
+/// smallest; if `forcePositiveDeterminant` is true, the smallest may be
+/// negative so that `U[i]` and `V[i]` are rotations.
+///
+/// The matrices are processed in blocks, as in jacobiEigenSolver()
+/// above.
+template <class T>
+void
+jacobiSVD (
+    const Matrix33<T>* A,
+    Matrix33<T>*       U,
+    Vec3<T>*           S,
+    Matrix33<T>*       V,
+    size_t             n,
+    const T            tol = std::numeric_limits<T>::epsilon (),
+    const bool         forcePositiveDeterminant = false)
+{
+    const size_t block = MatrixBatchDetail::blockSize;
+
+    MatrixBatchDetail::JacobiBlock<T> b;
+
+    for (size_t begin = 0; begin < n; begin += block)
+    {
+        const size_t k = n - begin < block ? n - begin : block;
+
+        MatrixBatchDetail::load (A + begin, b.a, k);
+        MatrixBatchDetail::svd (b, k, tol, forcePositiveDeterminant);
+        MatrixBatchDetail::store (b.u, U + begin, k);
+        MatrixBatchDetail::store (b.v, V + begin, k);
+
+        for (size_t i = 0; i < k; ++i)
+            S[begin + i] = Vec3<T> (b.s[0][i], b.s[1][i], b.s[2][i]);
+    }
+}
+
+/// @}
+
+/// @{
+/// @name Batched polar decomposition
+///
+/// These functions compute the polar decompositions `A[i] = S[i] *
+/// R[i]` of `n` 3x3 matrices like polarDecomposition() and
+/// fastPolarDecomposition(), with identical results. Each step of the
+/// Newton iteration is vectorized across a block of matrices. `ok` may
+/// be null; if not, `ok[i]` is set to whether matrix `i` could be
+/// decomposed.
+
+/// Compute the polar decompositions of `n` matrices, iterating until
+/// every matrix of a block has converged to within `tol`.
+/// @return true if all the matrices were decomposed
+template <class T>
+bool
+polarDecomposition (
+    const Matrix33<T>* A,
+    Matrix33<T>*       R,
+    Matrix33<T>*       S,
+    size_t             n,
+    bool*              ok,
+    const T            tol = std::numeric_limits<T>::epsilon ())
+{
+    const size_t block = MatrixBatchDetail::blockSize;
+    bool         all   = true;
+
+    MatrixBatchDetail::PolarBlock<T> b;
+
+    for (size_t begin = 0; begin < n; begin += block)
+    {
+        const size_t k = n - begin < block ? n - begin : block;
+
+        MatrixBatchDetail::load (A + begin, b.a, k);
+        MatrixBatchDetail::polarSolve (b, k, tol, 0);
+        MatrixBatchDetail::store (b.x, R + begin, k);
+        MatrixBatchDetail::store (b.c, S + begin, k);
+
+        for (size_t i = 0; i < k; ++i)
+        {
+            const bool good = !b.fail[i] && b.done[i];
+            all &= good;
+            if (ok) ok[begin + i] = good;
+        }
+    }
+
+    return all;
+}
+
+/// Compute the polar decompositions of `n` matrices with exactly
+/// `numIterations` Newton steps each.
+/// @return true if all the matrices were decomposed
+template <class T>
+bool
+fastPolarDecomposition (
+    const Matrix33<T>* A,
+    Matrix33<T>*       R,
+    Matrix33<T>*       S,
+    size_t             n,
+    bool*              ok,
+    const int          numIterations = 5)
+{
+    const size_t block = MatrixBatchDetail::blockSize;
+    const int    steps = numIterations > 1 ? numIterations : 1;
+    bool         all   = true;
+
+    MatrixBatchDetail::PolarBlock<T> b;
+
+    for (size_t begin = 0; begin < n; begin += block)
+    {
+        const size_t k = n - begin < block ? n - begin : block;
+
+        MatrixBatchDetail::load (A + begin, b.a, k);
+        MatrixBatchDetail::polarSolve (b, k, T (0), steps);
+        MatrixBatchDetail::store (b.x, R + begin, k);
+        MatrixBatchDetail::store (b.c, S + begin, k);
+
+        for (size_t i = 0; i < k; ++i)
+        {
+            all &= !b.fail[i];
+            if (ok) ok[begin + i] = !b.fail[i];
+        }
+    }
+
+    return all;
+}
+
+/// @}
+
+/// @{
+/// @name Conversion to and from quaternions
+///
+/// These functions convert between arrays of quaternions and arrays of
+/// rotation matrices with the same expressions as Quat::toMatrix33(),
+/// Quat::toMatrix44() and extractQuat(), with identical results, for
+/// blocks of elements at a time. extractQuat() chooses per matrix which
+/// component to compute from the diagonal with bit masks rather than
+/// branches, so the conversions vectorize whatever the rotations.
+
+/// Convert each quaternion `q[i]` to a rotation matrix `m[i]`. `m` is
+/// resized to `q.size()`.
+template <class T>
+inline void
+toMatrix44 (const QuatArray<T>& q, Matrix44Array<T>& m)
+{
+    const size_t n     = q.size ();
+    const size_t block = MatrixBatchDetail::blockSize;
+
+    T b[3][3][MatrixBatchDetail::blockSize];
+
+    m.resize (n);
+
+    for (size_t begin = 0; begin < n; begin += block)
+    {
+        const size_t k = n - begin < block ? n - begin : block;
+
+        MatrixBatchDetail::quatToMatrix (
+            QuatArrayDetail::Lanes<T> (q, begin), b, k);
+        MatrixBatchDetail::store (b, m, begin, k);
+    }
+}
+
+/// Convert each quaternion `q[i]` to a rotation matrix `m[i]`. `m`
+/// must hold `q.size()` matrices.
+template <class T>
+inline void
+toMatrix44 (const QuatArray<T>& q, Matrix44<T>* m)
+{
+    const size_t n     = q.size ();
+    const size_t block = MatrixBatchDetail::blockSize;
+
+    T b[3][3][MatrixBatchDetail::blockSize];
+
+    for (size_t begin = 0; begin < n; begin += block)
+    {
+        const size_t k = n - begin < block ? n - begin : block;
+
+        MatrixBatchDetail::quatToMatrix (
+            QuatArrayDetail::Lanes<T> (q, begin), b, k);
+        MatrixBatchDetail::store (b, m + begin, k);
+    }
+}
+
+/// Convert each quaternion `q[i]` to a rotation matrix `m[i]`. `m`
+/// must hold `q.size()` matrices.
+template <class T>
+inline void
+toMatrix33 (const QuatArray<T>& q, Matrix33<T>* m)
+{
+    const size_t n     = q.size ();
+    const size_t block = MatrixBatchDetail::blockSize;
+
+    T b[3][3][MatrixBatchDetail::blockSize];
+
+    for (size_t begin = 0; begin < n; begin += block)
+    {
+        const size_t k = n - begin < block ? n - begin : block;
+
+        MatrixBatchDetail::quatToMatrix (
+            QuatArrayDetail::Lanes<T> (q, begin), b, k);
+        MatrixBatchDetail::store (b, m + begin, k);
+    }
+}
+
+/// Extract the rotation of each matrix `m[i]` as a quaternion `q[i]`.
+/// `q` is resized to `m.size()`.
+template <class T>
+inline void
+extractQuat (const Matrix44Array<T>& m, QuatArray<T>& q)
+{
+    const size_t n     = m.size ();
+    const size_t block = MatrixBatchDetail::blockSize;
+
+    T b[3][3][MatrixBatchDetail::blockSize];
+
+    q.resize (n);
+
+    for (size_t begin = 0; begin < n; begin += block)
+    {
+        const size_t k = n - begin < block ? n - begin : block;
+
+        MatrixBatchDetail::load (m, begin, b, k);
+        MatrixBatchDetail::matrixToQuat (
+            b, QuatArrayDetail::Lanes<T> (q, begin), k);
+    }
+}
+
+/// Extract the rotations of `n` matrices `m[i]` as quaternions `q[i]`.
+/// `q` is resized to `n`.
+template <class T>
+inline void
+extractQuat (const Matrix44<T>* m, size_t n, QuatArray<T>& q)
+{
+    const size_t block = MatrixBatchDetail::blockSize;
+
+    T b[3][3][MatrixBatchDetail::blockSize];
+
+    q.resize (n);
+
+    for (size_t begin = 0; begin < n; begin += block)
+    {
+        const size_t k = n - begin < block ? n - begin : block;
+
+        MatrixBatchDetail::load (m + begin, b, k);
+        MatrixBatchDetail::matrixToQuat (
+            b, QuatArrayDetail::Lanes<T> (q, begin), k);
+    }
+}
+
+/// Extract the rotations of `n` 3x3 matrices `m[i]` as quaternions
+/// `q[i]`, as extractQuat() would from the 4x4 matrices with the same
+/// upper-left 3x3 blocks. `q` is resized to `n`.
+template <class T>
+inline void
+extractQuat (const Matrix33<T>* m, size_t n, QuatArray<T>& q)
+{
+    const size_t block = MatrixBatchDetail::blockSize;
+
+    T b[3][3][MatrixBatchDetail::blockSize];
+
+    q.resize (n);
+
+    for (size_t begin = 0; begin < n; begin += block)
+    {
+        const size_t k = n - begin < block ? n - begin : block;
+
+        MatrixBatchDetail::load (m + begin, b, k);
+        MatrixBatchDetail::matrixToQuat (
+            b, QuatArrayDetail::Lanes<T> (q, begin), k);
+    }
+}
+
+/// @}
+
+/// @{
+/// @name Conversion to and from Euler angles
+///
+/// These functions convert between arrays of Euler angles and arrays of
+/// rotation matrices like Euler::toMatrix33(), Euler::toMatrix44() and
+/// Euler::extract() do, for blocks of elements at a time. The order of
+/// the angles is the template argument `Order`, an Euler<T>::Order such
+/// as `Eulerf::XYZ`, so that the choice of axes is made at compile
+/// time instead of per call. The angles are stored like the components
+/// of an Euler<T>, and the sines, cosines and arc tangents are computed
+/// with the BatchMathFast kernels of ImathBatchMath.h, which agree with
+/// the library functions to within a few ulp.
+
+/// Convert the Euler angles `angles[i]` in the order `Order` to a
+/// rotation matrix `m[i]`. `m` is resized to `angles.size()`.
+template <int Order, class T>
+inline void
+eulerToMatrix44 (const Vec3Array<T>& angles, Matrix44Array<T>& m)
+{
+    const size_t n     = angles.size ();
+    const size_t block = MatrixBatchDetail::blockSize;
+
+    T b[3][3][MatrixBatchDetail::blockSize];
+
+    m.resize (n);
+
+    for (size_t begin = 0; begin < n; begin += block)
+    {
+        const size_t k = n - begin < block ? n - begin : block;
+
+        MatrixBatchDetail::eulerToMatrix<Order> (angles, begin, b, k);
+        MatrixBatchDetail::store (b, m, begin, k);
+    }
+}
+
+/// Convert the Euler angles `angles[i]` in the order `Order` to a
+/// rotation matrix `m[i]`. `m` must hold `angles.size()` matrices.
+template <int Order, class T>
+inline void
+eulerToMatrix44 (const Vec3Array<T>& angles, Matrix44<T>* m)
+{
+    const size_t n     = angles.size ();
+    const size_t block = MatrixBatchDetail::blockSize;
+
+    T b[3][3][MatrixBatchDetail::blockSize];
+
+    for (size_t begin = 0; begin < n; begin += block)
+    {
+        const size_t k = n - begin < block ? n - begin : block;
+
+        MatrixBatchDetail::eulerToMatrix<Order> (angles, begin, b, k);
+        MatrixBatchDetail::store (b, m + begin, k);
+    }
+}
+
+/// Convert the Euler angles `angles[i]` in the order `Order` to a
+/// rotation matrix `m[i]`. `m` must hold `angles.size()` matrices.
+template <int Order, class T>
+inline void
+eulerToMatrix33 (const Vec3Array<T>& angles, Matrix33<T>* m)
+{
+    const size_t n     = angles.size ();
+    const size_t block = MatrixBatchDetail::blockSize;
+
+    T b[3][3][MatrixBatchDetail::blockSize];
+
+    for (size_t begin = 0; begin < n; begin += block)
+    {
+        const size_t k = n - begin < block ? n - begin : block;
+
+        MatrixBatchDetail::eulerToMatrix<Order> (angles, begin, b, k);
+        MatrixBatchDetail::store (b, m + begin, k);
+    }
+}
+
+/// Extract the rotation of each matrix `m[i]` as Euler angles
+/// `angles[i]` in the order `Order`. `angles` is resized to
+/// `m.size()`.
+template <int Order, class T>
+inline void
+extractEuler (const Matrix44Array<T>& m, Vec3Array<T>& angles)
+{
+    const size_t n     = m.size ();
+    const size_t block = MatrixBatchDetail::blockSize;
+
+    T b[3][3][MatrixBatchDetail::blockSize];
+
+    angles.resize (n);
+
+    for (size_t begin = 0; begin < n; begin += block)
+    {
+        const size_t k = n - begin < block ? n - begin : block;
+
+        MatrixBatchDetail::load (m, begin, b, k);
+        MatrixBatchDetail::matrixToEuler<Order> (b, angles, begin, k);
+    }
+}
+
+/// Extract the rotations of `n` matrices `m[i]` as Euler angles
+/// `angles[i]` in the order `Order`. `angles` is resized to `n`.
+template <int Order, class T>
+inline void
+extractEuler (const Matrix44<T>* m, size_t n, Vec3Array<T>& angles)
+{
+    const size_t block = MatrixBatchDetail::blockSize;
+
+    T b[3][3][MatrixBatchDetail::blockSize];
+
+    angles.resize (n);
+
+    for (size_t begin = 0; begin < n; begin += block)
+    {
+        const size_t k = n - begin < block ? n - begin : block;
+
+        MatrixBatchDetail::load (m + begin, b, k);
+        MatrixBatchDetail::matrixToEuler<Order> (b, angles, begin, k);
+    }
+}
+
+/// Extract the rotations of `n` 3x3 matrices `m[i]` as Euler angles
+/// `angles[i]` in the order `Order`. `angles` is resized to `n`.
+template <int Order, class T>
+inline void
+extractEuler (const Matrix33<T>* m, size_t n, Vec3Array<T>& angles)
+{
+    const size_t block = MatrixBatchDetail::blockSize;
+
+    T b[3][3][MatrixBatchDetail::blockSize];
+
+    angles.resize (n);
+
+    for (size_t begin = 0; begin < n; begin += block)
+    {
+        const size_t k = n - begin < block ? n - begin : block;
+
+        MatrixBatchDetail::load (m + begin, b, k);
+        MatrixBatchDetail::matrixToEuler<Order> (b, angles, begin, k);
+    }
+}
+
+/// @}
+
+IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif // INCLUDED_IMATHMATRIXBATCH_H
@@ -0,0 +1,111 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#include "ImathParallel.h"
+
+#include <exception>
+#include <thread>
+#include <vector>
+
+IMATH_INTERNAL_NAMESPACE_SOURCE_ENTER
+
+unsigned int
+parallelThreadCount (unsigned int requested, size_t n, size_t grain)
+{
+    unsigned int t = requested;
+
+    if (t == 0) t = std::thread::hardware_concurrency ();
+
+    if (t == 0) t = 1;
+
+    if (grain == 0) grain = 1;
+
+    size_t maxThreads = (n + grain - 1) / grain;
+
+    if (maxThreads < t) t = maxThreads ? (unsigned int) maxThreads : 1;
+
+    return t;
+}
+
+void
+parallelForChunks (
+    size_t            begin,
+    size_t            end,
+    unsigned int      numThreads,
+    size_t            grain,
+    ParallelChunkFunc run,
+    const void*       body)
+{
+    if (end <= begin) return;
+
+    size_t       n = end - begin;
+    unsigned int t = parallelThreadCount (numThreads, n, grain);
+
+    if (t == 1)
+    {
+        run (body, begin, end);
+        return;
+    }
+
+    std::vector<std::exception_ptr> errors (t);
+    std::vector<std::thread>        threads;
+    threads.reserve (t - 1);
+
+    size_t chunk = n / t;
+    size_t extra = n % t;
+    size_t b     = begin + chunk + (extra > 0);
+
+    //
+    // If a thread cannot be started, the chunks that were not handed
+    // out are processed on the calling thread instead.
+    //
+
+    size_t rest = end;
+
+    for (unsigned int i = 1; i < t; ++i)
+    {
+        size_t e = b + chunk + (i < extra);
+
+        try
+        {
+            threads.emplace_back ([run, body, &errors, i, b, e] () {
+                try
+                {
+                    run (body, b, e);
+                }
+                catch (...)
+                {
+                    errors[i] = std::current_exception ();
+                }
+            });
+        }
+        catch (...)
+        {
+            rest = b;
+            break;
+        }
+
+        b = e;
+    }
+
+    try
+    {
+        run (body, begin, begin + chunk + (extra > 0));
+
+        if (rest < end) run (body, rest, end);
+    }
+    catch (...)
+    {
+        errors[0] = std::current_exception ();
+    }
+
+    for (size_t i = 0; i < threads.size (); ++i)
+        threads[i].join ();
+
+    for (size_t i = 0; i < errors.size (); ++i)
+        if (errors[i]) std::rethrow_exception (errors[i]);
+}
+
+IMATH_INTERNAL_NAMESPACE_SOURCE_EXIT
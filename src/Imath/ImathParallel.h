@@ -0,0 +1,93 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+//
+// Minimal thread-based loop splitting, used by the bulk and table
+// building algorithms that can optionally run on several threads.
+//
+
+#ifndef INCLUDED_IMATHPARALLEL_H
+#define INCLUDED_IMATHPARALLEL_H
+
+#include "ImathExport.h"
+#include "ImathNamespace.h"
+
+#include <stddef.h>
+
+IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
+
+///
+/// Tag type that selects the multi-threaded variant of a constructor
+/// or algorithm. A thread count of zero means "one thread per
+/// hardware thread".
+///
+
+struct ParallelBuild
+{
+    explicit ParallelBuild (unsigned int n = 0) : numThreads (n) {}
+
+    unsigned int numThreads;
+};
+
+///
+/// Return the number of threads to use for `n` items, given the
+/// requested thread count (zero for the hardware concurrency) and the
+/// smallest amount of work worth handing to a thread.
+///
+
+IMATH_EXPORT unsigned int
+parallelThreadCount (unsigned int requested, size_t n, size_t grain);
+
+/// @cond Doxygen_Suppress
+
+//
+// The threads are started in the library, so that the headers need
+// neither <thread> nor the thread library. run (body, b, e) calls the
+// body of parallelFor() for one chunk.
+//
+
+typedef void (*ParallelChunkFunc) (const void* body, size_t b, size_t e);
+
+IMATH_EXPORT void parallelForChunks (
+    size_t            begin,
+    size_t            end,
+    unsigned int      numThreads,
+    size_t            grain,
+    ParallelChunkFunc run,
+    const void*       body);
+
+template <class Body>
+void
+parallelChunk (const void* body, size_t b, size_t e)
+{
+    (*static_cast<const Body*> (body)) (b, e);
+}
+
+/// @endcond
+
+///
+/// Split `[begin, end)` into contiguous chunks and call `body (b, e)`
+/// once per chunk, running the chunks on up to `numThreads` threads.
+/// The first chunk runs on the calling thread. `body` must be safe to
+/// call concurrently on disjoint ranges. If a chunk throws, the first
+/// exception is rethrown once all threads have finished.
+///
+
+template <class Body>
+inline void
+parallelFor (
+    size_t       begin,
+    size_t       end,
+    unsigned int numThreads,
+    size_t       grain,
+    const Body&  body)
+{
+    parallelForChunks (
+        begin, end, numThreads, grain, parallelChunk<Body>, &body);
+}
+
+IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif // INCLUDED_IMATHPARALLEL_H
@@ -0,0 +1,667 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+//
+// A structure-of-arrays container of quaternions, and bulk
+// interpolation of many pairs of rotation keys at once:
+//
+// - nlerp(), normalized linear interpolation along the shorter arc.
+//
+// - fastSlerp(), spherical linear interpolation along the shorter arc,
+//   with the interpolation weights sin(t*a)/sin(a) evaluated as a
+//   polynomial in cos(a) instead of with acos() and sin().
+//
+// - squad() and spline(), spherical cubic interpolation built from
+//   fastSlerp(), with the tangent quaternions computed once per key by
+//   intermediate(), which uses Quat::log() and Quat::exp().
+//
+// All the loops are written so that the compiler can vectorize them.
+//
+
+#ifndef INCLUDED_IMATHQUATARRAY_H
+#define INCLUDED_IMATHQUATARRAY_H
+
+#include "ImathExport.h"
+#include "ImathNamespace.h"
+
+#include "ImathQuat.h"
+#include "ImathVecArray.h"
+
+#include <stddef.h>
+#include <vector>
+
+IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
+
+///
+/// A structure-of-arrays container of quaternions: the scalar parts
+/// are stored in lane 0 and the x, y and z components of the vector
+/// parts in lanes 1 to 3. The bulk operations on 4D vectors in
+/// ImathVecArray.h, such as dot() and normalize(), apply as well.
+///
+
+template <class T> class IMATH_EXPORT_TEMPLATE_TYPE QuatArray
+    : public VecArrayBase<T, 4>
+{
+public:
+    /// @{
+    /// @name Constructors and Assignment
+
+    /// An empty array
+    QuatArray () IMATH_NOEXCEPT {}
+
+    /// An array of `n` uninitialized quaternions
+    explicit QuatArray (size_t n) : VecArrayBase<T, 4> (n) {}
+
+    /// Copy `n` quaternions from `q`
+    QuatArray (const Quat<T>* q, size_t n);
+
+    /// Copy the quaternions in `q`
+    explicit QuatArray (const std::vector<Quat<T>>& q);
+
+    /// @}
+
+    /// @{
+    /// @name Direct access to the component arrays
+
+    T*       r () IMATH_NOEXCEPT { return this->lane (0); }
+    const T* r () const IMATH_NOEXCEPT { return this->lane (0); }
+    T*       x () IMATH_NOEXCEPT { return this->lane (1); }
+    const T* x () const IMATH_NOEXCEPT { return this->lane (1); }
+    T*       y () IMATH_NOEXCEPT { return this->lane (2); }
+    const T* y () const IMATH_NOEXCEPT { return this->lane (2); }
+    T*       z () IMATH_NOEXCEPT { return this->lane (3); }
+    const T* z () const IMATH_NOEXCEPT { return this->lane (3); }
+
+    /// @}
+
+    /// @{
+    /// @name Element access and conversion
+
+    /// Return quaternion `i`
+    Quat<T> operator[] (size_t i) const IMATH_NOEXCEPT;
+
+    /// Set quaternion `i`
+    void set (size_t i, const Quat<T>& q) IMATH_NOEXCEPT;
+
+    /// Replace the contents with `n` quaternions copied from `q`
+    void assign (const Quat<T>* q, size_t n);
+
+    /// Copy the quaternions to `q`, which must hold `size()` quaternions
+    void copyTo (Quat<T>* q) const IMATH_NOEXCEPT;
+
+    /// Return the quaternions as an array of structs
+    std::vector<Quat<T>> toVector () const;
+
+    /// @}
+};
+
+/// QuatArray of float
+typedef QuatArray<float> QuatfArray;
+
+/// QuatArray of double
+typedef QuatArray<double> QuatdArray;
+
+template <class T>
+inline QuatArray<T>::QuatArray (const Quat<T>* q, size_t n)
+{
+    assign (q, n);
+}
+
+template <class T>
+inline QuatArray<T>::QuatArray (const std::vector<Quat<T>>& q)
+{
+    assign (q.data (), q.size ());
+}
+
+template <class T>
+inline Quat<T>
+QuatArray<T>::operator[] (size_t i) const IMATH_NOEXCEPT
+{
+    return Quat<T> (r ()[i], x ()[i], y ()[i], z ()[i]);
+}
+
+template <class T>
+inline void
+QuatArray<T>::set (size_t i, const Quat<T>& q) IMATH_NOEXCEPT
+{
+    r ()[i] = q.r;
+    x ()[i] = q.v.x;
+    y ()[i] = q.v.y;
+    z ()[i] = q.v.z;
+}
+
+template <class T>
+inline void
+QuatArray<T>::assign (const Quat<T>* q, size_t n)
+{
+    this->resize (n);
+
+    T* qr = r ();
+    T* qx = x ();
+    T* qy = y ();
+    T* qz = z ();
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        qr[i] = q[i].r;
+        qx[i] = q[i].v.x;
+        qy[i] = q[i].v.y;
+        qz[i] = q[i].v.z;
+    }
+}
+
+template <class T>
+inline void
+QuatArray<T>::copyTo (Quat<T>* q) const IMATH_NOEXCEPT
+{
+    const T* qr = r ();
+    const T* qx = x ();
+    const T* qy = y ();
+    const T* qz = z ();
+
+    for (size_t i = 0; i < this->size (); ++i)
+    {
+        q[i].r   = qr[i];
+        q[i].v.x = qx[i];
+        q[i].v.y = qy[i];
+        q[i].v.z = qz[i];
+    }
+}
+
+template <class T>
+inline std::vector<Quat<T>>
+QuatArray<T>::toVector () const
+{
+    std::vector<Quat<T>> q (this->size ());
+
+    if (!q.empty ()) copyTo (q.data ());
+
+    return q;
+}
+
+/// @cond Doxygen_Suppress
+
+namespace QuatArrayDetail
+{
+
+//
+// Number of quaternions processed per block. The intermediate values
+// of a block live on the stack.
+//
+
+const size_t blockSize = 64;
+
+//
+// The lanes of quaternions [begin, begin + n) of an array
+//
+
+template <class T> struct Lanes
+{
+    Lanes (const VecArrayBase<T, 4>& a, size_t begin) IMATH_NOEXCEPT
+    {
+        for (int c = 0; c < 4; ++c)
+            p[c] = const_cast<T*> (a.lane (c)) + begin;
+    }
+
+    Lanes (T b[4][blockSize]) IMATH_NOEXCEPT
+    {
+        for (int c = 0; c < 4; ++c)
+            p[c] = b[c];
+    }
+
+    T* p[4];
+};
+
+//
+// The interpolation parameters of a block: either a slice of a
+// per-quaternion array or a copy of a single value.
+//
+
+template <class T> struct Params
+{
+    Params (const T* t, size_t begin, size_t) IMATH_NOEXCEPT
+        : p (t + begin)
+    {}
+
+    Params (T t, size_t, size_t n) IMATH_NOEXCEPT : p (v)
+    {
+        for (size_t i = 0; i < n; ++i)
+            v[i] = t;
+    }
+
+    T        v[blockSize];
+    const T* p;
+};
+
+//
+// Dot products of n pairs of quaternions, reduced to the shorter arc:
+// x[i] = |a[i] ^ b[i]|, clamped to 1, and sign[i] = -1 if b[i] must
+// be negated.
+//
+
+template <class T>
+inline void
+shorterArc (
+    const Lanes<T>& a,
+    const Lanes<T>& b,
+    T* IMATH_RESTRICT x,
+    T* IMATH_RESTRICT sign,
+    size_t            n) IMATH_NOEXCEPT
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        const T d = a.p[0][i] * b.p[0][i] + a.p[1][i] * b.p[1][i] +
+                    a.p[2][i] * b.p[2][i] + a.p[3][i] * b.p[3][i];
+        const T m = d < T (0) ? -d : d;
+
+        sign[i] = d < T (0) ? T (-1) : T (1);
+        x[i]    = m < T (1) ? m : T (1);
+    }
+}
+
+//
+// nlerp() of n quaternions.
+//
+
+template <class T>
+inline void
+nlerp (
+    const Lanes<T>& a,
+    const Lanes<T>& b,
+    const T*        t,
+    const Lanes<T>& r,
+    size_t          n) IMATH_NOEXCEPT
+{
+    T x[blockSize];
+    T sign[blockSize];
+    T l[blockSize];
+
+    shorterArc (a, b, x, sign, n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        sign[i] *= t[i];
+        l[i] = 0;
+    }
+
+    for (int c = 0; c < 4; ++c)
+        for (size_t i = 0; i < n; ++i)
+        {
+            const T q = a.p[c][i] * (T (1) - t[i]) + b.p[c][i] * sign[i];
+            r.p[c][i] = q;
+            l[i] += q * q;
+        }
+
+    VecArrayDetail::sqrt (l, n);
+
+    for (size_t i = 0; i < n; ++i)
+        l[i] = l[i] != T (0) ? l[i] : T (1);
+
+    for (int c = 0; c < 4; ++c)
+        for (size_t i = 0; i < n; ++i)
+            r.p[c][i] /= l[i];
+}
+
+//
+// fastSlerp() of n quaternions.
+//
+// With x = cos(a), the slerp weight sin(t*a)/sin(a) is the power series
+//
+//     sum_k b_k(t) (x - 1)^k,  b_0 = t,
+//     b_k = b_(k-1) (t^2 - k^2) / (k (2k + 1))
+//
+// (D. Eberly, "A Fast and Accurate Algorithm for Computing SLERP",
+// 2011). On the shorter arc, 0 <= x <= 1, the series is truncated
+// after slerpTerms terms, and the last term is scaled by
+// slerpCorrection to make up for the ones left out. Over 0 <= t <= 1
+// the weights are then within 7.2e-7 of the exact ones.
+//
+
+const int    slerpTerms      = 12;
+const double slerpCorrection = 1.8937143063730155;
+
+template <class T>
+inline void
+fastSlerp (
+    const Lanes<T>& a,
+    const Lanes<T>& b,
+    const T*        t,
+    const Lanes<T>& r,
+    size_t          n) IMATH_NOEXCEPT
+{
+    T x[blockSize];
+    T sign[blockSize];
+    T s[blockSize];
+    T bt[slerpTerms + 1][blockSize];
+    T bs[slerpTerms + 1][blockSize];
+    T wt[blockSize];
+    T ws[blockSize];
+
+    shorterArc (a, b, x, sign, n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        s[i]     = T (1) - t[i];
+        bt[0][i] = t[i];
+        bs[0][i] = s[i];
+        x[i] -= T (1);
+    }
+
+    for (int k = 1; k <= slerpTerms; ++k)
+    {
+        const T kk = T (k * k);
+        const T c  = T (
+            (k == slerpTerms ? slerpCorrection : 1.0) / (k * (2.0 * k + 1)));
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            bt[k][i] = bt[k - 1][i] * ((t[i] * t[i] - kk) * c);
+            bs[k][i] = bs[k - 1][i] * ((s[i] * s[i] - kk) * c);
+        }
+    }
+
+    //
+    // Horner's rule; summing the powers of x - 1 directly would create
+    // denormals when x is close to 1.
+    //
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        wt[i] = bt[slerpTerms][i];
+        ws[i] = bs[slerpTerms][i];
+    }
+
+    for (int k = slerpTerms - 1; k >= 0; --k)
+        for (size_t i = 0; i < n; ++i)
+        {
+            wt[i] = bt[k][i] + x[i] * wt[i];
+            ws[i] = bs[k][i] + x[i] * ws[i];
+        }
+
+    for (size_t i = 0; i < n; ++i)
+        wt[i] *= sign[i];
+
+    for (int c = 0; c < 4; ++c)
+        for (size_t i = 0; i < n; ++i)
+            r.p[c][i] = a.p[c][i] * ws[i] + b.p[c][i] * wt[i];
+}
+
+//
+// squad() of n quaternions.
+//
+
+template <class T>
+inline void
+squad (
+    const Lanes<T>& q1,
+    const Lanes<T>& qa,
+    const Lanes<T>& qb,
+    const Lanes<T>& q2,
+    const T*        t,
+    const Lanes<T>& r,
+    size_t          n) IMATH_NOEXCEPT
+{
+    T r1[4][blockSize];
+    T r2[4][blockSize];
+    T u[blockSize];
+
+    fastSlerp (q1, q2, t, Lanes<T> (r1), n);
+    fastSlerp (qa, qb, t, Lanes<T> (r2), n);
+
+    for (size_t i = 0; i < n; ++i)
+        u[i] = 2 * t[i] * (T (1) - t[i]);
+
+    fastSlerp (Lanes<T> (r1), Lanes<T> (r2), u, r, n);
+}
+
+//
+// Apply f to blocks of the quaternion arrays, with the parameters
+// `t`, a value or an array.
+//
+
+template <class T, class P, class F>
+inline void
+forEachBlock (size_t n, P t, F f)
+{
+    for (size_t begin = 0; begin < n; begin += blockSize)
+    {
+        const size_t k = n - begin < blockSize ? n - begin : blockSize;
+
+        Params<T> params (t, begin, k);
+        f (begin, params.p, k);
+    }
+}
+
+} // namespace QuatArrayDetail
+
+/// @endcond
+
+/// @{
+/// @name Bulk interpolation
+///
+/// In all of these, the input arrays must have the same size and hold
+/// unit quaternions. The interpolation parameter is either a single
+/// value `t` or an array `t` of one value per quaternion, between 0
+/// and 1. The output array is resized to match, and may be one of the
+/// inputs.
+
+/// Normalized linear interpolation along the shorter arc from `a[i]`
+/// to `b[i]` or `-b[i]`. The result moves along the same great arc as
+/// slerpShortestArc(), but not at constant angular velocity: between
+/// rotations 90 degrees apart, the result is up to 0.92 degrees off
+/// the slerp result, and between rotations 180 degrees apart up to 8.2
+/// degrees.
+template <class T>
+inline void
+nlerp (
+    const QuatArray<T>& a,
+    const QuatArray<T>& b,
+    T                   t,
+    QuatArray<T>&       result)
+{
+    typedef QuatArrayDetail::Lanes<T> L;
+
+    result.resize (a.size ());
+
+    QuatArrayDetail::forEachBlock<T> (
+        a.size (), t, [&] (size_t begin, const T* p, size_t n) {
+            QuatArrayDetail::nlerp (
+                L (a, begin), L (b, begin), p, L (result, begin), n);
+        });
+}
+
+/// Normalized linear interpolation with one parameter per quaternion
+template <class T>
+inline void
+nlerp (
+    const QuatArray<T>& a,
+    const QuatArray<T>& b,
+    const T*            t,
+    QuatArray<T>&       result)
+{
+    typedef QuatArrayDetail::Lanes<T> L;
+
+    result.resize (a.size ());
+
+    QuatArrayDetail::forEachBlock<T> (
+        a.size (), t, [&] (size_t begin, const T* p, size_t n) {
+            QuatArrayDetail::nlerp (
+                L (a, begin), L (b, begin), p, L (result, begin), n);
+        });
+}
+
+/// Spherical linear interpolation along the shorter arc from `a[i]` to
+/// `b[i]` or `-b[i]`, like slerpShortestArc(), without transcendental
+/// functions. In double precision, each component of the result is
+/// within 1.5e-6 of slerpShortestArc(); in single precision, rounding
+/// adds a few ulps. The result is not renormalized, so its length is
+/// within the same bound of 1.
+template <class T>
+inline void
+fastSlerp (
+    const QuatArray<T>& a,
+    const QuatArray<T>& b,
+    T                   t,
+    QuatArray<T>&       result)
+{
+    typedef QuatArrayDetail::Lanes<T> L;
+
+    result.resize (a.size ());
+
+    QuatArrayDetail::forEachBlock<T> (
+        a.size (), t, [&] (size_t begin, const T* p, size_t n) {
+            QuatArrayDetail::fastSlerp (
+                L (a, begin), L (b, begin), p, L (result, begin), n);
+        });
+}
+
+/// Fast spherical linear interpolation with one parameter per
+/// quaternion
+template <class T>
+inline void
+fastSlerp (
+    const QuatArray<T>& a,
+    const QuatArray<T>& b,
+    const T*            t,
+    QuatArray<T>&       result)
+{
+    typedef QuatArrayDetail::Lanes<T> L;
+
+    result.resize (a.size ());
+
+    QuatArrayDetail::forEachBlock<T> (
+        a.size (), t, [&] (size_t begin, const T* p, size_t n) {
+            QuatArrayDetail::fastSlerp (
+                L (a, begin), L (b, begin), p, L (result, begin), n);
+        });
+}
+
+/// Compute the tangent quaternions `result[i] = intermediate (q0[i],
+/// q1[i], q2[i])` for squad(). These use Quat::log() and Quat::exp()
+/// and give identical results; compute them once per key rather than
+/// once per evaluation.
+template <class T>
+inline void
+intermediate (
+    const QuatArray<T>& q0,
+    const QuatArray<T>& q1,
+    const QuatArray<T>& q2,
+    QuatArray<T>&       result)
+{
+    const size_t n = q0.size ();
+
+    result.resize (n);
+
+    for (size_t i = 0; i < n; ++i)
+        result.set (i, intermediate (q0[i], q1[i], q2[i]));
+}
+
+/// Spherical quadrangle interpolation, as squad(), with the three
+/// slerps computed by fastSlerp(). Since each of these takes the
+/// shorter arc, the result matches squad() to within a few times the
+/// fastSlerp() error when the quaternions of each slerp are in the same
+/// hemisphere, as they are for the keys of a smooth rotation sequence
+/// with consistent signs and their intermediate() tangents.
+template <class T>
+inline void
+squad (
+    const QuatArray<T>& q1,
+    const QuatArray<T>& qa,
+    const QuatArray<T>& qb,
+    const QuatArray<T>& q2,
+    T                   t,
+    QuatArray<T>&       result)
+{
+    typedef QuatArrayDetail::Lanes<T> L;
+
+    result.resize (q1.size ());
+
+    QuatArrayDetail::forEachBlock<T> (
+        q1.size (), t, [&] (size_t begin, const T* p, size_t n) {
+            QuatArrayDetail::squad (
+                L (q1, begin),
+                L (qa, begin),
+                L (qb, begin),
+                L (q2, begin),
+                p,
+                L (result, begin),
+                n);
+        });
+}
+
+/// Spherical quadrangle interpolation with one parameter per
+/// quaternion
+template <class T>
+inline void
+squad (
+    const QuatArray<T>& q1,
+    const QuatArray<T>& qa,
+    const QuatArray<T>& qb,
+    const QuatArray<T>& q2,
+    const T*            t,
+    QuatArray<T>&       result)
+{
+    typedef QuatArrayDetail::Lanes<T> L;
+
+    result.resize (q1.size ());
+
+    QuatArrayDetail::forEachBlock<T> (
+        q1.size (), t, [&] (size_t begin, const T* p, size_t n) {
+            QuatArrayDetail::squad (
+                L (q1, begin),
+                L (qa, begin),
+                L (qb, begin),
+                L (q2, begin),
+                p,
+                L (result, begin),
+                n);
+        });
+}
+
+/// Spherical cubic spline interpolation between `q1[i]` and `q2[i]`,
+/// as spline(): the tangents are computed with intermediate() and the
+/// segment is evaluated with squad(). When evaluating the same segments
+/// repeatedly, compute the tangents once and call squad() instead.
+template <class T>
+inline void
+spline (
+    const QuatArray<T>& q0,
+    const QuatArray<T>& q1,
+    const QuatArray<T>& q2,
+    const QuatArray<T>& q3,
+    T                   t,
+    QuatArray<T>&       result)
+{
+    QuatArray<T> qa, qb;
+
+    intermediate (q0, q1, q2, qa);
+    intermediate (q1, q2, q3, qb);
+    squad (q1, qa, qb, q2, t, result);
+}
+
+/// Spherical cubic spline interpolation with one parameter per
+/// quaternion
+template <class T>
+inline void
+spline (
+    const QuatArray<T>& q0,
+    const QuatArray<T>& q1,
+    const QuatArray<T>& q2,
+    const QuatArray<T>& q3,
+    const T*            t,
+    QuatArray<T>&       result)
+{
+    QuatArray<T> qa, qb;
+
+    intermediate (q0, q1, q2, qa);
+    intermediate (q1, q2, q3, qb);
+    squad (q1, qa, qb, q2, t, result);
+}
+
+/// @}
+
+IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif // INCLUDED_IMATHQUATARRAY_H
@@ -0,0 +1,66 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#include "ImathVecArray.h"
+
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64) ||                \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    include <immintrin.h>
+#    define IMATH_VEC_ARRAY_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#    include <arm_neon.h>
+#    define IMATH_VEC_ARRAY_NEON
+#endif
+
+IMATH_INTERNAL_NAMESPACE_SOURCE_ENTER
+
+namespace VecArrayDetail
+{
+
+void
+sqrt (float* v, size_t n) IMATH_NOEXCEPT
+{
+    size_t i = 0;
+
+#if defined(__AVX__)
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps (v + i, _mm256_sqrt_ps (_mm256_loadu_ps (v + i)));
+#endif
+#if defined(IMATH_VEC_ARRAY_SSE2)
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps (v + i, _mm_sqrt_ps (_mm_loadu_ps (v + i)));
+#elif defined(IMATH_VEC_ARRAY_NEON)
+    for (; i + 4 <= n; i += 4)
+        vst1q_f32 (v + i, vsqrtq_f32 (vld1q_f32 (v + i)));
+#endif
+
+    for (; i < n; ++i)
+        v[i] = std::sqrt (v[i]);
+}
+
+void
+sqrt (double* v, size_t n) IMATH_NOEXCEPT
+{
+    size_t i = 0;
+
+#if defined(__AVX__)
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd (v + i, _mm256_sqrt_pd (_mm256_loadu_pd (v + i)));
+#endif
+#if defined(IMATH_VEC_ARRAY_SSE2)
+    for (; i + 2 <= n; i += 2)
+        _mm_storeu_pd (v + i, _mm_sqrt_pd (_mm_loadu_pd (v + i)));
+#elif defined(IMATH_VEC_ARRAY_NEON)
+    for (; i + 2 <= n; i += 2)
+        vst1q_f64 (v + i, vsqrtq_f64 (vld1q_f64 (v + i)));
+#endif
+
+    for (; i < n; ++i)
+        v[i] = std::sqrt (v[i]);
+}
+
+} // namespace VecArrayDetail
+
+IMATH_INTERNAL_NAMESPACE_SOURCE_EXIT
@@ -0,0 +1,909 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+//
+// Structure-of-arrays containers for 3D and 4D vectors, and bulk
+// operations on them.
+//
+// A Vec3Array<T> stores the x, y and z components of its vectors in
+// three separate, 64-byte aligned arrays, so that loops over many
+// vectors process each component with full-width SIMD instructions.
+// The bulk operations below are written so that the compiler can
+// vectorize them; square roots, which compilers do not vectorize
+// because of errno, are computed in the library with SSE/AVX or NEON
+// instructions where the library is compiled for them. The results
+// are identical to applying the corresponding Vec3 or Vec4 method to
+// each element.
+//
+
+#ifndef INCLUDED_IMATHVECARRAY_H
+#define INCLUDED_IMATHVECARRAY_H
+
+#include "ImathExport.h"
+#include "ImathNamespace.h"
+
+#include "ImathPlatform.h"
+#include "ImathTypeTraits.h"
+#include "ImathVec.h"
+
+#include <cmath>
+#include <limits>
+#include <new>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#if defined(_WIN32)
+#    include <malloc.h>
+#endif
+
+IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
+
+///
+/// Allocate `size` bytes aligned to `alignment`, a power of two that
+/// is at least `sizeof (void*)`. Throws `std::bad_alloc` on failure.
+/// The memory must be released with `alignedFree()`.
+///
+
+inline void*
+alignedAlloc (size_t size, size_t alignment)
+{
+    void* p = 0;
+
+#if defined(_WIN32)
+    p = _aligned_malloc (size ? size : 1, alignment);
+#else
+    if (posix_memalign (&p, alignment, size ? size : 1) != 0) p = 0;
+#endif
+
+    if (!p) throw std::bad_alloc ();
+
+    return p;
+}
+
+/// Release memory allocated with `alignedAlloc()`.
+inline void
+alignedFree (void* p) IMATH_NOEXCEPT
+{
+#if defined(_WIN32)
+    _aligned_free (p);
+#else
+    free (p);
+#endif
+}
+
+///
+/// Storage shared by Vec3Array and Vec4Array: `N` separately stored
+/// component arrays ("lanes") of equal length. Each lane starts on a
+/// 64-byte boundary. T must be trivially copyable.
+///
+
+template <class T, int N> class IMATH_EXPORT_TEMPLATE_TYPE VecArrayBase
+{
+    static_assert (
+        std::is_trivially_copyable<T>::value,
+        "VecArrayBase requires a trivially copyable component type");
+
+public:
+    /// Alignment of each lane, in bytes
+    static const size_t alignment = 64;
+
+    /// @{
+    /// @name Size
+
+    /// Number of vectors
+    size_t size () const IMATH_NOEXCEPT { return _size; }
+
+    /// Return true if there are no vectors
+    bool empty () const IMATH_NOEXCEPT { return _size == 0; }
+
+    /// Change the number of vectors. Existing vectors are kept; new
+    /// vectors are uninitialized.
+    void resize (size_t n);
+
+    /// Remove all vectors and release the storage.
+    void clear () IMATH_NOEXCEPT;
+
+    /// @}
+
+    /// @{
+    /// @name Direct access to the component arrays
+
+    /// The array of component `i`, where `0 <= i < N`
+    T* lane (int i) IMATH_NOEXCEPT { return _lanes[i]; }
+
+    /// The array of component `i`, where `0 <= i < N`
+    const T* lane (int i) const IMATH_NOEXCEPT { return _lanes[i]; }
+
+    /// @}
+
+    /// The number of components of each vector
+    static constexpr int dimensions () IMATH_NOEXCEPT { return N; }
+
+protected:
+    VecArrayBase () IMATH_NOEXCEPT;
+    explicit VecArrayBase (size_t n);
+    VecArrayBase (const VecArrayBase& a);
+    VecArrayBase (VecArrayBase&& a) IMATH_NOEXCEPT;
+    ~VecArrayBase () IMATH_NOEXCEPT;
+
+    VecArrayBase& operator= (const VecArrayBase& a);
+    VecArrayBase& operator= (VecArrayBase&& a) IMATH_NOEXCEPT;
+
+private:
+    void allocate (size_t capacity);
+
+    void*  _data;
+    T*     _lanes[N];
+    size_t _size;
+    size_t _capacity;
+};
+
+///
+/// A structure-of-arrays container of 3D vectors
+///
+
+template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Vec3Array
+    : public VecArrayBase<T, 3>
+{
+public:
+    /// @{
+    /// @name Constructors and Assignment
+
+    /// An empty array
+    Vec3Array () IMATH_NOEXCEPT {}
+
+    /// An array of `n` uninitialized vectors
+    explicit Vec3Array (size_t n) : VecArrayBase<T, 3> (n) {}
+
+    /// Copy `n` vectors from `v`
+    Vec3Array (const Vec3<T>* v, size_t n);
+
+    /// Copy the vectors in `v`
+    explicit Vec3Array (const std::vector<Vec3<T>>& v);
+
+    /// @}
+
+    /// @{
+    /// @name Direct access to the component arrays
+
+    T*       x () IMATH_NOEXCEPT { return this->lane (0); }
+    const T* x () const IMATH_NOEXCEPT { return this->lane (0); }
+    T*       y () IMATH_NOEXCEPT { return this->lane (1); }
+    const T* y () const IMATH_NOEXCEPT { return this->lane (1); }
+    T*       z () IMATH_NOEXCEPT { return this->lane (2); }
+    const T* z () const IMATH_NOEXCEPT { return this->lane (2); }
+
+    /// @}
+
+    /// @{
+    /// @name Element access and conversion
+
+    /// Return vector `i`
+    Vec3<T> operator[] (size_t i) const IMATH_NOEXCEPT;
+
+    /// Set vector `i`
+    void set (size_t i, const Vec3<T>& v) IMATH_NOEXCEPT;
+
+    /// Replace the contents with `n` vectors copied from `v`
+    void assign (const Vec3<T>* v, size_t n);
+
+    /// Copy the vectors to `v`, which must hold `size()` vectors
+    void copyTo (Vec3<T>* v) const IMATH_NOEXCEPT;
+
+    /// Return the vectors as an array of structs
+    std::vector<Vec3<T>> toVector () const;
+
+    /// @}
+};
+
+///
+/// A structure-of-arrays container of 4D vectors
+///
+
+template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Vec4Array
+    : public VecArrayBase<T, 4>
+{
+public:
+    /// @{
+    /// @name Constructors and Assignment
+
+    /// An empty array
+    Vec4Array () IMATH_NOEXCEPT {}
+
+    /// An array of `n` uninitialized vectors
+    explicit Vec4Array (size_t n) : VecArrayBase<T, 4> (n) {}
+
+    /// Copy `n` vectors from `v`
+    Vec4Array (const Vec4<T>* v, size_t n);
+
+    /// Copy the vectors in `v`
+    explicit Vec4Array (const std::vector<Vec4<T>>& v);
+
+    /// @}
+
+    /// @{
+    /// @name Direct access to the component arrays
+
+    T*       x () IMATH_NOEXCEPT { return this->lane (0); }
+    const T* x () const IMATH_NOEXCEPT { return this->lane (0); }
+    T*       y () IMATH_NOEXCEPT { return this->lane (1); }
+    const T* y () const IMATH_NOEXCEPT { return this->lane (1); }
+    T*       z () IMATH_NOEXCEPT { return this->lane (2); }
+    const T* z () const IMATH_NOEXCEPT { return this->lane (2); }
+    T*       w () IMATH_NOEXCEPT { return this->lane (3); }
+    const T* w () const IMATH_NOEXCEPT { return this->lane (3); }
+
+    /// @}
+
+    /// @{
+    /// @name Element access and conversion
+
+    /// Return vector `i`
+    Vec4<T> operator[] (size_t i) const IMATH_NOEXCEPT;
+
+    /// Set vector `i`
+    void set (size_t i, const Vec4<T>& v) IMATH_NOEXCEPT;
+
+    /// Replace the contents with `n` vectors copied from `v`
+    void assign (const Vec4<T>* v, size_t n);
+
+    /// Copy the vectors to `v`, which must hold `size()` vectors
+    void copyTo (Vec4<T>* v) const IMATH_NOEXCEPT;
+
+    /// Return the vectors as an array of structs
+    std::vector<Vec4<T>> toVector () const;
+
+    /// @}
+};
+
+/// Vec3Array of float
+typedef Vec3Array<float> V3fArray;
+
+/// Vec3Array of double
+typedef Vec3Array<double> V3dArray;
+
+/// Vec4Array of float
+typedef Vec4Array<float> V4fArray;
+
+/// Vec4Array of double
+typedef Vec4Array<double> V4dArray;
+
+//---------------
+// Implementation
+//---------------
+
+template <class T, int N>
+inline VecArrayBase<T, N>::VecArrayBase () IMATH_NOEXCEPT
+    : _data (0),
+      _size (0),
+      _capacity (0)
+{
+    for (int i = 0; i < N; ++i)
+        _lanes[i] = 0;
+}
+
+template <class T, int N>
+inline VecArrayBase<T, N>::VecArrayBase (size_t n)
+    : _data (0), _size (0), _capacity (0)
+{
+    for (int i = 0; i < N; ++i)
+        _lanes[i] = 0;
+
+    resize (n);
+}
+
+template <class T, int N>
+inline VecArrayBase<T, N>::VecArrayBase (const VecArrayBase& a)
+    : _data (0), _size (0), _capacity (0)
+{
+    for (int i = 0; i < N; ++i)
+        _lanes[i] = 0;
+
+    *this = a;
+}
+
+template <class T, int N>
+inline VecArrayBase<T, N>::VecArrayBase (VecArrayBase&& a) IMATH_NOEXCEPT
+    : _data (a._data),
+      _size (a._size),
+      _capacity (a._capacity)
+{
+    for (int i = 0; i < N; ++i)
+    {
+        _lanes[i]   = a._lanes[i];
+        a._lanes[i] = 0;
+    }
+
+    a._data     = 0;
+    a._size     = 0;
+    a._capacity = 0;
+}
+
+template <class T, int N>
+inline VecArrayBase<T, N>::~VecArrayBase () IMATH_NOEXCEPT
+{
+    alignedFree (_data);
+}
+
+template <class T, int N>
+inline VecArrayBase<T, N>&
+VecArrayBase<T, N>::operator= (const VecArrayBase& a)
+{
+    if (this != &a)
+    {
+        if (a._size > _capacity)
+        {
+            clear ();
+            allocate (a._size);
+        }
+
+        _size = a._size;
+
+        for (int i = 0; i < N; ++i)
+            if (_size) memcpy (_lanes[i], a._lanes[i], _size * sizeof (T));
+    }
+
+    return *this;
+}
+
+template <class T, int N>
+inline VecArrayBase<T, N>&
+VecArrayBase<T, N>::operator= (VecArrayBase&& a) IMATH_NOEXCEPT
+{
+    if (this != &a)
+    {
+        alignedFree (_data);
+
+        _data     = a._data;
+        _size     = a._size;
+        _capacity = a._capacity;
+
+        for (int i = 0; i < N; ++i)
+        {
+            _lanes[i]   = a._lanes[i];
+            a._lanes[i] = 0;
+        }
+
+        a._data     = 0;
+        a._size     = 0;
+        a._capacity = 0;
+    }
+
+    return *this;
+}
+
+template <class T, int N>
+inline void
+VecArrayBase<T, N>::allocate (size_t capacity)
+{
+    //
+    // Round the capacity up so that every lane is a whole number of
+    // alignment units long, which keeps all lanes aligned.
+    //
+
+    const size_t unit = alignment / sizeof (T) ? alignment / sizeof (T) : 1;
+
+    capacity = (capacity + unit - 1) / unit * unit;
+
+    if (capacity > std::numeric_limits<size_t>::max () / (N * sizeof (T)))
+        throw std::bad_alloc ();
+
+    _data     = alignedAlloc (N * capacity * sizeof (T), alignment);
+    _capacity = capacity;
+
+    for (int i = 0; i < N; ++i)
+        _lanes[i] = static_cast<T*> (_data) + i * capacity;
+}
+
+template <class T, int N>
+inline void
+VecArrayBase<T, N>::resize (size_t n)
+{
+    if (n > _capacity)
+    {
+        void*  oldData = _data;
+        T*     oldLanes[N];
+        size_t oldSize = _size;
+
+        for (int i = 0; i < N; ++i)
+            oldLanes[i] = _lanes[i];
+
+        try
+        {
+            allocate (n > 2 * _capacity ? n : 2 * _capacity);
+        }
+        catch (...)
+        {
+            _data = oldData;
+
+            for (int i = 0; i < N; ++i)
+                _lanes[i] = oldLanes[i];
+
+            throw;
+        }
+
+        for (int i = 0; i < N; ++i)
+            if (oldSize) memcpy (_lanes[i], oldLanes[i], oldSize * sizeof (T));
+
+        alignedFree (oldData);
+    }
+
+    _size = n;
+}
+
+template <class T, int N>
+inline void
+VecArrayBase<T, N>::clear () IMATH_NOEXCEPT
+{
+    alignedFree (_data);
+
+    _data     = 0;
+    _size     = 0;
+    _capacity = 0;
+
+    for (int i = 0; i < N; ++i)
+        _lanes[i] = 0;
+}
+
+template <class T>
+inline Vec3Array<T>::Vec3Array (const Vec3<T>* v, size_t n)
+{
+    assign (v, n);
+}
+
+template <class T>
+inline Vec3Array<T>::Vec3Array (const std::vector<Vec3<T>>& v)
+{
+    assign (v.data (), v.size ());
+}
+
+template <class T>
+inline Vec3<T>
+Vec3Array<T>::operator[] (size_t i) const IMATH_NOEXCEPT
+{
+    return Vec3<T> (x ()[i], y ()[i], z ()[i]);
+}
+
+template <class T>
+inline void
+Vec3Array<T>::set (size_t i, const Vec3<T>& v) IMATH_NOEXCEPT
+{
+    x ()[i] = v.x;
+    y ()[i] = v.y;
+    z ()[i] = v.z;
+}
+
+template <class T>
+inline void
+Vec3Array<T>::assign (const Vec3<T>* v, size_t n)
+{
+    this->resize (n);
+
+    T* IMATH_RESTRICT px = x ();
+    T* IMATH_RESTRICT py = y ();
+    T* IMATH_RESTRICT pz = z ();
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        px[i] = v[i].x;
+        py[i] = v[i].y;
+        pz[i] = v[i].z;
+    }
+}
+
+template <class T>
+inline void
+Vec3Array<T>::copyTo (Vec3<T>* v) const IMATH_NOEXCEPT
+{
+    const T* px = x ();
+    const T* py = y ();
+    const T* pz = z ();
+
+    for (size_t i = 0; i < this->size (); ++i)
+    {
+        v[i].x = px[i];
+        v[i].y = py[i];
+        v[i].z = pz[i];
+    }
+}
+
+template <class T>
+inline std::vector<Vec3<T>>
+Vec3Array<T>::toVector () const
+{
+    std::vector<Vec3<T>> v (this->size ());
+
+    if (!v.empty ()) copyTo (v.data ());
+
+    return v;
+}
+
+template <class T>
+inline Vec4Array<T>::Vec4Array (const Vec4<T>* v, size_t n)
+{
+    assign (v, n);
+}
+
+template <class T>
+inline Vec4Array<T>::Vec4Array (const std::vector<Vec4<T>>& v)
+{
+    assign (v.data (), v.size ());
+}
+
+template <class T>
+inline Vec4<T>
+Vec4Array<T>::operator[] (size_t i) const IMATH_NOEXCEPT
+{
+    return Vec4<T> (x ()[i], y ()[i], z ()[i], w ()[i]);
+}
+
+template <class T>
+inline void
+Vec4Array<T>::set (size_t i, const Vec4<T>& v) IMATH_NOEXCEPT
+{
+    x ()[i] = v.x;
+    y ()[i] = v.y;
+    z ()[i] = v.z;
+    w ()[i] = v.w;
+}
+
+template <class T>
+inline void
+Vec4Array<T>::assign (const Vec4<T>* v, size_t n)
+{
+    this->resize (n);
+
+    T* IMATH_RESTRICT px = x ();
+    T* IMATH_RESTRICT py = y ();
+    T* IMATH_RESTRICT pz = z ();
+    T* IMATH_RESTRICT pw = w ();
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        px[i] = v[i].x;
+        py[i] = v[i].y;
+        pz[i] = v[i].z;
+        pw[i] = v[i].w;
+    }
+}
+
+template <class T>
+inline void
+Vec4Array<T>::copyTo (Vec4<T>* v) const IMATH_NOEXCEPT
+{
+    const T* px = x ();
+    const T* py = y ();
+    const T* pz = z ();
+    const T* pw = w ();
+
+    for (size_t i = 0; i < this->size (); ++i)
+    {
+        v[i].x = px[i];
+        v[i].y = py[i];
+        v[i].z = pz[i];
+        v[i].w = pw[i];
+    }
+}
+
+template <class T>
+inline std::vector<Vec4<T>>
+Vec4Array<T>::toVector () const
+{
+    std::vector<Vec4<T>> v (this->size ());
+
+    if (!v.empty ()) copyTo (v.data ());
+
+    return v;
+}
+
+/// @cond Doxygen_Suppress
+
+namespace VecArrayDetail
+{
+
+//
+// In-place square root of n values. Compilers do not vectorize
+// std::sqrt() because it may set errno, so float and double use
+// vector instructions explicitly, in ImathVecArray.cpp. The results
+// are identical, since the vector square root instructions are
+// correctly rounded.
+//
+
+template <class T>
+inline void
+sqrt (T* v, size_t n) IMATH_NOEXCEPT
+{
+    for (size_t i = 0; i < n; ++i)
+        v[i] = std::sqrt (v[i]);
+}
+
+IMATH_EXPORT void sqrt (float* v, size_t n) IMATH_NOEXCEPT;
+IMATH_EXPORT void sqrt (double* v, size_t n) IMATH_NOEXCEPT;
+
+//
+// Sum of the squares of the components of vectors [begin, end).
+//
+
+template <class T, int N>
+inline void
+length2 (
+    const VecArrayBase<T, N>& a,
+    size_t                    begin,
+    size_t                    end,
+    T* IMATH_RESTRICT         result) IMATH_NOEXCEPT
+{
+    const T* IMATH_RESTRICT x = a.lane (0) + begin;
+
+    for (size_t i = 0; i < end - begin; ++i)
+        result[i] = x[i] * x[i];
+
+    for (int c = 1; c < N; ++c)
+    {
+        const T* IMATH_RESTRICT v = a.lane (c) + begin;
+
+        for (size_t i = 0; i < end - begin; ++i)
+            result[i] += v[i] * v[i];
+    }
+}
+
+//
+// Lengths of vectors [begin, end), as computed by Vec3::length() and
+// Vec4::length(): vectors too short for the squared length to be
+// accurate take the slower scaled path.
+//
+
+template <class T>
+inline T
+lengthTiny (const VecArrayBase<T, 3>& a, size_t i) IMATH_NOEXCEPT
+{
+    return Vec3<T> (a.lane (0)[i], a.lane (1)[i], a.lane (2)[i]).length ();
+}
+
+template <class T>
+inline T
+lengthTiny (const VecArrayBase<T, 4>& a, size_t i) IMATH_NOEXCEPT
+{
+    return Vec4<T> (a.lane (0)[i], a.lane (1)[i], a.lane (2)[i], a.lane (3)[i])
+        .length ();
+}
+
+template <class T, int N>
+inline void
+length (
+    const VecArrayBase<T, N>& a,
+    size_t                    begin,
+    size_t                    end,
+    T* IMATH_RESTRICT         result) IMATH_NOEXCEPT
+{
+    const size_t n = end - begin;
+
+    length2 (a, begin, end, result);
+
+    const T limit = T (2) * std::numeric_limits<T>::min ();
+    bool    tiny  = false;
+
+    for (size_t i = 0; i < n; ++i)
+        tiny |= result[i] < limit;
+
+    sqrt (result, n);
+
+    //
+    // Vec3::length() and Vec4::length() decide for themselves whether
+    // the vector is tiny; the margin here only needs to catch every
+    // vector that might be.
+    //
+
+    if (IMATH_UNLIKELY (tiny))
+    {
+        for (size_t i = 0; i < n; ++i)
+            if (result[i] * result[i] < T (4) * limit)
+                result[i] = lengthTiny (a, begin + i);
+    }
+}
+
+//
+// Number of vectors processed per block by operations that need
+// temporary storage.
+//
+
+const size_t blockSize = 256;
+
+} // namespace VecArrayDetail
+
+/// @endcond
+
+/// @{
+/// @name Bulk operations
+///
+/// In all of these, the input arrays must have the same size. Output
+/// arrays are resized to match, and plain output arrays must hold
+/// `a.size()` values. A Vec3Array or Vec4Array output may be one of
+/// the inputs; a plain output array must not overlap them.
+
+/// `result[i] = a[i] ^ b[i]`
+template <class T, int N>
+inline void
+dot (
+    const VecArrayBase<T, N>& a,
+    const VecArrayBase<T, N>& b,
+    T*                        result) IMATH_NOEXCEPT
+{
+    const size_t n = a.size ();
+
+    {
+        const T* ax = a.lane (0);
+        const T* bx = b.lane (0);
+
+        for (size_t i = 0; i < n; ++i)
+            result[i] = ax[i] * bx[i];
+    }
+
+    for (int c = 1; c < N; ++c)
+    {
+        const T* ac = a.lane (c);
+        const T* bc = b.lane (c);
+
+        for (size_t i = 0; i < n; ++i)
+            result[i] += ac[i] * bc[i];
+    }
+}
+
+/// `result[i] = a[i] % b[i]`
+template <class T>
+inline void
+cross (const Vec3Array<T>& a, const Vec3Array<T>& b, Vec3Array<T>& result)
+{
+    const size_t n = a.size ();
+
+    result.resize (n);
+
+    const T* ax = a.x ();
+    const T* ay = a.y ();
+    const T* az = a.z ();
+    const T* bx = b.x ();
+    const T* by = b.y ();
+    const T* bz = b.z ();
+    T*       rx = result.x ();
+    T*       ry = result.y ();
+    T*       rz = result.z ();
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        T x = ay[i] * bz[i] - az[i] * by[i];
+        T y = az[i] * bx[i] - ax[i] * bz[i];
+        T z = ax[i] * by[i] - ay[i] * bx[i];
+
+        rx[i] = x;
+        ry[i] = y;
+        rz[i] = z;
+    }
+}
+
+/// `result[i] = a[i].length2()`
+template <class T, int N>
+inline void
+length2 (const VecArrayBase<T, N>& a, T* result) IMATH_NOEXCEPT
+{
+    VecArrayDetail::length2 (a, 0, a.size (), result);
+}
+
+/// `result[i] = a[i].length()`
+template <class T, int N, IMATH_ENABLE_IF (!std::is_integral<T>::value)>
+inline void
+length (const VecArrayBase<T, N>& a, T* result) IMATH_NOEXCEPT
+{
+    VecArrayDetail::length (a, 0, a.size (), result);
+}
+
+/// `a[i].normalize()` for every vector; null vectors are unchanged
+template <class T, int N, IMATH_ENABLE_IF (!std::is_integral<T>::value)>
+inline void
+normalize (VecArrayBase<T, N>& a) IMATH_NOEXCEPT
+{
+    T l[VecArrayDetail::blockSize];
+
+    for (size_t begin = 0; begin < a.size ();
+         begin += VecArrayDetail::blockSize)
+    {
+        size_t n = a.size () - begin;
+
+        if (n > VecArrayDetail::blockSize) n = VecArrayDetail::blockSize;
+
+        VecArrayDetail::length (a, begin, begin + n, l);
+
+        //
+        // As in Vec3::normalize(), divide rather than multiply by 1/l,
+        // which could overflow; null vectors are divided by 1.
+        //
+
+        for (size_t i = 0; i < n; ++i)
+            l[i] = l[i] != T (0) ? l[i] : T (1);
+
+        for (int c = 0; c < N; ++c)
+        {
+            T* IMATH_RESTRICT v = a.lane (c) + begin;
+
+            for (size_t i = 0; i < n; ++i)
+                v[i] /= l[i];
+        }
+    }
+}
+
+/// `result[i] = a[i] * (1 - t) + b[i] * t`
+template <class T, int N>
+inline void
+lerp (
+    const VecArrayBase<T, N>& a,
+    const VecArrayBase<T, N>& b,
+    T                         t,
+    VecArrayBase<T, N>&       result)
+{
+    const size_t n = a.size ();
+    const T      s = T (1) - t;
+
+    result.resize (n);
+
+    for (int c = 0; c < N; ++c)
+    {
+        const T* ac = a.lane (c);
+        const T* bc = b.lane (c);
+        T*       rc = result.lane (c);
+
+        for (size_t i = 0; i < n; ++i)
+            rc[i] = ac[i] * s + bc[i] * t;
+    }
+}
+
+/// Component-wise minimum of `a[i]` and `b[i]`
+template <class T, int N>
+inline void
+min (const VecArrayBase<T, N>& a,
+     const VecArrayBase<T, N>& b,
+     VecArrayBase<T, N>&       result)
+{
+    const size_t n = a.size ();
+
+    result.resize (n);
+
+    for (int c = 0; c < N; ++c)
+    {
+        const T* ac = a.lane (c);
+        const T* bc = b.lane (c);
+        T*       rc = result.lane (c);
+
+        for (size_t i = 0; i < n; ++i)
+            rc[i] = bc[i] < ac[i] ? bc[i] : ac[i];
+    }
+}
+
+/// Component-wise maximum of `a[i]` and `b[i]`
+template <class T, int N>
+inline void
+max (const VecArrayBase<T, N>& a,
+     const VecArrayBase<T, N>& b,
+     VecArrayBase<T, N>&       result)
+{
+    const size_t n = a.size ();
+
+    result.resize (n);
+
+    for (int c = 0; c < N; ++c)
+    {
+        const T* ac = a.lane (c);
+        const T* bc = b.lane (c);
+        T*       rc = result.lane (c);
+
+        for (size_t i = 0; i < n; ++i)
+            rc[i] = ac[i] < bc[i] ? bc[i] : ac[i];
+    }
+}
+
+/// @}
+
+IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif // INCLUDED_IMATHVECARRAY_H
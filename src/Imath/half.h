@@ -120,6 +120,16 @@
 /// of these numbers has been converted and stored in a table pointed
 /// to by the ``imath_half_to_float_table`` pointer.
 ///
+/// The full table occupies 256 KiB, which can evict an application's
+/// working set from the processor caches when halfs are converted in
+/// random order. With the ``IMATH_HALF_USE_COMPACT_LOOKUP_TABLE``
+/// option, half-to-float conversion instead uses three small tables
+/// pointed to by ``imath_half_to_float_mantissa_table``,
+/// ``imath_half_to_float_exponent_table`` and
+/// ``imath_half_to_float_offset_table``, about 8 KiB in total, at the
+/// cost of two additional loads and an addition per conversion. Both
+/// produce identical results.
+///
 /// Prior to Imath v3.1, conversion from float to half was
 /// accomplished with the help of an exponent look table, but this is
 /// now replaced with explicit bit shifting.
@@ -130,6 +140,28 @@
 /// F16C SSE instructions whenever present and enabled by compiler
 /// flags.
 ///
+/// **Bulk Conversion:**
+///
+/// The ``halfToFloat()`` and ``floatToHalf()`` functions convert whole
+/// arrays at once. They are compiled into the library with AVX-512,
+/// F16C and NEON kernels, and select the widest kernel the processor
+/// supports at runtime, regardless of the compiler flags used to build
+/// the application.
+///
+/// **Conversion via Runtime Dispatch:**
+///
+/// The bulk functions above, and the ``imath_half_to_float_dispatch()``
+/// and ``imath_float_to_half_dispatch()`` functions, use the method
+/// selected once, when the library is loaded: F16C, NEON, or the
+/// portable methods. A binary built for a baseline instruction set
+/// thus still uses hardware conversion where it is available.
+///
+/// The dispatch functions are out-of-line calls, which cost several
+/// times as much per value as the inline ``imath_half_to_float()``
+/// and ``imath_float_to_half()``, so class half does not use them.
+/// Converting arrays with ``halfToFloat()`` and ``floatToHalf()``
+/// amortizes the call over many values.
+///
 /// **Conversion via Bit-Shifting**
 ///
 /// If F16C SSE instructions are not available, conversion can be
@@ -187,6 +219,7 @@
 #    include <immintrin.h>
 #endif
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 
@@ -275,31 +308,59 @@ extern "C"
 extern
 #    endif
     IMATH_EXPORT const imath_half_uif_t* imath_half_to_float_table;
+#    if defined(__cplusplus)
+extern "C"
+#    else
+extern
+#    endif
+    IMATH_EXPORT const uint32_t* imath_half_to_float_mantissa_table;
+#    if defined(__cplusplus)
+extern "C"
+#    else
+extern
+#    endif
+    IMATH_EXPORT const uint32_t* imath_half_to_float_exponent_table;
+#    if defined(__cplusplus)
+extern "C"
+#    else
+extern
+#    endif
+    IMATH_EXPORT const uint16_t* imath_half_to_float_offset_table;
+#endif
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/// Convert half to float, using the method selected for the processor
+/// the program is running on when the Imath library is loaded. This
+/// is an out-of-line call per value, several times slower than the
+/// inline imath_half_to_float(); use halfToFloat() for arrays.
+IMATH_EXPORT float imath_half_to_float_dispatch (imath_half_bits_t h);
+
+/// Convert float to half, rounding to nearest even, using the method
+/// selected for the processor the program is running on. Like
+/// imath_half_to_float_dispatch(), this is an out-of-line call per
+/// value; use floatToHalf() for arrays.
+IMATH_EXPORT imath_half_bits_t imath_float_to_half_dispatch (float f);
+
+/// Return the name of the conversion method selected for
+/// ``imath_half_to_float_dispatch()`` and
+/// ``imath_float_to_half_dispatch()``: "avx512", "f16c", "neon",
+/// "compact table", "table" or "bit-shift".
+IMATH_EXPORT const char* imath_half_conversion_method (void);
+
+#if defined(__cplusplus)
+} // extern "C"
 #endif
 
 ///
-/// Convert half to float
+/// Convert half to float using the bit-shift algorithm
 ///
 
 static inline float
-imath_half_to_float (imath_half_bits_t h)
+imath_half_to_float_bitshift (imath_half_bits_t h)
 {
-#if defined(__F16C__)
-    // NB: The intel implementation does seem to treat NaN slightly
-    // different than the original toFloat table does (i.e. where the
-    // 1 bits are, meaning the signalling or not bits). This seems
-    // benign, given that the original library didn't really deal with
-    // signalling vs non-signalling NaNs
-#    ifdef _MSC_VER
-    /* msvc does not seem to have cvtsh_ss :( */
-    return _mm_cvtss_f32 (_mm_cvtph_ps (_mm_set1_epi16 (h)));
-#    else
-    return _cvtsh_ss (h);
-#    endif
-#elif defined(IMATH_HALF_USE_LOOKUP_TABLE) &&                                  \
-    !defined(IMATH_HALF_NO_LOOKUP_TABLE)
-    return imath_half_to_float_table[h].f;
-#else
     imath_half_uif_t v;
     // this code would be clearer, although it does appear to be faster
     // (1.06 vs 1.08 ns/call) to avoid the constants and just do 4
@@ -328,7 +389,7 @@ imath_half_to_float (imath_half_bits_t h)
         // other compilers may provide count-leading-zeros primitives,
         // but we need the community to inform us of the variants
         uint32_t lc;
-#    if defined(_MSC_VER)
+#if defined(_MSC_VER)
         // The direct intrinsic for this is __lznct, but that is not supported
         // on older x86_64 hardware or ARM. Instead uses the bsr instruction
         // and one additional subtraction. This assumes hexpmant != 0, for 0
@@ -336,13 +397,13 @@ imath_half_to_float (imath_half_bits_t h)
         unsigned long bsr;
         _BitScanReverse (&bsr, hexpmant);
         lc = (31 - bsr);
-#    elif defined(__GNUC__) || defined(__clang__)
+#elif defined(__GNUC__) || defined(__clang__)
         lc = (uint32_t) __builtin_clz (hexpmant);
-#    else
+#else
         lc = 0;
         while (0 == ((hexpmant << lc) & 0x80000000))
             ++lc;
-#    endif
+#endif
         lc -= 8;
         // so nominally we want to remove that extra bit we shifted
         // up, but we are going to add that bit back in, then subtract
@@ -360,31 +421,34 @@ imath_half_to_float (imath_half_bits_t h)
         v.i -= (lc << 23);
     }
     return v.f;
-#endif
 }
 
+#if !defined(IMATH_HALF_NO_LOOKUP_TABLE)
+
 ///
-/// Convert half to float
+/// Convert half to float using the compact lookup tables
 ///
-/// Note: This only supports the "round to even" rounding mode, which
-/// was the only mode supported by the original OpenEXR library
+
+static inline float
+imath_half_to_float_compact (imath_half_bits_t h)
+{
+    imath_half_uif_t v;
+    v.i = imath_half_to_float_mantissa_table
+              [imath_half_to_float_offset_table[h >> 10] + (h & 0x3ff)] +
+          imath_half_to_float_exponent_table[h >> 10];
+    return v.f;
+}
+
+#endif
+
+///
+/// Convert float to half using the bit-shift algorithm, rounding to
+/// nearest even
 ///
 
 static inline imath_half_bits_t
-imath_float_to_half (float f)
+imath_float_to_half_bitshift (float f)
 {
-#if defined(__F16C__)
-#    ifdef _MSC_VER
-    // msvc does not seem to have cvtsh_ss :(
-    return _mm_extract_epi16 (
-        _mm_cvtps_ph (
-            _mm_set_ss (f), (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)),
-        0);
-#    else
-    // preserve the fixed rounding mode to nearest
-    return _cvtss_sh (f, (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
-#    endif
-#else
     imath_half_uif_t  v;
     imath_half_bits_t ret;
     uint32_t          e, m, ui, r, shift;
@@ -410,9 +474,9 @@ imath_float_to_half (float f)
         // too large, round to infinity
         if (IMATH_UNLIKELY (ui > 0x477fefff))
         {
-#    ifdef IMATH_HALF_ENABLE_FP_EXCEPTIONS
+#ifdef IMATH_HALF_ENABLE_FP_EXCEPTIONS
             feraiseexcept (FE_OVERFLOW);
-#    endif
+#endif
             return ret | 0x7c00;
         }
 
@@ -424,10 +488,10 @@ imath_float_to_half (float f)
     // zero or flush to 0
     if (ui < 0x33000001)
     {
-#    ifdef IMATH_HALF_ENABLE_FP_EXCEPTIONS
+#ifdef IMATH_HALF_ENABLE_FP_EXCEPTIONS
         if (ui == 0) return ret;
         feraiseexcept (FE_UNDERFLOW);
-#    endif
+#endif
         return ret;
     }
 
@@ -439,6 +503,61 @@ imath_float_to_half (float f)
     ret |= (m >> shift);
     if (r > 0x80000000 || (r == 0x80000000 && (ret & 0x1) != 0)) ++ret;
     return ret;
+}
+
+///
+/// Convert half to float
+///
+
+static inline float
+imath_half_to_float (imath_half_bits_t h)
+{
+#if defined(__F16C__)
+    // NB: The intel implementation does seem to treat NaN slightly
+    // different than the original toFloat table does (i.e. where the
+    // 1 bits are, meaning the signalling or not bits). This seems
+    // benign, given that the original library didn't really deal with
+    // signalling vs non-signalling NaNs
+#    ifdef _MSC_VER
+    /* msvc does not seem to have cvtsh_ss :( */
+    return _mm_cvtss_f32 (_mm_cvtph_ps (_mm_set1_epi16 (h)));
+#    else
+    return _cvtsh_ss (h);
+#    endif
+#elif defined(IMATH_HALF_USE_COMPACT_LOOKUP_TABLE) &&                          \
+    !defined(IMATH_HALF_NO_LOOKUP_TABLE)
+    return imath_half_to_float_compact (h);
+#elif defined(IMATH_HALF_USE_LOOKUP_TABLE) &&                                  \
+    !defined(IMATH_HALF_NO_LOOKUP_TABLE)
+    return imath_half_to_float_table[h].f;
+#else
+    return imath_half_to_float_bitshift (h);
+#endif
+}
+
+///
+/// Convert half to float
+///
+/// Note: This only supports the "round to even" rounding mode, which
+/// was the only mode supported by the original OpenEXR library
+///
+
+static inline imath_half_bits_t
+imath_float_to_half (float f)
+{
+#if defined(__F16C__)
+#    ifdef _MSC_VER
+    // msvc does not seem to have cvtsh_ss :(
+    return _mm_extract_epi16 (
+        _mm_cvtps_ph (
+            _mm_set_ss (f), (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)),
+        0);
+#    else
+    // preserve the fixed rounding mode to nearest
+    return _cvtss_sh (f, (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+#    endif
+#else
+    return imath_float_to_half_bitshift (f);
 #endif
 }
 
@@ -504,6 +623,25 @@ public:
         FromBits
     };
 
+    /// Rounding modes for bulk float-to-half conversion
+    enum IMATH_EXPORT_ENUM RoundingMode
+    {
+        /// Round to the nearest half, and ties to the half whose
+        /// least significant bit is zero. Floats too large for a
+        /// half become infinity.
+        RoundNearestEven,
+
+        /// Round toward zero, as defined by IEEE 754: the magnitude
+        /// never increases, so finite floats too large for a half
+        /// become ``HALF_MAX``, with the sign of the float.
+        RoundTowardZero,
+
+        /// Discard the low 13 bits of the significand. This rounds
+        /// toward zero, except that floats too large for a half
+        /// become infinity.
+        RoundTruncate
+    };
+
     /// @{
     ///	@name Constructors
 
@@ -888,6 +1026,59 @@ half::setBits (uint16_t bits) IMATH_NOEXCEPT
     _h = bits;
 }
 
+//----------------
+// Bulk conversion
+//----------------
+
+///
+/// Convert an array of `n` halfs to floats.
+///
+/// The kernel is chosen at runtime: 16 lanes with AVX-512, 8 lanes
+/// with F16C, 4 lanes with NEON on ARM, or the lookup table or
+/// bit-shift algorithm otherwise. Every kernel produces results that
+/// are bit-for-bit identical to the lookup table, including the
+/// payload of signalling NaNs.
+///
+/// The `src` and `dst` arrays must not overlap.
+///
+
+IMATH_EXPORT void
+halfToFloat (const half* src, float* dst, size_t n) IMATH_NOEXCEPT;
+
+///
+/// Convert an array of `n` floats to halfs, rounding to nearest even.
+///
+/// The kernel is chosen at runtime as for ``halfToFloat()``, and every
+/// kernel produces results that are bit-for-bit identical to the
+/// bit-shift algorithm.
+///
+/// The `src` and `dst` arrays must not overlap.
+///
+
+IMATH_EXPORT void
+floatToHalf (const float* src, half* dst, size_t n) IMATH_NOEXCEPT;
+
+///
+/// Convert an array of `n` floats to halfs with the given rounding
+/// mode.
+///
+/// If `saturate` is true, every float that would convert to infinity,
+/// including infinity itself, becomes ``HALF_MAX`` with the sign of
+/// the float instead. NaNs remain NaNs.
+///
+/// The conversion has no per-element branches: it uses AVX2 or SSE2
+/// integer instructions on x86 processors, selected at runtime.
+///
+/// The `src` and `dst` arrays must not overlap.
+///
+
+IMATH_EXPORT void floatToHalf (
+    const float*       src,
+    half*              dst,
+    size_t             n,
+    half::RoundingMode mode,
+    bool               saturate = false) IMATH_NOEXCEPT;
+
 IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
 
 /// Output h to os, formatted as a float
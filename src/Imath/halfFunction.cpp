@@ -0,0 +1,290 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+//-----------------------------------------------------------------------------
+//
+//	Saving and memory-mapping halfFunction<T> lookup tables.
+//
+//	A table file consists of a 64-byte header followed by the 65536
+//	table entries, in the byte order of the machine that wrote it:
+//
+//	    offset  size  contents
+//	         0     8  magic number "ImathHFT"
+//	         8     4  file format version (tableVersion)
+//	        12     4  0x01020304, to detect byte order mismatches
+//	        16     4  size of one entry, sizeof (T)
+//	        20     4  number of entries, 65536
+//	        24     1  kind of entry (see halfFunction<T>::tableKind)
+//	        25    39  zero
+//
+//	The header size keeps the entries as aligned as the mapping itself.
+//
+//-----------------------------------------------------------------------------
+
+#include "halfFunction.h"
+
+#include <stdexcept>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+#if defined(_WIN32)
+#    ifndef WIN32_LEAN_AND_MEAN
+#        define WIN32_LEAN_AND_MEAN
+#    endif
+#    include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#    define IMATH_HALF_FUNCTION_MMAP
+#endif
+
+IMATH_INTERNAL_NAMESPACE_SOURCE_ENTER
+
+namespace HalfFunctionDetail
+{
+
+namespace
+{
+
+const char     magic[8]      = {'I', 'm', 'a', 't', 'h', 'H', 'F', 'T'};
+const uint32_t byteOrderMark = 0x01020304;
+const uint32_t numEntries    = 1 << 16;
+const size_t   headerSize    = 64;
+
+struct TableHeader
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t entrySize;
+    uint32_t entryCount;
+    char     kind;
+    char     reserved[39];
+};
+
+static_assert (
+    sizeof (TableHeader) == headerSize, "unexpected table header size");
+
+void
+fail (const char* fileName, const char* what)
+{
+    throw std::runtime_error (
+        std::string ("Cannot load halfFunction table \"") + fileName +
+        "\": " + what + ".");
+}
+
+void
+checkHeader (
+    const char*        fileName,
+    const TableHeader& header,
+    size_t             fileSize,
+    size_t             entrySize,
+    char               kind)
+{
+    if (memcmp (header.magic, magic, sizeof (magic)) != 0)
+        fail (fileName, "not a halfFunction table file");
+
+    if (header.version != tableVersion)
+        fail (fileName, "unsupported file format version");
+
+    if (header.byteOrder != byteOrderMark)
+        fail (fileName, "file was written with a different byte order");
+
+    if (header.entrySize != entrySize || header.kind != kind)
+        fail (fileName, "table entry type does not match");
+
+    if (header.entryCount != numEntries ||
+        fileSize != headerSize + size_t (numEntries) * entrySize)
+        fail (fileName, "file has the wrong size");
+}
+
+} // namespace
+
+void
+saveTable (const char* fileName, const void* table, size_t entrySize, char kind)
+{
+    TableHeader header;
+    memset (&header, 0, sizeof (header));
+    memcpy (header.magic, magic, sizeof (magic));
+    header.version    = tableVersion;
+    header.byteOrder  = byteOrderMark;
+    header.entrySize  = uint32_t (entrySize);
+    header.entryCount = numEntries;
+    header.kind       = kind;
+
+    FILE* file = fopen (fileName, "wb");
+
+    if (!file)
+    {
+        throw std::runtime_error (
+            std::string ("Cannot open \"") + fileName + "\" for writing.");
+    }
+
+    bool ok = fwrite (&header, sizeof (header), 1, file) == 1 &&
+              fwrite (table, entrySize, numEntries, file) == numEntries;
+
+    ok = (fclose (file) == 0) && ok;
+
+    if (!ok)
+    {
+        remove (fileName);
+
+        throw std::runtime_error (
+            std::string ("Cannot write halfFunction table \"") + fileName +
+            "\".");
+    }
+}
+
+const void*
+mapTable (const char* fileName, size_t entrySize, char kind, void** mapping)
+{
+#if defined(_WIN32)
+
+    HANDLE file = CreateFileA (
+        fileName,
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        NULL,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        NULL);
+
+    if (file == INVALID_HANDLE_VALUE) fail (fileName, "cannot open file");
+
+    LARGE_INTEGER size;
+
+    if (!GetFileSizeEx (file, &size) || size_t (size.QuadPart) < headerSize)
+    {
+        CloseHandle (file);
+        fail (fileName, "file has the wrong size");
+    }
+
+    HANDLE map = CreateFileMappingA (file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle (file);
+
+    if (!map) fail (fileName, "cannot map file");
+
+    void* view = MapViewOfFile (map, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle (map);
+
+    if (!view) fail (fileName, "cannot map file");
+
+    try
+    {
+        checkHeader (
+            fileName,
+            *static_cast<const TableHeader*> (view),
+            size_t (size.QuadPart),
+            entrySize,
+            kind);
+    }
+    catch (...)
+    {
+        UnmapViewOfFile (view);
+        throw;
+    }
+
+    *mapping = view;
+    return static_cast<const char*> (view) + headerSize;
+
+#elif defined(IMATH_HALF_FUNCTION_MMAP)
+
+    int fd = open (fileName, O_RDONLY);
+
+    if (fd < 0) fail (fileName, "cannot open file");
+
+    struct stat st;
+
+    if (fstat (fd, &st) != 0 || size_t (st.st_size) < headerSize)
+    {
+        close (fd);
+        fail (fileName, "file has the wrong size");
+    }
+
+    void* view = mmap (0, size_t (st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    close (fd);
+
+    if (view == MAP_FAILED) fail (fileName, "cannot map file");
+
+    try
+    {
+        checkHeader (
+            fileName,
+            *static_cast<const TableHeader*> (view),
+            size_t (st.st_size),
+            entrySize,
+            kind);
+    }
+    catch (...)
+    {
+        munmap (view, size_t (st.st_size));
+        throw;
+    }
+
+    *mapping = view;
+    return static_cast<const char*> (view) + headerSize;
+
+#else
+
+    //
+    // No memory mapping available: read the file into private memory.
+    //
+
+    const size_t fileSize = headerSize + size_t (numEntries) * entrySize;
+
+    FILE* file = fopen (fileName, "rb");
+
+    if (!file) fail (fileName, "cannot open file");
+
+    char* data = new char[fileSize + 1];
+    size_t n   = fread (data, 1, fileSize + 1, file);
+    fclose (file);
+
+    try
+    {
+        if (n < headerSize) fail (fileName, "file has the wrong size");
+
+        checkHeader (
+            fileName,
+            *reinterpret_cast<const TableHeader*> (data),
+            n,
+            entrySize,
+            kind);
+    }
+    catch (...)
+    {
+        delete[] data;
+        throw;
+    }
+
+    *mapping = data;
+    return data + headerSize;
+
+#endif
+}
+
+void
+unmapTable (void* mapping, size_t entrySize)
+{
+    if (!mapping) return;
+
+#if defined(_WIN32)
+    (void) entrySize;
+    UnmapViewOfFile (mapping);
+#elif defined(IMATH_HALF_FUNCTION_MMAP)
+    munmap (mapping, headerSize + size_t (numEntries) * entrySize);
+#else
+    (void) entrySize;
+    delete[] static_cast<char*> (mapping);
+#endif
+}
+
+} // namespace HalfFunctionDetail
+
+IMATH_INTERNAL_NAMESPACE_SOURCE_EXIT
@@ -44,6 +44,32 @@
 //	    half x = hsin (1);
 //	    half y = hsqrt (3.5);
 //
+//	Whole arrays of half values can be evaluated with apply(), which
+//	uses AVX2 or AVX-512 gathers when the code is compiled for those
+//	instruction sets and T is a 4-byte type, and otherwise walks the
+//	input with software prefetching of the table entries:
+//
+//	    hsin.apply (pixels, result, numPixels);
+//
+//	Filling the table calls the function 65536 times.  Passing an
+//	IMATH_NAMESPACE::ParallelBuild tag as the first constructor
+//	argument splits that work among several threads; the function
+//	must then be safe to call concurrently:
+//
+//	    halfFunction<float> curve (Imath::ParallelBuild (), toneCurve);
+//
+//	A table can also be written to a file with save() and loaded back
+//	with the halfFunction (const char fileName[]) constructor.  The
+//	file is memory-mapped read-only, so processes that load the same
+//	file share one physical copy of the table and skip building it.
+//	The file records the format version, the byte order and the size
+//	and kind of T, and loading throws std::runtime_error if any of them
+//	do not match.  T must be trivially copyable.
+//
+//	    curve.save ("toneCurve.hft");
+//	    ...
+//	    halfFunction<float> curve ("toneCurve.hft");
+//
 //---------------------------------------------------------------------------
 
 #ifndef _HALF_FUNCTION_H_
@@ -54,12 +80,43 @@
 #include "half.h"
 
 #include "ImathConfig.h"
+#include "ImathParallel.h"
 #ifndef IMATH_HAVE_LARGE_STACK
 #    include <string.h> // need this for memset
 #else
+#    include <string.h> // need this for memcpy
 #endif
 
 #include <float.h>
+#include <stddef.h>
+#include <type_traits>
+
+#if defined(__AVX2__) && !defined(__CUDA_ARCH__)
+#    include <immintrin.h>
+#endif
+
+IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
+
+namespace HalfFunctionDetail
+{
+
+//
+// Table file support for halfFunction<T>, implemented in halfFunction.cpp.
+//
+
+const uint32_t tableVersion = 1;
+
+IMATH_EXPORT void saveTable (
+    const char* fileName, const void* table, size_t entrySize, char kind);
+
+IMATH_EXPORT const void* mapTable (
+    const char* fileName, size_t entrySize, char kind, void** mapping);
+
+IMATH_EXPORT void unmapTable (void* mapping, size_t entrySize);
+
+} // namespace HalfFunctionDetail
+
+IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
 
 template <class T> class halfFunction
 {
@@ -78,8 +135,37 @@ public:
         T        negInfValue  = 0,
         T        nanValue     = 0);
 
+    template <class Function>
+    halfFunction (
+        IMATH_NAMESPACE::ParallelBuild parallel,
+        Function                       f,
+        half                           domainMin    = -HALF_MAX,
+        half                           domainMax    = HALF_MAX,
+        T                              defaultValue = 0,
+        T                              posInfValue  = 0,
+        T                              negInfValue  = 0,
+        T                              nanValue     = 0);
+
+    //--------------------------------------------------------------
+    // Load a table written by save().  Unless IMATH_HAVE_LARGE_STACK
+    // is defined, the file is mapped read-only rather than copied.
+    // The file must then stay unchanged for the lifetime of the
+    // halfFunction: on POSIX systems, truncating or rewriting it
+    // while it is mapped, for example by saving another table under
+    // the same name, makes evaluation fail with SIGBUS.
+    //--------------------------------------------------------------
+
+    explicit halfFunction (const char fileName[]);
+
 #ifndef IMATH_HAVE_LARGE_STACK
-    ~halfFunction () { delete[] _lut; }
+    ~halfFunction ()
+    {
+        if (_mapping)
+            IMATH_NAMESPACE::HalfFunctionDetail::unmapTable (
+                _mapping, sizeof (T));
+        else
+            delete[] _lut;
+    }
     halfFunction (const halfFunction&) = delete;
     halfFunction& operator= (const halfFunction&) = delete;
     halfFunction (halfFunction&&)                 = delete;
@@ -92,11 +178,42 @@ public:
 
     T operator() (half x) const;
 
+    //-----------------------------------------------------------------
+    // Evaluate the function for n half values: out[i] = (*this)(in[i])
+    //-----------------------------------------------------------------
+
+    void apply (const half* in, T* out, size_t n) const;
+
+    //--------------------------------------
+    // Write the table to a file for loading
+    // with halfFunction (const char[])
+    //--------------------------------------
+
+    void save (const char fileName[]) const;
+
 private:
+    static char tableKind ();
+
+    template <class Function>
+    static void fill (
+        T*        table,
+        Function& f,
+        int       begin,
+        int       end,
+        half      domainMin,
+        half      domainMax,
+        T         defaultValue,
+        T         posInfValue,
+        T         negInfValue,
+        T         nanValue);
+
+    size_t applyGather (const half* in, T* out, size_t n) const;
+
 #ifdef IMATH_HAVE_LARGE_STACK
     T _lut[1 << 16];
 #else
-    T* _lut;
+    const T* _lut;
+    void*    _mapping;
 #endif
 };
 
@@ -116,22 +233,156 @@ halfFunction<T>::halfFunction (
     T        nanValue)
 {
 #ifndef IMATH_HAVE_LARGE_STACK
-    _lut = new T[1 << 16];
+    T* table = new T[1 << 16];
+    _lut     = table;
+    _mapping = 0;
+#else
+    T* table = _lut;
+#endif
+
+    fill (
+        table,
+        f,
+        0,
+        1 << 16,
+        domainMin,
+        domainMax,
+        defaultValue,
+        posInfValue,
+        negInfValue,
+        nanValue);
+}
+
+template <class T>
+template <class Function>
+halfFunction<T>::halfFunction (
+    IMATH_NAMESPACE::ParallelBuild parallel,
+    Function                       f,
+    half                           domainMin,
+    half                           domainMax,
+    T                              defaultValue,
+    T                              posInfValue,
+    T                              negInfValue,
+    T                              nanValue)
+{
+#ifndef IMATH_HAVE_LARGE_STACK
+    T* table = new T[1 << 16];
+    _lut     = table;
+    _mapping = 0;
+
+    try
+    {
+#else
+    T* table = _lut;
+#endif
+        IMATH_NAMESPACE::parallelFor (
+            0,
+            1 << 16,
+            parallel.numThreads,
+            4096,
+            [&] (size_t begin, size_t end) {
+                fill (
+                    table,
+                    f,
+                    int (begin),
+                    int (end),
+                    domainMin,
+                    domainMax,
+                    defaultValue,
+                    posInfValue,
+                    negInfValue,
+                    nanValue);
+            });
+#ifndef IMATH_HAVE_LARGE_STACK
+    }
+    catch (...)
+    {
+        delete[] table;
+        throw;
+    }
+#endif
+}
+
+template <class T>
+halfFunction<T>::halfFunction (const char fileName[])
+{
+    static_assert (
+        std::is_trivially_copyable<T>::value,
+        "halfFunction tables can only be loaded for trivially copyable T");
+
+    void*    mapping = 0;
+    const T* table =
+        static_cast<const T*> (IMATH_NAMESPACE::HalfFunctionDetail::mapTable (
+            fileName, sizeof (T), tableKind (), &mapping));
+
+#ifndef IMATH_HAVE_LARGE_STACK
+    _lut     = table;
+    _mapping = mapping;
+#else
+    memcpy (_lut, table, sizeof (_lut));
+    IMATH_NAMESPACE::HalfFunctionDetail::unmapTable (mapping, sizeof (T));
 #endif
+}
+
+template <class T>
+void
+halfFunction<T>::save (const char fileName[]) const
+{
+    static_assert (
+        std::is_trivially_copyable<T>::value,
+        "halfFunction tables can only be saved for trivially copyable T");
+
+    IMATH_NAMESPACE::HalfFunctionDetail::saveTable (
+        fileName, &_lut[0], sizeof (T), tableKind ());
+}
 
-    for (int i = 0; i < (1 << 16); i++)
+//
+// A one-character code for the kind of T, stored in table files so
+// that, say, a table of floats is not loaded as a table of ints.
+//
+
+template <class T>
+inline char
+halfFunction<T>::tableKind ()
+{
+    if (std::is_same<T, half>::value) return 'h';
+
+    if (std::is_floating_point<T>::value) return 'f';
+
+    if (std::is_integral<T>::value)
+        return std::is_signed<T>::value ? 'i' : 'u';
+
+    return 'o';
+}
+
+template <class T>
+template <class Function>
+void
+halfFunction<T>::fill (
+    T*        table,
+    Function& f,
+    int       begin,
+    int       end,
+    half      domainMin,
+    half      domainMax,
+    T         defaultValue,
+    T         posInfValue,
+    T         negInfValue,
+    T         nanValue)
+{
+    for (int i = begin; i < end; i++)
     {
         half x;
         x.setBits (i);
 
         if (x.isNan ())
-            _lut[i] = nanValue;
+            table[i] = nanValue;
         else if (x.isInfinity ())
-            _lut[i] = x.isNegative () ? negInfValue : posInfValue;
+            table[i] = x.isNegative () ? negInfValue : posInfValue;
         else if (x < domainMin || x > domainMax)
-            _lut[i] = defaultValue;
+            table[i] = defaultValue;
         else
-            _lut[i] = f (x);
+            table[i] = f (x);
     }
 }
 
@@ -142,6 +393,81 @@ halfFunction<T>::operator() (half x) const
     return _lut[x.bits ()];
 }
 
+//
+// Gather the table entries for as many leading elements as the
+// available vector instructions allow, and return how many were done.
+// Gathers only help for 4-byte entries; other types fall through to
+// the scalar loop in apply().
+//
+
+template <class T>
+inline size_t
+halfFunction<T>::applyGather (const half* in, T* out, size_t n) const
+{
+    size_t i = 0;
+
+#if defined(__AVX2__) && !defined(__CUDA_ARCH__)
+    if (sizeof (T) == 4 && std::is_trivially_copyable<T>::value)
+    {
+        const int* table = reinterpret_cast<const int*> (&_lut[0]);
+
+#    if defined(__AVX512F__)
+        for (; i + 16 <= n; i += 16)
+        {
+            __m512i idx = _mm512_cvtepu16_epi32 (_mm256_loadu_si256 (
+                reinterpret_cast<const __m256i*> (in + i)));
+
+            _mm512_storeu_si512 (
+                reinterpret_cast<void*> (out + i),
+                _mm512_i32gather_epi32 (idx, table, 4));
+        }
+#    endif
+
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256i idx = _mm256_cvtepu16_epi32 (
+                _mm_loadu_si128 (reinterpret_cast<const __m128i*> (in + i)));
+
+            _mm256_storeu_si256 (
+                reinterpret_cast<__m256i*> (out + i),
+                _mm256_i32gather_epi32 (table, idx, 4));
+        }
+    }
+#else
+    (void) in;
+    (void) out;
+    (void) n;
+#endif
+
+    return i;
+}
+
+template <class T>
+void
+halfFunction<T>::apply (const half* in, T* out, size_t n) const
+{
+    size_t i = applyGather (in, out, n);
+
+    //
+    // The table is too large for the L1 cache, so fetch the entries
+    // for the values a few iterations ahead while the current ones
+    // are being copied.
+    //
+
+#if defined(__GNUC__) || defined(__clang__)
+    const size_t distance = 16;
+
+    for (; i + distance < n; ++i)
+    {
+        __builtin_prefetch (&_lut[in[i + distance].bits ()]);
+        out[i] = _lut[in[i].bits ()];
+    }
+#endif
+
+    for (; i < n; ++i)
+        out[i] = _lut[in[i].bits ()];
+}
+
 /// @endcond
 
 #endif
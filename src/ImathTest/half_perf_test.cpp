@@ -3,6 +3,43 @@
 // Copyright Contributors to the OpenEXR Project.
 //
 
+//
+// Benchmark of the half <-> float conversion methods.
+//
+// Every conversion method is timed for four access patterns and a
+// range of working-set sizes:
+//
+//   sequential  convert src[0], src[1], src[2], ...
+//   strided     convert src[(i * stride) % n], with a stride of at
+//               least 33 elements, so that every access touches a new
+//               cache line
+//   random      convert src[perm[i]] for a random permutation perm
+//   cold        convert short sequential batches from random offsets,
+//               evicting the caches before each batch, as an
+//               application's own working set would; the conversion
+//               tables then have to be fetched from memory again
+//
+// The output is always written sequentially. Bulk conversion functions
+// only have a sequential form and are skipped for the strided and
+// random patterns. The cold pattern times only the conversions, not
+// the eviction, and since its working set is evicted anyway, it is run
+// for the smallest working set only.
+//
+// The working set is the combined size of the source and destination
+// arrays (not counting the index array of the strided and random
+// patterns), from L1-sized to DRAM-sized. Each case is repeated until
+// a minimum time has elapsed, and the fastest repetition is reported,
+// as ns per element and as GB/s of source plus destination traffic.
+//
+// Usage:
+//
+//   ImathHalfPerfTest [--text | --csv | --json] [--quick]
+//                     [--min-time <seconds>] [--max-size <bytes>]
+//
+// --quick runs only the smallest working sets, briefly, as a smoke
+// test; the test suite runs the benchmark that way.
+//
+
 #ifdef _WIN32
 #    define _CRT_RAND_S
 #endif
@@ -11,7 +48,6 @@
 #include <ImathRandom.h>
 #include <half.h>
 
-#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -21,381 +57,660 @@
 #    include <time.h>
 #endif
 
-#include <memory>
+#include <vector>
 
-static const unsigned short imath_float_half_exp_table[1 << 9] =
-#include "eLut.h"
+using namespace IMATH_NAMESPACE;
 
-    using namespace IMATH_NAMESPACE;
+int64_t
+get_ticks (void)
+{
+#ifdef _WIN32
+    static uint64_t scale = 0;
+    if (scale == 0)
+    {
+        LARGE_INTEGER freq;
+        QueryPerformanceFrequency (&freq);
+        scale = (1000000000 / freq.QuadPart);
+    }
 
-#ifdef IMATH_USE_HALF_LOOKUP_TABLE
+    LARGE_INTEGER ticks;
+    QueryPerformanceCounter (&ticks);
+    return ticks.QuadPart * scale;
+#else
+    struct timespec t;
+    uint64_t        nsecs;
 
-static inline float
-table_half_cast (const half& h)
-{
-    return imath_half_to_float_table[h.bits ()].f;
+    static uint64_t start = 0;
+    if (start == 0)
+    {
+        clock_gettime (CLOCK_MONOTONIC, &t);
+        start = t.tv_sec;
+    }
+
+    clock_gettime (CLOCK_MONOTONIC, &t);
+    nsecs = (t.tv_sec - start) * 1000000000;
+    nsecs += t.tv_nsec;
+    return nsecs;
+#endif
 }
 
-//-----------------------------------------------
-// Overflow handler for float-to-half conversion;
-// generates a hardware floating-point overflow,
-// which may be trapped by the operating system.
-//-----------------------------------------------
+//
+// Conversion methods. Each per-element method is a functor that is
+// instantiated into a sequential and an indexed loop, so that the
+// conversion is inlined as it would be in application code.
+//
 
-static float
-half_overflow ()
+struct HalfToFloatTable
 {
-    float f = 1e10;
+    float operator() (uint16_t h) const
+    {
+        return imath_half_to_float_table[h].f;
+    }
+};
 
-    for (int i = 0; i < 10; i++)
-        f *= f; // this will overflow before the for loop terminates
+struct HalfToFloatCompactTable
+{
+    float operator() (uint16_t h) const
+    {
+        return imath_half_to_float_compact (h);
+    }
+};
 
-    return f;
-}
+struct HalfToFloatBitShift
+{
+    float operator() (uint16_t h) const
+    {
+        return imath_half_to_float_bitshift (h);
+    }
+};
 
-//-----------------------------------------------------
-// Float-to-half conversion -- general case, including
-// zeroes, denormalized numbers and exponent overflows.
-//-----------------------------------------------------
+struct HalfToFloatInline
+{
+    float operator() (uint16_t h) const { return imath_half_to_float (h); }
+};
 
-static uint16_t
-long_convert (int i)
+struct HalfToFloatDispatch
 {
-    //
-    // Our floating point number, f, is represented by the bit
-    // pattern in integer i.  Disassemble that bit pattern into
-    // the sign, s, the exponent, e, and the significand, m.
-    // Shift s into the position where it will go in in the
-    // resulting half number.
-    // Adjust e, accounting for the different exponent bias
-    // of float and half (127 versus 15).
-    //
+    float operator() (uint16_t h) const
+    {
+        return imath_half_to_float_dispatch (h);
+    }
+};
 
-    int s = (i >> 16) & 0x00008000;
-    int e = ((i >> 23) & 0x000000ff) - (127 - 15);
-    int m = i & 0x007fffff;
+#ifdef __F16C__
+struct HalfToFloatF16C
+{
+    float operator() (uint16_t h) const { return _cvtsh_ss (h); }
+};
+#endif
 
-    //
-    // Now reassemble s, e and m into a half:
-    //
+struct FloatToHalfBitShift
+{
+    uint16_t operator() (float f) const
+    {
+        return imath_float_to_half_bitshift (f);
+    }
+};
 
-    if (e <= 0)
+struct FloatToHalfInline
+{
+    uint16_t operator() (float f) const { return imath_float_to_half (f); }
+};
+
+struct FloatToHalfDispatch
+{
+    uint16_t operator() (float f) const
     {
-        if (e < -10)
-        {
-            //
-            // E is less than -10.  The absolute value of f is
-            // less than HALF_DENORM_MIN (f may be a small normalized
-            // float, a denormalized float or a zero).
-            //
-            // We convert f to a half zero with the same sign as f.
-            //
-
-            return s;
-        }
+        return imath_float_to_half_dispatch (f);
+    }
+};
 
-        //
-        // E is between -10 and 0.  F is a normalized float
-        // whose magnitude is less than HALF_NRM_MIN.
-        //
-        // We convert f to a denormalized half.
-        //
+#ifdef __F16C__
+struct FloatToHalfF16C
+{
+    uint16_t operator() (float f) const
+    {
+        return _cvtss_sh (f, _MM_FROUND_TO_NEAREST_INT);
+    }
+};
+#endif
 
-        //
-        // Add an explicit leading 1 to the significand.
-        //
+template <class Src, class Dst, class Convert>
+void
+convert_sequential (const void* src, void* dst, const uint32_t*, size_t n)
+{
+    const Src* s = static_cast<const Src*> (src);
+    Dst*       d = static_cast<Dst*> (dst);
+    Convert    convert;
 
-        m = m | 0x00800000;
+    for (size_t i = 0; i < n; ++i)
+        d[i] = convert (s[i]);
+}
 
-        //
-        // Round to m to the nearest (10+e)-bit value (with e between
-        // -10 and 0); in case of a tie, round to the nearest even value.
-        //
-        // Rounding may cause the significand to overflow and make
-        // our number normalized.  Because of the way a half's bits
-        // are laid out, we don't have to treat this case separately;
-        // the code below will handle it correctly.
-        //
+template <class Src, class Dst, class Convert>
+void
+convert_indexed (const void* src, void* dst, const uint32_t* index, size_t n)
+{
+    const Src* s = static_cast<const Src*> (src);
+    Dst*       d = static_cast<Dst*> (dst);
+    Convert    convert;
 
-        int t = 14 - e;
-        int a = (1 << (t - 1)) - 1;
-        int b = (m >> t) & 1;
+    for (size_t i = 0; i < n; ++i)
+        d[i] = convert (s[index[i]]);
+}
 
-        m = (m + a + b) >> t;
+void
+half_to_float_bulk (const void* src, void* dst, const uint32_t*, size_t n)
+{
+    halfToFloat (static_cast<const half*> (src), static_cast<float*> (dst), n);
+}
 
-        //
-        // Assemble the half from s, e (zero) and m.
-        //
+void
+float_to_half_bulk (const void* src, void* dst, const uint32_t*, size_t n)
+{
+    floatToHalf (static_cast<const float*> (src), static_cast<half*> (dst), n);
+}
 
-        return s | m;
-    }
-    else if (e == 0xff - (127 - 15))
-    {
-        if (m == 0)
-        {
-            //
-            // F is an infinity; convert f to a half
-            // infinity with the same sign as f.
-            //
+void
+float_to_half_bulk_toward_zero (
+    const void* src, void* dst, const uint32_t*, size_t n)
+{
+    floatToHalf (
+        static_cast<const float*> (src),
+        static_cast<half*> (dst),
+        n,
+        half::RoundTowardZero);
+}
 
-            return s | 0x7c00;
-        }
-        else
-        {
-            //
-            // F is a NAN; we produce a half NAN that preserves
-            // the sign bit and the 10 leftmost bits of the
-            // significand of f, with one exception: If the 10
-            // leftmost bits are all zero, the NAN would turn
-            // into an infinity, so we have to set at least one
-            // bit in the significand.
-            //
-
-            m >>= 13;
-            return s | 0x7c00 | m | (m == 0);
-        }
-    }
-    else
-    {
-        //
-        // E is greater than zero.  F is a normalized float.
-        // We try to convert f to a normalized half.
-        //
+typedef void (*convert_function) (
+    const void* src, void* dst, const uint32_t* index, size_t n);
 
-        //
-        // Round to m to the nearest 10-bit value.  In case of
-        // a tie, round to the nearest even value.
-        //
+struct Method
+{
+    const char*      name;
+    bool             to_float;
+    convert_function sequential;
+    convert_function indexed; // null for bulk functions
+};
+
+#define PER_ELEMENT_HALF_TO_FLOAT(name, functor)                               \
+    {                                                                          \
+        name, true, convert_sequential<uint16_t, float, functor>,              \
+            convert_indexed<uint16_t, float, functor>                          \
+    }
 
-        m = m + 0x00000fff + ((m >> 13) & 1);
+#define PER_ELEMENT_FLOAT_TO_HALF(name, functor)                               \
+    {                                                                          \
+        name, false, convert_sequential<float, uint16_t, functor>,             \
+            convert_indexed<float, uint16_t, functor>                          \
+    }
 
-        if (m & 0x00800000)
-        {
-            m = 0;  // overflow in significand,
-            e += 1; // adjust exponent
-        }
+static const Method methods[] = {
+    PER_ELEMENT_HALF_TO_FLOAT ("table", HalfToFloatTable),
+    PER_ELEMENT_HALF_TO_FLOAT ("compact table", HalfToFloatCompactTable),
+    PER_ELEMENT_HALF_TO_FLOAT ("bit-shift", HalfToFloatBitShift),
+#ifdef __F16C__
+    PER_ELEMENT_HALF_TO_FLOAT ("f16c", HalfToFloatF16C),
+#endif
+    PER_ELEMENT_HALF_TO_FLOAT ("inline", HalfToFloatInline),
+    PER_ELEMENT_HALF_TO_FLOAT ("dispatch", HalfToFloatDispatch),
+    {"bulk", true, half_to_float_bulk, 0},
+    PER_ELEMENT_FLOAT_TO_HALF ("bit-shift", FloatToHalfBitShift),
+#ifdef __F16C__
+    PER_ELEMENT_FLOAT_TO_HALF ("f16c", FloatToHalfF16C),
+#endif
+    PER_ELEMENT_FLOAT_TO_HALF ("inline", FloatToHalfInline),
+    PER_ELEMENT_FLOAT_TO_HALF ("dispatch", FloatToHalfDispatch),
+    {"bulk", false, float_to_half_bulk, 0},
+    {"bulk toward zero", false, float_to_half_bulk_toward_zero, 0},
+};
 
-        //
-        // Handle exponent overflow
-        //
+static const int num_methods = sizeof (methods) / sizeof (methods[0]);
 
-        if (e > 30)
-        {
-            half_overflow ();  // Cause a hardware floating point overflow;
-            return s | 0x7c00; // if this returns, the half becomes an
-        }                      // infinity with the same sign as f.
+enum Pattern
+{
+    SEQUENTIAL,
+    STRIDED,
+    RANDOM,
+    COLD,
+    NUM_PATTERNS
+};
 
-        //
-        // Assemble the half from s, e and m.
-        //
+static const char* pattern_names[NUM_PATTERNS] = {
+    "sequential", "strided", "random", "cold"};
 
-        return s | (e << 10) | (m >> 13);
-    }
-}
+enum Format
+{
+    TEXT,
+    CSV,
+    JSON
+};
 
-static inline half
-exptable_half_constructor (float f)
+struct Result
 {
-    half           ret;
-    imath_half_uif x;
+    const Method* method;
+    Pattern       pattern;
+    size_t        working_set;
+    size_t        elements;
+    double        ns_per_element;
+    double        gb_per_s;
+};
 
-    x.f = f;
+//
+// Fill the inputs with finite values spread evenly over the half
+// exponent range. The floats carry extra mantissa bits, so that
+// float-to-half conversion has to round.
+//
 
-    if (f == 0)
+static void
+make_inputs (Rand48& r, uint16_t* halfs, float* floats, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
     {
-        //
-        // Common special case - zero.
-        // Preserve the zero's sign bit.
-        //
+        uint16_t h;
 
-        ret.setBits ((x.i >> 16));
-    }
-    else
-    {
-        //
-        // We extract the combined sign and exponent, e, from our
-        // floating-point number, f.  Then we convert e to the sign
-        // and exponent of the half number via a table lookup.
-        //
-        // For the most common case, where a normalized half is produced,
-        // the table lookup returns a non-zero value; in this case, all
-        // we have to do is round f's significand to 10 bits and combine
-        // the result with e.
-        //
-        // For all other cases (overflow, zeroes, denormalized numbers
-        // resulting from underflow, infinities and NANs), the table
-        // lookup returns zero, and we call a longer, non-inline function
-        // to do the float-to-half conversion.
-        //
-
-        int e = (x.i >> 23) & 0x000001ff;
-
-        e = imath_float_half_exp_table[e];
-
-        if (e)
+        do
         {
-            //
-            // Simple case - round the significand, m, to 10
-            // bits and combine it with the sign and exponent.
-            //
+            h = (uint16_t) r.nexti ();
+        } while ((h & 0x7c00) == 0x7c00);
 
-            int m = x.i & 0x007fffff;
-            ret.setBits (e + ((m + 0x00000fff + ((m >> 13) & 1)) >> 13));
-        }
-        else
-        {
-            //
-            // Difficult case - call a function.
-            //
+        imath_half_uif x;
+        x.f = imath_half_to_float_table[h].f;
 
-            ret.setBits (long_convert (x.i));
-        }
+        if ((h & 0x7c00) != 0) x.i |= (uint32_t) r.nexti () & 0x1fff;
+
+        halfs[i]  = h;
+        floats[i] = x.f;
     }
-    return ret;
 }
-#else
-// provide a wrapping function for consistency/readability
-static inline float
-table_half_cast (const half& h)
+
+static size_t
+gcd (size_t a, size_t b)
 {
-    return static_cast<float> (h);
+    while (b)
+    {
+        size_t t = a % b;
+        a        = b;
+        b        = t;
+    }
+
+    return a;
 }
 
-static inline half
-exptable_half_constructor (float f)
+static void
+make_index (Rand48& r, Pattern pattern, uint32_t* index, size_t n)
 {
-    return half{f};
-}
+    //
+    // A stride that is relatively prime to n visits every element once.
+    //
 
-#endif
+    size_t stride = pattern == STRIDED ? 33 : 1;
 
-int64_t
-get_ticks (void)
-{
-#ifdef _WIN32
-    static uint64_t scale = 0;
-    if (scale == 0)
+    while (gcd (stride, n) != 1)
+        stride += 2;
+
+    for (size_t i = 0; i < n; ++i)
+        index[i] = (uint32_t) (i * stride % n);
+
+    if (pattern == RANDOM)
     {
-        LARGE_INTEGER freq;
-        QueryPerformanceFrequency (&freq);
-        scale = (1000000000 / freq.QuadPart);
+        for (size_t i = n - 1; i > 0; --i)
+        {
+            size_t   j = (size_t) r.nexti () % (i + 1);
+            uint32_t t = index[i];
+            index[i]   = index[j];
+            index[j]   = t;
+        }
     }
+}
 
-    LARGE_INTEGER ticks;
-    QueryPerformanceCounter (&ticks);
-    return ticks.QuadPart * scale;
-#else
-    struct timespec t;
-    uint64_t        nsecs;
+static double
+time_case (
+    const Method&   method,
+    Pattern         pattern,
+    const void*     src,
+    void*           dst,
+    const uint32_t* index,
+    size_t          n,
+    double          min_time,
+    unsigned int*   checksum)
+{
+    convert_function convert =
+        pattern == SEQUENTIAL ? method.sequential : method.indexed;
 
-    static uint64_t start = 0;
-    if (start == 0)
+    convert (src, dst, index, n);
+
+    const int64_t min_ticks = (int64_t) (min_time * 1e9);
+    int64_t       best      = -1;
+    int64_t       total     = 0;
+    int           reps      = 0;
+
+    while (reps < 3 || total < min_ticks)
     {
-        clock_gettime (CLOCK_MONOTONIC, &t);
-        start = t.tv_sec;
+        int64_t st = get_ticks ();
+        convert (src, dst, index, n);
+        int64_t et = get_ticks ();
+
+        if (best < 0 || et - st < best) best = et - st;
+
+        total += et - st;
+        ++reps;
     }
 
-    clock_gettime (CLOCK_MONOTONIC, &t);
-    nsecs = (t.tv_sec - start) * 1000000000;
-    nsecs += t.tv_nsec;
-    return nsecs;
-#endif
+    size_t dst_size = method.to_float ? sizeof (float) : sizeof (uint16_t);
+    const unsigned char* d = static_cast<const unsigned char*> (dst);
+
+    for (size_t i = 0; i < n * dst_size; i += 64)
+        *checksum += d[i];
+
+    return (double) (best > 0 ? best : 1) / (double) n;
 }
 
-void
-perf_test_half_to_float (float* floats, const uint16_t* halfs, int numentries)
+//
+// Time the conversion of cold_batches batches of cold_batch_size
+// elements each, reading the eviction buffer before every batch so
+// that neither the inputs nor any conversion tables are cached.
+//
+
+static const size_t cold_batch_size = 64;
+
+static double
+time_cold_case (
+    const Method&        method,
+    const void*          src,
+    void*                dst,
+    size_t               n,
+    int                  cold_batches,
+    const unsigned char* evict,
+    size_t               evict_size,
+    Rand48&              r,
+    unsigned int*        checksum)
 {
-    const half* halfvals = reinterpret_cast<const half*> (halfs);
+    size_t src_size = method.to_float ? sizeof (uint16_t) : sizeof (float);
 
-    int64_t st = get_ticks ();
-    for (int i = 0; i < numentries; ++i)
-        floats[i] = imath_half_to_float (halfs[i]);
-    int64_t et = get_ticks ();
+    int64_t overhead = get_ticks ();
+    overhead         = get_ticks () - overhead;
 
-    int64_t ost = get_ticks ();
-    for (int i = 0; i < numentries; ++i)
-        floats[i] = table_half_cast (halfvals[i]);
-    int64_t oet = get_ticks ();
+    int64_t total = 0;
 
-    int64_t onanos = (oet - ost);
-    int64_t nnanos = (et - st);
-    fprintf (
-        stderr,
-        "half -> float Old: %10lld (%g ns) New: %10lld (%g ns) (%10lld)\n",
-        (long long) onanos,
-        (double) onanos / ((double) numentries),
-        (long long) nnanos,
-        (double) nnanos / ((double) numentries),
-        ((long long) (onanos - nnanos)));
+    for (int b = 0; b < cold_batches; ++b)
+    {
+        for (size_t i = 0; i < evict_size; i += 64)
+            *checksum += evict[i];
+
+        size_t offset =
+            (size_t) r.nexti () % (n - cold_batch_size + 1) * src_size;
+
+        int64_t st = get_ticks ();
+        method.sequential (
+            static_cast<const unsigned char*> (src) + offset,
+            dst,
+            0,
+            cold_batch_size);
+        int64_t et = get_ticks ();
+
+        if (et - st > overhead) total += et - st - overhead;
+
+        *checksum += static_cast<const unsigned char*> (dst)[0];
+    }
+
+    return (double) (total > 0 ? total : 1) /
+           ((double) cold_batches * cold_batch_size);
 }
 
-void
-perf_test_float_to_half (uint16_t* halfs, const float* floats, int numentries)
+static void
+print_header (Format format)
 {
-    half* halfvals = reinterpret_cast<half*> (halfs);
+    if (format == TEXT)
+    {
+        printf (
+            "half conversion benchmark (dispatch and bulk use %s)\n\n"
+            "%-13s %-17s %-10s %10s %10s %9s %9s\n",
+            imath_half_conversion_method (),
+            "direction",
+            "method",
+            "pattern",
+            "bytes",
+            "elements",
+            "ns/elem",
+            "GB/s");
+    }
+    else if (format == CSV)
+    {
+        printf ("direction,method,pattern,working_set_bytes,elements,"
+                "ns_per_element,gb_per_s\n");
+    }
+    else
+    {
+        printf (
+            "{\n  \"implementation\": \"%s\",\n  \"results\": [",
+            imath_half_conversion_method ());
+    }
+}
+
+static void
+print_result (Format format, const Result& r, bool first)
+{
+    const char* direction =
+        r.method->to_float ? "half-to-float" : "float-to-half";
+
+    if (format == TEXT)
+    {
+        printf (
+            "%-13s %-17s %-10s %10lu %10lu %9.3f %9.2f\n",
+            direction,
+            r.method->name,
+            pattern_names[r.pattern],
+            (unsigned long) r.working_set,
+            (unsigned long) r.elements,
+            r.ns_per_element,
+            r.gb_per_s);
+    }
+    else if (format == CSV)
+    {
+        printf (
+            "%s,%s,%s,%lu,%lu,%.4f,%.4f\n",
+            direction,
+            r.method->name,
+            pattern_names[r.pattern],
+            (unsigned long) r.working_set,
+            (unsigned long) r.elements,
+            r.ns_per_element,
+            r.gb_per_s);
+    }
+    else
+    {
+        printf (
+            "%s\n    {\"direction\": \"%s\", \"method\": \"%s\", "
+            "\"pattern\": \"%s\", \"working_set_bytes\": %lu, "
+            "\"elements\": %lu, \"ns_per_element\": %.4f, "
+            "\"gb_per_s\": %.4f}",
+            first ? "" : ",",
+            direction,
+            r.method->name,
+            pattern_names[r.pattern],
+            (unsigned long) r.working_set,
+            (unsigned long) r.elements,
+            r.ns_per_element,
+            r.gb_per_s);
+    }
 
-    int64_t st = get_ticks ();
-    for (int i = 0; i < numentries; ++i)
-        halfs[i] = imath_float_to_half (floats[i]);
-    int64_t et = get_ticks ();
+    fflush (stdout);
+}
 
-    int64_t ost = get_ticks ();
-    for (int i = 0; i < numentries; ++i)
-        halfvals[i] = exptable_half_constructor (floats[i]);
-    int64_t oet = get_ticks ();
+static void
+print_footer (Format format)
+{
+    if (format == JSON) printf ("\n  ]\n}\n");
+}
 
-    int64_t onanos = (oet - ost);
-    int64_t nnanos = (et - st);
+static void
+usage (const char* program)
+{
     fprintf (
         stderr,
-        "float -> half Old: %10lld (%g ns) New: %10lld (%g ns) (%10lld)\n",
-        (long long) onanos,
-        (double) onanos / ((double) numentries),
-        (long long) nnanos,
-        (double) nnanos / ((double) numentries),
-        ((long long) (onanos - nnanos)));
+        "usage: %s [--text | --csv | --json] [--quick]\n"
+        "          [--min-time <seconds>] [--max-size <bytes>]\n",
+        program);
 }
 
 int
 main (int argc, char* argv[])
 {
-    int ret        = 0;
-    int numentries = 1920 * 1080 * 3;
-    if (argc > 1)
-    {
-        numentries = atoi (argv[1]);
+    Format format   = TEXT;
+    bool   quick    = false;
+    double min_time = 0.05;
+    size_t max_size = 256 << 20;
 
-        if (numentries <= 0)
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp (argv[i], "--text"))
+            format = TEXT;
+        else if (!strcmp (argv[i], "--csv"))
+            format = CSV;
+        else if (!strcmp (argv[i], "--json"))
+            format = JSON;
+        else if (!strcmp (argv[i], "--quick"))
+            quick = true;
+        else if (!strcmp (argv[i], "--min-time") && i + 1 < argc)
+            min_time = atof (argv[++i]);
+        else if (!strcmp (argv[i], "--max-size") && i + 1 < argc)
+            max_size = (size_t) atof (argv[++i]);
+        else
         {
-            fprintf (stderr, "Bad entry count '%s'\n", argv[1]);
-            ret = 1;
+            usage (argv[0]);
+            return 1;
         }
     }
 
-    if (numentries > 0)
+    int cold_batches = 256;
+
+    if (quick)
     {
-        uint16_t* halfs  = new uint16_t[numentries];
-        float*    floats = new float[numentries];
+        min_time     = 0.001;
+        max_size     = 256 << 10;
+        cold_batches = 4;
+    }
 
-        if (halfs && floats)
+    //
+    // Working sets of 16 KiB (L1), 256 KiB (L2), 4 MiB (L3) and
+    // 64 MiB and 256 MiB (DRAM). Each element occupies 6 bytes: a
+    // 2-byte half and a 4-byte float.
+    //
+
+    static const size_t working_sets[] = {
+        16 << 10, 256 << 10, 4 << 20, 64 << 20, 256 << 20};
+
+    static const int num_working_sets =
+        sizeof (working_sets) / sizeof (working_sets[0]);
+
+    size_t max_elements = 0;
+
+    for (int w = 0; w < num_working_sets; ++w)
+        if (working_sets[w] <= max_size) max_elements = working_sets[w] / 6;
+
+    if (max_elements == 0)
+    {
+        fprintf (stderr, "--max-size is smaller than the smallest test\n");
+        return 1;
+    }
+
+    std::vector<uint16_t> halfs (max_elements);
+    std::vector<float>    floats (max_elements);
+    std::vector<uint16_t> half_out (max_elements);
+    std::vector<float>    float_out (max_elements);
+    std::vector<uint32_t> index (max_elements);
+    Rand48                r (0);
+    unsigned int          checksum = 0;
+    bool                  first    = true;
+
+    make_inputs (r, halfs.data (), floats.data (), max_elements);
+
+    //
+    // Reading this buffer, which is larger than the last-level cache
+    // of most machines, evicts everything else for the cold pattern.
+    //
+
+    std::vector<unsigned char> evict (32 << 20, 1);
+
+    print_header (format);
+
+    for (int w = 0; w < num_working_sets && working_sets[w] <= max_size; ++w)
+    {
+        size_t n = working_sets[w] / 6;
+
+        for (int p = 0; p < NUM_PATTERNS; ++p)
         {
-            Rand48 r(numentries);
-            for (int i = 0; i < numentries; ++i)
+            Pattern pattern = Pattern (p);
+
+            if (pattern == COLD && w > 0) continue;
+
+            if (pattern != COLD) make_index (r, pattern, index.data (), n);
+
+            for (int m = 0; m < num_methods; ++m)
             {
-                halfs[i]  = (uint16_t) r.nexti();
-                floats[i] = imath_half_to_float (halfs[i]);
+                const Method& method = methods[m];
+
+                if ((pattern == STRIDED || pattern == RANDOM) &&
+                    !method.indexed)
+                    continue;
+
+                const void* src = method.to_float
+                                      ? (const void*) halfs.data ()
+                                      : (const void*) floats.data ();
+                void*       dst = method.to_float ? (void*) float_out.data ()
+                                                  : (void*) half_out.data ();
+
+                Result result;
+                result.method      = &method;
+                result.pattern     = pattern;
+                result.working_set = n * 6;
+                result.elements    = n;
+
+                if (pattern == COLD)
+                {
+                    result.working_set    = cold_batch_size * 6;
+                    result.elements       = cold_batch_size;
+                    result.ns_per_element = time_cold_case (
+                        method,
+                        src,
+                        dst,
+                        n,
+                        cold_batches,
+                        evict.data (),
+                        evict.size (),
+                        r,
+                        &checksum);
+                }
+                else
+                {
+                    result.ns_per_element = time_case (
+                        method,
+                        pattern,
+                        src,
+                        dst,
+                        index.data (),
+                        n,
+                        min_time,
+                        &checksum);
+                }
+
+                result.gb_per_s = 6.0 / result.ns_per_element;
+
+                print_result (format, result, first);
+                first = false;
             }
-            perf_test_half_to_float (floats, halfs, numentries);
-
-            // test float -> half with real-world values
-            for (int i = 0; i < numentries; ++i)
-                floats[i] = float(r.nextf(-65504, 65504));
-            perf_test_float_to_half (halfs, floats, numentries);
         }
-
-        delete[] halfs;
-        delete[] floats;
     }
 
-    return ret;
+    print_footer (format);
+
+    //
+    // Report a checksum of the outputs, so that the conversions
+    // cannot be optimized away.
+    //
+
+    fprintf (stderr, "checksum %u\n", checksum);
+
+    return 0;
 }
@@ -8,11 +8,14 @@
 #endif
 
 #include "testArithmetic.h"
+#include "testBatchMath.h"
 #include "testBitPatterns.h"
 #include "testBox.h"
 #include "testBoxAlgo.h"
+#include "testBvh.h"
 #include "testClassification.h"
 #include "testColor.h"
+#include "testDualQuat.h"
 #include "testError.h"
 #include "testExtractEuler.h"
 #include "testExtractSHRT.h"
@@ -28,9 +31,12 @@
 #include "testLimits.h"
 #include "testLineAlgo.h"
 #include "testMatrix.h"
+#include "testMatrixBatch.h"
 #include "testMiscMatrixAlgo.h"
+#include "testPolarDecomposition.h"
 #include "testProcrustes.h"
 #include "testQuat.h"
+#include "testQuatArray.h"
 #include "testQuatSetRotation.h"
 #include "testQuatSlerp.h"
 #include "testRandom.h"
@@ -40,6 +46,7 @@
 #include "testTinySVD.h"
 #include "testToFloat.h"
 #include "testVec.h"
+#include "testVecArray.h"
 
 #include <iostream>
 #include <string.h>
@@ -53,6 +60,8 @@ main (int argc, char* argv[])
     // NB: If you add a test here, make sure to enumerate it in the
     // CMakeLists.txt so it runs as part of the test suite
     TEST (testToFloat);
+    TEST (testBulkConversion);
+    TEST (testBulkRounding);
     TEST (testSize);
     TEST (testArithmetic);
     TEST (testNormalizedConversionError);
@@ -64,12 +73,15 @@ main (int argc, char* argv[])
     TEST (testHalfLimits);
     TEST (testFunction);
     TEST (testVec);
+    TEST (testVecArray);
     TEST (testColor);
     TEST (testShear);
     TEST (testMatrix);
+    TEST (testMatrixBatch);
     TEST (testMiscMatrixAlgo);
     TEST (testRoots);
     TEST (testFun);
+    TEST (testBatchMath);
     TEST (testInvert);
     TEST (testInterval);
     TEST (testFrustum);
@@ -77,14 +89,18 @@ main (int argc, char* argv[])
     TEST (testExtractEuler);
     TEST (testExtractSHRT);
     TEST (testQuat);
+    TEST (testQuatArray);
+    TEST (testDualQuat);
     TEST (testQuatSetRotation);
     TEST (testQuatSlerp);
     TEST (testLineAlgo);
     TEST (testBoxAlgo);
+    TEST (testBvh);
     TEST (testBox);
     TEST (testProcrustes);
     TEST (testTinySVD);
     TEST (testJacobiEigenSolver);
+    TEST (testPolarDecomposition);
     TEST (testFrustumTest);
     TEST (testInterop);
     TEST (testNoInterop);
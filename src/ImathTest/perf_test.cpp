@@ -0,0 +1,870 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+//
+// Benchmarks of the batched and accelerated algorithms against their
+// scalar counterparts, on inputs too large for the unit tests.
+//
+// Usage:
+//
+//   ImathPerfTest [--quick] [<benchmark> ...]
+//
+// runs the named benchmarks, or all of them, and prints the wall-clock
+// time of each case. --quick runs them on small inputs, as a smoke
+// test; the test suite runs the benchmarks that way.
+//
+
+#include "testUtil.h"
+#include <ImathBatchMath.h>
+#include <ImathBoxAlgo.h>
+#include <ImathBoxBatch.h>
+#include <ImathBvh.h>
+#include <ImathDualQuat.h>
+#include <ImathEuler.h>
+#include <ImathFrustum.h>
+#include <ImathFrustumTest.h>
+#include <ImathMatrixAlgo.h>
+#include <ImathMatrixBatch.h>
+#include <ImathQuatArray.h>
+#include <ImathRandom.h>
+
+#include <bitset>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+//
+// Wall-clock time since construction, in milliseconds. clock() would
+// add up the time of all the threads of a parallel build.
+//
+
+class Timer
+{
+public:
+    Timer () : _start (std::chrono::steady_clock::now ()) {}
+
+    double ms () const
+    {
+        return std::chrono::duration<double, std::milli> (
+                   std::chrono::steady_clock::now () - _start)
+            .count ();
+    }
+
+private:
+    std::chrono::steady_clock::time_point _start;
+};
+
+//
+// Print the time of one case, for the caller to end the line.
+//
+
+std::ostream&
+report (const char* name, double ms)
+{
+    cout << "  " << name;
+    for (size_t i = strlen (name); i < 24; ++i)
+        cout << ' ';
+    return cout << ms << " ms";
+}
+
+const char*
+precision (float)
+{
+    return "single";
+}
+
+const char*
+precision (double)
+{
+    return "double";
+}
+
+//
+// Batched math functions: std::sin and std::cos, std::exp and
+// std::atan2 element by element, compared with the batched functions.
+//
+
+template <class T>
+void
+batchMathPerf (size_t n, BatchMathAccuracy a)
+{
+    Rand48         rand (7);
+    std::vector<T> x (n), s (n), c (n);
+
+    for (size_t i = 0; i < n; ++i)
+        x[i] = T (rand.nextf (0.1, 3));
+
+    cout << "  " << (a == BatchMathPrecise ? "precise" : "fast") << endl;
+
+    Timer timer;
+    for (size_t i = 0; i < n; ++i)
+    {
+        s[i] = std::sin (x[i]);
+        c[i] = std::cos (x[i]);
+    }
+    report ("std::sin, std::cos", timer.ms ()) << endl;
+
+    timer = Timer ();
+    batchSincos (x.data (), s.data (), c.data (), n, a);
+    report ("batchSincos", timer.ms ()) << endl;
+
+    timer = Timer ();
+    for (size_t i = 0; i < n; ++i)
+        s[i] = std::exp (x[i]);
+    report ("std::exp", timer.ms ()) << endl;
+
+    timer = Timer ();
+    batchExp (x.data (), s.data (), n, a);
+    report ("batchExp", timer.ms ()) << endl;
+
+    timer = Timer ();
+    for (size_t i = 0; i < n; ++i)
+        s[i] = std::atan2 (x[i], c[i]);
+    report ("std::atan2", timer.ms ()) << endl;
+
+    timer = Timer ();
+    batchAtan2 (x.data (), c.data (), s.data (), n, a);
+    report ("batchAtan2", timer.ms ()) << endl;
+}
+
+template <class T>
+void
+batchMathPerf (size_t n)
+{
+    cout << "batched math functions in " << precision (T ()) << " precision, "
+         << n << " arguments" << endl;
+    batchMathPerf<T> (n, BatchMathPrecise);
+    batchMathPerf<T> (n, BatchMathFast);
+}
+
+void
+batchMathPerf (bool quick)
+{
+    const size_t n = quick ? 10000 : 1000000;
+    batchMathPerf<float> (n);
+    batchMathPerf<double> (n);
+}
+
+//
+// Ray-box slab test: each of a set of rays against each of a set of
+// boxes, with intersects(), with the slab test of an InverseRay, and
+// with packets of rays and packets of boxes.
+//
+
+template <class T>
+void
+boxAlgoPerf (size_t n)
+{
+    Rand48                    rand (37);
+    std::vector<Box<Vec3<T>>> boxes (n);
+    std::vector<Line3<T>>     rays (n);
+    Vec3Array<T>              pos (n), invDir (n), min (n), max (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const Vec3<T> c = randomPoint (rand, T (10));
+
+        boxes[i] = Box<Vec3<T>> (c - Vec3<T> (1), c + Vec3<T> (1));
+        min.set (i, boxes[i].min);
+        max.set (i, boxes[i].max);
+
+        rays[i].pos = randomPoint (rand, T (20));
+        rays[i].dir = c - rays[i].pos;
+
+        pos.set (i, rays[i].pos);
+        invDir.set (i, InverseRay<T> (rays[i]).invDir);
+    }
+
+    std::vector<uint64_t> bits ((n + 63) / 64);
+    std::vector<T>        t (n);
+    size_t                hits = 0;
+    Vec3<T>               ip;
+    T                     s;
+
+    cout << "ray-box slab test in " << precision (T ()) << " precision, "
+         << n << " rays x " << n << " boxes" << endl;
+
+    Timer timer;
+    for (size_t i = 0; i < n; ++i)
+        for (size_t k = 0; k < n; ++k)
+            hits += intersects (boxes[k], rays[i], ip);
+    report ("intersects()", timer.ms ()) << ", " << hits << " hits" << endl;
+
+    hits  = 0;
+    timer = Timer ();
+    for (size_t i = 0; i < n; ++i)
+    {
+        const InverseRay<T> r (rays[i]);
+        for (size_t k = 0; k < n; ++k)
+            hits += intersects (boxes[k], r, s);
+    }
+    report ("slab test", timer.ms ()) << ", " << hits << " hits" << endl;
+
+    hits  = 0;
+    timer = Timer ();
+    for (size_t k = 0; k < n; ++k)
+    {
+        intersects (boxes[k], pos, invDir, bits.data (), t.data ());
+        for (size_t j = 0; j < bits.size (); ++j)
+            hits += bitset<64> (bits[j]).count ();
+    }
+    report ("ray packets", timer.ms ()) << ", " << hits << " hits" << endl;
+
+    hits  = 0;
+    timer = Timer ();
+    for (size_t i = 0; i < n; ++i)
+    {
+        intersects (min, max, InverseRay<T> (rays[i]), bits.data (), t.data ());
+        for (size_t j = 0; j < bits.size (); ++j)
+            hits += bitset<64> (bits[j]).count ();
+    }
+    report ("box packets", timer.ms ()) << ", " << hits << " hits" << endl;
+}
+
+void
+boxAlgoPerf (bool quick)
+{
+    const size_t n = quick ? 100 : 1000;
+    boxAlgoPerf<float> (n);
+    boxAlgoPerf<double> (n);
+}
+
+//
+// Bvh: build a hierarchy of clustered boxes of sizes from 0.01 to 10,
+// on one and all threads, and find the box that each of a set of rays
+// hits first, compared with testing every box.
+//
+
+template <class T>
+void
+bvhPerf (size_t n)
+{
+    Rand48                    rand (7);
+    std::vector<Box<Vec3<T>>> boxes (n);
+    Vec3<T>                   cluster (0);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (i % 100 == 0) cluster = randomPoint<T> (rand, 100);
+
+        const T       size = T (std::pow (10.0, rand.nextf (-2, 1)));
+        const Vec3<T> c    = cluster + randomPoint<T> (rand, 20);
+        const Vec3<T> e (
+            T (size * rand.nextf ()),
+            T (size * rand.nextf ()),
+            T (size * rand.nextf ()));
+
+        boxes[i] = Box<Vec3<T>> (c - e, c + e);
+    }
+
+    cout << "Bvh in " << precision (T ()) << " precision, " << n << " boxes"
+         << endl;
+
+    Timer  timer;
+    Bvh<T> bvh (boxes.data (), n);
+    report ("build, 1 thread", timer.ms ()) << endl;
+
+    timer = Timer ();
+    bvh.build (boxes.data (), n, ParallelBuild ());
+    report ("build, all threads", timer.ms ()) << endl;
+
+    std::vector<Line3<T>> rays (1000);
+    for (size_t i = 0; i < rays.size (); ++i)
+        rays[i] = Line3<T> (
+            randomPoint<T> (rand, 150), randomPoint<T> (rand, 100));
+
+    size_t  hits = 0, index;
+    Vec3<T> point;
+
+    timer = Timer ();
+    for (size_t i = 0; i < rays.size (); ++i)
+        hits += bvh.closestIntersection (rays[i], index, point);
+    report ("closestIntersection", timer.ms ())
+        << ", " << hits << " of " << rays.size () << " rays hit" << endl;
+
+    // Every box, for a tenth of the rays
+    hits  = 0;
+    timer = Timer ();
+    for (size_t i = 0; i < rays.size () / 10; ++i)
+        for (size_t k = 0; k < n; ++k)
+            hits += intersects (boxes[k], rays[i]);
+    report ("every box x10", timer.ms () * 10)
+        << ", " << hits << " boxes hit" << endl;
+}
+
+void
+bvhPerf (bool quick)
+{
+    const size_t n = quick ? 10000 : 1000000;
+    bvhPerf<float> (n);
+    bvhPerf<double> (n);
+}
+
+//
+// Skinning: blend the matrices of four bones per point, compared with
+// dualQuatSkinning().
+//
+
+template <class T>
+void
+dualQuatPerf (size_t n)
+{
+    Rand48    rand (11);
+    const int influences = 4;
+    const int numBones   = 100;
+
+    std::vector<DualQuat<T>> bones (numBones);
+    std::vector<Matrix44<T>> matrices (numBones);
+
+    for (int b = 0; b < numBones; ++b)
+    {
+        bones[b] =
+            DualQuat<T> (randomRotation<T> (rand), randomPoint<T> (rand, 10));
+        matrices[b] = bones[b].toMatrix44 ();
+    }
+
+    std::vector<int> index (n * influences);
+    std::vector<T>   weight (n * influences);
+
+    for (size_t i = 0; i < n * influences; ++i)
+    {
+        index[i]  = rand.nexti () % numBones;
+        weight[i] = T (1) / influences;
+    }
+
+    std::vector<Vec3<T>> p (n), r (n);
+    for (size_t i = 0; i < n; ++i)
+        p[i] = randomPoint<T> (rand, 10);
+
+    const Vec3Array<T> points (p);
+    Vec3Array<T>       result (points);
+
+    cout << "skinning in " << precision (T ()) << " precision, " << n
+         << " points" << endl;
+
+    Timer timer;
+    for (size_t i = 0; i < n; ++i)
+    {
+        const int* k = &index[i * influences];
+        const T*   w = &weight[i * influences];
+
+        Matrix44<T> m = matrices[k[0]] * w[0];
+
+        for (int j = 1; j < influences; ++j)
+            m += matrices[k[j]] * w[j];
+
+        r[i] = p[i] * m;
+    }
+    report ("matrix blending", timer.ms ()) << endl;
+
+    timer = Timer ();
+    dualQuatSkinning (
+        bones.data (),
+        index.data (),
+        weight.data (),
+        influences,
+        points,
+        result);
+    report ("dualQuatSkinning", timer.ms ()) << endl;
+}
+
+void
+dualQuatPerf (bool quick)
+{
+    const size_t n = quick ? 10000 : 1000000;
+    dualQuatPerf<float> (n);
+    dualQuatPerf<double> (n);
+}
+
+//
+// Euler angles: convert to matrices and back, one Euler at a time and
+// with the batched functions, for the ZXYr order.
+//
+
+template <class T>
+void
+extractEulerPerf (size_t n)
+{
+    Rand48               rand (19);
+    std::vector<Vec3<T>> a (n);
+
+    for (size_t i = 0; i < n; ++i)
+        a[i] = Vec3<T> (
+            T (rand.nextf (-M_PI, M_PI)),
+            T (rand.nextf (-M_PI, M_PI)),
+            T (rand.nextf (-M_PI, M_PI)));
+
+    const Vec3Array<T>       angles (a);
+    std::vector<Matrix44<T>> m (n);
+    Matrix44Array<T>         mb (m.data (), n);
+    Vec3Array<T>             ab (angles);
+
+    cout << "Euler angles in " << precision (T ()) << " precision, " << n
+         << " rotations" << endl;
+
+    Timer timer;
+    for (size_t i = 0; i < n; ++i)
+        m[i] = Euler<T> (a[i], Euler<T>::ZXYr).toMatrix44 ();
+    report ("Euler::toMatrix44", timer.ms ()) << endl;
+
+    timer = Timer ();
+    eulerToMatrix44<Euler<T>::ZXYr> (angles, mb);
+    report ("eulerToMatrix44", timer.ms ()) << endl;
+
+    timer = Timer ();
+    for (size_t i = 0; i < n; ++i)
+    {
+        Euler<T> e (Euler<T>::ZXYr);
+        e.extract (m[i]);
+        a[i] = e;
+    }
+    report ("Euler::extract", timer.ms ()) << endl;
+
+    timer = Timer ();
+    extractEuler<Euler<T>::ZXYr> (mb, ab);
+    report ("extractEuler", timer.ms ()) << endl;
+}
+
+void
+extractEulerPerf (bool quick)
+{
+    const size_t n = quick ? 10000 : 1000000;
+    extractEulerPerf<float> (n);
+    extractEulerPerf<double> (n);
+}
+
+//
+// Frustum culling: boxes of sizes from 0.001 to 100 around a frustum,
+// one by one, in batches, and with the exact test, whose extra cost is
+// reported for each box it culls; and the leaves of an octree, one by
+// one and by descending the octree with plane masks.
+//
+
+template <class T>
+void
+frustumBoxes (
+    Rand48&                    rand,
+    size_t                     n,
+    std::vector<Box<Vec3<T>>>& boxes,
+    Vec3Array<T>&              centers,
+    Vec3Array<T>&              extents)
+{
+    boxes.resize (n);
+    centers.resize (n);
+    extents.resize (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const T size = T (std::pow (10.0, rand.nextf (-3, 2)));
+
+        const Vec3<T> c (
+            T (rand.nextf (-60, 60)),
+            T (rand.nextf (-60, 60)),
+            T (rand.nextf (-120, 10)));
+
+        const Vec3<T> e (
+            T (size * rand.nextf ()),
+            T (size * rand.nextf ()),
+            T (size * rand.nextf ()));
+
+        boxes[i] = Box<Vec3<T>> (c - e, c + e);
+        centers.set (i, c);
+        extents.set (i, e);
+    }
+}
+
+//
+// An octree of `depth` levels below `root`, as an array of boxes where
+// the children of node i are nodes 8 * i + 1 to 8 * i + 8.
+//
+
+template <class T> struct Octree
+{
+    std::vector<Box<Vec3<T>>> boxes;
+    std::vector<unsigned>     lastPlanes;
+    size_t                    firstLeaf;
+
+    Octree (const Box<Vec3<T>>& root, int depth)
+    {
+        size_t n = 0, level = 1;
+        for (int d = 0; d <= depth; ++d, level *= 8)
+            n += level;
+
+        boxes.resize (n);
+        lastPlanes.resize (n, 0);
+        firstLeaf = n - level / 8;
+        boxes[0]  = root;
+
+        for (size_t i = 0; i < firstLeaf; ++i)
+        {
+            const Vec3<T> c = boxes[i].center ();
+
+            for (int k = 0; k < 8; ++k)
+            {
+                Box<Vec3<T>>& b = boxes[8 * i + 1 + k];
+                b               = Box<Vec3<T>> (boxes[i].min, c);
+
+                if (k & 1) b.min.x = c.x, b.max.x = boxes[i].max.x;
+                if (k & 2) b.min.y = c.y, b.max.y = boxes[i].max.y;
+                if (k & 4) b.min.z = c.z, b.max.z = boxes[i].max.z;
+            }
+        }
+    }
+
+    // Return the number of visible leaves below node i
+    size_t cull (const FrustumTest<T>& frustumTest, size_t i, unsigned mask)
+    {
+        if (!frustumTest.isVisible (boxes[i], mask, lastPlanes[i])) return 0;
+
+        if (i >= firstLeaf) return 1;
+
+        size_t visible = 0;
+        for (size_t k = 1; k <= 8; ++k)
+            visible += cull (frustumTest, 8 * i + k, mask);
+
+        return visible;
+    }
+};
+
+//
+// The time of each of `count` objects, in ns.
+//
+
+double
+nsEach (double ms, size_t count)
+{
+    return count ? ms * 1e6 / double (count) : 0;
+}
+
+template <class T>
+void
+frustumTestPerf (size_t n, int depth)
+{
+    const Frustum<T> frustum (
+        T (0.5), T (100), T (-0.4), T (0.4), T (0.3), T (-0.3));
+
+    // A camera turned about its axis, so that the sides of the frustum
+    // are not aligned with the boxes
+    Matrix44<T> cameraMat;
+    cameraMat.rotate (Vec3<T> (T (0.1), T (-0.2), T (0.7)));
+
+    const FrustumTest<T>      frustumTest (frustum, cameraMat);
+    const FrustumExactTest<T> exactTest (frustumTest);
+
+    Rand48                    rand (31);
+    std::vector<Box<Vec3<T>>> boxes;
+    Vec3Array<T>              centers, extents;
+    frustumBoxes (rand, n, boxes, centers, extents);
+
+    std::vector<uint32_t> indices (n);
+    std::vector<uint64_t> bits ((n + 63) / 64);
+    size_t                visible = 0, exact = 0;
+
+    cout << "frustum culling in " << precision (T ()) << " precision, " << n
+         << " boxes" << endl;
+
+    Timer timer;
+    for (size_t i = 0; i < n; ++i)
+        visible += frustumTest.isVisible (boxes[i]);
+    const double cheapMs = timer.ms ();
+    report ("isVisible (Box)", cheapMs)
+        << ", " << visible << " visible" << endl;
+
+    timer = Timer ();
+    frustumTest.isVisible (centers, extents, bits.data ());
+    report ("isVisible (batch)", timer.ms ()) << endl;
+
+    timer = Timer ();
+    const size_t batchVisible =
+        frustumTest.visibleIndices (centers, extents, indices.data ());
+    report ("visibleIndices", timer.ms ()) << endl;
+
+    // The exact test of every box, against the cheap test above
+    timer = Timer ();
+    for (size_t i = 0; i < n; ++i)
+        exact += exactTest.isVisible (boxes[i]);
+    const double exactMs = timer.ms ();
+    report ("FrustumExactTest", exactMs)
+        << ", " << visible - exact << " more boxes culled, "
+        << nsEach (exactMs - cheapMs, visible - exact) << " ns per box"
+        << endl;
+
+    // The exact test of the boxes visibleIndices() kept
+    timer = Timer ();
+    const size_t refined = exactTest.refineVisibleIndices (
+        centers, extents, indices.data (), batchVisible);
+    const double refineMs = timer.ms ();
+    report ("refineVisibleIndices", refineMs)
+        << ", " << batchVisible - refined << " more boxes culled, "
+        << nsEach (refineMs, batchVisible - refined) << " ns per box" << endl;
+
+    // The leaves of an octree, as the camera turns a little from frame
+    // to frame
+    Octree<T> octree (
+        Box<Vec3<T>> (Vec3<T> (-128, -128, -128), Vec3<T> (128, 128, 128)),
+        depth);
+
+    double flat = 0, hierarchy = 0;
+    size_t flatVisible = 0, hierarchyVisible = 0;
+
+    for (int frame = 0; frame < 20; ++frame)
+    {
+        Matrix44<T> m;
+        m.rotate (Vec3<T> (T (0.01 * frame), T (0.02 * frame), 0));
+        m.translate (Vec3<T> (T (0.37), T (0.21), T (0.13)));
+
+        const FrustumTest<T> test (frustum, m);
+
+        timer = Timer ();
+        for (size_t i = octree.firstLeaf; i < octree.boxes.size (); ++i)
+            flatVisible += test.isVisible (octree.boxes[i]);
+        flat += timer.ms ();
+
+        timer = Timer ();
+        hierarchyVisible += octree.cull (test, 0, FrustumTest<T>::allPlanes);
+        hierarchy += timer.ms ();
+    }
+
+    cout << "  " << octree.boxes.size () - octree.firstLeaf
+         << " octree leaves, 20 frames" << endl;
+    report ("every leaf", flat) << ", " << flatVisible << " visible" << endl;
+    report ("octree with plane masks", hierarchy)
+        << ", " << hierarchyVisible << " visible" << endl;
+}
+
+void
+frustumTestPerf (bool quick)
+{
+    const size_t n     = quick ? 10000 : 1000000;
+    const int    depth = quick ? 3 : 6;
+    frustumTestPerf<float> (n, depth);
+    frustumTestPerf<double> (n, depth);
+}
+
+//
+// Polar decomposition of stretched rotations: with an SVD, iterating to
+// convergence and with a fixed number of iterations, one matrix at a
+// time and batched.
+//
+
+template <class T>
+void
+polarDecompositionPerf (size_t n)
+{
+    Rand48      rand (3);
+    Matrix33<T> U, V, R, S;
+    Vec3<T>     s;
+
+    std::vector<Matrix33<T>> A (n), BR (n), BS (n), BV (n);
+    std::vector<Vec3<T>>     BW (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const Matrix33<T> Q = randomRotation<T> (rand).toMatrix33 ();
+        Matrix33<T>       D;
+        D[0][0] = 1;
+        D[1][1] = T (rand.nextf (1, 10));
+        D[2][2] = 10;
+
+        A[i] = Q.transposed () * D * Q * randomRotation<T> (rand).toMatrix33 ();
+    }
+
+    cout << "polar decomposition in " << precision (T ()) << " precision, "
+         << n << " matrices" << endl;
+
+    Timer timer;
+    for (size_t i = 0; i < n; ++i)
+    {
+        jacobiSVD (A[i], U, s, V, std::numeric_limits<T>::epsilon (), true);
+        R = U * V.transposed ();
+    }
+    report ("SVD rotation", timer.ms ()) << endl;
+
+    timer = Timer ();
+    for (size_t i = 0; i < n; ++i)
+        polarDecomposition (A[i], R, S);
+    report ("polar", timer.ms ()) << endl;
+
+    timer = Timer ();
+    for (size_t i = 0; i < n; ++i)
+        fastPolarDecomposition (A[i], R, S);
+    report ("fast polar", timer.ms ()) << endl;
+
+    timer = Timer ();
+    jacobiSVD (
+        A.data (),
+        BR.data (),
+        BW.data (),
+        BV.data (),
+        n,
+        std::numeric_limits<T>::epsilon (),
+        true);
+    for (size_t i = 0; i < n; ++i)
+        BR[i] = BR[i] * BV[i].transposed ();
+    report ("batched SVD rotation", timer.ms ()) << endl;
+
+    timer = Timer ();
+    polarDecomposition (A.data (), BR.data (), BS.data (), n, 0);
+    report ("batched polar", timer.ms ()) << endl;
+
+    timer = Timer ();
+    fastPolarDecomposition (A.data (), BR.data (), BS.data (), n, 0);
+    report ("batched fast polar", timer.ms ()) << endl;
+}
+
+void
+polarDecompositionPerf (bool quick)
+{
+    const size_t n = quick ? 1000 : 100000;
+    polarDecompositionPerf<float> (n);
+    polarDecompositionPerf<double> (n);
+}
+
+//
+// Quaternion arrays: interpolation, and conversion to matrices and
+// back, one quaternion at a time and in bulk.
+//
+
+template <class T>
+void
+quatArrayPerf (size_t n)
+{
+    Rand48               rand (19);
+    std::vector<Quat<T>> a (n), b (n), r (n);
+    std::vector<T>       t (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        a[i] = randomRotation<T> (rand);
+        b[i] = randomRotation<T> (rand);
+        t[i] = T (rand.nextf ());
+    }
+
+    const QuatArray<T> qa (a), qb (b);
+    QuatArray<T>       qr (n);
+
+    cout << "quaternion arrays in " << precision (T ()) << " precision, " << n
+         << " quaternions" << endl;
+
+    Timer timer;
+    for (size_t i = 0; i < n; ++i)
+        r[i] = slerpShortestArc (a[i], b[i], t[i]);
+    report ("slerpShortestArc", timer.ms ()) << endl;
+
+    timer = Timer ();
+    fastSlerp (qa, qb, t.data (), qr);
+    report ("bulk fastSlerp", timer.ms ()) << endl;
+
+    timer = Timer ();
+    nlerp (qa, qb, t.data (), qr);
+    report ("bulk nlerp", timer.ms ()) << endl;
+
+    std::vector<Matrix44<T>> m (n);
+    Matrix44Array<T>         ma;
+
+    // Touch the outputs first, as for the arrays of structs
+    toMatrix44 (qa, ma);
+    extractQuat (ma, qr);
+
+    timer = Timer ();
+    for (size_t i = 0; i < n; ++i)
+        m[i] = a[i].toMatrix44 ();
+    report ("Quat::toMatrix44", timer.ms ()) << endl;
+
+    timer = Timer ();
+    toMatrix44 (qa, ma);
+    report ("bulk toMatrix44", timer.ms ()) << endl;
+
+    timer = Timer ();
+    for (size_t i = 0; i < n; ++i)
+        r[i] = extractQuat (m[i]);
+    report ("extractQuat", timer.ms ()) << endl;
+
+    timer = Timer ();
+    extractQuat (ma, qr);
+    report ("bulk extractQuat", timer.ms ()) << endl;
+}
+
+void
+quatArrayPerf (bool quick)
+{
+    const size_t n = quick ? 10000 : 1000000;
+    quatArrayPerf<float> (n);
+    quatArrayPerf<double> (n);
+}
+
+struct Benchmark
+{
+    const char* name;
+    void (*run) (bool quick);
+};
+
+const Benchmark benchmarks[] = {
+    {"batchMath", batchMathPerf},
+    {"boxAlgo", boxAlgoPerf},
+    {"bvh", bvhPerf},
+    {"dualQuat", dualQuatPerf},
+    {"extractEuler", extractEulerPerf},
+    {"frustumTest", frustumTestPerf},
+    {"polarDecomposition", polarDecompositionPerf},
+    {"quatArray", quatArrayPerf},
+};
+
+} // namespace
+
+int
+main (int argc, char* argv[])
+{
+    bool                     quick = false;
+    std::vector<const char*> names;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp (argv[i], "--quick"))
+            quick = true;
+        else
+            names.push_back (argv[i]);
+    }
+
+    for (size_t i = 0; i < names.size (); ++i)
+    {
+        bool found = false;
+
+        for (const Benchmark& b: benchmarks)
+            found = found || !strcmp (names[i], b.name);
+
+        if (!found)
+        {
+            cerr << "usage: " << argv[0] << " [--quick] [<benchmark> ...]\n"
+                 << "benchmarks:";
+            for (const Benchmark& b: benchmarks)
+                cerr << ' ' << b.name;
+            cerr << endl;
+            return 1;
+        }
+    }
+
+    for (const Benchmark& b: benchmarks)
+    {
+        bool run = names.empty ();
+
+        for (size_t i = 0; i < names.size (); ++i)
+            run = run || !strcmp (names[i], b.name);
+
+        if (run) b.run (quick);
+    }
+
+    return 0;
+}
@@ -0,0 +1,357 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include "testBatchMath.h"
+#include <ImathBatchMath.h>
+#include <ImathRandom.h>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+//
+// The error of r in ulp, compared with a more precise reference value:
+// the double result for float, and the long double result for double.
+//
+
+template <class T>
+long double
+ulpError (T r, long double ref)
+{
+    if (std::isnan (ref)) return std::isnan (r) ? 0 : 1e10;
+
+    if (std::isinf (ref)) return r == ref ? 0 : 1e10;
+
+    const long double a = std::abs (ref);
+    const int         e = a < std::numeric_limits<T>::min ()
+                              ? std::numeric_limits<T>::min_exponent - 1
+                              : std::ilogb (a);
+
+    return std::abs (r - ref) /
+           std::ldexp (1.0L, e - std::numeric_limits<T>::digits + 1);
+}
+
+template <class T> struct Reference;
+
+template <> struct Reference<float>
+{
+    typedef double Type;
+};
+
+template <> struct Reference<double>
+{
+    typedef long double Type;
+};
+
+const char*
+name (BatchMathAccuracy a)
+{
+    return a == BatchMathPrecise ? "precise" : "fast";
+}
+
+template <class T>
+std::vector<T>
+randomValues (Rand48& rand, size_t n, double low, double high)
+{
+    std::vector<T> x (n);
+
+    for (size_t i = 0; i < n; ++i)
+        x[i] = T (rand.nextf (low, high));
+
+    return x;
+}
+
+//
+// Check the errors of the batched functions at random arguments.
+// Precise results must be within 1 ulp and fast results within 3 ulp
+// of the reference.
+//
+
+template <class T>
+void
+checkError (
+    const char* function, BatchMathAccuracy a, long double maxError)
+{
+    const long double bound = a == BatchMathPrecise ? 1 : 3;
+
+    cout << "    " << function << " " << name (a) << ": " << maxError
+         << " ulp" << endl;
+
+    assert (maxError <= bound);
+}
+
+template <class T>
+void
+testSincos (BatchMathAccuracy a)
+{
+    typedef typename Reference<T>::Type R;
+
+    Rand48         rand (1);
+    std::vector<T> x = randomValues<T> (rand, 100000, -10, 10);
+
+    for (int i = 0; i < 1000; ++i)
+        x.push_back (T (rand.nextf (-1e5, 1e5)));
+
+    for (int i = -8; i <= 8; ++i)
+        x.push_back (T (i * M_PI_2));
+
+    std::vector<T> s (x.size ()), c (x.size ());
+    batchSincos (x.data (), s.data (), c.data (), x.size (), a);
+
+    long double e = 0;
+
+    for (size_t i = 0; i < x.size (); ++i)
+    {
+        e = std::max (e, ulpError (s[i], std::sin (R (x[i]))));
+        e = std::max (e, ulpError (c[i], std::cos (R (x[i]))));
+    }
+
+    checkError<T> ("sincos", a, e);
+
+    // Special values, and arguments beyond the range reduction
+    const T inf    = std::numeric_limits<T>::infinity ();
+    const T xs[6]  = {T (0), -T (0), inf, std::numeric_limits<T>::quiet_NaN (),
+                      T (1e30), T (-3e7)};
+    T       ss[6], cs[6];
+
+    batchSincos (xs, ss, cs, 6, a);
+
+    assert (ss[0] == 0 && !std::signbit (ss[0]) && cs[0] == 1);
+    assert (ss[1] == 0 && std::signbit (ss[1]) && cs[1] == 1);
+    assert (std::isnan (ss[2]) && std::isnan (cs[2]));
+    assert (std::isnan (ss[3]) && std::isnan (cs[3]));
+
+    for (int i = 4; i < 6; ++i)
+        assert (ulpError (ss[i], std::sin (R (xs[i]))) <= 1 &&
+                ulpError (cs[i], std::cos (R (xs[i]))) <= 1);
+}
+
+template <class T>
+void
+testAcos (BatchMathAccuracy a)
+{
+    typedef typename Reference<T>::Type R;
+
+    Rand48         rand (2);
+    std::vector<T> x = randomValues<T> (rand, 100000, -1, 1);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        x.push_back (T (1 - rand.nextf (0, 1e-4)));
+        x.push_back (T (rand.nextf (0, 1e-4) - 1));
+    }
+
+    std::vector<T> r (x.size ());
+    batchAcos (x.data (), r.data (), x.size (), a);
+
+    long double e = 0;
+
+    for (size_t i = 0; i < x.size (); ++i)
+        e = std::max (e, ulpError (r[i], std::acos (R (x[i]))));
+
+    checkError<T> ("acos", a, e);
+
+    const T xs[6] = {T (1), T (-1), T (0), T (0.5), T (2),
+                     std::numeric_limits<T>::quiet_NaN ()};
+    T       rs[6];
+
+    batchAcos (xs, rs, 6, a);
+
+    assert (rs[0] == 0);
+    assert (ulpError (rs[1], std::acos (R (-1))) <= 1);
+    assert (ulpError (rs[2], std::acos (R (0))) <= 1);
+    assert (ulpError (rs[3], std::acos (R (0.5))) <= 1);
+    assert (std::isnan (rs[4]) && std::isnan (rs[5]));
+}
+
+template <class T>
+void
+testAtan2 (BatchMathAccuracy a)
+{
+    typedef typename Reference<T>::Type R;
+
+    Rand48         rand (3);
+    std::vector<T> y = randomValues<T> (rand, 100000, -10, 10);
+    std::vector<T> x = randomValues<T> (rand, 100000, -10, 10);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        y.push_back (T (rand.nextf (-1e-3, 1e-3)));
+        x.push_back (T (rand.nextf (-1e3, 1e3)));
+    }
+
+    std::vector<T> r (x.size ());
+    batchAtan2 (y.data (), x.data (), r.data (), x.size (), a);
+
+    long double e = 0;
+
+    for (size_t i = 0; i < x.size (); ++i)
+        e = std::max (e, ulpError (r[i], std::atan2 (R (y[i]), R (x[i]))));
+
+    checkError<T> ("atan2", a, e);
+
+    // Signed zeros and infinities
+    const T inf    = std::numeric_limits<T>::infinity ();
+    const T z      = T (0);
+    const T ys[10] = {z, -z, z, -z, T (1), -T (1), inf, inf, -inf, T (2)};
+    const T xs[10] = {z, z, -z, -z, z, -inf, inf, -inf, T (3), inf};
+    T       rs[10];
+
+    batchAtan2 (ys, xs, rs, 10, a);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        const R ref = std::atan2 (R (ys[i]), R (xs[i]));
+        assert (ulpError (rs[i], ref) <= 1);
+        assert (std::signbit (rs[i]) == std::signbit (ref));
+    }
+}
+
+template <class T>
+void
+testExp (BatchMathAccuracy a)
+{
+    typedef typename Reference<T>::Type R;
+
+    Rand48         rand (4);
+    const T        high = T (std::log (std::numeric_limits<T>::max ()));
+    std::vector<T> x    = randomValues<T> (rand, 100000, -high, high);
+
+    for (int i = 0; i < 1000; ++i)
+        x.push_back (T (rand.nextf (-1, 1)));
+
+    std::vector<T> r (x.size ());
+    batchExp (x.data (), r.data (), x.size (), a);
+
+    long double e = 0;
+
+    for (size_t i = 0; i < x.size (); ++i)
+        e = std::max (e, ulpError (r[i], std::exp (R (x[i]))));
+
+    checkError<T> ("exp", a, e);
+
+    // Overflow, underflow to denormals and zero, and special values
+    const T inf   = std::numeric_limits<T>::infinity ();
+    const T xs[8] = {T (0), inf, -inf, std::numeric_limits<T>::quiet_NaN (),
+                     T (1e4), T (-1e4), high + 1, -high - 2};
+    T       rs[8];
+
+    batchExp (xs, rs, 8, a);
+
+    assert (rs[0] == 1 && rs[1] == inf && rs[2] == 0 && std::isnan (rs[3]));
+    assert (rs[4] == inf && rs[5] == 0 && rs[6] == inf);
+    assert (rs[7] > 0 && rs[7] < std::numeric_limits<T>::min ());
+}
+
+template <class T>
+void
+testLog (BatchMathAccuracy a)
+{
+    typedef typename Reference<T>::Type R;
+
+    Rand48         rand (5);
+    std::vector<T> x;
+
+    for (int i = 0; i < 100000; ++i)
+        x.push_back (T (std::exp (rand.nextf (-80, 80))));
+
+    for (int i = 0; i < 1000; ++i)
+        x.push_back (T (rand.nextf (0.5, 2)));
+
+    std::vector<T> r (x.size ());
+    batchLog (x.data (), r.data (), x.size (), a);
+
+    long double e = 0;
+
+    for (size_t i = 0; i < x.size (); ++i)
+        e = std::max (e, ulpError (r[i], std::log (R (x[i]))));
+
+    checkError<T> ("log", a, e);
+
+    const T inf   = std::numeric_limits<T>::infinity ();
+    const T den   = std::numeric_limits<T>::denorm_min ();
+    const T xs[8] = {T (1), T (0), -T (1), inf,
+                     std::numeric_limits<T>::quiet_NaN (), den,
+                     std::numeric_limits<T>::max (),
+                     std::numeric_limits<T>::min ()};
+    T       rs[8];
+
+    batchLog (xs, rs, 8, a);
+
+    assert (rs[0] == 0 && rs[1] == -inf && std::isnan (rs[2]));
+    assert (rs[3] == inf && std::isnan (rs[4]));
+
+    for (int i = 5; i < 8; ++i)
+        assert (ulpError (rs[i], std::log (R (xs[i]))) <= 1);
+}
+
+template <class T>
+void
+testInPlace ()
+{
+    // The results may overwrite the arguments, and arrays of any
+    // length are processed
+    Rand48               rand (6);
+    const std::vector<T> x = randomValues<T> (rand, 1000, 0.1, 10);
+
+    for (size_t n = 0; n <= 1000; n += 37)
+    {
+        std::vector<T> a (x.begin (), x.begin () + n), b (n), c (n);
+
+        batchExp (x.data (), b.data (), n);
+        batchExp (a.data (), a.data (), n);
+        assert (a == b);
+
+        std::vector<T> s (x.begin (), x.begin () + n);
+        batchSincos (x.data (), b.data (), c.data (), n);
+        batchSincos (s.data (), a.data (), s.data (), n);
+        assert (a == b && s == c);
+
+        a.assign (x.begin (), x.begin () + n);
+        batchAtan2 (x.data (), x.data () + 1000 - n, b.data (), n);
+        batchAtan2 (a.data (), x.data () + 1000 - n, a.data (), n);
+        assert (a == b);
+    }
+}
+
+template <class T>
+void
+testAccuracy (BatchMathAccuracy a)
+{
+    testSincos<T> (a);
+    testAcos<T> (a);
+    testAtan2<T> (a);
+    testExp<T> (a);
+    testLog<T> (a);
+}
+
+} // namespace
+
+void
+testBatchMath ()
+{
+    cout << "Testing batched math functions in single precision" << endl;
+    testAccuracy<float> (BatchMathPrecise);
+    testAccuracy<float> (BatchMathFast);
+    testInPlace<float> ();
+
+    cout << "Testing batched math functions in double precision" << endl;
+    testAccuracy<double> (BatchMathPrecise);
+    testAccuracy<double> (BatchMathFast);
+    testInPlace<double> ();
+
+    cout << "ok\n" << endl;
+}
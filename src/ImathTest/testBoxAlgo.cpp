@@ -8,11 +8,17 @@
 #endif
 
 #include "testBoxAlgo.h"
+#include "testUtil.h"
 #include <ImathBoxAlgo.h>
+#include <ImathBoxBatch.h>
 #include <ImathRandom.h>
 #include <algorithm>
 #include <assert.h>
+#include <bitset>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <vector>
 
 using namespace std;
 using namespace IMATH_INTERNAL_NAMESPACE;
@@ -706,6 +712,7 @@ testPerturbedRayBox (const Box3f& box, const Line3f& ray, bool result)
 
         V3f ip;
         assert (result == intersects (box, ray1, ip));
+        assert (result == intersects (box, InverseRayf (ray1)));
     }
 }
 
@@ -917,6 +924,271 @@ pointInAndOnBox ()
     assert (closestPointInBox (V3f (3, 3, 4.5), box) == V3f (3, 3, 4.5));
 }
 
+//
+// Check the packet versions of the slab test against the scalar one,
+// ray by ray and box by box. They perform the same operations, so the
+// distances must be equal.
+//
+
+template <class T>
+void
+checkRayPacket (
+    const Box<Vec3<T>>& box, const std::vector<Line3<T>>& rays)
+{
+    const size_t n = rays.size ();
+
+    Vec3Array<T> pos (n), invDir (n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        const InverseRay<T> r (rays[i]);
+        pos.set (i, r.pos);
+        invDir.set (i, r.invDir);
+    }
+
+    std::vector<uint64_t> hits ((n + 63) / 64, ~uint64_t (0));
+    std::vector<uint64_t> hitsOnly ((n + 63) / 64, ~uint64_t (0));
+    std::vector<T>        t (n);
+
+    intersects (box, pos, invDir, hits.data (), t.data ());
+    intersects (box, pos, invDir, hitsOnly.data ());
+    assert (hits == hitsOnly);
+
+    for (size_t i = 0; i < hits.size () * 64; ++i)
+    {
+        T          s;
+        const bool b   = i < n && intersects (box, InverseRay<T> (rays[i]), s);
+        const bool hit = (hits[i / 64] >> (i % 64)) & 1;
+
+        assert (hit == b);
+        if (b) assert (t[i] == s);
+    }
+}
+
+template <class T>
+void
+checkBoxPacket (
+    const std::vector<Box<Vec3<T>>>& boxes, const Line3<T>& ray)
+{
+    const size_t        n = boxes.size ();
+    const InverseRay<T> r (ray);
+
+    Vec3Array<T> min (n), max (n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        min.set (i, boxes[i].min);
+        max.set (i, boxes[i].max);
+    }
+
+    std::vector<uint64_t> hits ((n + 63) / 64, ~uint64_t (0));
+    std::vector<uint64_t> hitsOnly ((n + 63) / 64, ~uint64_t (0));
+    std::vector<T>        t (n);
+
+    intersects (min, max, r, hits.data (), t.data ());
+    intersects (min, max, r, hitsOnly.data ());
+    assert (hits == hitsOnly);
+
+    for (size_t i = 0; i < hits.size () * 64; ++i)
+    {
+        T          s;
+        const bool b   = i < n && intersects (boxes[i], r, s);
+        const bool hit = (hits[i / 64] >> (i % 64)) & 1;
+
+        assert (hit == b);
+        if (b) assert (t[i] == s);
+    }
+}
+
+//
+// Rays from a grid of points on and off the planes of the sides of a
+// box, in directions whose components are 0, -0 or powers of two, so
+// that they and their inverses are exact. Many of the rays lie in the
+// planes of the sides, or run along the edges. The slab test must
+// agree exactly with intersects().
+//
+
+template <class T>
+void
+slabRaysOnSides ()
+{
+    cout << "    rays on the sides of a box" << endl;
+
+    const Box<Vec3<T>> box (Vec3<T> (1, 2, 3), Vec3<T> (5, 4, 6));
+
+    const T coords[] = {-1, 1, 1.5, 2, 3, 4, 5, 5.5, 6, 8};
+    const T dirs[]   = {-2, -1, -0.5, T (-0.0), 0, 0.5, 1, 2};
+
+    std::vector<Line3<T>> rays;
+
+    for (T x: coords)
+        for (T y: coords)
+            for (T z: coords)
+                for (T dx: dirs)
+                    for (T dy: dirs)
+                        for (T dz: dirs)
+                        {
+                            Line3<T> ray;
+                            ray.pos = Vec3<T> (x, y, z);
+                            ray.dir = Vec3<T> (dx, dy, dz);
+                            rays.push_back (ray);
+                        }
+
+    size_t hits = 0;
+
+    for (size_t i = 0; i < rays.size (); ++i)
+    {
+        const Line3<T>& ray = rays[i];
+
+        Vec3<T>    ip;
+        T          t;
+        const bool expected = intersects (box, ray, ip);
+        const bool b        = intersects (box, InverseRay<T> (ray), t);
+
+        assert (b == expected);
+        assert (b == intersects (box, InverseRay<T> (ray)));
+        assert (!intersects (Box<Vec3<T>> (), InverseRay<T> (ray)));
+
+        if (b)
+        {
+            assert (ray.pos + t * ray.dir == ip);
+            ++hits;
+        }
+    }
+
+    assert (hits > 0 && hits < rays.size ());
+
+    checkRayPacket (box, rays);
+
+    //
+    // Boxes of all sizes, some of them flat or empty, with their sides
+    // on the same grid
+    //
+
+    std::vector<Box<Vec3<T>>> boxes;
+
+    for (T x: coords)
+        for (T y: coords)
+            for (T z: coords)
+            {
+                const Vec3<T> p (x, y, z);
+                boxes.push_back (Box<Vec3<T>> (p, box.max));
+                boxes.push_back (Box<Vec3<T>> (box.min, p));
+            }
+
+    boxes.push_back (Box<Vec3<T>> ());
+
+    for (size_t i = 0; i < rays.size (); i += 97)
+    {
+        for (size_t k = 0; k < boxes.size (); ++k)
+        {
+            Vec3<T> ip;
+            T       t;
+            assert (
+                intersects (boxes[k], InverseRay<T> (rays[i]), t) ==
+                intersects (boxes[k], rays[i], ip));
+        }
+
+        checkBoxPacket (boxes, rays[i]);
+    }
+}
+
+//
+// Random boxes and rays, some of them parallel to the sides of the
+// boxes. Multiplying by the inverse of the direction rounds differently
+// than dividing by the direction, so the results may differ only for
+// rays that pass within rounding distance of an edge: those that hit a
+// slightly smaller box, and miss a slightly larger one, must agree.
+//
+
+template <class T>
+void
+slabRandomRays ()
+{
+    cout << "    random rays" << endl;
+
+    Rand48  rand (31);
+    const T e      = 20000 * std::numeric_limits<T>::epsilon ();
+    size_t  misses = 0, hits = 0;
+
+    for (int i = 0; i < 100000; ++i)
+    {
+        const Vec3<T> c = randomPoint (rand, T (10));
+
+        const Vec3<T> r (
+            T (rand.nextf (0.01, 5)),
+            T (rand.nextf (0.01, 5)),
+            T (rand.nextf (0.01, 5)));
+
+        const Box<Vec3<T>> box (c - r, c + r);
+        const Vec3<T>      g (e, e, e);
+        const Box<Vec3<T>> inner (box.min + g, box.max - g);
+        const Box<Vec3<T>> outer (box.min - g, box.max + g);
+
+        Line3<T> ray;
+        ray.pos = randomPoint (rand, T (20));
+        ray.dir = randomPoint (rand, T (1));
+
+        for (int k = 0; k < 3; ++k)
+            if (rand.nextf () < 0.2) ray.dir[k] = 0;
+
+        Vec3<T>    ip;
+        T          t;
+        const bool expected = intersects (box, ray, ip);
+        const bool b        = intersects (box, InverseRay<T> (ray), t);
+        const bool hitInner = intersects (inner, ray);
+
+        if (hitInner == intersects (outer, ray))
+        {
+            assert (b == hitInner && expected == hitInner);
+            hits += b;
+            misses += !b;
+        }
+
+        if (b && expected)
+        {
+            const Vec3<T> p = ray.pos + t * ray.dir;
+            for (int k = 0; k < 3; ++k)
+                assert (std::abs (p[k] - ip[k]) <= e);
+        }
+    }
+
+    assert (hits > 1000 && misses > 1000);
+
+    //
+    // The packet versions
+    //
+
+    std::vector<Line3<T>>     rays (1001);
+    std::vector<Box<Vec3<T>>> boxes (1001);
+
+    for (size_t i = 0; i < rays.size (); ++i)
+    {
+        const Vec3<T> c = randomPoint (rand, T (10));
+
+        boxes[i] = Box<Vec3<T>> (c);
+        boxes[i].extendBy (c + randomPoint (rand, T (5)));
+
+        rays[i].pos = randomPoint (rand, T (20));
+        rays[i].dir = c - rays[i].pos + randomPoint (rand, T (5));
+
+        if (i % 7 == 0) rays[i].dir.y = 0;
+        if (i % 11 == 0) boxes[i].makeEmpty ();
+    }
+
+    for (size_t i = 0; i < 20; ++i)
+    {
+        checkRayPacket (boxes[i], rays);
+        checkBoxPacket (boxes, rays[i]);
+    }
+}
+
+template <class T>
+void
+slabRayBox ()
+{
+    slabRaysOnSides<T> ();
+    slabRandomRays<T> ();
+}
+
 } // namespace
 
 void
@@ -931,5 +1203,10 @@ testBoxAlgo ()
     boxMatrixTransform ();
     pointInAndOnBox ();
 
+    cout << "  ray-box slab test, float" << endl;
+    slabRayBox<float> ();
+    cout << "  ray-box slab test, double" << endl;
+    slabRayBox<double> ();
+
     cout << "ok\n" << endl;
 }
@@ -0,0 +1,318 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include "testBvh.h"
+#include "testUtil.h"
+#include <ImathBoxAlgo.h>
+#include <ImathBvh.h>
+#include <ImathRandom.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+//
+// Boxes of sizes from 0.01 to 10, in clusters, a few of them empty or
+// flat, and some repeated.
+//
+
+template <class T>
+std::vector<Box<Vec3<T>>>
+randomBoxes (Rand48& rand, size_t n)
+{
+    std::vector<Box<Vec3<T>>> boxes (n);
+    Vec3<T>                   cluster (0);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (i % 100 == 0) cluster = randomPoint<T> (rand, 100);
+
+        const T       size = T (std::pow (10.0, rand.nextf (-2, 1)));
+        const Vec3<T> c    = cluster + randomPoint<T> (rand, 20);
+        const Vec3<T> e (
+            T (size * rand.nextf ()),
+            T (size * rand.nextf ()),
+            T (i % 37 == 0 ? 0 : size * rand.nextf ()));
+
+        boxes[i] = Box<Vec3<T>> (c - e, c + e);
+
+        if (i % 101 == 0) boxes[i].makeEmpty ();
+        if (i % 53 == 0 && i > 0) boxes[i] = boxes[i - 1];
+    }
+
+    return boxes;
+}
+
+//
+// Check the structure of the hierarchy: the bounds of each node are
+// those of its children or boxes, and every non-empty box is in one
+// leaf.
+//
+
+template <class T>
+void
+checkStructure (
+    const Bvh<T>& bvh, const std::vector<Box<Vec3<T>>>& boxes, int maxLeafSize)
+{
+    typedef typename Bvh<T>::Node Node;
+
+    const std::vector<Node>& nodes = bvh.nodes ();
+    std::vector<int>         seen (boxes.size (), 0);
+    std::vector<int>         parents (nodes.size (), 0);
+    size_t                   numBoxes = 0;
+
+    for (size_t i = 0; i < boxes.size (); ++i)
+        numBoxes += !boxes[i].isEmpty ();
+
+    assert (bvh.boxes ().size () == numBoxes);
+    assert (bvh.indices ().size () == numBoxes);
+    assert (nodes.empty () == (numBoxes == 0));
+
+    for (size_t i = 0; i < nodes.size (); ++i)
+    {
+        const Node&  node = nodes[i];
+        Box<Vec3<T>> b;
+
+        if (node.isLeaf ())
+        {
+            assert (node.offset + node.count <= numBoxes);
+
+            for (uint32_t j = node.offset; j < node.offset + node.count; ++j)
+            {
+                const uint32_t k = bvh.indices ()[j];
+                assert (bvh.boxes ()[j] == boxes[k]);
+                ++seen[k];
+                b.extendBy (boxes[k]);
+            }
+
+            // Larger leaves only for boxes with the same center
+            if (node.count > uint32_t (maxLeafSize))
+                for (uint32_t j = node.offset; j < node.offset + node.count;
+                     ++j)
+                    assert (
+                        bvh.boxes ()[j].center () ==
+                        bvh.boxes ()[node.offset].center ());
+        }
+        else
+        {
+            assert (node.offset > i && node.offset + 1 < nodes.size ());
+            ++parents[node.offset];
+            ++parents[node.offset + 1];
+            b.extendBy (nodes[node.offset].bounds);
+            b.extendBy (nodes[node.offset + 1].bounds);
+        }
+
+        assert (b == node.bounds);
+    }
+
+    for (size_t i = 0; i < nodes.size (); ++i)
+        assert (parents[i] == (i == 0 ? 0 : 1));
+
+    for (size_t i = 0; i < boxes.size (); ++i)
+        assert (seen[i] == (boxes[i].isEmpty () ? 0 : 1));
+}
+
+template <class T>
+bool
+sameHierarchy (const Bvh<T>& a, const Bvh<T>& b)
+{
+    if (a.nodes ().size () != b.nodes ().size () ||
+        a.indices () != b.indices ())
+        return false;
+
+    for (size_t i = 0; i < a.nodes ().size (); ++i)
+    {
+        const typename Bvh<T>::Node& p = a.nodes ()[i];
+        const typename Bvh<T>::Node& q = b.nodes ()[i];
+
+        if (p.bounds != q.bounds || p.offset != q.offset || p.count != q.count)
+            return false;
+    }
+
+    return true;
+}
+
+template <class T>
+void
+testBuild ()
+{
+    Rand48 rand (3);
+
+    // No boxes, only empty boxes, one box
+    std::vector<Box<Vec3<T>>> boxes (3);
+
+    Bvh<T> empty;
+    assert (empty.nodes ().empty () && empty.bounds ().isEmpty ());
+
+    Bvh<T> onlyEmpty (boxes.data (), boxes.size ());
+    assert (onlyEmpty.nodes ().empty ());
+
+    boxes[1] = Box<Vec3<T>> (Vec3<T> (1, 2, 3), Vec3<T> (4, 5, 6));
+
+    Bvh<T> one (boxes.data (), boxes.size ());
+    checkStructure (one, boxes, 4);
+    assert (one.nodes ().size () == 1 && one.bounds () == boxes[1]);
+
+    // Many boxes with the same center
+    boxes.assign (100, boxes[1]);
+
+    for (int maxLeafSize = 1; maxLeafSize <= 8; maxLeafSize *= 2)
+    {
+        Bvh<T> same (boxes.data (), boxes.size (), maxLeafSize);
+        checkStructure (same, boxes, 100);
+
+        for (size_t i = 0; i < same.nodes ().size (); ++i)
+            assert (same.nodes ()[i].count <= uint32_t (maxLeafSize));
+    }
+
+    // More boxes than the 32-bit nodes and indices can hold; the boxes
+    // are not read
+    bool thrown = false;
+    try
+    {
+        Bvh<T> tooMany (boxes.data (), (size_t (1) << 31) + 1);
+    }
+    catch (const std::length_error&)
+    {
+        thrown = true;
+    }
+    assert (thrown);
+
+    // Random boxes, on one and several threads
+    for (size_t n : {2, 10, 1000, 100000})
+    {
+        boxes = randomBoxes<T> (rand, n);
+
+        for (int maxLeafSize = 1; maxLeafSize <= 8; maxLeafSize *= 2)
+        {
+            Bvh<T> bvh (boxes.data (), n, maxLeafSize);
+            checkStructure (bvh, boxes, maxLeafSize);
+
+            Bvh<T> parallel (boxes.data (), n, ParallelBuild (4), maxLeafSize);
+            assert (sameHierarchy (bvh, parallel));
+        }
+    }
+}
+
+template <class T>
+void
+testQueries ()
+{
+    Rand48                          rand (5);
+    const std::vector<Box<Vec3<T>>> boxes = randomBoxes<T> (rand, 20000);
+    const Bvh<T>                    bvh (boxes.data (), boxes.size ());
+
+    for (int i = 0; i < 200; ++i)
+    {
+        // Boxes that overlap a box
+        const Vec3<T> c = randomPoint<T> (rand, 120);
+        Box<Vec3<T>>  box (c);
+        box.extendBy (c + randomPoint<T> (rand, 20));
+
+        std::vector<size_t> expected, found;
+
+        for (size_t k = 0; k < boxes.size (); ++k)
+            if (boxes[k].intersects (box)) expected.push_back (k);
+
+        assert (bvh.findOverlapping (box, found) == found.size ());
+        std::sort (found.begin (), found.end ());
+        assert (found == expected);
+
+        // Boxes that a ray hits, from inside or outside the boxes
+        const Line3<T> ray (
+            randomPoint<T> (rand, 150), randomPoint<T> (rand, 100));
+
+        expected.clear ();
+        found.clear ();
+
+        size_t  first = 0;
+        Vec3<T> firstPoint (0);
+        T       firstT = std::numeric_limits<T>::max ();
+
+        for (size_t k = 0; k < boxes.size (); ++k)
+        {
+            Vec3<T> ip;
+            if (!intersects (boxes[k], ray, ip)) continue;
+
+            expected.push_back (k);
+
+            const T t = (ip - ray.pos) ^ ray.dir;
+            if (t < firstT)
+            {
+                first      = k;
+                firstPoint = ip;
+                firstT     = t;
+            }
+        }
+
+        bvh.findIntersecting (ray, [&found] (size_t k) {
+            found.push_back (k);
+        });
+        std::sort (found.begin (), found.end ());
+        assert (found == expected);
+
+        size_t  index;
+        Vec3<T> point;
+
+        if (expected.empty ())
+            assert (!bvh.closestIntersection (ray, index, point));
+        else
+        {
+            assert (bvh.closestIntersection (ray, index, point));
+
+            // The first box hit, or one hit at the same distance
+            assert (((point - ray.pos) ^ ray.dir) == firstT);
+            assert (index == first || point == firstPoint);
+        }
+
+        // The box closest to a point
+        const Vec3<T> p = randomPoint<T> (rand, 150);
+
+        T best = std::numeric_limits<T>::max ();
+        for (size_t k = 0; k < boxes.size (); ++k)
+            if (!boxes[k].isEmpty ())
+                best = std::min (
+                    best, (closestPointInBox (p, boxes[k]) - p).length2 ());
+
+        assert (bvh.closestPoint (p, index, point));
+        assert ((point - p).length2 () == best);
+        assert (point == closestPointInBox (p, boxes[index]));
+    }
+
+    // A point inside a box is its own closest point
+    size_t  index;
+    Vec3<T> point;
+    assert (bvh.closestPoint (boxes[1].center (), index, point));
+    assert (point == boxes[1].center ());
+}
+
+} // namespace
+
+void
+testBvh ()
+{
+    cout << "Testing Bvh in single precision" << endl;
+    testBuild<float> ();
+    testQueries<float> ();
+
+    cout << "Testing Bvh in double precision" << endl;
+    testBuild<double> ();
+    testQueries<double> ();
+
+    cout << "ok\n" << endl;
+}
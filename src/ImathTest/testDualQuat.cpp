@@ -0,0 +1,350 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include "testDualQuat.h"
+#include "testUtil.h"
+#include <ImathDualQuat.h>
+#include <ImathRandom.h>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+template <class T>
+DualQuat<T>
+randomTransform (Rand48& rand)
+{
+    return DualQuat<T> (randomRotation<T> (rand), randomPoint<T> (rand, 10));
+}
+
+template <class T>
+bool
+equalWithAbsError (const Vec3<T>& a, const Vec3<T>& b, T e)
+{
+    return a.equalWithAbsError (b, e);
+}
+
+template <class T>
+bool
+equalWithAbsError (const DualQuat<T>& a, const DualQuat<T>& b, T e)
+{
+    for (int i = 0; i < 4; ++i)
+        if (std::abs (a.r[i] - b.r[i]) > e || std::abs (a.d[i] - b.d[i]) > e)
+            return false;
+
+    return true;
+}
+
+template <class T>
+void
+testConstruction ()
+{
+    const T eps = 64 * std::numeric_limits<T>::epsilon ();
+
+    // Identity
+    const DualQuat<T> id;
+    assert (id == DualQuat<T>::identity ());
+    assert (id.r == Quat<T> () && id.d == Quat<T> (0, 0, 0, 0));
+    assert (id.toMatrix44 () == Matrix44<T> ());
+    assert (Vec3<T> (1, 2, 3) * id == Vec3<T> (1, 2, 3));
+
+    Rand48 rand (3);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        const Quat<T> q = randomRotation<T> (rand);
+        const Vec3<T> t = randomPoint<T> (rand, 10);
+        const Vec3<T> p = randomPoint<T> (rand, 10);
+
+        // Rotation and translation
+        const DualQuat<T> a (q, t);
+        assert (a.rotation () == q);
+        assert (equalWithAbsError (a.translation (), t, eps));
+        assert (std::abs (a.r ^ a.d) < eps);
+
+        // Matrix conversion
+        Matrix44<T> m = q.toMatrix44 ();
+        m[3][0]       = t.x;
+        m[3][1]       = t.y;
+        m[3][2]       = t.z;
+
+        assert (a.toMatrix44 ().equalWithAbsError (m, eps));
+        assert (equalWithAbsError (p * a, p * m, eps));
+
+        const DualQuat<T> b (m);
+        assert (
+            equalWithAbsError (b, a, eps) || equalWithAbsError (b, -a, eps));
+
+        // Conversion between base types
+        const DualQuat<double> c (a);
+        assert (DualQuat<T> (c) == a);
+    }
+}
+
+template <class T>
+void
+testAlgebra ()
+{
+    const T eps = 256 * std::numeric_limits<T>::epsilon ();
+    Rand48  rand (5);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        const DualQuat<T> a = randomTransform<T> (rand);
+        const DualQuat<T> b = randomTransform<T> (rand);
+        const Vec3<T>     p = randomPoint<T> (rand, 10);
+
+        // a * b applies b, then a
+        const DualQuat<T> ab = a * b;
+        assert (equalWithAbsError (p * ab, (p * b) * a, eps));
+        assert (ab.toMatrix44 ().equalWithAbsError (
+            b.toMatrix44 () * a.toMatrix44 (), eps));
+
+        DualQuat<T> c = a;
+        c *= b;
+        assert (c == ab);
+
+        // The product of unit dual quaternions is a unit dual quaternion
+        assert (std::abs (ab.r.length () - 1) < eps);
+        assert (std::abs (ab.r ^ ab.d) < eps);
+
+        // Inverse
+        const DualQuat<T> ai = a.inverse ();
+        assert (equalWithAbsError (a * ai, DualQuat<T> (), eps));
+        assert (equalWithAbsError (ai * a, DualQuat<T> (), eps));
+        assert (equalWithAbsError ((p * a) * ai, p, eps));
+
+        c = a;
+        c.invert ();
+        assert (equalWithAbsError (c, ai, eps));
+
+        // The inverse of a non-unit dual quaternion
+        const DualQuat<T> s  = a * T (2);
+        const DualQuat<T> si = s.inverse ();
+        assert (equalWithAbsError (s * si, DualQuat<T> (), eps));
+
+        // Normalization: scaling, and a dual part not orthogonal to the
+        // real part, leave the transform unchanged
+        const DualQuat<T> n = DualQuat<T> (a.r, a.d + a.r * T (0.25)) * T (3);
+        const DualQuat<T> u = n.normalized ();
+        assert (equalWithAbsError (u, a, eps));
+
+        c = n;
+        c.normalize ();
+        assert (c == u);
+
+        // Sums, differences and scalar products
+        assert ((a + b).r == a.r + b.r && (a + b).d == a.d + b.d);
+        assert ((a - b).r == a.r - b.r && (a - b).d == a.d - b.d);
+        assert (-(-a) == a);
+        assert (T (2) * a == a * T (2));
+
+        c = a;
+        c += b;
+        c -= a;
+        c *= T (4);
+        c /= T (2);
+        assert (equalWithAbsError (c, b * T (2), eps));
+        assert (c != b);
+    }
+
+    // A zero real part normalizes to the identity
+    DualQuat<T> z (Quat<T> (0, 0, 0, 0), Quat<T> (1, 2, 3, 4));
+    assert (z.normalize () == DualQuat<T> ());
+}
+
+//
+// The reference for dualQuatSkinning(): blend the dual quaternions of a
+// point in the hemisphere of its first bone, normalize, and transform.
+//
+
+template <class T>
+Vec3<T>
+skinPoint (
+    const std::vector<DualQuat<T>>& bones,
+    const int*                      index,
+    const T*                        weight,
+    int                             influences,
+    const Vec3<T>&                  p)
+{
+    DualQuat<T> b (Quat<T> (0, 0, 0, 0), Quat<T> (0, 0, 0, 0));
+
+    for (int j = 0; j < influences; ++j)
+    {
+        const DualQuat<T>& q = bones[index[j]];
+        b += q * ((q.r ^ bones[index[0]].r) < 0 ? -weight[j] : weight[j]);
+    }
+
+    const T l = b.r.length ();
+    if (l == 0) return p;
+
+    b /= l;
+    return b.transformPoint (p);
+}
+
+template <class T>
+void
+randomInfluences (
+    Rand48&           rand,
+    size_t            n,
+    int               influences,
+    int               numBones,
+    std::vector<int>& index,
+    std::vector<T>&   weight)
+{
+    index.resize (n * influences);
+    weight.resize (n * influences);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        T sum = 0;
+
+        for (int j = 0; j < influences; ++j)
+        {
+            index[i * influences + j]  = rand.nexti () % numBones;
+            weight[i * influences + j] = T (rand.nextf ());
+            sum += weight[i * influences + j];
+        }
+
+        for (int j = 0; j < influences; ++j)
+            weight[i * influences + j] /= sum;
+    }
+}
+
+template <class T>
+void
+testSkinning ()
+{
+    const T eps = 256 * std::numeric_limits<T>::epsilon ();
+    Rand48  rand (7);
+
+    const int                numBones = 50;
+    std::vector<DualQuat<T>> bones (numBones);
+
+    for (int b = 0; b < numBones; ++b)
+    {
+        // Give the bones random signs, which must not matter
+        bones[b] = randomTransform<T> (rand);
+        if (b % 3 == 0) bones[b] = -bones[b];
+    }
+
+    for (int influences = 1; influences <= 8; ++influences)
+    {
+        const size_t     n = 1000 + influences;
+        std::vector<int> index;
+        std::vector<T>   weight;
+
+        randomInfluences (rand, n, influences, numBones, index, weight);
+
+        std::vector<Vec3<T>> p (n);
+        for (size_t i = 0; i < n; ++i)
+            p[i] = randomPoint<T> (rand, 10);
+
+        // Points with a zero weight sum stay in place
+        for (int j = 0; j < influences; ++j)
+            weight[17 * influences + j] = 0;
+
+        const Vec3Array<T> points (p);
+        Vec3Array<T>       result;
+
+        dualQuatSkinning (
+            bones.data (),
+            index.data (),
+            weight.data (),
+            influences,
+            points,
+            result);
+
+        assert (result.size () == n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            const Vec3<T> e = skinPoint (
+                bones,
+                &index[i * influences],
+                &weight[i * influences],
+                influences,
+                p[i]);
+
+            assert (equalWithAbsError (result[i], e, eps));
+        }
+
+        assert (result[17] == p[17]);
+
+        if (influences == 1)
+        {
+            // A single bone is a rigid transform
+            for (size_t i = 0; i < n; ++i)
+                if (i != 17)
+                    assert (equalWithAbsError (
+                        result[i], p[i] * bones[index[i]].toMatrix44 (), eps));
+        }
+
+        // In place, and on several threads
+        Vec3Array<T> r1 (points), r2;
+
+        dualQuatSkinning (
+            bones.data (),
+            index.data (),
+            weight.data (),
+            influences,
+            r1,
+            r1);
+
+        dualQuatSkinning (
+            bones.data (),
+            index.data (),
+            weight.data (),
+            influences,
+            points,
+            r2,
+            ParallelBuild (4));
+
+        for (size_t i = 0; i < n; ++i)
+            assert (r1[i] == result[i] && r2[i] == result[i]);
+    }
+
+    // Blending the same transform with opposite signs gives that
+    // transform
+    std::vector<DualQuat<T>> pair (2, randomTransform<T> (rand));
+    pair[1]                 = -pair[1];
+    const int          k[2] = {0, 1};
+    const T            w[2] = {T (0.5), T (0.5)};
+    const Vec3<T>      p (1, 2, 3);
+    const Vec3Array<T> one (&p, 1);
+    Vec3Array<T>       r;
+
+    dualQuatSkinning (pair.data (), k, w, 2, one, r);
+    assert (equalWithAbsError (r[0], p * pair[0], eps));
+}
+
+} // namespace
+
+void
+testDualQuat ()
+{
+    cout << "Testing DualQuat in single precision" << endl;
+    testConstruction<float> ();
+    testAlgebra<float> ();
+    testSkinning<float> ();
+
+    cout << "Testing DualQuat in double precision" << endl;
+    testConstruction<double> ();
+    testAlgebra<double> ();
+    testSkinning<double> ();
+
+    cout << "ok\n" << endl;
+}
@@ -11,9 +11,13 @@
 #include <ImathEuler.h>
 #include <ImathFun.h>
 #include <ImathMatrixAlgo.h>
+#include <ImathMatrixBatch.h>
 #include <ImathRandom.h>
 #include <assert.h>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <vector>
 
 using namespace std;
 using namespace IMATH_INTERNAL_NAMESPACE;
@@ -200,6 +204,156 @@ testRandomAngles33 ()
     }
 }
 
+//
+// Batched conversions with the order as a template argument, compared
+// with Euler<T>::toMatrix44() and Euler<T>::extract().
+//
+
+template <class T>
+bool
+sameRotation (const Matrix44<T>& a, const Matrix44<T>& b, T e)
+{
+    for (int j = 0; j < 3; ++j)
+        for (int k = 0; k < 3; ++k)
+            if (std::abs (a[j][k] - b[j][k]) > e) return false;
+
+    return true;
+}
+
+template <class T>
+Vec3Array<T>
+batchAngles (Rand48& r)
+{
+    std::vector<Vec3<T>> a;
+
+    for (int i = 0; i < 1000; ++i)
+        a.push_back (Vec3<T> (
+            T (r.nextf (-M_PI, M_PI)),
+            T (r.nextf (-M_PI, M_PI)),
+            T (r.nextf (-M_PI, M_PI))));
+
+    // Several revolutions, and angles beyond the range of the
+    // polynomial approximations
+    for (int i = 0; i < 100; ++i)
+        a.push_back (Vec3<T> (
+            T (r.nextf (-100, 100)),
+            T (r.nextf (-1e4, 1e4)),
+            T (r.nextf (-1e7, 1e7))));
+
+    // Multiples of 90 degrees, where the matrices have exact zeros
+    for (int i = -4; i <= 4; ++i)
+        for (int j = -4; j <= 4; ++j)
+            for (int k = -4; k <= 4; ++k)
+                a.push_back (
+                    Vec3<T> (T (i * M_PI_2), T (j * M_PI_2), T (k * M_PI_2)));
+
+    return Vec3Array<T> (a);
+}
+
+template <int Order, class T>
+void
+testBatchOrder (const Vec3Array<T>& angles)
+{
+    const T      eps   = 8 * std::numeric_limits<T>::epsilon ();
+    const size_t n     = angles.size ();
+    const auto   order = typename Euler<T>::Order (Order);
+
+    Matrix44Array<T>         m;
+    std::vector<Matrix44<T>> m44 (n);
+    std::vector<Matrix33<T>> m33 (n);
+
+    eulerToMatrix44<Order> (angles, m);
+    eulerToMatrix44<Order> (angles, m44.data ());
+    eulerToMatrix33<Order> (angles, m33.data ());
+
+    assert (m.size () == n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const Euler<T> e (angles[i], order);
+
+        assert (sameRotation (m[i], e.toMatrix44 (), eps));
+        assert (m44[i] == m[i]);
+
+        for (int j = 0; j < 3; ++j)
+        {
+            assert (m[i][j][3] == 0 && m[i][3][j] == 0);
+
+            for (int k = 0; k < 3; ++k)
+                assert (m33[i][j][k] == m[i][j][k]);
+        }
+
+        assert (m[i][3][3] == 1);
+    }
+
+    Vec3Array<T> a, a44, a33;
+
+    extractEuler<Order> (m, a);
+    extractEuler<Order> (m44.data (), n, a44);
+    extractEuler<Order> (m33.data (), n, a33);
+
+    assert (a.size () == n && a44.size () == n && a33.size () == n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        assert (a44[i] == a[i] && a33[i] == a[i]);
+
+        // The extracted angles reproduce the matrix, and agree with
+        // Euler::extract() away from gimbal lock
+        Euler<T> e (order);
+        e.extract (m[i]);
+
+        const Euler<T> f (a[i], order);
+        assert (sameRotation (f.toMatrix44 (), m[i], 4 * eps));
+
+        if (i < 1000 && std::abs (std::abs (e.y) - T (M_PI_2)) > T (0.01) &&
+            std::abs (e.y) > T (0.01))
+            assert (a[i].equalWithAbsError (e, 64 * eps));
+    }
+
+    // Empty arrays
+    const Vec3Array<T> none;
+    eulerToMatrix44<Order> (none, m);
+    extractEuler<Order> (m, a);
+    assert (m.empty () && a.empty ());
+}
+
+template <class T>
+void
+testBatch ()
+{
+    Rand48             r (17);
+    const Vec3Array<T> angles = batchAngles<T> (r);
+
+    testBatchOrder<Euler<T>::XYZ> (angles);
+    testBatchOrder<Euler<T>::XZY> (angles);
+    testBatchOrder<Euler<T>::YZX> (angles);
+    testBatchOrder<Euler<T>::YXZ> (angles);
+    testBatchOrder<Euler<T>::ZXY> (angles);
+    testBatchOrder<Euler<T>::ZYX> (angles);
+
+    testBatchOrder<Euler<T>::XZX> (angles);
+    testBatchOrder<Euler<T>::XYX> (angles);
+    testBatchOrder<Euler<T>::YXY> (angles);
+    testBatchOrder<Euler<T>::YZY> (angles);
+    testBatchOrder<Euler<T>::ZYZ> (angles);
+    testBatchOrder<Euler<T>::ZXZ> (angles);
+
+    testBatchOrder<Euler<T>::XYZr> (angles);
+    testBatchOrder<Euler<T>::XZYr> (angles);
+    testBatchOrder<Euler<T>::YZXr> (angles);
+    testBatchOrder<Euler<T>::YXZr> (angles);
+    testBatchOrder<Euler<T>::ZXYr> (angles);
+    testBatchOrder<Euler<T>::ZYXr> (angles);
+
+    testBatchOrder<Euler<T>::XZXr> (angles);
+    testBatchOrder<Euler<T>::XYXr> (angles);
+    testBatchOrder<Euler<T>::YXYr> (angles);
+    testBatchOrder<Euler<T>::YZYr> (angles);
+    testBatchOrder<Euler<T>::ZYZr> (angles);
+    testBatchOrder<Euler<T>::ZXZr> (angles);
+}
+
 } // namespace
 
 void
@@ -245,5 +399,9 @@ testExtractEuler ()
     test (matrixEulerMatrix_2, Eulerf::ZYZr);
     test (matrixEulerMatrix_2, Eulerf::ZXZr);
 
+    cout << "Testing batched Euler angle conversion" << endl;
+    testBatch<float> ();
+    testBatch<double> ();
+
     cout << "ok\n" << endl;
 }
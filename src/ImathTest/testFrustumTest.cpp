@@ -11,15 +11,556 @@
 #include <ImathBox.h>
 #include <ImathFrustum.h>
 #include <ImathFrustumTest.h>
+#include <ImathPlane.h>
+#include <ImathRandom.h>
 #include <ImathSphere.h>
+#include <algorithm>
 #include <assert.h>
+#include <cmath>
 #include <iostream>
+#include <type_traits>
+#include <vector>
 
 // Include ImathForward *after* other headers to validate forward declarations
 #include <ImathForward.h>
 
 using namespace std;
 
+namespace
+{
+
+template <class T>
+using Box3 = IMATH_INTERNAL_NAMESPACE::Box<IMATH_INTERNAL_NAMESPACE::Vec3<T>>;
+
+//
+// Random spheres and boxes around a frustum, of sizes from tiny to
+// larger than the frustum, and a few empty boxes. The centers and
+// extents are computed from the boxes as FrustumTest::isVisible()
+// computes them.
+//
+
+template <class T>
+void
+randomObjects (
+    IMATH_INTERNAL_NAMESPACE::Rand48&       rand,
+    size_t                                  n,
+    std::vector<Box3<T>>&                   boxes,
+    std::vector<T>&                         radii,
+    IMATH_INTERNAL_NAMESPACE::Vec3Array<T>& centers,
+    IMATH_INTERNAL_NAMESPACE::Vec3Array<T>& extents)
+{
+    boxes.resize (n);
+    radii.resize (n);
+    centers.resize (n);
+    extents.resize (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const T size = T (std::pow (10.0, rand.nextf (-3, 2)));
+
+        const IMATH_INTERNAL_NAMESPACE::Vec3<T> c (
+            T (rand.nextf (-60, 60)),
+            T (rand.nextf (-60, 60)),
+            T (rand.nextf (-120, 10)));
+
+        const IMATH_INTERNAL_NAMESPACE::Vec3<T> e (
+            T (size * rand.nextf ()),
+            T (size * rand.nextf ()),
+            T (size * rand.nextf (i % 97 == 0 ? -1 : 0, 1)));
+
+        boxes[i].min = c - e;
+        boxes[i].max = c + e;
+        radii[i]     = size;
+
+        const IMATH_INTERNAL_NAMESPACE::Vec3<T> center =
+            (boxes[i].min + boxes[i].max) / 2;
+
+        centers.set (i, center);
+        extents.set (i, boxes[i].max - center);
+    }
+}
+
+template <class T>
+void
+testBatch ()
+{
+    const IMATH_INTERNAL_NAMESPACE::Frustum<T> frustum (
+        T (0.5), T (100), T (-0.4), T (0.4), T (0.3), T (-0.3));
+
+    IMATH_INTERNAL_NAMESPACE::Matrix44<T> cameraMat;
+    cameraMat.rotate (
+        IMATH_INTERNAL_NAMESPACE::Vec3<T> (T (0.1), T (-0.2), T (0.3)));
+    cameraMat.translate (IMATH_INTERNAL_NAMESPACE::Vec3<T> (1, 2, 3));
+
+    const IMATH_INTERNAL_NAMESPACE::FrustumTest<T> frustumTest (
+        frustum, cameraMat);
+
+    IMATH_INTERNAL_NAMESPACE::Rand48 rand (17);
+
+    const size_t sizes[] = {0, 1, 3, 7, 8, 63, 64, 65, 129, 10000};
+
+    for (size_t size: sizes)
+    {
+        std::vector<Box3<T>>                   boxes;
+        std::vector<T>                         radii;
+        IMATH_INTERNAL_NAMESPACE::Vec3Array<T> centers, extents;
+        randomObjects (rand, size, boxes, radii, centers, extents);
+
+        // One extra value each, to check that nothing is written there
+        std::vector<uint64_t> sphereBits ((size + 63) / 64 + 1, 1);
+        std::vector<uint64_t> boxBits ((size + 63) / 64 + 1, 1);
+        std::vector<uint32_t> sphereIndices (size + 1, 0);
+        std::vector<uint32_t> boxIndices (size + 1, 0);
+
+        frustumTest.isVisible (centers, radii.data (), sphereBits.data ());
+        frustumTest.isVisible (centers, extents, boxBits.data ());
+
+        const size_t numSpheres = frustumTest.visibleIndices (
+            centers, radii.data (), sphereIndices.data ());
+        const size_t numBoxes = frustumTest.visibleIndices (
+            centers, extents, boxIndices.data ());
+
+        size_t s = 0, b = 0;
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            const bool sphere = frustumTest.isVisible (
+                IMATH_INTERNAL_NAMESPACE::Sphere3<T> (centers[i], radii[i]));
+            const bool box = frustumTest.isVisible (boxes[i]);
+
+            assert (bool (sphereBits[i / 64] >> (i % 64) & 1) == sphere);
+            assert (bool (boxBits[i / 64] >> (i % 64) & 1) == box);
+
+            if (sphere) assert (sphereIndices[s++] == i);
+            if (box) assert (boxIndices[b++] == i);
+        }
+
+        assert (s == numSpheres && b == numBoxes);
+
+        // The unused bits of the last word are cleared
+        if (size % 64)
+        {
+            assert (sphereBits[size / 64] >> (size % 64) == 0);
+            assert (boxBits[size / 64] >> (size % 64) == 0);
+        }
+
+        assert (sphereBits[(size + 63) / 64] == 1);
+        assert (boxBits[(size + 63) / 64] == 1);
+        assert (sphereIndices[size] == 0 && boxIndices[size] == 0);
+    }
+}
+
+template <class T>
+void
+testPlaneMasks ()
+{
+    const IMATH_INTERNAL_NAMESPACE::Frustum<T> frustum (
+        T (0.5), T (100), T (-0.4), T (0.4), T (0.3), T (-0.3));
+
+    IMATH_INTERNAL_NAMESPACE::Matrix44<T> cameraMat;
+    cameraMat.rotate (
+        IMATH_INTERNAL_NAMESPACE::Vec3<T> (T (-0.2), T (0.1), T (0.2)));
+
+    typedef IMATH_INTERNAL_NAMESPACE::FrustumTest<T> Test;
+    const Test frustumTest (frustum, cameraMat);
+
+    IMATH_INTERNAL_NAMESPACE::Rand48       rand (23);
+    std::vector<Box3<T>>                   boxes;
+    std::vector<T>                         radii;
+    IMATH_INTERNAL_NAMESPACE::Vec3Array<T> centers, extents;
+    randomObjects (rand, 10000, boxes, radii, centers, extents);
+
+    for (size_t i = 0; i < boxes.size (); ++i)
+    {
+        const IMATH_INTERNAL_NAMESPACE::Sphere3<T> sphere (
+            centers[i], radii[i]);
+
+        // With all planes, the results are those of isVisible() and
+        // completelyContains(), whichever plane is tested first; hints
+        // that are not plane numbers are ignored
+        const unsigned hints[] = {0, 1, 2, 3, 4, 5, 6, 31, 32, 1000};
+
+        for (unsigned first: hints)
+        {
+            unsigned sphereMask = Test::allPlanes, sphereLast = first;
+            unsigned boxMask = Test::allPlanes, boxLast = first;
+
+            const bool sphereVisible =
+                frustumTest.isVisible (sphere, sphereMask, sphereLast);
+            const bool boxVisible =
+                frustumTest.isVisible (boxes[i], boxMask, boxLast);
+
+            assert (sphereVisible == frustumTest.isVisible (sphere));
+            assert (boxVisible == frustumTest.isVisible (boxes[i]));
+
+            if (sphereVisible)
+            {
+                assert (
+                    (sphereMask == 0) ==
+                    frustumTest.completelyContains (sphere));
+                assert (sphereLast == first);
+            }
+            else
+            {
+                // The plane that rejected the sphere rejects it alone
+                unsigned m = 1u << sphereLast;
+                assert (sphereMask == Test::allPlanes);
+                assert (!frustumTest.isVisible (sphere, m));
+            }
+
+            if (boxVisible)
+            {
+                assert (
+                    (boxMask == 0) ==
+                    frustumTest.completelyContains (boxes[i]));
+                assert (boxLast == first);
+            }
+            else if (!boxes[i].isEmpty ())
+            {
+                unsigned m = 1u << boxLast;
+                assert (boxMask == Test::allPlanes);
+                assert (!frustumTest.isVisible (boxes[i], m));
+            }
+
+            // A mask is never extended
+            unsigned m = sphereMask & 0x15;
+            if (frustumTest.isVisible (sphere, m)) assert ((m & ~0x15u) == 0);
+        }
+
+        // With no planes to test, everything is visible, except empty
+        // boxes
+        unsigned none = 0;
+        assert (frustumTest.isVisible (sphere, none) && none == 0);
+        assert (frustumTest.isVisible (boxes[i], none) == !boxes[i].isEmpty ());
+    }
+}
+
+//
+// An octree of boxes, with the box of each node split in eight for its
+// children. Node n has children 8n + 1 to 8n + 8.
+//
+
+template <class T>
+struct Octree
+{
+    std::vector<Box3<T>>  boxes;
+    std::vector<unsigned> lastPlanes;
+    int                   depth;
+
+    Octree (const Box3<T>& root, int depth) : depth (depth)
+    {
+        size_t n = 0;
+        for (int d = 0, level = 1; d <= depth; ++d, level *= 8)
+            n += level;
+
+        boxes.resize (n);
+        lastPlanes.resize (n, 0);
+        boxes[0] = root;
+
+        for (size_t i = 0; 8 * i + 8 < n; ++i)
+        {
+            const IMATH_INTERNAL_NAMESPACE::Vec3<T> c = boxes[i].center ();
+
+            for (int k = 0; k < 8; ++k)
+            {
+                Box3<T>& b = boxes[8 * i + 1 + k];
+                b.min      = boxes[i].min;
+                b.max      = c;
+
+                if (k & 1) b.min.x = c.x, b.max.x = boxes[i].max.x;
+                if (k & 2) b.min.y = c.y, b.max.y = boxes[i].max.y;
+                if (k & 4) b.min.z = c.z, b.max.z = boxes[i].max.z;
+            }
+        }
+    }
+
+    size_t firstLeaf () const
+    {
+        return boxes.size () - (boxes.size () * 7 + 1) / 8;
+    }
+
+    // Add the visible leaves below node i to leaves, and return the
+    // number of nodes tested
+    size_t cull (
+        const IMATH_INTERNAL_NAMESPACE::FrustumTest<T>& frustumTest,
+        size_t                                          i,
+        unsigned                                        planeMask,
+        std::vector<size_t>&                            leaves)
+    {
+        if (!frustumTest.isVisible (boxes[i], planeMask, lastPlanes[i]))
+            return 1;
+
+        if (i >= firstLeaf ())
+        {
+            leaves.push_back (i);
+            return 1;
+        }
+
+        size_t tested = 1;
+
+        for (size_t k = 1; k <= 8; ++k)
+            tested += cull (frustumTest, 8 * i + k, planeMask, leaves);
+
+        return tested;
+    }
+};
+
+template <class T>
+void
+testHierarchy ()
+{
+    const IMATH_INTERNAL_NAMESPACE::Frustum<T> frustum (
+        T (0.5), T (100), T (-0.4), T (0.4), T (0.3), T (-0.3));
+
+    Octree<T> octree (
+        Box3<T> (
+            IMATH_INTERNAL_NAMESPACE::Vec3<T> (-128, -128, -128),
+            IMATH_INTERNAL_NAMESPACE::Vec3<T> (128, 128, 128)),
+        6);
+
+    const size_t firstLeaf = octree.firstLeaf ();
+
+    size_t tested = 0, visible = 0;
+
+    // Turn the camera a little from frame to frame. The camera is off
+    // the grid of the octree, so that no plane touches a box exactly,
+    // where rounding may reject a box and not its children.
+    for (int frame = 0; frame < 20; ++frame)
+    {
+        IMATH_INTERNAL_NAMESPACE::Matrix44<T> cameraMat;
+        cameraMat.rotate (IMATH_INTERNAL_NAMESPACE::Vec3<T> (
+            T (0.01 * frame), T (0.02 * frame), 0));
+        cameraMat.translate (
+            IMATH_INTERNAL_NAMESPACE::Vec3<T> (T (0.37), T (0.21), T (0.13)));
+
+        const IMATH_INTERNAL_NAMESPACE::FrustumTest<T> frustumTest (
+            frustum, cameraMat);
+
+        std::vector<size_t> flat, leaves;
+
+        for (size_t i = firstLeaf; i < octree.boxes.size (); ++i)
+            if (frustumTest.isVisible (octree.boxes[i])) flat.push_back (i);
+
+        tested += octree.cull (
+            frustumTest,
+            0,
+            IMATH_INTERNAL_NAMESPACE::FrustumTest<T>::allPlanes,
+            leaves);
+
+        assert (leaves == flat);
+        visible += leaves.size ();
+    }
+
+    cout << "  " << visible << " visible leaves, " << tested
+         << " nodes tested\n";
+}
+
+//
+// Return true if some point of the segment from a to b is inside all
+// the planes, clipping the segment against them one by one.
+//
+
+template <class T>
+bool
+segmentInside (
+    const IMATH_INTERNAL_NAMESPACE::Plane3<T>* planes,
+    const IMATH_INTERNAL_NAMESPACE::Vec3<T>&   a,
+    const IMATH_INTERNAL_NAMESPACE::Vec3<T>&   b)
+{
+    double t0 = 0, t1 = 1;
+
+    for (int i = 0; i < 6; ++i)
+    {
+        const double da = planes[i].distanceTo (a);
+        const double db = planes[i].distanceTo (b);
+
+        if (da > 0 && db > 0) return false;
+
+        if (da > 0)
+            t0 = std::max (t0, da / (da - db));
+        else if (db > 0)
+            t1 = std::min (t1, da / (da - db));
+    }
+
+    return t0 <= t1;
+}
+
+//
+// The reference for FrustumExactTest::isVisible(): two convex
+// polyhedra intersect if and only if an edge of one of them intersects
+// the other.
+//
+
+template <class T>
+bool
+intersects (
+    const IMATH_INTERNAL_NAMESPACE::Plane3<T>* frustumPlanes,
+    const IMATH_INTERNAL_NAMESPACE::Vec3<T>*   frustumCorners,
+    const Box3<T>&                             box)
+{
+    if (box.isEmpty ()) return false;
+
+    IMATH_INTERNAL_NAMESPACE::Plane3<T> boxPlanes[6];
+    IMATH_INTERNAL_NAMESPACE::Vec3<T>   boxCorners[8];
+
+    for (int i = 0; i < 3; ++i)
+    {
+        IMATH_INTERNAL_NAMESPACE::Vec3<T> n (0, 0, 0);
+        n[i] = 1;
+        boxPlanes[2 * i].set (n, box.max[i]);
+        boxPlanes[2 * i + 1].set (-n, -box.min[i]);
+    }
+
+    for (int i = 0; i < 8; ++i)
+        boxCorners[i] = IMATH_INTERNAL_NAMESPACE::Vec3<T> (
+            (i & 1) ? box.max.x : box.min.x,
+            (i & 2) ? box.max.y : box.min.y,
+            (i & 4) ? box.max.z : box.min.z);
+
+    // The corners of both are numbered so that an edge joins corners
+    // whose numbers differ in one bit
+    for (int i = 0; i < 8; ++i)
+    {
+        for (int bit = 1; bit < 8; bit <<= 1)
+        {
+            if (i & bit) continue;
+
+            if (segmentInside (
+                    frustumPlanes, boxCorners[i], boxCorners[i | bit]) ||
+                segmentInside (
+                    boxPlanes, frustumCorners[i], frustumCorners[i | bit]))
+                return true;
+        }
+    }
+
+    return false;
+}
+
+template <class T>
+void
+testExact (bool orthographic)
+{
+    const IMATH_INTERNAL_NAMESPACE::Frustum<T> frustum (
+        T (0.5),
+        T (100),
+        T (-0.4),
+        T (0.4),
+        T (0.3),
+        T (-0.3),
+        orthographic);
+
+    IMATH_INTERNAL_NAMESPACE::Matrix44<T> cameraMat;
+    cameraMat.rotate (
+        IMATH_INTERNAL_NAMESPACE::Vec3<T> (T (0.1), T (-0.2), T (0.7)));
+    cameraMat.translate (IMATH_INTERNAL_NAMESPACE::Vec3<T> (1, 2, 3));
+
+    const IMATH_INTERNAL_NAMESPACE::FrustumTest<T> frustumTest (
+        frustum, cameraMat);
+    const IMATH_INTERNAL_NAMESPACE::FrustumExactTest<T> exactTest (
+        frustumTest);
+
+    assert (exactTest.frustumTest ().cameraMat () == cameraMat);
+
+    IMATH_INTERNAL_NAMESPACE::Plane3<T> frustumPlanes[6];
+    frustum.planes (frustumPlanes, cameraMat);
+
+    const T scale = orthographic ? 1 : T (100 / 0.5);
+
+    IMATH_INTERNAL_NAMESPACE::Vec3<T> frustumCorners[8];
+    for (int i = 0; i < 8; ++i)
+    {
+        const T s = (i & 4) ? scale : 1;
+
+        frustumCorners[i] =
+            IMATH_INTERNAL_NAMESPACE::Vec3<T> (
+                s * ((i & 1) ? T (0.4) : T (-0.4)),
+                s * ((i & 2) ? T (0.3) : T (-0.3)),
+                (i & 4) ? T (-100) : T (-0.5)) *
+            cameraMat;
+    }
+
+    IMATH_INTERNAL_NAMESPACE::Rand48       rand (29);
+    std::vector<Box3<T>>                   boxes;
+    std::vector<T>                         radii;
+    IMATH_INTERNAL_NAMESPACE::Vec3Array<T> centers, extents;
+    randomObjects (rand, 20000, boxes, radii, centers, extents);
+
+    // Move half of the boxes close to the edges of the frustum, where
+    // isVisible() lets most of the invisible ones through
+    for (size_t i = 0; i < boxes.size (); i += 2)
+    {
+        const int a   = rand.nexti () % 8;
+        const int b   = a ^ (1 << rand.nexti () % 3);
+        const T   t   = T (rand.nextf ());
+        const T   off = T (std::pow (10.0, rand.nextf (-3, 1)));
+
+        const IMATH_INTERNAL_NAMESPACE::Vec3<T> c =
+            frustumCorners[a] + (frustumCorners[b] - frustumCorners[a]) * t +
+            IMATH_INTERNAL_NAMESPACE::Vec3<T> (
+                T (rand.nextf (-off, off)),
+                T (rand.nextf (-off, off)),
+                T (rand.nextf (-off, off)));
+
+        const IMATH_INTERNAL_NAMESPACE::Vec3<T> e (
+            T (rand.nextf (0, off)),
+            T (rand.nextf (0, off)),
+            T (rand.nextf (0, off)));
+
+        boxes[i].min = c - e;
+        boxes[i].max = c + e;
+
+        const IMATH_INTERNAL_NAMESPACE::Vec3<T> center =
+            (boxes[i].min + boxes[i].max) / 2;
+
+        centers.set (i, center);
+        extents.set (i, boxes[i].max - center);
+    }
+
+    // Boxes a little larger and smaller, to allow for rounding
+    const T tol = std::is_same<T, float>::value ? T (1e-3) : T (1e-8);
+    const IMATH_INTERNAL_NAMESPACE::Vec3<T> grow (tol, tol, tol);
+
+    std::vector<uint32_t> expected;
+    size_t                rejected = 0;
+
+    for (size_t i = 0; i < boxes.size (); ++i)
+    {
+        const bool exact = exactTest.isVisible (boxes[i]);
+        const bool cheap = frustumTest.isVisible (boxes[i]);
+
+        assert (cheap || !exact);
+
+        if (!intersects (
+                frustumPlanes,
+                frustumCorners,
+                Box3<T> (boxes[i].min - grow, boxes[i].max + grow)))
+            assert (!exact);
+
+        if (intersects (
+                frustumPlanes,
+                frustumCorners,
+                Box3<T> (boxes[i].min + grow, boxes[i].max - grow)))
+            assert (exact);
+
+        if (exact) expected.push_back (uint32_t (i));
+        if (cheap && !exact) ++rejected;
+    }
+
+    // There must be some boxes for the exact test to reject
+    assert (rejected > boxes.size () / 1000);
+
+    std::vector<uint32_t> indices (boxes.size ());
+    size_t                n =
+        frustumTest.visibleIndices (centers, extents, indices.data ());
+
+    n = exactTest.refineVisibleIndices (centers, extents, indices.data (), n);
+
+    indices.resize (n);
+    assert (indices == expected);
+}
+
+} // namespace
+
 void
 testFrustumTest ()
 {
@@ -150,5 +691,25 @@ testFrustumTest ()
         IMATH_INTERNAL_NAMESPACE::Sphere3<float> (outsideVec_up, tinyRadius)));
     cout << "passed Sphere\n";
 
+    testBatch<float> ();
+    testBatch<double> ();
+    cout << "passed batches\n";
+
+    testPlaneMasks<float> ();
+    testPlaneMasks<double> ();
+    cout << "passed plane masks\n";
+
+    testExact<float> (false);
+    testExact<float> (true);
+    testExact<double> (false);
+    testExact<double> (true);
+    cout << "passed exact box tests\n";
+
+
+    cout << "hierarchical culling in single precision\n";
+    testHierarchy<float> ();
+    cout << "hierarchical culling in double precision\n";
+    testHierarchy<double> ();
+
     cout << "\nok\n\n";
 }
@@ -11,6 +11,9 @@
 #include "halfFunction.h"
 #include <assert.h>
 #include <iostream>
+#include <stdexcept>
+#include <stdio.h>
+#include <vector>
 
 using namespace std;
 
@@ -30,6 +33,131 @@ struct timesN
     float n;
 };
 
+template <class T>
+void
+testApply (const halfFunction<T>& f)
+{
+    //
+    // Evaluate every half value, at every length and offset around the
+    // vector widths, and compare against operator().
+    //
+
+    std::vector<half> in (1 << 16);
+    std::vector<T>    out (in.size () + 64);
+
+    for (int i = 0; i < (1 << 16); i++)
+        in[i].setBits (i);
+
+    f.apply (in.data (), out.data (), in.size ());
+
+    for (size_t i = 0; i < in.size (); i++)
+        assert (out[i] == f (in[i]) || f (in[i]) != f (in[i]));
+
+    for (size_t offset = 0; offset < 3; offset++)
+    {
+        for (size_t n = 0; n < 40; n++)
+        {
+            T sentinel = T (123);
+            for (size_t i = 0; i < out.size (); i++)
+                out[i] = sentinel;
+
+            f.apply (in.data () + 15360 + offset, out.data () + offset, n);
+
+            for (size_t i = 0; i < n; i++)
+                assert (out[offset + i] == f (in[15360 + offset + i]));
+
+            assert (out[offset + n] == sentinel);
+        }
+    }
+}
+
+bool
+loadFails (const char fileName[])
+{
+    try
+    {
+        halfFunction<float> f (fileName);
+    }
+    catch (const std::runtime_error&)
+    {
+        return true;
+    }
+
+    return false;
+}
+
+void
+testSaveLoad (const halfFunction<float>& d2, const halfFunction<half>& t5)
+{
+    const char* fileName = "testFunction.hft";
+
+    d2.save (fileName);
+
+    {
+        halfFunction<float> loaded (fileName);
+
+        for (int i = 0; i < (1 << 16); i++)
+        {
+            half x;
+            x.setBits (i);
+            assert (loaded (x) == d2 (x));
+        }
+
+        testApply (loaded);
+    }
+
+    //
+    // Tables of a different type, truncated files and files
+    // that are not tables at all must be rejected.
+    //
+
+    {
+        bool threw = false;
+
+        try
+        {
+            halfFunction<int> wrongType (fileName);
+        }
+        catch (const std::runtime_error&)
+        {
+            threw = true;
+        }
+
+        assert (threw);
+    }
+
+    t5.save (fileName);
+
+    {
+        halfFunction<half> loaded (fileName);
+
+        for (int i = 0; i < (1 << 16); i++)
+        {
+            half x;
+            x.setBits (i);
+            assert (loaded (x).bits () == t5 (x).bits ());
+        }
+    }
+
+    assert (loadFails (fileName));
+
+    FILE* file = fopen (fileName, "wb");
+    assert (file);
+    fputs ("not a table", file);
+    fclose (file);
+    assert (loadFails (fileName));
+
+    d2.save (fileName);
+    file = fopen (fileName, "ab");
+    assert (file);
+    fputc (0, file);
+    fclose (file);
+    assert (loadFails (fileName));
+
+    remove (fileName);
+    assert (loadFails (fileName));
+}
+
 } // namespace
 
 void
@@ -71,5 +199,45 @@ testFunction ()
 
     assert (t5 (half::qNan ()).isNan ());
 
+    testApply (d2);
+    testApply (t5);
+    testSaveLoad (d2, t5);
+
+    halfFunction<int> bits ([] (half x) { return int (x.bits ()); });
+    testApply (bits);
+
+    //
+    // A table built on several threads must match the serial build.
+    //
+
+    for (unsigned int threads = 0; threads < 5; threads++)
+    {
+        halfFunction<int> pbits (
+            IMATH_NAMESPACE::ParallelBuild (threads),
+            [] (half x) { return int (x.bits ()); },
+            -1,
+            1);
+
+        for (int i = 0; i < (1 << 16); i++)
+        {
+            half x;
+            x.setBits (i);
+
+            if (x.isFinite () && x >= -1 && x <= 1)
+                assert (pbits (x) == i);
+            else
+                assert (pbits (x) == 0);
+        }
+    }
+
+    halfFunction<float> pd2 (IMATH_NAMESPACE::ParallelBuild (), divideByTwo);
+
+    for (int i = 0; i < (1 << 16); i++)
+    {
+        half x;
+        x.setBits (i);
+        assert (pd2 (x) == d2 (x));
+    }
+
     cout << "ok\n\n" << flush;
 }
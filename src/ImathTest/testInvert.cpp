@@ -10,8 +10,10 @@
 #include "testInvert.h"
 #include <ImathMatrix.h>
 #include <ImathMatrixAlgo.h>
+#include <ImathRandom.h>
 #include <assert.h>
 #include <iostream>
+#include <stdexcept>
 
 using namespace std;
 using namespace IMATH_INTERNAL_NAMESPACE;
@@ -51,6 +53,75 @@ invertM33f (const M33f& m, float e)
     assert (ident2.equalWithAbsError (identity33f, e));
 }
 
+//
+// Random well-conditioned matrices, both affine and projective, and
+// singular matrices, which must be detected by both inverse () and
+// gjInverse ().
+//
+
+template <class T>
+void
+invertRandomM44 (T e)
+{
+    Rand48 rand (19);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        Matrix44<T> m;
+
+        for (int j = 0; j < 4; ++j)
+            for (int k = 0; k < 4; ++k)
+                m[j][k] = T (rand.nextf (-1, 1)) + (j == k ? T (4) : T (0));
+
+        if (i % 2)
+        {
+            m[0][3] = 0;
+            m[1][3] = 0;
+            m[2][3] = 0;
+            m[3][3] = 1;
+        }
+
+        Matrix44<T> ident1 = m * m.inverse ();
+        Matrix44<T> ident2 = m * m.gjInverse ();
+
+        assert (ident1.equalWithAbsError (Matrix44<T> (), e));
+        assert (ident2.equalWithAbsError (Matrix44<T> (), e));
+        assert (m.inverse (true) == m.inverse ());
+        assert (m.gjInverse (true) == m.gjInverse ());
+
+        for (int k = 0; k < 4; ++k)
+            m[2][k] = m[1][k] * 2;
+
+        assert (m.inverse () == Matrix44<T> ());
+        assert (m.gjInverse () == Matrix44<T> ());
+
+        bool caught = false;
+
+        try
+        {
+            m.inverse (true);
+        }
+        catch (const std::invalid_argument&)
+        {
+            caught = true;
+        }
+
+        assert (caught);
+        caught = false;
+
+        try
+        {
+            m.gjInverse (true);
+        }
+        catch (const std::invalid_argument&)
+        {
+            caught = true;
+        }
+
+        assert (caught);
+    }
+}
+
 } // namespace
 
 void
@@ -131,5 +202,8 @@ testInvert ()
         invertM33f (m5, 1e-6f);
     }
 
+    invertRandomM44<float> (1e-5f);
+    invertRandomM44<double> (1e-12);
+
     cout << "ok\n" << endl;
 }
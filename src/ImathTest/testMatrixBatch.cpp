@@ -0,0 +1,588 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include "testMatrixBatch.h"
+#include <ImathEuler.h>
+#include <ImathMatrix.h>
+#include <ImathMatrixAlgo.h>
+#include <ImathMatrixBatch.h>
+#include <ImathRandom.h>
+#include <ImathVec.h>
+#include <assert.h>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+//
+// Distance between two floating-point numbers in units in the last
+// place; infinities of the same sign and any two NaNs count as equal.
+//
+
+int64_t
+ulps (float a, float b)
+{
+    if (a != a && b != b) return 0;
+
+    int32_t ia, ib;
+    memcpy (&ia, &a, sizeof (a));
+    memcpy (&ib, &b, sizeof (b));
+
+    if (ia < 0) ia = INT32_MIN - ia;
+    if (ib < 0) ib = INT32_MIN - ib;
+
+    return ia > ib ? int64_t (ia) - ib : int64_t (ib) - ia;
+}
+
+int64_t
+ulps (double a, double b)
+{
+    if (a != a && b != b) return 0;
+
+    int64_t ia, ib;
+    memcpy (&ia, &a, sizeof (a));
+    memcpy (&ib, &b, sizeof (b));
+
+    if (ia < 0) ia = INT64_MIN - ia;
+    if (ib < 0) ib = INT64_MIN - ib;
+
+    return ia > ib ? ia - ib : ib - ia;
+}
+
+//
+// The batched transformations perform the same operations as the scalar
+// ones, so the results agree to within one ulp. If the compiler contracts
+// multiplications and additions into fused multiply-adds, however, it may
+// do so differently in the two versions, so the results may differ by up
+// to a few rounding errors of the individual terms of each sum instead.
+//
+
+enum Kind
+{
+    Projective,
+    Affine,
+    Direction
+};
+
+template <class T, class S>
+bool
+close (
+    const Matrix44<T>& m,
+    const Vec3<S>&     p,
+    const Vec3<S>&     a,
+    const Vec3<S>&     b,
+    Kind               kind)
+{
+    double e = 8 * std::numeric_limits<S>::epsilon ();
+    double w = 1;
+    double d = 0;
+
+    if (kind == Projective)
+    {
+        w = p.x * double (m[0][3]) + p.y * double (m[1][3]) +
+            p.z * double (m[2][3]) + double (m[3][3]);
+        d = std::abs (p.x * double (m[0][3])) +
+            std::abs (p.y * double (m[1][3])) +
+            std::abs (p.z * double (m[2][3])) + std::abs (double (m[3][3]));
+    }
+
+    for (int j = 0; j < 3; ++j)
+    {
+        if (ulps (a[j], b[j]) <= 1) continue;
+
+        double n = std::abs (p.x * double (m[0][j])) +
+                   std::abs (p.y * double (m[1][j])) +
+                   std::abs (p.z * double (m[2][j]));
+
+        if (kind != Direction) n += std::abs (double (m[3][j]));
+
+        double bound = e * (n + std::abs (double (a[j])) * d) / std::abs (w);
+
+        if (!(std::abs (double (a[j]) - double (b[j])) <= bound)) return false;
+    }
+
+    return true;
+}
+
+template <class T>
+Matrix44<T>
+randomMatrix (Rand48& rand, bool affine)
+{
+    Matrix44<T> m;
+
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 4; ++j)
+            m[i][j] = T (rand.nextf (-2, 2));
+
+    if (affine)
+    {
+        m[0][3] = 0;
+        m[1][3] = 0;
+        m[2][3] = 0;
+        m[3][3] = 1;
+    }
+
+    return m;
+}
+
+template <class T, class S>
+void
+testTransform (const Matrix44<T>& m, Rand48& rand, size_t n)
+{
+    std::vector<Vec3<S>> src (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        src[i] = Vec3<S> (
+            S (rand.nextf (-100, 100)),
+            S (rand.nextf (-100, 100)),
+            S (rand.nextf (-100, 100)));
+    }
+
+    std::vector<Vec3<S>> dst (n);
+    Vec3<S>              r;
+
+    m.multVecMatrix (src.data (), dst.data (), n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        m.multVecMatrix (src[i], r);
+        assert (close (m, src[i], dst[i], r, Projective));
+    }
+
+    m.multDirMatrix (src.data (), dst.data (), n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        m.multDirMatrix (src[i], r);
+        assert (close (m, src[i], dst[i], r, Direction));
+    }
+
+    if (m[0][3] == 0 && m[1][3] == 0 && m[2][3] == 0 && m[3][3] == 1)
+    {
+        m.multVecMatrixAffine (src.data (), dst.data (), n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            m.multVecMatrix (src[i], r);
+            assert (close (m, src[i], dst[i], r, Affine));
+        }
+    }
+
+    //
+    // In-place transformation
+    //
+
+    std::vector<Vec3<S>> tmp (src);
+    m.multVecMatrix (tmp.data (), tmp.data (), n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        m.multVecMatrix (src[i], r);
+        assert (close (m, src[i], tmp[i], r, Projective));
+    }
+}
+
+template <class T, class S>
+void
+testTransformT (const char* name)
+{
+    cout << "    " << name << endl;
+
+    Rand48 rand (7);
+
+    for (int affine = 0; affine < 2; ++affine)
+    {
+        Matrix44<T> m = randomMatrix<T> (rand, affine != 0);
+
+        for (size_t n = 0; n < 40; ++n)
+            testTransform<T, S> (m, rand, n);
+
+        testTransform<T, S> (m, rand, 1003);
+    }
+
+    //
+    // Points that are mapped to infinity
+    //
+
+    Matrix44<T> m;
+    m[3][3] = 0;
+
+    std::vector<Vec3<S>> src (9, Vec3<S> (0, 1, 2));
+    std::vector<Vec3<S>> dst (9);
+    Vec3<S>              r;
+
+    m.multVecMatrix (src.data (), dst.data (), src.size ());
+    m.multVecMatrix (src[0], r);
+
+    for (size_t i = 0; i < dst.size (); ++i)
+        assert (ulps (dst[i].x, r.x) == 0 && ulps (dst[i].y, r.y) == 0 &&
+                ulps (dst[i].z, r.z) == 0);
+}
+
+//
+// Whether c is the product a * b. Without fused multiply-adds the bulk
+// products are computed exactly like operator*; with them, the compiler
+// may contract the operations differently where the code is inlined.
+//
+
+template <class T>
+bool
+isProduct (const Matrix44<T>& c, const Matrix44<T>& a, const Matrix44<T>& b)
+{
+    const Matrix44<T> p = a * b;
+
+#if defined(__FMA__) || defined(__aarch64__)
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 4; ++j)
+        {
+            double n = 0;
+
+            for (int k = 0; k < 4; ++k)
+                n += std::abs (double (a[i][k]) * double (b[k][j]));
+
+            double e = 8 * std::numeric_limits<T>::epsilon () * n;
+
+            if (!(std::abs (double (c[i][j]) - double (p[i][j])) <= e))
+                return false;
+        }
+
+    return true;
+#else
+    return c == p;
+#endif
+}
+
+template <class T>
+void
+testMultiplyT (const char* name)
+{
+    cout << "    " << name << " products" << endl;
+
+    Rand48 rand (11);
+
+    //
+    // Pairwise products, sequential and threaded, including arrays
+    // that are too small to be split across threads
+    //
+
+    for (size_t n = 0; n < 20000; n = n * 3 + 1)
+    {
+        std::vector<Matrix44<T>> a (n), b (n), c (n), d (n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            a[i] = randomMatrix<T> (rand, i % 2);
+            b[i] = randomMatrix<T> (rand, i % 3);
+        }
+
+        multiply (a.data (), b.data (), c.data (), n);
+        multiply (a.data (), b.data (), d.data (), n, ParallelBuild (4));
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            assert (isProduct (c[i], a[i], b[i]));
+            assert (d[i] == c[i]);
+        }
+
+        multiply (a.data (), b.data (), a.data (), n, ParallelBuild (3));
+        assert (a == c);
+    }
+
+    //
+    // Transform hierarchies made of rotations and translations: a forest
+    // of random trees, a single chain, and a wide, flat tree. The threaded
+    // version must give the same results as the sequential one.
+    //
+
+    for (int shape = 0; shape < 3; ++shape)
+    {
+        const size_t n = 30000;
+
+        std::vector<int>         parent (n);
+        std::vector<Matrix44<T>> local (n), world (n), pworld (n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            switch (shape)
+            {
+                case 0: parent[i] = int (rand.nexti () % (i + 1)) - 1; break;
+                case 1: parent[i] = int (i) - 1; break;
+                default: parent[i] = int (i < 10 ? i : 10) - 1; break;
+            }
+
+            Vec3<T> axis (
+                T (rand.nextf (-1, 1)),
+                T (rand.nextf (-1, 1)),
+                T (rand.nextf (1, 2)));
+
+            local[i].setAxisAngle (axis.normalized (), T (rand.nextf (0, 3)));
+            local[i].translate (Vec3<T> (T (rand.nextf (-1, 1))));
+        }
+
+        composeHierarchy (local.data (), parent.data (), world.data (), n);
+        composeHierarchy (
+            local.data (),
+            parent.data (),
+            pworld.data (),
+            n,
+            ParallelBuild (4));
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (parent[i] < 0)
+                assert (world[i] == local[i]);
+            else
+                assert (isProduct (world[i], local[i], world[parent[i]]));
+
+            assert (pworld[i] == world[i]);
+        }
+
+        composeHierarchy (
+            local.data (),
+            parent.data (),
+            local.data (),
+            n,
+            ParallelBuild ());
+
+        assert (local == world);
+    }
+}
+
+//
+// The batched decomposition performs the same operations as the scalar
+// one, so the results are identical, unless the compiler contracts
+// multiplications and additions into fused multiply-adds differently in
+// the two versions.
+//
+
+template <class T>
+bool
+same (T a, T b)
+{
+#if defined(__FMA__) || defined(__aarch64__)
+    return ulps (a, b) <= 1024 ||
+           std::abs (a - b) <= 1024 * std::numeric_limits<T>::epsilon ();
+#else
+    return ulps (a, b) == 0;
+#endif
+}
+
+template <class T>
+bool
+same (const Vec3<T>& a, const Vec3<T>& b)
+{
+    return same (a.x, b.x) && same (a.y, b.y) && same (a.z, b.z);
+}
+
+template <class T>
+Matrix44<T>
+randomSHRT (Rand48& rand)
+{
+    Vec3<T> s (
+        T (rand.nextf (0.1, 10)),
+        T (rand.nextf (0.1, 10)),
+        T (rand.nextf (0.1, 10)));
+
+    if (rand.nextf () < 0.3) s.x = -s.x;
+
+    Vec3<T> h (
+        T (rand.nextf (-1, 1)), T (rand.nextf (-1, 1)), T (rand.nextf (-1, 1)));
+
+    Vec3<T> r (
+        T (rand.nextf (-3, 3)),
+        T (rand.nextf (-1.5, 1.5)),
+        T (rand.nextf (-3, 3)));
+
+    Vec3<T> t (
+        T (rand.nextf (-100, 100)),
+        T (rand.nextf (-100, 100)),
+        T (rand.nextf (-100, 100)));
+
+    Matrix44<T> m;
+    m.translate (t);
+    m.rotate (r);
+    m.shear (h);
+    m.scale (s);
+
+    return m;
+}
+
+template <class T>
+void
+testDecomposeT (const char* name)
+{
+    cout << "    " << name << " decomposition" << endl;
+
+    Rand48 rand (13);
+
+    //
+    // Random transforms, mixed with matrices that cannot be decomposed:
+    // zero or huge rows, and a zero matrix. Also include tiny scales,
+    // which take the slow path of Vec3::length().
+    //
+
+    const size_t             n = 1000;
+    std::vector<Matrix44<T>> mats (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        mats[i] = randomSHRT<T> (rand);
+
+        switch (i % 17)
+        {
+            case 3:
+                for (int j = 0; j < 3; ++j)
+                    mats[i][1][j] = 0;
+                break;
+            case 5: mats[i][2][1] = std::numeric_limits<T>::max (); break;
+            case 7: mats[i] *= T (1e-20); break;
+            case 11:
+                for (int j = 0; j < 3; ++j)
+                    for (int k = 0; k < 3; ++k)
+                        mats[i][j][k] = 0;
+                break;
+            case 13:
+                mats[i][0][0] *= std::numeric_limits<T>::min ();
+                mats[i][0][1] *= std::numeric_limits<T>::min ();
+                mats[i][0][2] *= std::numeric_limits<T>::min ();
+                break;
+            default: break;
+        }
+    }
+
+    const typename Euler<T>::Order orders[] = {
+        Euler<T>::XYZ, Euler<T>::ZYX, Euler<T>::XZX, Euler<T>::YXZr};
+
+    for (typename Euler<T>::Order order: orders)
+    {
+        Matrix44Array<T> m (mats);
+        Vec3Array<T>     s, h, r, t;
+        bool*            flags = new bool[n];
+
+        bool all = extractSHRT (m, s, h, r, t, flags, order);
+
+        assert (s.size () == n && h.size () == n);
+        assert (r.size () == n && t.size () == n);
+
+        bool anyFailed = false;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            Vec3<T> ss, hh, rr, tt;
+
+            bool e = extractSHRT (mats[i], ss, hh, rr, tt, false, order);
+
+            assert (flags[i] == e);
+            anyFailed |= !e;
+
+            if (!e) continue;
+
+            assert (same (s[i], ss));
+            assert (same (h[i], hh));
+            assert (t[i] == tt);
+
+            // The rotations are extracted with the batched Euler
+            // conversion, so they match only to within a few ulps
+            const Euler<T> er (r[i], order, Euler<T>::XYZLayout);
+            const Euler<T> err (rr, order, Euler<T>::XYZLayout);
+
+            assert (er.toMatrix44 ().equalWithAbsError (
+                err.toMatrix44 (), 64 * std::numeric_limits<T>::epsilon ()));
+        }
+
+        assert (anyFailed && !all);
+        delete[] flags;
+    }
+
+    //
+    // Removing scaling and shear in place; matrices that cannot be
+    // decomposed are left unchanged
+    //
+
+    Matrix44Array<T> m (mats);
+    Vec3Array<T>     s, h;
+    bool*            ok = new bool[n];
+
+    assert (!extractAndRemoveScalingAndShear (m, s, h, ok));
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Matrix44<T> mm (mats[i]);
+        Vec3<T>     ss, hh;
+
+        bool e = extractAndRemoveScalingAndShear (mm, ss, hh, false);
+
+        assert (ok[i] == e);
+
+        if (e)
+        {
+            for (int j = 0; j < 4; ++j)
+                for (int k = 0; k < 4; ++k)
+                    assert (same (m[i][j][k], mm[j][k]));
+
+            assert (same (s[i], ss));
+            assert (same (h[i], hh));
+        }
+        else
+        {
+            assert (m[i] == mats[i]);
+        }
+    }
+
+    delete[] ok;
+
+    //
+    // All decomposable, without flags
+    //
+
+    std::vector<Matrix44<T>> good (70);
+
+    for (size_t i = 0; i < good.size (); ++i)
+        good[i] = randomSHRT<T> (rand);
+
+    Matrix44Array<T> g (good);
+    Vec3Array<T>     gs, gh, gr, gt;
+
+    assert (extractSHRT (g, gs, gh, gr, gt, 0));
+    assert (extractAndRemoveScalingAndShear (g, gs, gh, 0));
+
+    Matrix44Array<T> empty;
+    assert (extractSHRT (empty, gs, gh, gr, gt, 0));
+    assert (gs.size () == 0 && gt.size () == 0);
+}
+
+} // namespace
+
+void
+testMatrixBatch ()
+{
+    cout << "Testing batched matrix operations" << endl;
+
+    testTransformT<float, float> ("M44f, V3f");
+    testTransformT<double, double> ("M44d, V3d");
+    testTransformT<double, float> ("M44d, V3f");
+    testTransformT<float, double> ("M44f, V3d");
+
+    testMultiplyT<float> ("M44f");
+    testMultiplyT<double> ("M44d");
+
+    testDecomposeT<float> ("M44f");
+    testDecomposeT<double> ("M44d");
+
+    cout << "ok\n" << endl;
+}
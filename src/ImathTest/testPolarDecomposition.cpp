@@ -0,0 +1,262 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include "testUtil.h"
+#include <ImathMatrixAlgo.h>
+#include <ImathMatrixBatch.h>
+#include <ImathRandom.h>
+#include <assert.h>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+//
+// A random symmetric positive definite stretch with eigenvalues
+// between 1 and cond.
+//
+
+template <typename T>
+Matrix33<T>
+randomStretch (Rand48& rand, double cond)
+{
+    const M33d Q = M33d (randomRotation<T> (rand).toMatrix33 ());
+    M33d       D;
+    D[0][0] = 1;
+    D[1][1] = rand.nextf (1, cond);
+    D[2][2] = cond;
+    return Matrix33<T> (Q.transposed () * D * Q);
+}
+
+//
+// Check that R is a rotation, S is symmetric, and S * R reproduces A.
+//
+
+template <typename T>
+void
+verifyPolar (
+    const Matrix33<T>& A, const Matrix33<T>& R, const Matrix33<T>& S, T tol)
+{
+    const T eps = tol * std::numeric_limits<T>::epsilon ();
+
+    assert (maxDiff (R * R.transposed (), Matrix33<T> ()) < eps);
+    assert (std::abs (R.determinant () - 1) < eps);
+    assert (S == S.transposed ());
+
+    T scale = 1;
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            scale = std::max (scale, std::abs (A[i][j]));
+
+    assert (maxDiff (S * R, A) < eps * scale);
+}
+
+template <typename T>
+void
+testPolarDecompositionImp ()
+{
+    const T eps = std::numeric_limits<T>::epsilon ();
+    Rand48  rand (17);
+
+    //
+    // Rotations and stretches are recovered, with the stretch positive
+    // definite; the rotation matches the one from the SVD.
+    //
+
+    for (int k = 0; k < 1000; ++k)
+    {
+        const double      cond = k < 500 ? 10 : 1000;
+        const Matrix33<T> Q    = randomRotation<T> (rand).toMatrix33 ();
+        const Matrix33<T> P    = randomStretch<T> (rand, cond);
+        const Matrix33<T> A    = P * Q;
+
+        Matrix33<T> R, S;
+        assert (polarDecomposition (A, R, S));
+        verifyPolar (A, R, S, T (100 * cond));
+        assert (maxDiff (R, Q) < T (100 * cond) * eps);
+
+        Matrix33<T> U, V;
+        Vec3<T>     s;
+        jacobiSVD (A, U, s, V, eps, true);
+        assert (maxDiff (R, U * V.transposed ()) < T (100 * cond) * eps);
+
+        Vec3<T>     e;
+        Matrix33<T> W, SS = S;
+        jacobiEigenSolver (SS, e, W);
+        assert (e.x > 0 && e.y > 0 && e.z > 0);
+
+        // The fixed iteration count suffices for moderate conditioning:
+        Matrix33<T> FR, FS;
+        assert (fastPolarDecomposition (A, FR, FS));
+        if (cond <= 100) verifyPolar (A, FR, FS, T (100 * cond));
+
+        // One iteration is not enough:
+        fastPolarDecomposition (A, FR, FS, 1);
+        assert (maxDiff (FR, R) > T (1e-3));
+    }
+
+    //
+    // A rotation is its own rotation, with a unit stretch
+    //
+
+    {
+        const Matrix33<T> Q = randomRotation<T> (rand).toMatrix33 ();
+        Matrix33<T>       R, S;
+        assert (polarDecomposition (Q, R, S));
+        assert (maxDiff (R, Q) < 4 * eps);
+        assert (maxDiff (S, Matrix33<T> ()) < 4 * eps);
+    }
+
+    //
+    // A negative determinant yields a rotation and a negative definite
+    // stretch.
+    //
+
+    {
+        const Matrix33<T> Q = randomRotation<T> (rand).toMatrix33 ();
+        const Matrix33<T> P = randomStretch<T> (rand, 5);
+        const Matrix33<T> A = P * Matrix33<T> ().scale (Vec2<T> (1, -1)) * Q;
+
+        Matrix33<T> R, S;
+        assert (A.determinant () < 0);
+        assert (polarDecomposition (A, R, S));
+        verifyPolar (A, R, S, T (500));
+
+        Vec3<T>     e;
+        Matrix33<T> W, SS = S;
+        jacobiEigenSolver (SS, e, W);
+        assert (e.x < 0 && e.y < 0 && e.z < 0);
+    }
+
+    //
+    // Singular matrices cannot be decomposed
+    //
+
+    {
+        const Matrix33<T> A (1, 2, 3, 4, 5, 6, 2, 4, 6);
+        Matrix33<T>       R, S;
+        assert (!polarDecomposition (A, R, S));
+        assert (!fastPolarDecomposition (A, R, S));
+        assert (!polarDecomposition (Matrix33<T> (T (0)), R, S));
+    }
+
+    //
+    // 4x4 matrices decompose their upper left 3x3 block
+    //
+
+    {
+        const Matrix33<T> Q = randomRotation<T> (rand).toMatrix33 ();
+        const Matrix33<T> P = randomStretch<T> (rand, 5);
+        const Matrix33<T> A = P * Q;
+
+        Matrix44<T> A4;
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j)
+                A4[i][j] = A[i][j];
+        A4.translate (Vec3<T> (1, 2, 3));
+
+        Matrix33<T> R, S;
+        Matrix44<T> R4, S4;
+        assert (polarDecomposition (A, R, S));
+        assert (polarDecomposition (A4, R4, S4));
+
+        for (int i = 0; i < 4; ++i)
+            for (int j = 0; j < 4; ++j)
+            {
+                const T r = i < 3 && j < 3 ? R[i][j] : T (i == j);
+                const T s = i < 3 && j < 3 ? S[i][j] : T (i == j);
+                assert (R4[i][j] == r && S4[i][j] == s);
+            }
+
+        assert (fastPolarDecomposition (A, R, S));
+        assert (fastPolarDecomposition (A4, R4, S4));
+        assert (R4[1][2] == R[1][2] && S4[2][0] == S[2][0]);
+    }
+}
+
+template <typename T>
+void
+testBatchedPolarDecompositionImp ()
+{
+    Rand48 rand (29);
+
+    std::vector<Matrix33<T>> A;
+
+    A.push_back (Matrix33<T> ());
+    A.push_back (Matrix33<T> (T (0)));
+    A.push_back (Matrix33<T> (1, 2, 3, 4, 5, 6, 7, 8, 9));
+    A.push_back (Matrix33<T> (2, 0, 0, 0, -3, 0, 0, 0, 4));
+
+    for (int k = 0; k < 1000; ++k)
+    {
+        const double cond = k % 2 ? 10 : 1e4;
+        Matrix33<T>  M    = randomStretch<T> (rand, cond);
+
+        M = M * randomRotation<T> (rand).toMatrix33 ();
+
+        if (k % 3 == 0) M = -M;
+
+        A.push_back (M);
+    }
+
+    const size_t             n = A.size ();
+    std::vector<Matrix33<T>> R (n), S (n);
+    std::vector<bool>        expected (n);
+    bool                     ok[2000];
+
+    for (int fast = 0; fast < 2; ++fast)
+    {
+        bool all = fast ? fastPolarDecomposition (
+                              A.data (), R.data (), S.data (), n, ok)
+                        : polarDecomposition (
+                              A.data (), R.data (), S.data (), n, ok);
+        assert (!all);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            Matrix33<T> RR, SS;
+            const bool  good = fast ? fastPolarDecomposition (A[i], RR, SS)
+                                    : polarDecomposition (A[i], RR, SS);
+
+            assert (ok[i] == good);
+            assert (good == (i != 1 && i != 2));
+
+#if defined(__FMA__) || defined(__aarch64__)
+            if (good && !fast) verifyPolar (A[i], R[i], S[i], T (1e5));
+#else
+            assert (R[i] == RR && S[i] == SS);
+#endif
+        }
+    }
+
+    // Without the failure flags:
+    assert (polarDecomposition (A.data () + 3, R.data (), S.data (), n - 3, 0));
+}
+
+} // namespace
+
+void
+testPolarDecomposition ()
+{
+    cout << "Testing polar decomposition in single precision..." << endl;
+    testPolarDecompositionImp<float> ();
+    testBatchedPolarDecompositionImp<float> ();
+
+    cout << "Testing polar decomposition in double precision..." << endl;
+    testPolarDecompositionImp<double> ();
+    testBatchedPolarDecompositionImp<double> ();
+
+    cout << "ok\n" << endl;
+}
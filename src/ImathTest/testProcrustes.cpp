@@ -10,6 +10,7 @@
 #include <ImathEuler.h>
 #include <ImathMatrixAlgo.h>
 #include <ImathRandom.h>
+#include <algorithm>
 #include <assert.h>
 #include <cmath>
 #include <iostream>
@@ -409,14 +410,131 @@ testProcrustesImp ()
     testProcrustesWithMatrix<T> (m);
 }
 
+bool
+sameTransform (
+    const IMATH_INTERNAL_NAMESPACE::M44d& a,
+    const IMATH_INTERNAL_NAMESPACE::M44d& b)
+{
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 4; ++j)
+            if (std::abs (a[i][j] - b[i][j]) > 1e-9 * (1 + std::abs (a[i][j])))
+                return false;
+    return true;
+}
+
+template <typename T>
+void
+testProcrustesAccumulatorImp ()
+{
+    std::cout << "Testing streaming Procrustes accumulation\n";
+
+    typedef IMATH_INTERNAL_NAMESPACE::Vec3<T> Vec;
+    using IMATH_INTERNAL_NAMESPACE::M44d;
+    using IMATH_INTERNAL_NAMESPACE::ParallelBuild;
+    using IMATH_INTERNAL_NAMESPACE::ProcrustesAccumulator;
+
+    // Empty and zero-weight accumulators give the identity:
+    ProcrustesAccumulator empty;
+    assert (empty.transform () == M44d ());
+    assert (empty.transform (true) == M44d ());
+
+    const Vec origin (0);
+    const T   zero (0);
+    empty.add (&origin, &origin, &zero, 1);
+    assert (empty.numPoints () == 1 && empty.weight () == 0);
+    assert (empty.transform (true) == M44d ());
+
+    // A noisy, scaled rigid transform of a point cloud:
+    M44d m;
+    m.translate (IMATH_INTERNAL_NAMESPACE::V3d (4.0, -2.0, 7.5));
+    m.rotate (IMATH_INTERNAL_NAMESPACE::V3d (0.3, -1.2, 2.1));
+    m.scale (IMATH_INTERNAL_NAMESPACE::V3d (1.7));
+
+    IMATH_INTERNAL_NAMESPACE::Rand48 random (2718);
+    const size_t                     n = 50000;
+    std::vector<Vec>                 from (n);
+    std::vector<Vec>                 to (n);
+    std::vector<T>                   weights (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const IMATH_INTERNAL_NAMESPACE::V3d p (
+            random.nextf (-10, 10),
+            random.nextf (-10, 10),
+            random.nextf (-10, 10));
+        const IMATH_INTERNAL_NAMESPACE::V3d noise (
+            random.nextf (-0.1, 0.1),
+            random.nextf (-0.1, 0.1),
+            random.nextf (-0.1, 0.1));
+        from[i]    = Vec (p);
+        to[i]      = Vec (p * m + noise);
+        weights[i] = T (random.nextf (0.1, 2.0));
+    }
+
+    for (int weighted = 0; weighted < 2; ++weighted)
+    {
+        const T* w = weighted ? &weights[0] : 0;
+
+        for (int doScale = 0; doScale < 2; ++doScale)
+        {
+            const M44d expected = procrustesRotationAndTranslation (
+                &from[0], &to[0], w, n, doScale != 0);
+
+            // All at once:
+            ProcrustesAccumulator whole;
+            whole.add (&from[0], &to[0], w, n);
+            assert (whole.numPoints () == n);
+            assert (sameTransform (whole.transform (doScale != 0), expected));
+
+            // In uneven chunks, including one of a single point:
+            ProcrustesAccumulator chunked;
+            for (size_t b = 0; b < n;)
+            {
+                const size_t e = std::min (n, b + (b == 0 ? 1 : 7919));
+                chunked.add (&from[b], &to[b], w ? w + b : 0, e - b);
+                b = e;
+            }
+            assert (chunked.numPoints () == n);
+            assert (sameTransform (
+                chunked.transform (doScale != 0), expected));
+
+            // Two parts accumulated separately, then merged:
+            ProcrustesAccumulator first, second;
+            first.add (&from[0], &to[0], w, n / 3);
+            second.add (
+                &from[n / 3], &to[n / 3], w ? w + n / 3 : 0, n - n / 3);
+            first.merge (second);
+            assert (first.numPoints () == n);
+            assert (sameTransform (first.transform (doScale != 0), expected));
+
+            // Split across threads:
+            ProcrustesAccumulator threaded;
+            threaded.add (&from[0], &to[0], w, n, ParallelBuild (4));
+            assert (threaded.numPoints () == n);
+            assert (std::abs (threaded.weight () - whole.weight ()) <
+                    1e-9 * whole.weight ());
+            assert (sameTransform (
+                threaded.transform (doScale != 0), expected));
+
+            threaded.clear ();
+            assert (threaded.numPoints () == 0);
+            assert (threaded.transform () == M44d ());
+        }
+    }
+
+    std::cout << "  OK\n";
+}
+
 void
 testProcrustes ()
 {
     std::cout << "Testing Procrustes algorithms in single precision..."
               << std::endl;
     testProcrustesImp<float> ();
+    testProcrustesAccumulatorImp<float> ();
 
     std::cout << "Testing Procrustes algorithms in double precision..."
               << std::endl;
     testProcrustesImp<double> ();
+    testProcrustesAccumulatorImp<double> ();
 }
@@ -0,0 +1,447 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include "testQuatArray.h"
+#include "testUtil.h"
+#include <ImathMatrixBatch.h>
+#include <ImathQuatArray.h>
+#include <ImathRandom.h>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+//
+// Pairs of unit quaternions: random, nearly equal, equal, nearly
+// opposite and opposite.
+//
+
+template <class T>
+void
+randomPairs (
+    Rand48& rand, size_t n, std::vector<Quat<T>>& a, std::vector<Quat<T>>& b)
+{
+    a.resize (n);
+    b.resize (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        a[i] = randomRotation<T> (rand);
+
+        switch (i % 8)
+        {
+            case 0: b[i] = a[i]; break;
+            case 1: b[i] = -a[i]; break;
+            case 2:
+                b[i] =
+                    (a[i] + T (1e-3) * randomRotation<T> (rand)).normalize ();
+                break;
+            case 3:
+                b[i] =
+                    (T (1e-3) * randomRotation<T> (rand) - a[i]).normalize ();
+                break;
+            default: b[i] = randomRotation<T> (rand); break;
+        }
+    }
+}
+
+template <class T>
+void
+testQuatArrayBasics ()
+{
+    Rand48               rand (7);
+    std::vector<Quat<T>> q (100);
+
+    for (size_t i = 0; i < q.size (); ++i)
+        q[i] = randomRotation<T> (rand);
+
+    QuatArray<T> a (q);
+    assert (a.size () == q.size ());
+
+    for (size_t i = 0; i < q.size (); ++i)
+    {
+        assert (a[i] == q[i]);
+        assert (a.r ()[i] == q[i].r && a.x ()[i] == q[i].v.x);
+        assert (a.y ()[i] == q[i].v.y && a.z ()[i] == q[i].v.z);
+    }
+
+    assert (a.toVector () == q);
+
+    a.set (5, Quat<T> (1, 2, 3, 4));
+    assert (a[5] == Quat<T> (1, 2, 3, 4));
+
+    QuatArray<T> b (q.data (), 10);
+    assert (b.size () == 10 && b[9] == q[9]);
+}
+
+template <class T>
+void
+testNlerp ()
+{
+    Rand48               rand (11);
+    std::vector<Quat<T>> a, b;
+    std::vector<T>       t (1000);
+
+    randomPairs (rand, t.size (), a, b);
+
+    for (size_t i = 0; i < t.size (); ++i)
+        t[i] = T (rand.nextf ());
+
+    const QuatArray<T> qa (a), qb (b);
+    QuatArray<T>       r;
+
+    nlerp (qa, qb, t.data (), r);
+    assert (r.size () == a.size ());
+
+    const T eps = 8 * std::numeric_limits<T>::epsilon ();
+
+    for (size_t i = 0; i < t.size (); ++i)
+    {
+        const Quat<T> bb = (a[i] ^ b[i]) < 0 ? -b[i] : b[i];
+        const Quat<T> e  = (a[i] * (1 - t[i]) + bb * t[i]).normalize ();
+
+        assert (maxDiff (r[i], e) < eps);
+        assert (std::abs (r[i].length () - 1) < eps);
+
+        //
+        // The rotation is within the documented angle of slerp, at most
+        // 8.2 degrees.
+        //
+
+        const Quat<T> s = slerpShortestArc (a[i], b[i], t[i]);
+        const T       d = std::min (T (1), std::abs (r[i] ^ s));
+        assert (2 * std::acos (d) < T (8.2 * M_PI / 180));
+    }
+
+    // A single parameter, in place:
+    QuatArray<T> ra (qa);
+    nlerp (ra, qb, T (0.25), ra);
+
+    for (size_t i = 0; i < t.size (); ++i)
+    {
+        const Quat<T> bb = (a[i] ^ b[i]) < 0 ? -b[i] : b[i];
+        const Quat<T> e  = (a[i] * T (0.75) + bb * T (0.25)).normalize ();
+        assert (maxDiff (ra[i], e) < eps);
+    }
+}
+
+template <class T>
+void
+testFastSlerp ()
+{
+    Rand48               rand (13);
+    std::vector<Quat<T>> a, b;
+    std::vector<T>       t (10000);
+
+    randomPairs (rand, t.size (), a, b);
+
+    for (size_t i = 0; i < t.size (); ++i)
+        t[i] = i % 5 == 0 ? T (i % 2) : T (rand.nextf ());
+
+    const QuatArray<T> qa (a), qb (b);
+    QuatArray<T>       r;
+
+    fastSlerp (qa, qb, t.data (), r);
+
+    T maxErr = 0;
+    T maxLen = 0;
+
+    for (size_t i = 0; i < t.size (); ++i)
+    {
+        const Quat<T> e = slerpShortestArc (a[i], b[i], t[i]);
+        maxErr          = std::max (maxErr, maxDiff (r[i], e));
+        maxLen = std::max (maxLen, std::abs (r[i].length () - 1));
+    }
+
+    const T bound = T (1.5e-6) + 8 * std::numeric_limits<T>::epsilon ();
+    assert (maxErr < bound);
+    assert (maxLen < bound);
+
+    // The endpoints are exact:
+    QuatArray<T> r0, r1;
+    fastSlerp (qa, qb, T (0), r0);
+    fastSlerp (qa, qb, T (1), r1);
+
+    for (size_t i = 0; i < t.size (); ++i)
+    {
+        assert (r0[i] == a[i]);
+        assert (r1[i] == ((a[i] ^ b[i]) < 0 ? -b[i] : b[i]));
+    }
+
+    // A single parameter, in place:
+    QuatArray<T> ra (qa);
+    fastSlerp (ra, qb, T (0.3), ra);
+
+    for (size_t i = 0; i < t.size (); ++i)
+        assert (
+            maxDiff (ra[i], slerpShortestArc (a[i], b[i], T (0.3))) <= maxErr);
+}
+
+//
+// Keys of smooth rotation sequences: each track turns about a random,
+// slowly drifting axis, with the signs of consecutive keys chosen to
+// keep them in the same hemisphere.
+//
+
+template <class T>
+void
+testSquad ()
+{
+    Rand48       rand (17);
+    const size_t n = 1000;
+
+    std::vector<Quat<T>> keys[4];
+    std::vector<T>       t (n);
+
+    for (int k = 0; k < 4; ++k)
+        keys[k].resize (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Vec3<T> axis (
+            T (rand.nextf (-1, 1)),
+            T (rand.nextf (-1, 1)),
+            T (rand.nextf (-1, 1)));
+        T angle = T (rand.nextf (-M_PI, M_PI));
+        T step  = T (rand.nextf (0.1, 1.2));
+
+        for (int k = 0; k < 4; ++k)
+        {
+            Quat<T> q;
+            q.setAxisAngle (axis.normalized (), angle + k * step);
+
+            if (k > 0 && (q ^ keys[k - 1][i]) < 0) q = -q;
+
+            keys[k][i] = q;
+            axis += Vec3<T> (T (0.1), T (-0.05), T (0.02));
+        }
+
+        t[i] = T (rand.nextf ());
+    }
+
+    const QuatArray<T> q0 (keys[0]), q1 (keys[1]), q2 (keys[2]), q3 (keys[3]);
+    QuatArray<T>       qa, qb, r;
+
+    intermediate (q0, q1, q2, qa);
+    intermediate (q1, q2, q3, qb);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        assert (qa[i] == intermediate (keys[0][i], keys[1][i], keys[2][i]));
+        assert (qb[i] == intermediate (keys[1][i], keys[2][i], keys[3][i]));
+    }
+
+    const T bound = T (5e-6) + 16 * std::numeric_limits<T>::epsilon ();
+
+    squad (q1, qa, qb, q2, t.data (), r);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const Quat<T> e = squad (keys[1][i], qa[i], qb[i], keys[2][i], t[i]);
+        assert (maxDiff (r[i], e) < bound);
+    }
+
+    squad (q1, qa, qb, q2, T (0.6), r);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const Quat<T> e =
+            squad (keys[1][i], qa[i], qb[i], keys[2][i], T (0.6));
+        assert (maxDiff (r[i], e) < bound);
+    }
+
+    spline (q0, q1, q2, q3, t.data (), r);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const Quat<T> e =
+            spline (keys[0][i], keys[1][i], keys[2][i], keys[3][i], t[i]);
+        assert (maxDiff (r[i], e) < bound);
+    }
+
+    spline (q0, q1, q2, q3, T (0.1), r);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const Quat<T> e =
+            spline (keys[0][i], keys[1][i], keys[2][i], keys[3][i], T (0.1));
+        assert (maxDiff (r[i], e) < bound);
+    }
+}
+
+//
+// Unit quaternions for the matrix conversions: random ones, and ones
+// whose matrices make extractQuat() pivot on each component in turn,
+// including half turns about the axes and the diagonals between them.
+//
+
+template <class T>
+std::vector<Quat<T>>
+conversionQuats (Rand48& rand, size_t n)
+{
+    const T              h = T (std::sqrt (0.5));
+    std::vector<Quat<T>> q;
+
+    q.push_back (Quat<T> ());
+    q.push_back (Quat<T> (0, 1, 0, 0));
+    q.push_back (Quat<T> (0, 0, 1, 0));
+    q.push_back (Quat<T> (0, 0, 0, 1));
+    q.push_back (Quat<T> (0, h, h, 0));
+    q.push_back (Quat<T> (0, 0, h, h));
+    q.push_back (Quat<T> (0, h, 0, h));
+    q.push_back (Quat<T> (h, 0, 0, h));
+    q.push_back (Quat<T> (-h, 0, h, 0));
+
+    while (q.size () < n)
+    {
+        Quat<T> r = randomRotation<T> (rand);
+
+        // Make r or one component of v dominate
+        switch (q.size () % 5)
+        {
+            case 0: r.r *= 8; break;
+            case 1: r.v.x *= 8; break;
+            case 2: r.v.y *= 8; break;
+            case 3: r.v.z *= 8; break;
+            default: break;
+        }
+
+        q.push_back (r.normalize ());
+    }
+
+    return q;
+}
+
+template <class T>
+bool
+sameMatrix (const Matrix44<T>& a, const Matrix44<T>& b)
+{
+#if defined(__FMA__) || defined(__aarch64__)
+    // Quat::toMatrix44() may be compiled with fused multiply-adds
+    return a.equalWithAbsError (b, 4 * std::numeric_limits<T>::epsilon ());
+#else
+    return a == b;
+#endif
+}
+
+template <class T>
+void
+testMatrixConversion ()
+{
+    Rand48                     rand (23);
+    const std::vector<Quat<T>> q  = conversionQuats<T> (rand, 1000);
+    const size_t               n  = q.size ();
+    const QuatArray<T>         qa (q);
+
+    // Quaternions to matrices
+    Matrix44Array<T>         ma;
+    std::vector<Matrix44<T>> m44 (n);
+    std::vector<Matrix33<T>> m33 (n);
+
+    toMatrix44 (qa, ma);
+    toMatrix44 (qa, m44.data ());
+    toMatrix33 (qa, m33.data ());
+
+    assert (ma.size () == n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const Matrix44<T> e = q[i].toMatrix44 ();
+        const Matrix33<T> f = q[i].toMatrix33 ();
+
+        assert (sameMatrix (ma[i], e));
+        assert (m44[i] == ma[i]);
+
+        for (int r = 0; r < 3; ++r)
+            for (int c = 0; c < 3; ++c)
+                assert (m33[i][r][c] == ma[i][r][c]);
+
+        assert (sameMatrix (Matrix44<T> (f, Vec3<T> (0)), e));
+    }
+
+    // Matrices to quaternions, with the same results as extractQuat()
+    // and, up to sign, the original quaternions
+    QuatArray<T> ra, r44, r33;
+
+    extractQuat (ma, ra);
+    extractQuat (m44.data (), n, r44);
+    extractQuat (m33.data (), n, r33);
+
+    assert (ra.size () == n && r44.size () == n && r33.size () == n);
+
+    const T eps = 8 * std::numeric_limits<T>::epsilon ();
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const Matrix44<T> m = ma[i];
+        const Quat<T>     e = extractQuat (m);
+
+        assert (ra[i] == e);
+        assert (r44[i] == e);
+        assert (r33[i] == e);
+        assert (std::min (maxDiff (e, q[i]), maxDiff (e, -q[i])) < eps);
+    }
+
+    // Matrices with translation, scaling and projection, whose upper-left
+    // 3x3 blocks are not rotations
+    for (size_t i = 0; i < n; ++i)
+    {
+        Matrix44<T>& m = m44[i];
+        m[3][0] = T (rand.nextf (-10, 10));
+        m[0][3] = T (rand.nextf (-1, 1));
+        m[1][1] *= T (rand.nextf (0.5, 2));
+        ma.set (i, m);
+    }
+
+    extractQuat (ma, ra);
+    extractQuat (m44.data (), n, r44);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const Quat<T> e = extractQuat (m44[i]);
+        assert (ra[i] == e && r44[i] == e);
+    }
+
+    // Empty arrays
+    QuatArray<T>     q0;
+    Matrix44Array<T> m0 (3);
+
+    toMatrix44 (q0, m0);
+    extractQuat (m0, ra);
+    assert (m0.size () == 0 && ra.size () == 0);
+}
+
+} // namespace
+
+void
+testQuatArray ()
+{
+    cout << "Testing QuatArray in single precision" << endl;
+    testQuatArrayBasics<float> ();
+    testNlerp<float> ();
+    testFastSlerp<float> ();
+    testSquad<float> ();
+    testMatrixConversion<float> ();
+
+    cout << "Testing QuatArray in double precision" << endl;
+    testQuatArrayBasics<double> ();
+    testNlerp<double> ();
+    testFastSlerp<double> ();
+    testSquad<double> ();
+    testMatrixConversion<double> ();
+
+    cout << "ok\n" << endl;
+}
@@ -8,11 +8,14 @@
 #endif
 
 #include <ImathMatrixAlgo.h>
+#include <ImathMatrixBatch.h>
+#include <ImathRandom.h>
 #include <algorithm>
 #include <assert.h>
 #include <cmath>
 #include <iostream>
 #include <limits>
+#include <vector>
 
 template <typename T>
 void
@@ -54,7 +57,13 @@ verifyOrthonormal (const IMATH_INTERNAL_NAMESPACE::Matrix44<T>& A)
 
 template <typename T>
 void
-verifyTinySVD_3x3 (const IMATH_INTERNAL_NAMESPACE::Matrix33<T>& A)
+verifySVD_3x3 (
+    const IMATH_INTERNAL_NAMESPACE::Matrix33<T>& A,
+    const IMATH_INTERNAL_NAMESPACE::Matrix33<T>& U,
+    const IMATH_INTERNAL_NAMESPACE::Vec3<T>&     S,
+    const IMATH_INTERNAL_NAMESPACE::Matrix33<T>& V,
+    const bool                                   posDet,
+    const T                                      relTol = 10)
 {
     T maxEntry = 0;
     for (int i = 0; i < 3; ++i)
@@ -62,47 +71,56 @@ verifyTinySVD_3x3 (const IMATH_INTERNAL_NAMESPACE::Matrix33<T>& A)
             maxEntry = std::max (maxEntry, std::abs (A[i][j]));
 
     const T eps      = std::numeric_limits<T>::epsilon ();
-    const T valueEps = maxEntry * T (10) * eps;
+    const T valueEps = maxEntry * relTol * eps;
 
-    for (int i = 0; i < 2; ++i)
+    IMATH_INTERNAL_NAMESPACE::Matrix33<T> S_times_Vt;
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            S_times_Vt[i][j] = S[j] * V[i][j];
+    S_times_Vt.transpose ();
+
+    // Verify that the product of the matrices is A:
+    const IMATH_INTERNAL_NAMESPACE::Matrix33<T> product = U * S_times_Vt;
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            assert (std::abs (product[i][j] - A[i][j]) <= valueEps);
+
+    // Verify that U and V are orthogonal:
+    if (posDet)
     {
-        const bool posDet = (i == 0);
+        assert (U.determinant () > 0.9);
+        assert (V.determinant () > 0.9);
+    }
 
-        IMATH_INTERNAL_NAMESPACE::Matrix33<T> U, V;
-        IMATH_INTERNAL_NAMESPACE::Vec3<T>     S;
-        IMATH_INTERNAL_NAMESPACE::jacobiSVD (A, U, S, V, eps, posDet);
+    // Verify that the singular values are sorted:
+    for (int i = 0; i < 2; ++i)
+        assert (S[i] >= S[i + 1]);
 
-        IMATH_INTERNAL_NAMESPACE::Matrix33<T> S_times_Vt;
-        for (int i = 0; i < 3; ++i)
-            for (int j = 0; j < 3; ++j)
-                S_times_Vt[i][j] = S[j] * V[i][j];
-        S_times_Vt.transpose ();
+    // Verify that all the SVs except maybe the last one are positive:
+    for (int i = 0; i < 2; ++i)
+        assert (S[i] >= T (0));
 
-        // Verify that the product of the matrices is A:
-        const IMATH_INTERNAL_NAMESPACE::Matrix33<T> product = U * S_times_Vt;
-        for (int i = 0; i < 3; ++i)
-            for (int j = 0; j < 3; ++j)
-                assert (std::abs (product[i][j] - A[i][j]) <= valueEps);
+    if (!posDet) assert (S[2] >= T (0));
 
-        // Verify that U and V are orthogonal:
-        if (posDet)
-        {
-            assert (U.determinant () > 0.9);
-            assert (V.determinant () > 0.9);
-        }
+    verifyOrthonormal (U);
+    verifyOrthonormal (V);
+}
 
-        // Verify that the singular values are sorted:
-        for (int i = 0; i < 2; ++i)
-            assert (S[i] >= S[i + 1]);
+template <typename T>
+void
+verifyTinySVD_3x3 (const IMATH_INTERNAL_NAMESPACE::Matrix33<T>& A)
+{
+    const T eps = std::numeric_limits<T>::epsilon ();
 
-        // Verify that all the SVs except maybe the last one are positive:
-        for (int i = 0; i < 2; ++i)
-            assert (S[i] >= T (0));
+    for (int i = 0; i < 2; ++i)
+    {
+        const bool posDet = (i == 0);
 
-        if (!posDet) assert (S[2] >= T (0));
+        IMATH_INTERNAL_NAMESPACE::Matrix33<T> U, V;
+        IMATH_INTERNAL_NAMESPACE::Vec3<T>     S;
+        IMATH_INTERNAL_NAMESPACE::jacobiSVD (A, U, S, V, eps, posDet);
 
-        verifyOrthonormal (U);
-        verifyOrthonormal (V);
+        verifySVD_3x3 (A, U, S, V, posDet);
     }
 }
 
@@ -387,6 +405,70 @@ testTinySVDImp ()
             IMATH_INTERNAL_NAMESPACE::Vec4<T> (1, 2, 3, 3)));
 }
 
+// The batched SVD applies the same rotations as the scalar one, so the
+// results are identical, unless the compiler contracts operations into
+// fused multiply-adds differently in the two versions. In that case,
+// verify the decompositions with a tolerance that also suits the scalar
+// version on random matrices.
+template <typename T>
+void
+testBatchedSVD_3x3 ()
+{
+    std::vector<IMATH_INTERNAL_NAMESPACE::Matrix33<T>> A;
+
+    A.push_back (IMATH_INTERNAL_NAMESPACE::Matrix33<T> ());
+    A.push_back (IMATH_INTERNAL_NAMESPACE::Matrix33<T> (T (0)));
+    A.push_back (IMATH_INTERNAL_NAMESPACE::Matrix33<T> (
+        1, 0, 0, T (1e-10), 0, 0, 0, 0, 100000));
+    A.push_back (IMATH_INTERNAL_NAMESPACE::Matrix33<T> (
+        1, 2, 3, 4, 5, 6, 7, 8, 9));
+
+    IMATH_INTERNAL_NAMESPACE::Rand48 rand (5);
+
+    for (int k = 0; k < 1000; ++k)
+    {
+        IMATH_INTERNAL_NAMESPACE::Matrix33<T> M;
+
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j)
+                M[i][j] = T (rand.nextf (-1, 1));
+
+        // Some rank-deficient matrices
+        if (k % 6 == 0)
+            for (int j = 0; j < 3; ++j)
+                M[2][j] = M[0][j] + M[1][j];
+
+        A.push_back (M);
+    }
+
+    const size_t                                       n = A.size ();
+    std::vector<IMATH_INTERNAL_NAMESPACE::Matrix33<T>> U (n), V (n);
+    std::vector<IMATH_INTERNAL_NAMESPACE::Vec3<T>>     S (n);
+
+    const T eps = std::numeric_limits<T>::epsilon ();
+
+    for (int k = 0; k < 2; ++k)
+    {
+        const bool posDet = (k == 0);
+
+        IMATH_INTERNAL_NAMESPACE::jacobiSVD (
+            A.data (), U.data (), S.data (), V.data (), n, eps, posDet);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            IMATH_INTERNAL_NAMESPACE::Matrix33<T> UU, VV;
+            IMATH_INTERNAL_NAMESPACE::Vec3<T>     SS;
+            IMATH_INTERNAL_NAMESPACE::jacobiSVD (A[i], UU, SS, VV, eps, posDet);
+
+#if defined(__FMA__) || defined(__aarch64__)
+            verifySVD_3x3 (A[i], U[i], S[i], V[i], posDet, T (100));
+#else
+            assert (U[i] == UU && S[i] == SS && V[i] == VV);
+#endif
+        }
+    }
+}
+
 void
 testTinySVD ()
 {
@@ -397,4 +479,10 @@ testTinySVD ()
     std::cout << "Testing TinySVD algorithms in double precision..."
               << std::endl;
     testTinySVDImp<double> ();
+
+    std::cout << "Testing batched TinySVD in single precision..." << std::endl;
+    testBatchedSVD_3x3<float> ();
+
+    std::cout << "Testing batched TinySVD in double precision..." << std::endl;
+    testBatchedSVD_3x3<double> ();
 }
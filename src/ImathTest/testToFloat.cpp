@@ -12,6 +12,8 @@
 #include <half.h>
 #include <iomanip>
 #include <iostream>
+#include <limits>
+#include <vector>
 
 using namespace std;
 
@@ -132,6 +134,15 @@ testToFloat ()
         half::uif uif;
         uif.i = halfToFloat (s);
 
+        //
+        // The compact tables must reproduce the full table exactly,
+        // including NaN payloads.
+        //
+
+        half::uif compact;
+        compact.f = imath_half_to_float_compact (s);
+        assert (compact.i == uif.i);
+
         //
         // Equality operators fail for inf and nan, so handle them
         // specially.
@@ -155,3 +166,213 @@ testToFloat ()
 
     std::cout << "ok" << std::endl;
 }
+
+void
+testBulkConversion ()
+{
+    std::cout << "running testBulkConversion using "
+              << imath_half_conversion_method () << std::endl;
+
+    //
+    // Every half, converted in one call, must match the scalar
+    // conversion bit for bit, including NaN payloads.
+    //
+
+    constexpr int iMax = (1 << 16);
+
+    std::vector<half>  hs (iMax);
+    std::vector<float> fs (iMax);
+
+    for (int i = 0; i < iMax; i++)
+        hs[i].setBits (static_cast<unsigned short> (i));
+
+    halfToFloat (hs.data (), fs.data (), hs.size ());
+
+    for (int i = 0; i < iMax; i++)
+    {
+        half::uif expected, actual, dispatched;
+        expected.f   = imath_half_to_float_bitshift (hs[i].bits ());
+        actual.f     = fs[i];
+        dispatched.f = imath_half_to_float_dispatch (hs[i].bits ());
+        assert (expected.i == actual.i);
+        assert (expected.i == dispatched.i);
+    }
+
+    //
+    // Convert every float produced above back to half, plus a
+    // selection of floats that are not exactly representable: values
+    // halfway between halfs, values that overflow or underflow, float
+    // denormals and signalling NaNs.
+    //
+
+    std::vector<float> floats (fs);
+
+    for (unsigned int i = 0; i < 0xffffffffu - 997u; i += 997u)
+    {
+        half::uif x;
+        x.i = i;
+        floats.push_back (x.f);
+    }
+
+    for (int i = 0; i < iMax; i++)
+    {
+        half::uif x;
+        x.f = fs[i];
+        x.i += 0x1000;
+        floats.push_back (x.f);
+    }
+
+    std::vector<half> hs2 (floats.size ());
+    floatToHalf (floats.data (), hs2.data (), floats.size ());
+
+    for (size_t i = 0; i < floats.size (); i++)
+    {
+        assert (hs2[i].bits () == imath_float_to_half_bitshift (floats[i]));
+        assert (hs2[i].bits () == imath_float_to_half_dispatch (floats[i]));
+    }
+
+    //
+    // Lengths that do not fill a whole vector must leave the rest of
+    // the destination untouched.
+    //
+
+    for (size_t n = 0; n < 40; n++)
+    {
+        std::vector<float> dst (48, 42.0f);
+        halfToFloat (hs.data () + 0x3c00, dst.data (), n);
+
+        for (size_t i = 0; i < n; i++)
+            assert (dst[i] == float (hs[0x3c00 + i]));
+        for (size_t i = n; i < dst.size (); i++)
+            assert (dst[i] == 42.0f);
+
+        std::vector<half> hdst (48, half (42.0f));
+        floatToHalf (dst.data (), hdst.data (), n);
+
+        for (size_t i = 0; i < n; i++)
+            assert (hdst[i].bits () == hs[0x3c00 + i].bits ());
+        for (size_t i = n; i < hdst.size (); i++)
+            assert (hdst[i] == 42.0f);
+    }
+
+    std::cout << "ok" << std::endl;
+}
+
+namespace
+{
+
+//
+// Reference float-to-half conversion for the bulk rounding modes,
+// derived from the round-to-nearest-even conversion: whenever that
+// rounded away from zero, the truncated result is the next half
+// toward zero.
+//
+
+unsigned short
+roundedHalf (float f, half::RoundingMode mode, bool saturate)
+{
+    unsigned short h = imath_float_to_half_bitshift (f);
+
+    if (!isnan (f) && mode != half::RoundNearestEven)
+    {
+        if (fabs (imath_half_to_float_bitshift (h)) > fabs (f)) --h;
+
+        if (mode == half::RoundTruncate && fabs (f) >= 65536.0f)
+            h = (h & 0x8000) | 0x7c00;
+    }
+
+    if (saturate && (h & 0x7fff) == 0x7c00) h = (h & 0x8000) | 0x7bff;
+
+    return h;
+}
+
+} // namespace
+
+void
+testBulkRounding ()
+{
+    std::cout << "running testBulkRounding" << std::endl;
+
+    std::vector<float> floats;
+
+    for (unsigned int i = 0; i < 0xffffffffu - 997u; i += 997u)
+    {
+        half::uif x;
+        x.i = i;
+        floats.push_back (x.f);
+    }
+
+    //
+    // Every half, and the floats just above, just below and exactly
+    // halfway to the next half.
+    //
+
+    for (unsigned int i = 0; i < (1 << 16); i++)
+    {
+        half::uif x;
+        x.f = imath_half_to_float_bitshift (i);
+
+        if (isnan (x.f)) continue;
+
+        for (int d = -1; d <= 1; d++)
+        {
+            half::uif y = x;
+            y.i += d;
+            floats.push_back (y.f);
+            y.i = x.i + 0x1000 + d;
+            floats.push_back (y.f);
+        }
+    }
+
+    const float special[] = {
+        65504.0f,
+        65519.0f,
+        65520.0f,
+        65535.0f,
+        65536.0f,
+        1e10f,
+        std::numeric_limits<float>::max (),
+        std::numeric_limits<float>::infinity (),
+        std::numeric_limits<float>::quiet_NaN (),
+        std::numeric_limits<float>::signaling_NaN (),
+        std::numeric_limits<float>::denorm_min (),
+        std::numeric_limits<float>::min (),
+        2.98023224e-08f, // HALF_DENORM_MIN / 2
+        8.94069672e-08f, // HALF_DENORM_MIN * 1.5
+        0.0f};
+
+    for (float f: special)
+    {
+        floats.push_back (f);
+        floats.push_back (-f);
+    }
+
+    const half::RoundingMode modes[] = {
+        half::RoundNearestEven, half::RoundTowardZero, half::RoundTruncate};
+
+    std::vector<half> hs (floats.size ());
+
+    for (half::RoundingMode mode: modes)
+    {
+        for (int saturate = 0; saturate < 2; saturate++)
+        {
+            floatToHalf (
+                floats.data (), hs.data (), floats.size (), mode, saturate);
+
+            for (size_t i = 0; i < floats.size (); i++)
+            {
+                assert (
+                    hs[i].bits () == roundedHalf (floats[i], mode, saturate));
+            }
+        }
+    }
+
+    assert (roundedHalf (65535.0f, half::RoundNearestEven, false) == 0x7c00);
+    assert (roundedHalf (65535.0f, half::RoundTowardZero, false) == 0x7bff);
+    assert (roundedHalf (65535.0f, half::RoundTruncate, false) == 0x7bff);
+    assert (roundedHalf (-1e10f, half::RoundTowardZero, false) == 0xfbff);
+    assert (roundedHalf (-1e10f, half::RoundTruncate, false) == 0xfc00);
+    assert (roundedHalf (-1e10f, half::RoundTruncate, true) == 0xfbff);
+
+    std::cout << "ok" << std::endl;
+}
@@ -4,3 +4,5 @@
 //
 
 void testToFloat ();
+void testBulkConversion ();
+void testBulkRounding ();
@@ -0,0 +1,81 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+//
+// Random inputs and error measures shared by the tests and by
+// ImathPerfTest.
+//
+
+#ifndef INCLUDED_TESTUTIL_H
+#define INCLUDED_TESTUTIL_H
+
+#include <ImathMatrix.h>
+#include <ImathQuat.h>
+#include <ImathRandom.h>
+#include <ImathVec.h>
+#include <algorithm>
+#include <cmath>
+
+//
+// A point with coordinates between -size and size.
+//
+
+template <class T>
+IMATH_INTERNAL_NAMESPACE::Vec3<T>
+randomPoint (IMATH_INTERNAL_NAMESPACE::Rand48& rand, T size)
+{
+    return IMATH_INTERNAL_NAMESPACE::Vec3<T> (
+        T (rand.nextf (-size, size)),
+        T (rand.nextf (-size, size)),
+        T (rand.nextf (-size, size)));
+}
+
+//
+// A rotation, as a unit quaternion. Use toMatrix33() or toMatrix44()
+// for a rotation matrix.
+//
+
+template <class T>
+IMATH_INTERNAL_NAMESPACE::Quat<T>
+randomRotation (IMATH_INTERNAL_NAMESPACE::Rand48& rand)
+{
+    IMATH_INTERNAL_NAMESPACE::Quat<T> q (
+        T (rand.nextf (-1, 1)),
+        T (rand.nextf (-1, 1)),
+        T (rand.nextf (-1, 1)),
+        T (rand.nextf (-1, 1)));
+    return q.normalize ();
+}
+
+//
+// The largest absolute difference between the components of a and b.
+//
+
+template <class T>
+T
+maxDiff (
+    const IMATH_INTERNAL_NAMESPACE::Quat<T>& a,
+    const IMATH_INTERNAL_NAMESPACE::Quat<T>& b)
+{
+    const IMATH_INTERNAL_NAMESPACE::Quat<T> d = a - b;
+    return std::max (
+        std::max (std::abs (d.r), std::abs (d.v.x)),
+        std::max (std::abs (d.v.y), std::abs (d.v.z)));
+}
+
+template <class T>
+T
+maxDiff (
+    const IMATH_INTERNAL_NAMESPACE::Matrix33<T>& a,
+    const IMATH_INTERNAL_NAMESPACE::Matrix33<T>& b)
+{
+    T d = 0;
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            d = std::max (d, std::abs (a[i][j] - b[i][j]));
+    return d;
+}
+
+#endif
@@ -0,0 +1,271 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include "testVecArray.h"
+#include <ImathFun.h>
+#include <ImathRandom.h>
+#include <ImathVecArray.h>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+//
+// Random vectors, including null vectors, vectors too short for the
+// squared length to be accurate, and very long vectors.
+//
+
+template <class T>
+Vec3<T>
+randomVec (Rand48& rand, const Vec3<T>*)
+{
+    return Vec3<T> (
+        T (rand.nextf (-10, 10)),
+        T (rand.nextf (-10, 10)),
+        T (rand.nextf (-10, 10)));
+}
+
+template <class T>
+Vec4<T>
+randomVec (Rand48& rand, const Vec4<T>*)
+{
+    return Vec4<T> (
+        T (rand.nextf (-10, 10)),
+        T (rand.nextf (-10, 10)),
+        T (rand.nextf (-10, 10)),
+        T (rand.nextf (-10, 10)));
+}
+
+template <class Vec>
+std::vector<Vec>
+randomVecs (Rand48& rand, size_t n)
+{
+    typedef typename Vec::BaseType T;
+
+    std::vector<Vec> v (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        v[i] = randomVec (rand, (const Vec*) 0);
+
+        switch (i % 7)
+        {
+            case 3: v[i] *= std::numeric_limits<T>::min (); break;
+            case 4: v[i] *= std::numeric_limits<T>::max () / T (100); break;
+            case 5: v[i] = Vec (T (0)); break;
+            default: break;
+        }
+    }
+
+    return v;
+}
+
+template <class T>
+bool
+same (T a, T b)
+{
+    return a == b || (a != a && b != b);
+}
+
+template <class T>
+bool
+same (const Vec3<T>& a, const Vec3<T>& b)
+{
+    return same (a.x, b.x) && same (a.y, b.y) && same (a.z, b.z);
+}
+
+template <class T>
+bool
+same (const Vec4<T>& a, const Vec4<T>& b)
+{
+    return same (a.x, b.x) && same (a.y, b.y) && same (a.z, b.z) &&
+           same (a.w, b.w);
+}
+
+template <class Array, class Vec>
+void
+testArrayT (const char* name)
+{
+    typedef typename Vec::BaseType T;
+
+    cout << "    " << name << endl;
+
+    Rand48 rand (17);
+
+    //
+    // Construction, element access, conversion and alignment
+    //
+
+    Array empty;
+    assert (empty.size () == 0 && empty.empty ());
+    assert (empty.toVector ().empty ());
+
+    for (size_t n = 0; n < 70; n += (n < 20 ? 1 : 13))
+    {
+        std::vector<Vec> v = randomVecs<Vec> (rand, n);
+        Array            a (v);
+
+        assert (a.size () == n);
+
+        for (int c = 0; c < Array::dimensions (); ++c)
+        {
+            assert ((uintptr_t) a.lane (c) % Array::alignment == 0 || n == 0);
+        }
+
+        for (size_t i = 0; i < n; ++i)
+            assert (same (a[i], v[i]));
+
+        assert (a.toVector () == v);
+
+        Array b (a);
+        assert (b.toVector () == v);
+
+        Array c;
+        c = b;
+        assert (c.toVector () == v);
+
+        Array d (std::move (c));
+        assert (d.toVector () == v && c.size () == 0);
+
+        //
+        // Growing keeps the existing vectors
+        //
+
+        d.resize (3 * n + 5);
+
+        for (size_t i = 0; i < n; ++i)
+            assert (same (d[i], v[i]));
+
+        d.resize (n / 2);
+        assert (d.size () == n / 2);
+
+        d.clear ();
+        assert (d.empty ());
+    }
+
+    //
+    // Bulk operations give the same results as the per-vector methods
+    //
+
+    const size_t     n  = 1000 + 3;
+    std::vector<Vec> va = randomVecs<Vec> (rand, n);
+    std::vector<Vec> vb = randomVecs<Vec> (rand, n);
+    Array            a (va);
+    Array            b (vb);
+    std::vector<T>   r (n);
+
+    dot (a, b, r.data ());
+
+    for (size_t i = 0; i < n; ++i)
+        assert (same<T> (r[i], va[i].dot (vb[i])));
+
+    length2 (a, r.data ());
+
+    for (size_t i = 0; i < n; ++i)
+        assert (same<T> (r[i], va[i].length2 ()));
+
+    length (a, r.data ());
+
+    for (size_t i = 0; i < n; ++i)
+        assert (same<T> (r[i], va[i].length ()));
+
+    Array c;
+    lerp (a, b, T (0.25), c);
+
+    for (size_t i = 0; i < n; ++i)
+        assert (same (c[i], lerp (va[i], vb[i], T (0.25))));
+
+    IMATH_INTERNAL_NAMESPACE::min (a, b, c);
+
+    for (size_t i = 0; i < n; ++i)
+        for (unsigned int j = 0; j < Vec::dimensions (); ++j)
+            assert (c[i][j] == std::min (va[i][j], vb[i][j]));
+
+    IMATH_INTERNAL_NAMESPACE::max (a, b, c);
+
+    for (size_t i = 0; i < n; ++i)
+        for (unsigned int j = 0; j < Vec::dimensions (); ++j)
+            assert (c[i][j] == std::max (va[i][j], vb[i][j]));
+
+    //
+    // Outputs may be inputs
+    //
+
+    c = a;
+    IMATH_INTERNAL_NAMESPACE::max (c, b, c);
+
+    for (size_t i = 0; i < n; ++i)
+        for (unsigned int j = 0; j < Vec::dimensions (); ++j)
+            assert (c[i][j] == std::max (va[i][j], vb[i][j]));
+
+    normalize (a);
+
+    for (size_t i = 0; i < n; ++i)
+        assert (same (a[i], va[i].normalized ()));
+}
+
+template <class T>
+void
+testCrossT ()
+{
+    Rand48                rand (5);
+    const size_t          n  = 517;
+    std::vector<Vec3<T>> va = randomVecs<Vec3<T>> (rand, n);
+    std::vector<Vec3<T>> vb = randomVecs<Vec3<T>> (rand, n);
+    Vec3Array<T>          a (va);
+    Vec3Array<T>          b (vb);
+    Vec3Array<T>          c;
+
+    cross (a, b, c);
+
+    for (size_t i = 0; i < n; ++i)
+        assert (same (c[i], va[i] % vb[i]));
+
+    cross (a, b, a);
+
+    for (size_t i = 0; i < n; ++i)
+        assert (same (a[i], va[i] % vb[i]));
+}
+
+} // namespace
+
+void
+testVecArray ()
+{
+    cout << "Testing structure-of-arrays vector containers" << endl;
+
+    testArrayT<V3fArray, V3f> ("V3fArray");
+    testArrayT<V3dArray, V3d> ("V3dArray");
+    testArrayT<V4fArray, V4f> ("V4fArray");
+    testArrayT<V4dArray, V4d> ("V4dArray");
+
+    testCrossT<float> ();
+    testCrossT<double> ();
+
+    //
+    // Integer arrays support everything but length and normalize
+    //
+
+    std::vector<V3i> vi (10, V3i (1, 2, 3));
+    Vec3Array<int>   ai (vi);
+    std::vector<int> ri (10);
+
+    dot (ai, ai, ri.data ());
+    assert (ri[9] == 14);
+
+    cout << "ok\n" << endl;
+}